@@ -0,0 +1,229 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#ifdef ZX_AY_ARM7
+#include <nds.h>
+#include <string.h>
+
+#include "cpu/ay38910/AY38910.h"
+#include "ay7_ipc.h"
+
+// ------------------------------------------------------------------------------------------
+// The ARM7 side of the AY chip. The ARM7 otherwise just sits waiting for the vertical blank so
+// here it runs the same AY38910 core the ARM9 used to, from the register writes the ARM9 logs
+// (see ay7_ipc.h), into a looping buffer on its own hardware channel. TIMER2 is set to tick at
+// the same rate as the channel and TIMER3 (cascaded) counts the samples played, so we always
+// know how far ahead of the sound hardware we are. If we fall behind, we pick up again a little
+// ahead with the last sample held. If the ARM9 gets too far ahead (full speed mode) whole frames
+// are applied to the chip without being rendered.
+//
+// The beeper still goes out through the ARM9's maxmod stream, which plays some way behind the
+// emulation (the mixer buffer plus the stream buffer - the ARM9 keeps it steady, see its
+// audio_rate_control). The ARM9 tells us how far that is and we keep the AY the same distance
+// ahead of the sound hardware: a small difference is taken up by running the channel and the
+// timers a tick or two faster or slower, a big one (starting up, a new buffer size) by jumping
+// straight there. So the two halves of the sound don't drift apart.
+// ------------------------------------------------------------------------------------------
+#define AY7_CHANNEL     15          // Out of maxmod's way at the top
+#define AY7_OUT_SIZE    4096        // Looping output buffer in samples - must divide 65536
+#define AY7_LATENCY_MAX 2048        // Never further ahead of the sound hardware than this (half the buffer)
+#define AY7_STEP        32          // Samples off the ARM9's latency for each timer tick of correction
+#define AY7_TRIM_MAX    8           // At most this many ticks either way (about 1.5% at 31KHz)
+#define AY7_SNAP        512         // Further off than this and we jump straight to it
+
+static AY38910 ay7_chip;
+static AY7Ring_t *ay7_ring = 0;     // Set when the ARM9 sends it over
+static u8  ay7_started = 0;
+static u32 ay7_rate = 0;
+static u32 ay7_ticks = 0;           // Sound timer ticks per sample at ay7_rate
+static s32 ay7_trim = 0;            // Ticks taken off that to catch up (or added to fall back)
+static s32 ay7_ahead_avg = 0;       // Smoothed samples ahead of the sound hardware in 1/16ths
+static u16 ay7_written = 0;         // Samples written into ay7_out[] - wraps along with TIMER3
+static s16 ay7_last = 0;
+static s16 ay7_out[AY7_OUT_SIZE] ALIGN(4);
+
+static void ay7_address_handler(void *address, void *userdata)
+{
+    ay7_ring = (AY7Ring_t *)address;
+}
+
+void ay7_install(void)
+{
+    fifoSetAddressHandler(AY7_FIFO_CHANNEL, ay7_address_handler, 0);
+}
+
+// The AY core output sits at -32768 when silent - make that 0 so we don't add any DC to the mix
+static void ay7_render(u32 count)
+{
+    while (count)
+    {
+        u32 idx = ay7_written & (AY7_OUT_SIZE-1);
+        u32 len = AY7_OUT_SIZE - idx;
+        if (len > count) len = count;
+
+        s16 *out = &ay7_out[idx];
+        ay38910Mixer(len, out, &ay7_chip);
+        for (u32 i=0; i<len; i++)
+        {
+            out[i] = (u16)(out[i] ^ 0x8000) >> 1;
+        }
+        ay7_last = out[len-1];
+
+        ay7_written += len;
+        count -= len;
+    }
+}
+
+static void ay7_set_timers(void)
+{
+    u32 ticks = ay7_ticks - ay7_trim;
+    SCHANNEL_TIMER(AY7_CHANNEL) = (u16)(-ticks);
+    TIMER2_DATA = (u16)(-(2 * ticks));              // The timers run twice as fast as the sound clock
+}
+
+static void ay7_set_rate(u32 rate)
+{
+    ay7_rate = rate;
+    ay7_ticks = 0x1000000 / rate;                   // As SOUND_FREQ() but positive
+    ay7_set_timers();
+}
+
+// ------------------------------------------------------------------------------------------
+// How far ahead we should be just after a frame has gone in. A frame sits here for half a
+// vertical blank on average before we pick it up, so that comes off the ARM9's latency. But
+// frames come at 50Hz and we look at 60Hz, so one can be two vertical blanks away from the
+// next - we never aim for less than that (plus a little) or the sound hardware catches us.
+// On the DS that floor is a few ms past the ARM9's latency, which beats a gap every frame.
+// ------------------------------------------------------------------------------------------
+static s32 ay7_target(void)
+{
+    s32 vblank = ay7_rate / 60;
+    s32 least = (2 * vblank) + 64;
+    s32 latency = ay7_ring->latency;
+
+    if (latency == 0) return least;                 // The ARM9 hasn't said yet
+    latency -= vblank / 2;
+    if (latency < least) return least;
+    if (latency > AY7_LATENCY_MAX) return AY7_LATENCY_MAX;
+    return latency;
+}
+
+// The sound hardware has played up to 'played' - carry on from 'ahead' samples after that with the
+// last sample held until then
+static void ay7_hold(u16 played, s32 ahead)
+{
+    for (u16 pos = ay7_written; (s16)(pos - (u16)(played + ahead)) < 0; pos++) ay7_out[pos & (AY7_OUT_SIZE-1)] = ay7_last;
+    ay7_written = played + ahead;
+    ay7_ahead_avg = ahead << 4;
+}
+
+// ------------------------------------------------------------------------------------------
+// Just after a frame has gone in, see how far ahead we are against the ARM9's latency and
+// set the play rate to close the gap - or if it's way out, move straight there.
+// ------------------------------------------------------------------------------------------
+static void ay7_rate_control(u16 played)
+{
+    s32 target = ay7_target();
+    s32 ahead = (s16)(ay7_written - played);
+
+    ay7_ahead_avg += ((ahead << 4) - ay7_ahead_avg) >> 3;
+    s32 error = (ay7_ahead_avg >> 4) - target;
+
+    if ((error < -AY7_SNAP) || (error > AY7_SNAP)) // Too close puts in a gap, too far drops the end
+    {
+        ay7_hold(played, target);
+        error = 0;
+    }
+
+    s32 trim = error / AY7_STEP;
+    if (trim > AY7_TRIM_MAX) trim = AY7_TRIM_MAX;
+    else if (trim < -AY7_TRIM_MAX) trim = -AY7_TRIM_MAX;
+    if (trim != ay7_trim)
+    {
+        ay7_trim = trim;
+        ay7_set_timers();
+    }
+}
+
+static void ay7_start(void)
+{
+    ay38910Reset(&ay7_chip);
+    ay7_last = 0;
+    ay7_trim = 0;
+    memset(ay7_out, 0x00, sizeof(ay7_out));
+
+    SCHANNEL_CR(AY7_CHANNEL) = 0;
+    SCHANNEL_SOURCE(AY7_CHANNEL) = (u32)ay7_out;
+    SCHANNEL_REPEAT_POINT(AY7_CHANNEL) = 0;
+    SCHANNEL_LENGTH(AY7_CHANNEL) = sizeof(ay7_out) >> 2;
+
+    TIMER2_CR = 0;
+    TIMER3_CR = 0;
+    ay7_set_rate(ay7_ring->rate);
+    TIMER3_DATA = 0;
+    TIMER3_CR = TIMER_ENABLE | TIMER_CASCADE;
+    TIMER2_CR = TIMER_ENABLE | TIMER_DIV_1;
+    SCHANNEL_CR(AY7_CHANNEL) = SCHANNEL_ENABLE | SOUND_REPEAT | SOUND_VOL(127) | SOUND_PAN(64) | SOUND_FORMAT_16BIT;
+
+    ay7_written = 0;
+    ay7_hold(0, ay7_target());
+    ay7_started = 1;
+}
+
+// ------------------------------------------------------------------------------------------
+// Called from the main loop after every vertical blank - take whatever whole frames the ARM9
+// has finished and render them into the output buffer.
+// ------------------------------------------------------------------------------------------
+void ay7_update(void)
+{
+    if (!ay7_ring || !ay7_ring->rate) return;
+    if (!ay7_started) ay7_start();
+    if (ay7_ring->rate != ay7_rate) ay7_set_rate(ay7_ring->rate);
+
+    u16 played = TIMER3_DATA;
+    if ((s16)(ay7_written - played) < 64) // Fell behind - hold the last sample up to where we start again
+    {
+        ay7_written = played;
+        ay7_hold(played, ay7_target());
+    }
+
+    u32 read = ay7_ring->read;
+    u32 write = ay7_ring->write;
+    u8 rendered = 0;
+    while (read != write)
+    {
+        u32 end = read;
+        while (!AY7_IS_FRAME(ay7_ring->ring[end])) end = (end + 1) & (AY7_RING_SIZE-1);
+        u32 samples = ay7_ring->ring[end] & 0xFFFF;
+
+        u8 render = !ay7_ring->mute && ((s16)(ay7_written - played) < (s16)(AY7_OUT_SIZE - samples - 64));
+
+        u32 pos = 0;
+        for (; read != end; read = (read + 1) & (AY7_RING_SIZE-1))
+        {
+            u32 word = ay7_ring->ring[read];
+            u32 at = AY7_POS(word);
+            if (at > samples) at = samples;
+            if (render && (at > pos)) {ay7_render(at - pos); pos = at;}
+            ay38910IndexW(AY7_REG(word), &ay7_chip);
+            ay38910DataW(AY7_VALUE(word), &ay7_chip);
+        }
+        if (render && (pos < samples)) ay7_render(samples - pos);
+        rendered |= render;
+
+        read = (end + 1) & (AY7_RING_SIZE-1);
+        ay7_ring->read = read;
+    }
+
+    if (rendered) ay7_rate_control(played);
+}
+#endif
+
+// End of file
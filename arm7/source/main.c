@@ -33,6 +33,11 @@
 
 extern void mmInstall( int fifo_channel );
 
+#ifdef ZX_AY_ARM7
+extern void ay7_install(void);
+extern void ay7_update(void);
+#endif
+
 //---------------------------------------------------------------------------------
 void VblankHandler(void) {
 //---------------------------------------------------------------------------------
@@ -76,6 +81,10 @@ int main() {
 
 	installSystemFIFO();
 
+#ifdef ZX_AY_ARM7
+	ay7_install();
+#endif
+
 	irqSet(IRQ_VCOUNT, VcountHandler);
 	irqSet(IRQ_VBLANK, VblankHandler);
 
@@ -90,6 +99,10 @@ int main() {
 		}
     
 		swiWaitForVBlank();
+
+#ifdef ZX_AY_ARM7
+		ay7_update();
+#endif
 	}
 	return 0;
 }
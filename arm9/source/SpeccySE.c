@@ -31,6 +31,9 @@
 #include "soundbank.h"
 #include "soundbank_bin.h"
 #include "screenshot.h"
+#include "recorder.h"
+#include "ay7_ipc.h"
+#include "beeper.h"
 #include "cpu/z80/Z80_interface.h"
 
 #include "printf.h"
@@ -81,6 +84,8 @@ u8 bStartIn          = 0;
 // ---------------------------------------------------------------------------
 u16 emuActFrames    __attribute__((section(".dtcm"))) = 0;
 u16 timingFrames    __attribute__((section(".dtcm"))) = 0;
+s16 frameSlack      __attribute__((section(".dtcm"))) = 0;    // Smoothed TIMER2 ticks left over at the end of each frame
+u8  frameBehind     __attribute__((section(".dtcm"))) = 0;    // Set when the adaptive frameskip wants the next frame skipped
 
 // ----------------------------------------------------------------------------------
 // For the various BIOS files ... only the 48.rom spectrum BIOS is truly required...
@@ -181,6 +186,9 @@ const int8 brightness[] = {0, -6, -12, -15};
 void SoundPause(void)
 {
     soundEmuPause = 1;
+#ifdef ZX_AY_ARM7
+    ay7_mute(1);
+#endif
 }
 
 // ------------------------------------------------------------
@@ -189,6 +197,9 @@ void SoundPause(void)
 void SoundUnPause(void)
 {
     soundEmuPause = 0;
+#ifdef ZX_AY_ARM7
+    ay7_mute(0);
+#endif
 }
 
 // --------------------------------------------------------------------------------------------
@@ -218,9 +229,46 @@ u16 GAME_SPEED_PAL[]  __attribute__((section(".dtcm"))) = {654, 640, 623, 594, 5
 // maxmod will call this routine when the buffer is half-empty and requests that
 // we fill the sound buffer with more samples. They will request 'len' samples and
 // we will fill exactly that many. If the sound is paused, we fill with 'mute' samples.
+//
+// The stream runs at the rate the emulation makes samples (see get_sample_rate) but the
+// two clocks never agree exactly, so rather than copying samples straight across we step
+// through the mixer buffer mixer_step (16.16) at a time, interpolating between samples.
+// Once a frame audio_rate_control() nudges mixer_step to keep the buffer half full.
 // -------------------------------------------------------------------------------------------
-s16 last_sample __attribute__((section(".dtcm"))) = 0;
-int breather    __attribute__((section(".dtcm"))) = 0;
+s16 last_sample     __attribute__((section(".dtcm"))) = 0;
+u32 mixer_step      __attribute__((section(".dtcm"))) = 0x10000;   // Mixer samples per output sample in 16.16 fixed point
+u32 mixer_frac      __attribute__((section(".dtcm"))) = 0;         // How far we are between mixer_read and the next one
+u32 audio_underruns = 0;   // Times the sound callback ran out of samples
+u32 audio_overruns  = 0;   // Samples dropped because the mixer buffer was full
+
+static inline void OurSoundResample(s16 *p, mm_word len, const s16 *ring, u16 mask)
+{
+    s16 local_sample = last_sample; // A tiny bit faster to move this locally
+    u16 read = mixer_read;
+    u32 frac = mixer_frac;
+    u8  dry = 0;
+
+    for (int i=0; i<len; i++)
+    {
+        if (((mixer_write - read) & mask) < 2) {*p++ = local_sample; dry = 1;} // Need this sample and the next
+        else
+        {
+            s32 a = ring[read];
+            s32 b = ring[(read + 1) & mask];
+            local_sample = a + (((b - a) * (s32)frac) >> 16);
+            *p++ = local_sample;
+
+            frac += mixer_step;     // Well under 2.0 so we never step past mixer_write
+            read = (read + (frac >> 16)) & mask;
+            frac &= 0xFFFF;
+        }
+    }
+    if (dry) audio_underruns++;
+
+    mixer_read = read;
+    mixer_frac = frac;
+    last_sample = local_sample;
+}
 
 ITCM_CODE mm_word OurSoundMixer(mm_word len, mm_addr dest, mm_stream_formats format)
 {
@@ -234,21 +282,7 @@ ITCM_CODE mm_word OurSoundMixer(mm_word len, mm_addr dest, mm_stream_formats for
     }
     else
     {
-        s16 *p = (s16*)dest;
-        s16 local_sample = last_sample; // A tiny bit faster to move this locally
-        for (int i=0; i<len; i++)
-        {
-            if (mixer_read == mixer_write) {*p++ = local_sample;}
-            else
-            {
-                local_sample = mixer[mixer_read];
-                *p++ = local_sample;
-                mixer_read = (mixer_read + 1) & WAVE_DIRECT_BUF_SIZE;
-            }
-        }
-        if (breather) {breather -= len; if (breather < 0) breather = 0;}
-
-        last_sample = local_sample;
+        OurSoundResample((s16*)dest, len, mixer, WAVE_DIRECT_BUF_SIZE);
     }
 
     return  len;
@@ -266,124 +300,343 @@ ITCM_CODE mm_word OurSoundMixerDSI(mm_word len, mm_addr dest, mm_stream_formats
     }
     else
     {
-        s16 *p = (s16*)dest;
-        s16 local_sample = last_sample; // A tiny bit faster to move this locally
-        for (int i=0; i<len; i++)
-        {
-            if (mixer_read == mixer_write) {*p++ = local_sample;}
-            else
-            {
-                local_sample = mixer_DSI[mixer_read];
-                *p++ = local_sample;
-                mixer_read = (mixer_read + 1) & WAVE_DIRECT_BUF_SIZE_DSI;
-            }
-        }
-        if (breather) {breather -= len; if (breather < 0) breather = 0;}
-
-        last_sample = local_sample;
+        OurSoundResample((s16*)dest, len, mixer_DSI, WAVE_DIRECT_BUF_SIZE_DSI);
     }
 
     return  len;
 }
 
+// -------------------------------------------------------------------------------------------
+// Called once per frame - a PI controller on how full the mixer buffer is. The fill level is
+// smoothed over a few frames (it saw-tooths as frames are made in a burst and the callback
+// takes a block at a time) and the error to half full goes straight into mixer_step, with the
+// sum of the error taking up whatever steady difference there is between the two clocks.
+//
+// With ZX_AUDIO=arm7 the AY plays on its own channel from the ARM7, so the ARM7 is told how
+// far behind the emulation this stream is - the mixer fill plus (on average) three quarters of
+// the maxmod buffer - and it keeps the AY as near that distance behind as it can.
+// -------------------------------------------------------------------------------------------
+#define MIXER_STEP_RANGE    0x1000      // mixer_step can move +/-6% from 1.0
+#define MIXER_TRIM_MAX      (3000<<7)   // And the integral (in 1/128ths) up to about 4.5% of that
+
+s32 mixer_fill_avg  = 0;    // Smoothed fill level in 1/16ths of a sample
+s32 mixer_fill_trim = 0;    // Sum of the fill error
+
+void audio_rate_control(void)
+{
+    const u16 mask = (isDSiMode() ? WAVE_DIRECT_BUF_SIZE_DSI : WAVE_DIRECT_BUF_SIZE);
+    const s32 target = (mask + 1) / 2;
+
+#ifdef ZX_AY_ARM7
+    ay7_latency((((mixer_fill_avg >> 4) + ((buffer_size * 3) / 4)) * AY7_SAMPLES_PER_LINE) / (isDSiMode() ? 4:2));
+#endif
+
+    // Nothing is being played (or we're running flat out) - hold the trim where it is
+    if (soundEmuPause || (speccy_mode == MODE_ZX81) || (myGlobalConfig.showFPS == 2))
+    {
+        mixer_fill_avg = target << 4;
+        return;
+    }
+
+    s32 fill = (mixer_write - mixer_read) & mask;
+    mixer_fill_avg += ((fill << 4) - mixer_fill_avg) >> 3;
+
+    s32 error = (mixer_fill_avg >> 4) - target;
+    mixer_fill_trim += error;
+    if (mixer_fill_trim > MIXER_TRIM_MAX) mixer_fill_trim = MIXER_TRIM_MAX;
+    else if (mixer_fill_trim < -MIXER_TRIM_MAX) mixer_fill_trim = -MIXER_TRIM_MAX;
+
+    s32 step = 0x10000 + error + (mixer_fill_trim >> 7);
+    if (step > 0x10000 + MIXER_STEP_RANGE) step = 0x10000 + MIXER_STEP_RANGE;
+    else if (step < 0x10000 - MIXER_STEP_RANGE) step = 0x10000 - MIXER_STEP_RANGE;
+    mixer_step = step;
+}
+
 // --------------------------------------------------------------------------------------------
-// This is called when we want to sample the audio directly - we grab 2x AY samples and mix
-// them with the beeper tones. We do a little bit of edge smoothing on the audio  tones here
-// to make the direct beeper sound a bit less harsh - but this really needs to be properly
-// over-sampled and smoothed someday to make it really shine... good enough for now.
+// The AY is not rendered a few samples at a time as we go. Instead every register write is
+// logged with its T-State (see cpu_writeport_speccy) and every AY_BATCH_LINES scanlines (the
+// EVT_AY_BATCH event in speccy_run), and at the end of the frame, the whole batch is rendered
+// in one go - each logged write applied at the exact AY sample it landed on. The scanlines
+// themselves only put the beeper into the mixer buffer; those samples are held back from the
+// sound callback (mixer_pending) until the batch adds the AY on top and hands them over. myAY
+// stays the chip the CPU sees (the registers can be read back and are saved with the state) and
+// myAYRender is the one that makes the sound.
 // --------------------------------------------------------------------------------------------
-s16 mixbufAY[16]        __attribute__((section(".dtcm"))) = { 0x000, 0x000, 0x000, 0x000, 0x000 , 0x000 , 0x000 , 0x000, 0x000, 0x000, 0x000, 0x000, 0x000 , 0x000 , 0x000 , 0x000 };
-s16 beeper_vol          __attribute__((section(".dtcm"))) = 0;
-u32 ay_sample_idx       __attribute__((section(".dtcm"))) = 0;
-u32 beeper_pulses_idx   __attribute__((section(".dtcm"))) = 0;
-u8  beeper_toggle[]     __attribute__((section(".dtcm"))) = {0x00, 0x01, 0x05, 0x0B, 0x0F};
+#define AY_LOG_SIZE         64      // If a batch has more writes than this, the extra ones land early
 
-ITCM_CODE void processDirectAudio(void)
+typedef struct
 {
-    if (ay_sample_idx & 0xF8)
+    u32 tstates;
+    u8  reg;
+    u8  value;
+} AYWrite_t;
+
+u16 mixer_pending       __attribute__((section(".dtcm"))) = 0;   // Samples up to here are written but the AY isn't in them yet
+u32 ay_scale            __attribute__((section(".dtcm"))) = 0;   // T-States to AY samples in 16.16 fixed point
+u32 ay_batch_lines      __attribute__((section(".dtcm"))) = 0;   // Scanlines waiting for the AY
+u32 ay_batch_end        __attribute__((section(".dtcm"))) = 0;   // CPU.TStates at the end of the last of them
+s16 ay_last_sample      __attribute__((section(".dtcm"))) = 0;   // Held while the AY isn't in use
+s16 ay_batch_buf[AY_BATCH_LINES * AY_SAMPLES_PER_LINE] __attribute__((section(".dtcm"))) ALIGN(4);
+#ifndef ZX_AY_ARM7
+AY38910 myAYRender      __attribute__((section(".dtcm")));
+u32 ay_log_count        __attribute__((section(".dtcm"))) = 0;
+AYWrite_t ay_log[AY_LOG_SIZE];
+
+ITCM_CODE void ay_log_write(u8 reg, u8 value)
+{
+    if (ay_log_count < AY_LOG_SIZE)
+    {
+        ay_log[ay_log_count].tstates = CPU.TStates;
+        ay_log[ay_log_count].reg = reg;
+        ay_log[ay_log_count].value = value;
+        ay_log_count++;
+    }
+    else // Nowhere to put it - it will just be heard a little early
     {
-        if (zx_AY_enabled) ay38910Mixer(8, mixbufAY, &myAY); // Grab 8 samples
-        ay_sample_idx = 0;
+        ay38910IndexW(reg, &myAYRender);
+        ay38910DataW(value, &myAYRender);
     }
+}
 
-    if (breather) {return;}
-    
-    for (u8 i=0; i<2; i++)
+// Render the AY for the batch of scanlines ending at line_end into ay_batch_buf[]
+static void ay_batch_render(u32 line_end, u32 samples)
+{
+    u32 batch_start = line_end - (ay_batch_lines * beeper_line_span);
+    u32 pos = 0;
+
+    for (u32 i=0; i<ay_log_count; i++)
     {
-        if (beeper_pulses_idx)
-        {
-            beeper_vol = beeper_vol ^ 0x4000;
-            beeper_pulses_idx--;
-        }
+        s32 offset = (s32)(ay_log[i].tstates - batch_start);
+        u32 at = (offset > 0) ? (((u32)offset * ay_scale) >> 16) : 0; // Anything before the batch (lines we dropped) goes at the start
+        if (at > samples) at = samples;
+        if (at > pos) {ay38910Mixer(at - pos, &ay_batch_buf[pos], &myAYRender); pos = at;}
+        ay38910IndexW(ay_log[i].reg, &myAYRender);
+        ay38910DataW(ay_log[i].value, &myAYRender);
+    }
+    ay_log_count = 0;
 
-        s32 sample = (s32)mixbufAY[ay_sample_idx++] + (s32)beeper_vol;
-        if (sample > 32767) sample = 32767;
-        mixer[mixer_write++] = (s16)sample;
+    if (pos < samples) ay38910Mixer(samples - pos, &ay_batch_buf[pos], &myAYRender);
+    ay_last_sample = ay_batch_buf[samples-1];
+}
 
-        mixer_write &= WAVE_DIRECT_BUF_SIZE;
-        if (((mixer_write+1)&WAVE_DIRECT_BUF_SIZE) == mixer_read) {breather = 1024; return;}
+// Nothing to render (tape loading or the AY not in use yet) - the writes just go straight in
+static void ay_batch_apply(void)
+{
+    for (u32 i=0; i<ay_log_count; i++)
+    {
+        ay38910IndexW(ay_log[i].reg, &myAYRender);
+        ay38910DataW(ay_log[i].value, &myAYRender);
     }
+    ay_log_count = 0;
+}
+
+// The AY state changed behind the CPU's back (reset, load state) - copy it over to myAYRender
+void ay_render_sync(void)
+{
+    u8 ay_state[64];
+    ay38910SaveState(ay_state, &myAY);
+    ay38910Reset(&myAYRender);
+    ay38910LoadState(&myAYRender, ay_state);
+    ay_log_count = 0;
 }
+#endif
 
-ITCM_CODE void processDirectAudioDSI(void)
+// Add the AY to the scanlines written since the last batch and let the sound callback have them
+void ay_batch_flush(void)
 {
-    if (ay_sample_idx & 0xF8)
+    const u8 bDSi = isDSiMode();
+    const u16 mask = (bDSi ? WAVE_DIRECT_BUF_SIZE_DSI : WAVE_DIRECT_BUF_SIZE);
+    s16 *ring = (bDSi ? mixer_DSI : mixer);
+    u32 count = (mixer_pending - mixer_write) & mask; // Can be short of the full batch if the buffer filled
+    u32 idx = mixer_write;
+    u8 rendered = 0;
+
+#ifndef ZX_AY_ARM7 // Otherwise the ARM7 renders the AY and we just hold the last sample
+    if (ay_batch_lines && zx_AY_enabled)
     {
-        if (zx_AY_enabled) ay38910Mixer(8, mixbufAY, &myAY); // Grab 8 samples
-        ay_sample_idx = 0;
+        ay_batch_render(ay_batch_end, ay_batch_lines * AY_SAMPLES_PER_LINE);
+        rendered = 1;
+    }
+    else ay_batch_apply();
+#endif
+
+    for (u32 i=0; i<count; i++)
+    {
+        s32 sample = (s32)ring[idx] + (rendered ? ay_batch_buf[bDSi ? (i>>1):i] : ay_last_sample); // DSi has 2 samples for each AY sample
+        if (sample > 32767) sample = 32767;
+        else if (sample < -32768) sample = -32768;
+        ring[idx] = (s16)sample;
+        idx = (idx + 1) & mask;
     }
 
-    if (breather) {return;}
+    mixer_write = mixer_pending;
+    ay_batch_lines = 0;
+}
 
-    u8 toggle = beeper_toggle[beeper_pulses_idx];
-    beeper_pulses_idx = 0;
+// The mixer buffer was emptied out from under us (tape loading)
+void ay_batch_reset(void)
+{
+    mixer_read = mixer_write = mixer_pending = 0;
+    mixer_frac = 0;
+    ay_batch_lines = 0;
+}
 
-    for (u8 i=0; i<4; i++)
+// The lines of this run join the batch. A run never crosses an EVT_AY_BATCH so it always fits.
+static inline void ay_batch_lines_add(u32 run_end, u32 lines)
+{
+    ay_batch_lines += lines;
+    ay_batch_end = run_end;
+}
+
+// ------------------------------------------------------------------------------------------
+// The run of 'lines' scanlines ending at run_end is done - the beeper samples for each line
+// (the AY is added on top when the batch is flushed). See beeper.h for how the edges go in.
+// ------------------------------------------------------------------------------------------
+ITCM_CODE void processDirectAudio(u32 run_end, u32 lines)
+{
+    u32 line_end = run_end - ((lines-1) * beeper_line_span);
+    u32 edge = 0;
+
+    ay_batch_lines_add(run_end, lines);
+    while (1)
     {
-        if (toggle & (1 << i))
+        edge = beeper_steps(line_end, edge, (lines == 1));
+
+        for (u8 i=0; i<2; i++)
         {
-            beeper_vol = beeper_vol ^ 0x4000;
+            s16 sample = (s16)beeper_sample();
+            u16 next = (mixer_pending + 1) & WAVE_DIRECT_BUF_SIZE;
+            if (next == mixer_read) {audio_overruns++; continue;} // Full - only when running flat out
+            mixer[mixer_pending] = sample;
+            mixer_pending = next;
         }
 
-        s32 sample = (s32)mixbufAY[ay_sample_idx] + (s32)beeper_vol;
-        if (i&1) ay_sample_idx++; // Consume AY samples half as fast as DS-Lite
-        if (sample > 32767) sample = 32767;
-        mixer_DSI[mixer_write++] = (s16)sample;
+        if (--lines == 0) break;
+        line_end += beeper_line_span;
+    }
+    beeper_edge_count = 0;
+}
+
+ITCM_CODE void processDirectAudioDSI(u32 run_end, u32 lines)
+{
+    u32 line_end = run_end - ((lines-1) * beeper_line_span);
+    u32 edge = 0;
+
+    ay_batch_lines_add(run_end, lines);
+    while (1)
+    {
+        edge = beeper_steps(line_end, edge, (lines == 1));
+
+        for (u8 i=0; i<4; i++)
+        {
+            s16 sample = (s16)beeper_sample();
+            u16 next = (mixer_pending + 1) & WAVE_DIRECT_BUF_SIZE_DSI;
+            if (next == mixer_read) {audio_overruns++; continue;} // Full - only when running flat out
+            mixer_DSI[mixer_pending] = sample;
+            mixer_pending = next;
+        }
+
+        if (--lines == 0) break;
+        line_end += beeper_line_span;
+    }
+    beeper_edge_count = 0;
+}
+
+#ifdef ZX_AY_ARM7
+// --------------------------------------------------------------------------------------------
+// With ZX_AUDIO=arm7 the ARM7 runs the AY chip. Register writes still go to myAY here (the CPU
+// can read them back and they are saved with the state) but each is also logged in the shared
+// ring with the AY sample it landed on - see ay7_ipc.h. The ring is only ever touched through
+// the uncached mirror so the ARM7 sees exactly what we wrote. If the ARM7 can't keep up and the
+// ring fills, writes are lost so the next frame starts by sending all 16 registers again.
+// --------------------------------------------------------------------------------------------
+AY7Ring_t ay7_ring_storage ALIGN(32);
+AY7Ring_t *ay7_ring     = 0;
+u32 ay7_pending         __attribute__((section(".dtcm"))) = 0;   // Next ring entry - published at the end of the frame
+u8  ay7_resync          __attribute__((section(".dtcm"))) = 1;   // Send all the registers at the start of the next frame
+
+static inline u8 ay7_put(u32 word)
+{
+    u32 next = (ay7_pending + 1) & (AY7_RING_SIZE-1);
+    if (next == ay7_ring->read) return 0; // Full - the ARM7 is behind
+    ay7_ring->ring[ay7_pending] = word;
+    ay7_pending = next;
+    return 1;
+}
+
+ITCM_CODE void ay7_write(u8 reg, u8 value)
+{
+    u32 pos = (CPU.TStates * ay_scale) >> 16;
+    if (pos > 0xFFFE) pos = 0xFFFE; // The ARM7 clamps to the end of the frame
+    if (!ay7_put(AY7_WRITE(pos, reg, value))) ay7_resync = 1;
+}
+
+// Close off the frame just emulated and hand it over to the ARM7
+void ay7_frame_end(u32 samples)
+{
+    if (ay7_put(AY7_FRAME(samples))) ay7_ring->write = ay7_pending;
+    else {ay7_pending = ay7_ring->write; ay7_resync = 1;} // Drop the whole frame
 
-        mixer_write &= WAVE_DIRECT_BUF_SIZE_DSI;
-        if (((mixer_write+1)&WAVE_DIRECT_BUF_SIZE_DSI) == mixer_read) {breather = 2048; return;}
+    if (ay7_resync)
+    {
+        ay7_resync = 0;
+        for (u8 reg=0; reg<16; reg++)
+        {
+            if (!ay7_put(AY7_WRITE(0, reg, myAY.ayRegs[reg]))) {ay7_pending = ay7_ring->write; ay7_resync = 1; break;}
+        }
     }
 }
 
+void ay7_mute(u8 mute)
+{
+    if (ay7_ring) ay7_ring->mute = mute;
+}
+
+// How far behind the emulation the maxmod stream is playing (in AY7 samples) - the ARM7 holds
+// the AY that far behind too so the two stay together (see audio_rate_control)
+void ay7_latency(u32 samples)
+{
+    if (ay7_ring) ay7_ring->latency = samples;
+}
+
+// The AY state changed behind the CPU's back (reset, load state)
+void ay7_sync(void)
+{
+    ay7_resync = 1;
+}
+
+void ay7_init(void)
+{
+    ay7_ring = (AY7Ring_t *)memUncached(&ay7_ring_storage);
+    memset(ay7_ring, 0x00, sizeof(AY7Ring_t));
+    ay7_pending = 0;
+    ay7_resync = 1;
+    ay7_ring->mute = 1;
+    fifoSendAddress(AY7_FIFO_CHANNEL, &ay7_ring_storage);
+}
+#endif
+
 // -----------------------------------------------------------------------------------------------
 // The user can override the core emulation speed from 80% to 120% to make games play faster/slow
 // than normal. We must adjust the MaxMode sample frequency to match or else we will not have the
-// proper number of samples in our sound buffer... this isn't perfect but it's reasonably good!
+// proper number of samples in our sound buffer. This is the rate the emulation makes them at - so
+// many per scanline, at the frame rate TIMER2 holds us to (GAME_SPEED_PAL[] ticks of the 32728.5Hz
+// timer per frame). Whatever small difference is left between that and the real sound clock is
+// taken up by audio_rate_control() so there's nothing here to hand-tune.
 // -----------------------------------------------------------------------------------------------
 static u8 last_game_speed = 99;
 static u8 last_machine = 99;
-static u32 sample_rate_adjust[] = {100, 102, 105, 110, 120, 98, 95, 90, 80};
 
-int get_sample_rate(void)
+static u32 emu_sample_rate(u32 samples_per_line)
 {
-    // Adjust the sample rate to match the core emulation speed... user can override from 80% to 120%
-    // The sample rates below are hand-tuned so that we end up coming up a tiny bit slower with the 
-    // interrupt and so we never run out of buffer to process. Change these at your own risk!
-
-    int sample_rate;
-
-    if (isDSiMode())
-    {
-        sample_rate = (myConfig.machine ? 61450:61650);  // 48K has one more scanline (~200 more samples per second)
-    }
-    else
-    {
-        sample_rate = (myConfig.machine ? 30500:30600); // 48K has one more scanline (~100 more samples per second)
-    }
+    u32 lines = (myConfig.machine ? SCANLINES_PER_FRAME_128:SCANLINES_PER_FRAME_48);  // 48K has one more scanline
 
-    int new_sample_rate = (sample_rate * sample_rate_adjust[myConfig.gameSpeed]) / 100;
+    return (lines * samples_per_line * (BUS_CLOCK >> 9)) / (GAME_SPEED_PAL[myConfig.gameSpeed] * 2);
+}
 
-    return new_sample_rate;
+int get_sample_rate(void)
+{
+    return emu_sample_rate(isDSiMode() ? 4:2);
 }
 
 void newStreamSampleRate(void)
@@ -402,6 +655,11 @@ void newStreamSampleRate(void)
         myStream.timer          = MM_TIMER0;              // use hardware timer 0
         myStream.manual         = false;                  // use automatic filling
         mmStreamOpen(&myStream);
+
+#ifdef ZX_AY_ARM7
+        // The ARM7 plays the AY at the rate the emulation makes samples - 2 per scanline
+        if (ay7_ring) ay7_ring->rate = emu_sample_rate(AY7_SAMPLES_PER_LINE);
+#endif
     }
     //----------------------------------------------------------------
     //  when using 'automatic' filling, your callback will be triggered
@@ -443,8 +701,14 @@ void sound_chip_reset()
   ay38910Reset(&myAY);             // Reset the "AY" sound chip
   ay38910IndexW(0x07, &myAY);      // Register 7 is ENABLE
   ay38910DataW(0x3F, &myAY);       // All OFF (negative logic)
-  ay38910Mixer(8, mixbufAY, &myAY);// Do an initial mix conversion to clear the output
-  last_sample = mixbufAY[4];       // And set the last sample for muting
+  ay38910Mixer(8, ay_batch_buf, &myAY); // Do an initial mix conversion to clear the output
+  ay_last_sample = ay_batch_buf[4];
+  last_sample = ay_last_sample;    // And set the last sample for muting
+#ifdef ZX_AY_ARM7
+  ay7_sync();                      // And the ARM7 copy of the chip starts over too
+#else
+  ay_render_sync();                // And so does the one that makes the sound here
+#endif
 
   // Initialize the mixer buffers to the last sample
   for (int i=0; i < WAVE_DIRECT_BUF_SIZE+1; i++)
@@ -456,8 +720,7 @@ void sound_chip_reset()
       mixer_DSI[i] = last_sample;
   }
 
-  mixer_read=0;
-  mixer_write=0;
+  ay_batch_reset();
 }
 
 // -----------------------------------------------------------------------
@@ -465,6 +728,9 @@ void sound_chip_reset()
 // -----------------------------------------------------------------------
 void dsInstallSoundEmuFIFO(void)
 {
+#ifdef ZX_AY_ARM7
+  ay7_init();               // Hand the AY write ring over to the ARM7
+#endif
   SoundPause();             // Pause any sound output
   sound_chip_reset();       // Reset the SN, AY and SCC chips
   setupStream();            // Setup maxmod stream...
@@ -483,6 +749,7 @@ void ResetSpectrum(void)
 {
   JoyState = 0x00000000;                // Nothing pressed to start
 
+  recorder_stop();                      // A recording only ever covers one game session
   sound_chip_reset();                   // Reset the AY chip
   ResetZ80(&CPU);                       // Reset the Z80 CPU core
   speccy_reset();                       // Reset the ZX Spectrum memory - decompress .z80 and restore BIOS
@@ -572,6 +839,10 @@ void ShowDebugZ80(void)
         sprintf(tmp, "LOAD: %-9s", loader_type); DSPrint(0,idx++, 7, tmp);
         sprintf(tmp, "MEM Used %dK", getMemUsed()/1024); DSPrint(0,idx++,7, tmp);
         sprintf(tmp, "MEM Free %dK", getMemFree()/1024); DSPrint(0,idx++,7, tmp);
+        sprintf(tmp, "IDLE %-11lu", idle_loop_skips); DSPrint(0,idx++,7, tmp);
+        sprintf(tmp, "IDLE %-9luKT", idle_loop_cycles/1000); DSPrint(0,idx++,7, tmp);
+        sprintf(tmp, "SND %4ld %+6ld", mixer_fill_avg >> 4, (s32)mixer_step - 0x10000); DSPrint(0,idx++,7, tmp);
+        sprintf(tmp, "U%-6lu O%-7lu", audio_underruns, audio_overruns); DSPrint(0,idx++,7, tmp);
 
         // CPU Disassembly!
 
@@ -583,6 +854,7 @@ void ShowDebugZ80(void)
         }
         sprintf(tmp, "DX %-9lu", DX); DSPrint(17,idx++, 7, tmp);
         sprintf(tmp, "DY %-9lu", DY); DSPrint(17,idx++, 7, tmp);
+        sprintf(tmp, "ATTR OVF %-6lu", zx_attr_log_overflows); DSPrint(17,idx++, 7, tmp);
     }
     else
     {
@@ -1312,6 +1584,7 @@ void SpeccySE_main(void)
                     {
                         u8 *ptr = MemoryMap[16393>>14] +  (16393);
                         memcpy(ptr, ROM_Memory, last_file_size);
+                        zx_screen_dirty_all();
                     }
                     else // Otherwise, play the ZX Spectrum tape!
                     {
@@ -1368,12 +1641,26 @@ void SpeccySE_main(void)
         //
         // This is how we time frame-to frame to keep the game running at 50FPS
         // ----------------------------------------------------------------------
+
+        // ----------------------------------------------------------------------
+        // Adaptive frameskip: how much of this frame's time is left over tells
+        // us if we can afford to render the next one. Averaged over a few frames
+        // so one slow frame doesn't cause a skip. Skip once we're within 1/8 of
+        // a frame of falling behind - rendering a frame takes about that much.
+        // ----------------------------------------------------------------------
+        if (myConfig.frameSkip == 2)
+        {
+            s16 slack = (s16)(GAME_SPEED_PAL[myConfig.gameSpeed]*(timingFrames+1)) - (s16)TIMER2_DATA;
+            frameSlack = (frameSlack*3 + slack) / 4;
+            frameBehind = (frameSlack < (s16)(GAME_SPEED_PAL[myConfig.gameSpeed] / 8));
+        }
+
         while (TIMER2_DATA <= GAME_SPEED_PAL[myConfig.gameSpeed]*(timingFrames+1))
         {
             if (myGlobalConfig.showFPS == 2) break;   // If Full Speed, break out...
             if (tape_is_playing())
             {
-                mixer_read = mixer_write = 0;
+                ay_batch_reset();
                 bStartSoundEngine = 2;  // Unpause sound after 2 frames
                 SoundPause();           // But for now, keep muted while we load
                 currentBrightness = 0;  // Keep at full brightness while loading
@@ -1385,6 +1672,16 @@ void SpeccySE_main(void)
        // We've run one frame of timing... let the tape player know
        tape_frame();
 
+       // And if we're recording gameplay, capture this frame's screen and audio
+       if (recorder_active)
+       {
+           if (isDSiMode()) recorder_frame(mixer_DSI, WAVE_DIRECT_BUF_SIZE_DSI, mixer_write);
+           else recorder_frame(mixer, WAVE_DIRECT_BUF_SIZE, mixer_write);
+       }
+
+      // Keep the sound output in step with the emulation
+      audio_rate_control();
+
       // If the Z80 Debugger is enabled, call it
       if (myGlobalConfig.debugger >= 2)
       {
@@ -1488,6 +1785,21 @@ void SpeccySE_main(void)
             WAITVBL;WAITVBL;WAITVBL;WAITVBL;WAITVBL;WAITVBL;
             DSPrint(5,0,0,"        ");
       }
+      else if ((nds_key & KEY_L) && (nds_key & KEY_R) && (nds_key & KEY_A))
+      {
+            if (recorder_active)
+            {
+                recorder_stop();
+                DSPrint(5,0,0,"RECORD OFF");
+            }
+            else
+            {
+                recorder_start(myStream.sampling_rate);
+                DSPrint(5,0,0,(recorder_active ? "RECORD ON ":"REC FAILED"));
+            }
+            WAITVBL;WAITVBL;WAITVBL;WAITVBL;WAITVBL;WAITVBL;
+            DSPrint(5,0,0,"          ");
+      }
       else if  (nds_key & (KEY_UP | KEY_DOWN | KEY_LEFT | KEY_RIGHT | KEY_A | KEY_B | KEY_X | KEY_Y | KEY_START | KEY_SELECT | KEY_R | KEY_L ))
       {
           // START or SELECT will interrupt the tape playing...
@@ -1785,8 +2097,8 @@ __attribute__ ((noinline)) void HandleBrightness(void)
 
 // -------------------------------------------------------------
 // We double buffer the screen rendering to avoid the majority
-// of tearing issues - we render the screen to non-main VRAM
-// and then during the DS VBLANK, we copy it over for display.
+// of tearing issues - we render the screen to the VRAM page not
+// on display and then during the DS VBLANK, we flip over to it.
 // -------------------------------------------------------------
 #define VCOUNT *((u16*)(0x4000006))
 ITCM_CODE void irqVBlank(void)
@@ -1794,13 +2106,19 @@ ITCM_CODE void irqVBlank(void)
     // Manage time
     vusCptVBL++;
 
-    if (backgroundRenderScreen) // Render screen to DSi LCD
+#ifdef ZX_TILED_DISPLAY
+    zx_tiled_flush();           // Only the character cells which changed go over to VRAM
+    backgroundRenderScreen = 0;
+#else
+    if (backgroundRenderScreen) // Flip the DS LCD over to the page just drawn - 64K apart in VRAM bank A
     {
-        extern u8 screen_buffer_A[];
-        extern u8 screen_buffer_B[];
-        dmaCopyWordsAsynch(3, (u16*)(backgroundRenderScreen & 1 ? screen_buffer_A:screen_buffer_B), (u16*)0x06000000, 256*192);
+        zx_display_page = backgroundRenderScreen & 1;
+        REG_BG3CNT = BG_BMP8_256x256 | BG_BMP_BASE(zx_display_page ? 4:0);
         backgroundRenderScreen = 0;
     }
+#endif
+
+    speccy_border_vblank();     // Per-line border colors if the border changed mid-frame
 
     if (currentBrightness != brightness[myGlobalConfig.brightness])
     {
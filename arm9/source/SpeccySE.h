@@ -128,6 +128,7 @@ extern u8 kbd_keys_pressed;
 extern u8 kbd_keys[12];
 extern u16 emuActFrames;
 extern u16 timingFrames;
+extern u8  frameBehind;
 extern char initial_file[];
 extern char initial_path[];
 extern u16 nds_key;
@@ -156,11 +157,19 @@ extern u32 next_edge1;
 extern u32 next_edge2;
 extern u8 give_up_counter;
 extern u32 last_edge;
-extern u32 beeper_pulses_idx;
+#define AY_SAMPLES_PER_LINE 2   // The AY is always rendered at 2 samples per scanline (the DSi doubles them up)
+#define AY_BATCH_LINES      64  // Render the AY this many scanlines at a time
+// Speaker edges logged per run of scanlines (see speccy_run) - enough for an OUT (11 T-States) one
+// after the other for a whole run of the longest (128K) lines at 7MHz turbo, plus a line to spare
+#define BEEPER_EDGES_MAX    (((AY_BATCH_LINES+1) * 228 * 2) / 11)
+extern u32 beeper_edges[BEEPER_EDGES_MAX];
+extern u32 beeper_edge_count;
 extern u8 bottom_screen;
 extern char *loader_type;
 extern u8 bZX81EmuFound;
 extern u8 backgroundRenderScreen;
+extern u8 zx_back_page;
+extern u8 zx_display_page;
 extern int8 currentBrightness;
 extern uint16 dimDampen;
 extern u8 rom_special_bank;
@@ -172,6 +181,10 @@ extern u8 zx_ula_plus_enabled;
 extern u8 zx_ula_plus_group;
 extern u8 zx_ula_plus_palette_reg;
 extern u8 zx_ula_plus_palette[64];
+extern u8 zx_timex_mode;
+extern u8 zx_timex_latched;
+extern u8 zx_hires_attr[32];
+extern u32 zx_attr_log_overflows;
 extern void BottomScreenOptions(void);
 extern void BottomScreenCassette(void);
 extern void BottomScreenKeyboard(void);
@@ -182,11 +195,29 @@ extern void ReadFileCRCAndConfig(void);
 extern void DisplayStatusLine(bool bForce);
 extern void CassetteInsert(char *filename);
 extern void ResetSpectrum(void);
-extern void processDirectAudio(void);
-extern void processDirectAudioDSI(void);
+extern void processDirectAudio(u32 run_end, u32 lines);
+extern void processDirectAudioDSI(u32 run_end, u32 lines);
+extern u32  ay_scale;
+extern void ay_batch_flush(void);
+#ifdef ZX_AY_ARM7
+extern void ay7_write(u8 reg, u8 value);
+extern void ay7_frame_end(u32 samples);
+extern void ay7_sync(void);
+extern void ay7_mute(u8 mute);
+extern void ay7_latency(u32 samples);
+#else
+extern void ay_log_write(u8 reg, u8 value);
+extern void ay_render_sync(void);
+#endif
 extern u8   speccyTapePosition(void);
 extern void tape_frame(void);
 extern void apply_ula_plus_palette(void);
+extern void speccy_render_line_asm(u32 *vidBuf, u8 *attrPtr, u8 *pixelPtr, u32 flash);
+extern void speccy_render_line_ula_plus_asm(u32 *vidBuf, u8 *attrPtr, u8 *pixelPtr);
+extern void speccy_border_vblank(void);
+extern void zx_tiled_init(void);
+extern void zx_tiled_flush(void);
+extern void speccy_render_line_tiled(u8 line, u8 *attrPtr, u8 *pixelPtr);
 extern void debug_init();
 extern void debug_save();
 extern void debug_printf(const char * str, ...);
@@ -992,8 +992,8 @@ void SetDefaultGameConfig(void)
     myConfig.ULAcontend  = 1;                           // Normal contend memory access
     myConfig.ULAtiming   = 0;                           // Normal timing - no tweaks
     myConfig.turbo       = 0;                           // Normal Z80 clock (1=TURBO 7MHz)
-    myConfig.frameSkip   = (isDSiMode() ? 0:1);         // Frameskip for DS-Lite/Phat by default
-    myConfig.reserved7   = 0;
+    myConfig.frameSkip   = (isDSiMode() ? 0:2);         // Adaptive frameskip for DS-Lite/Phat by default
+    myConfig.multicolor  = 0;                           // Normal attribute handling (1=beam exact for multicolor engines)
     myConfig.reserved8   = 0;
     myConfig.reserved9   = 0xA5;    // So it's easy to spot on an "upgrade" and we can re-default it
 }
@@ -1194,7 +1194,7 @@ const struct options_t Option_Table[2][20] =
         {"ULA CONTEND",    {"UNCONTESTED", "NORMAL"},                                   &myConfig.ULAcontend,        2},
         {"ULA TIMING",     {"NORMAL", "TWEAK 1", "TWEAK 2", "TWEAK 3", "TWEAK 4", 
                             "TWEAK 5", "TWEAK 6", "TWEAK 7"},                           &myConfig.ULAtiming,         8},
-        {"FRAMESKIP",      {"OFF (SHOW ALL)", "ON (SHOW 3/4)"},                         &myConfig.frameSkip,         2},
+        {"FRAMESKIP",      {"OFF (SHOW ALL)", "ON (SHOW 3/4)", "AUTO (ADAPTIVE)"},      &myConfig.frameSkip,         3},
         {"AUTO PLAY",      {"NO", "YES", "YES - SEARCH"},                               &myConfig.autoPlay,          3},
         {"AUTO STOP",      {"NO", "YES", "AGGRESSIVE"},                                 &myConfig.autoStop,          3},
         {"AUTO FIRE",      {"OFF", "ON"},                                               &myConfig.autoFire,          2},
@@ -1202,6 +1202,7 @@ const struct options_t Option_Table[2][20] =
         {"GAME SPEED",     {"100%","102%","105%","110%","120%","98%","95%","90%","80%"},&myConfig.gameSpeed,         9},
         {"Z80 MODE",       {"3.5MHZ NORMAL", "7MHZ TURBO"},                             &myConfig.turbo,             2},
         {"NDS D-PAD",      {"NORMAL", "DIAGONALS", "SLIDE-N-GLIDE"},                    &myConfig.dpad,              3},
+        {"MULTICOLOR",     {"OFF", "ON (BEAM EXACT)"},                                  &myConfig.multicolor,        2},
         {NULL,             {"",      ""},                                               NULL,                        1},
     },
     // Global Options
@@ -1952,8 +1953,7 @@ void ProcessBufferedKeys(void)
  ********************************************************************************/
 u8 spectrumInit(char *szGame)
 {
-  u8 RetFct,uBcl;
-  u16 uVide;
+  u8 RetFct;
 
   // We've got some debug data we can use for development... reset these.
   memset(debug, 0x00, sizeof(debug));
@@ -1964,6 +1964,11 @@ u8 spectrumInit(char *szGame)
   // Here we can claim back 128K of VRAM which is otherwise unused
   // but we can use it for fast memory swaps and look-up-tables.
   // -----------------------------------------------------------------
+#ifdef ZX_TILED_DISPLAY
+  vramSetBankA(VRAM_A_MAIN_BG_0x06000000);      // This is our top emulation screen (where the game is played)
+  vramSetBankB(VRAM_B_LCD);
+  zx_tiled_init();                              // Two 4bpp tile layers rather than the 8bpp bitmap
+#else
   videoSetMode(MODE_5_2D | DISPLAY_BG3_ACTIVE);
   vramSetBankA(VRAM_A_MAIN_BG_0x06000000);      // This is our top emulation screen (where the game is played)
   vramSetBankB(VRAM_B_LCD);
@@ -1976,13 +1981,17 @@ u8 spectrumInit(char *szGame)
   REG_BG3X = 0;
   REG_BG3Y = 0;
 
-  // Init the page flipping buffer...
+  // Init both of the page flipping pages (64K apart) and show the first one...
   u16 *pVidBuffer = (u16*) (0x06000000);
-  for (uBcl=0;uBcl<192;uBcl++)
+  for (u8 uBcl=0;uBcl<192;uBcl++)
   {
-     uVide=(uBcl/12);
+     u16 uVide=(uBcl/12);
      dmaFillWords(uVide | (uVide<<16),pVidBuffer+uBcl*128,256);
+     dmaFillWords(uVide | (uVide<<16),pVidBuffer+0x8000+uBcl*128,256);
   }
+  zx_display_page = 0;
+  zx_back_page = 1;
+#endif
 
   RetFct = loadgame(szGame);      // Load up the Spectrum game/tap/tzx
 
@@ -2035,7 +2044,11 @@ void spectrumSetPalette(void)
     b = (u8) ((float) ZX_Spectrum_palette[uBcl*3+2]*0.121568f);
 
     SPRITE_PALETTE[uBcl] = RGB15(r,g,b);
+#ifdef ZX_TILED_DISPLAY
+    BG_PALETTE[(uBcl<<4) | 1] = RGB15(r,g,b); // Color 1 of each 16 color palette bank for the tiled display
+#else
     BG_PALETTE[uBcl] = RGB15(r,g,b);
+#endif
   }
 }
 
@@ -95,7 +95,7 @@ struct __attribute__((__packed__)) Config_t
     u8  ULAtiming;
     u8  turbo;
     u8  frameSkip;
-    u8  reserved7;
+    u8  multicolor;
     u8  reserved8;
     u8  reserved9;
     u8  reserved10;
@@ -123,11 +123,12 @@ extern u16 joystick_interrupt;
 extern u8 zx_force_128k_mode;
 extern u8 bFlash;
 extern u32 flash_timer;
+extern u8 *zx_screen_page;
+extern void zx_screen_dirty_all(void);
 
 extern u8 portFE, portFD;
 extern u8 zx_AY_enabled;
 extern u8 zx_128k_mode;
-extern u32 ay_sample_idx;
 extern u8 tape_play_skip_frame;
 
 extern u8 SpectrumBios[0x4000];
@@ -165,6 +166,7 @@ extern u32  ReadFileCarefully(char *filename, u8 *buf, u32 buf_size, u32 buf_off
 extern u8   loadgame(const char *path);
 extern u8   spectrumInit(char *szGame);
 extern void spectrumSetPalette(void);
+extern u8 ZX_Spectrum_palette[16*3];
 extern void spectrumRun(void);
 extern void tape_search_for_loader(void);
 extern void tape_detect_loading(void);
@@ -174,8 +176,28 @@ extern void speccy_decompress_snapshot(int romSize);
 extern void speccy_restore_z80(void);
 extern void speccy_restore_sna(void);
 extern void zx_bank(u8 new_bank);
+#ifdef Z80_THREADED_DISPATCH
+extern void rom_decode_remap(void);
+extern void rom_decode_flush(void);
+#else
+#define rom_decode_remap()
+#define rom_decode_flush()
+#endif
 extern void speccy_reset(void);
 extern u32  speccy_run(void);
+extern void speccy_schedule_event(u16 line, u16 repeat, u8 event);
+
+// Events due at an exact T-State (see speccy_cpu_event in spectrum.c)
+#define CPU_EVT_DANDANATOR  0   // The Dandanator command has settled
+#define CPU_EVT_TAPE        1   // The loader has just started the tape
+#define CPU_EVT_COUNT       2
+
+extern u32  cpu_event_next;
+extern u8   cpu_event_pending;
+extern u32  zx_run_limit;
+extern void speccy_cpu_event(u32 tstates, u8 event);
+extern void speccy_cpu_events(void);
+extern void dandanator_settle(void);
 extern u8   tape_pulse(void);
 extern void tape_reset(void);
 extern void tape_patch(void);
@@ -0,0 +1,45 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, it's source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave (SpeccySE)
+// and Marat Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty.
+// =====================================================================================
+
+// ------------------------------------------------------------------------------------------
+// Shared between the ARM9 and the ARM7 when the AY chip is synthesised on the ARM7 (built with
+// ZX_AUDIO=arm7). The ARM9 logs every AY register write into a ring in main RAM, stamped with
+// the AY sample of the frame it landed on, and closes off each emulated frame with a marker
+// holding the number of samples in that frame. The write index only moves at the end of a frame
+// so the ARM7 only ever sees whole frames. Its address goes over once on AY7_FIFO_CHANNEL.
+// ------------------------------------------------------------------------------------------
+#ifndef __AY7_IPC_H
+#define __AY7_IPC_H
+
+#define AY7_FIFO_CHANNEL        FIFO_USER_01
+#define AY7_RING_SIZE           1024                // Must be a power of 2
+
+#define AY7_SAMPLES_PER_LINE    2                   // Same rate the ARM9 always ran the AY at
+
+// Each ring entry is the sample within the frame (16 bits), the AY register and the value
+#define AY7_WRITE(pos, reg, value)  (((pos) << 16) | ((reg) << 8) | (value))
+#define AY7_FRAME(samples)          (0xFFFF0000 | (samples))
+#define AY7_IS_FRAME(word)          (((word) >> 16) == 0xFFFF)
+#define AY7_POS(word)               ((word) >> 16)
+#define AY7_REG(word)               (((word) >> 8) & 0x0F)
+#define AY7_VALUE(word)             ((word) & 0xFF)
+
+typedef struct
+{
+    vu32 write;                     // Only moved by the ARM9 - at the end of each frame
+    vu32 read;                      // Only moved by the ARM7
+    vu32 rate;                      // Samples per second the ARM7 should play at
+    vu32 mute;                      // Set by the ARM9 while the emulation sound is paused
+    vu32 latency;                   // Samples the ARM9 sound is behind the emulation - the ARM7 matches it
+    vu32 ring[AY7_RING_SIZE];
+} AY7Ring_t;
+
+#endif
@@ -0,0 +1,147 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#include <nds.h>
+
+#include <string.h>
+
+#include "SpeccySE.h"
+#include "beeper.h"
+#include "cpu/z80/Z80_interface.h"
+
+// --------------------------------------------------------------------------------------------
+// The band-limited beeper - see beeper.h. The steps are laid down and the samples taken by the
+// inline functions there, called from processDirectAudio() in SpeccySE.c for each scanline.
+// --------------------------------------------------------------------------------------------
+u32 beeper_edges[BEEPER_EDGES_MAX];                                  // CPU.TStates of each speaker edge on this run of lines
+u32 beeper_edge_count   __attribute__((section(".dtcm"))) = 0;
+u32 beeper_line_span    __attribute__((section(".dtcm"))) = CYCLES_PER_SCANLINE_48;   // T-States per scanline (with turbo)
+u32 beeper_sample_span  __attribute__((section(".dtcm"))) = 0;   // T-States per sample - and so how many rows beeper_step[] has
+u32 beeper_recip        __attribute__((section(".dtcm"))) = 0;   // 1/beeper_sample_span in 12.20 fixed point
+s32 beeper_target       __attribute__((section(".dtcm"))) = 0;   // 0 or BEEPER_LEVEL - where the last edge left the speaker
+s32 beeper_level        __attribute__((section(".dtcm"))) = 0;   // Output level (Q15) - the sum of beeper_blep[]
+u32 beeper_blep_idx     __attribute__((section(".dtcm"))) = 0;   // Where the next sample comes out of beeper_blep[]
+s32 beeper_blep[BEEPER_BLEP_SIZE] __attribute__((section(".dtcm"))) ALIGN(4);
+
+// The band-limited step impulse for an edge on each T-State of a sample (built from the master
+// table below by beeper_set_timing). An edge lands on the exact T-State it happened on - with
+// only 16 phases a sample the edges were rounded to 7 T-States on a 48K, and with a fast engine
+// that jitter was heard as noise all the way down the band.
+s16 beeper_step[BEEPER_SPAN_MAX][BEEPER_TAPS] ALIGN(16);
+
+// The impulse for an edge 0/64 to 64/64 of the way into a sample. Each row sums to exactly 32768
+// (Q15). Generated from a 0.7 x Nyquist sinc with a Blackman window over +/-4 samples.
+static const s16 beeper_master[65][BEEPER_TAPS] =
+{
+    {    71,  -1687,   6529,  22942,   6529,  -1687,     71,      0},
+    {    76,  -1661,   6213,  22935,   6849,  -1710,     66,      0},
+    {    79,  -1633,   5901,  22918,   7174,  -1732,     61,      0},
+    {    83,  -1604,   5595,  22888,   7502,  -1751,     55,      0},
+    {    85,  -1573,   5294,  22847,   7835,  -1768,     48,      0},
+    {    87,  -1540,   4998,  22794,   8170,  -1782,     40,      1},
+    {    89,  -1506,   4707,  22729,   8509,  -1793,     32,      1},
+    {    90,  -1471,   4422,  22654,   8852,  -1802,     22,      1},
+    {    91,  -1435,   4143,  22566,   9196,  -1807,     12,      2},
+    {    91,  -1398,   3869,  22468,   9543,  -1809,      2,      2},
+    {    91,  -1360,   3602,  22356,   9893,  -1807,    -10,      3},
+    {    91,  -1321,   3341,  22234,  10244,  -1802,    -23,      4},
+    {    90,  -1282,   3086,  22102,  10596,  -1793,    -36,      5},
+    {    90,  -1242,   2837,  21958,  10950,  -1781,    -50,      6},
+    {    88,  -1202,   2595,  21805,  11305,  -1764,    -66,      7},
+    {    87,  -1161,   2360,  21639,  11660,  -1743,    -82,      8},
+    {    85,  -1121,   2131,  21466,  12015,  -1718,    -99,      9},
+    {    83,  -1080,   1909,  21280,  12371,  -1688,   -117,     10},
+    {    81,  -1039,   1694,  21084,  12726,  -1654,   -136,     12},
+    {    79,   -998,   1485,  20879,  13080,  -1614,   -156,     13},
+    {    77,   -958,   1283,  20665,  13433,  -1570,   -177,     15},
+    {    74,   -918,   1089,  20442,  13784,  -1521,   -199,     17},
+    {    71,   -877,    901,  20208,  14134,  -1466,   -222,     19},
+    {    69,   -838,    719,  19969,  14481,  -1406,   -247,     21},
+    {    66,   -799,    545,  19720,  14826,  -1341,   -272,     23},
+    {    63,   -760,    378,  19461,  15168,  -1269,   -298,     25},
+    {    60,   -722,    217,  19195,  15507,  -1192,   -325,     28},
+    {    57,   -684,     64,  18922,  15842,  -1110,   -353,     30},
+    {    54,   -648,    -83,  18642,  16174,  -1021,   -382,     32},
+    {    52,   -611,   -223,  18352,  16501,   -926,   -412,     35},
+    {    49,   -576,   -357,  18059,  16823,   -825,   -443,     38},
+    {    46,   -542,   -483,  17759,  17141,   -718,   -475,     40},
+    {    43,   -508,   -604,  17453,  17453,   -604,   -508,     43},
+    {    40,   -475,   -718,  17141,  17759,   -483,   -542,     46},
+    {    38,   -443,   -825,  16823,  18059,   -357,   -576,     49},
+    {    35,   -412,   -926,  16501,  18352,   -223,   -611,     52},
+    {    32,   -382,  -1021,  16174,  18642,    -83,   -648,     54},
+    {    30,   -353,  -1110,  15842,  18922,     64,   -684,     57},
+    {    28,   -325,  -1192,  15507,  19195,    217,   -722,     60},
+    {    25,   -298,  -1269,  15168,  19461,    378,   -760,     63},
+    {    23,   -272,  -1341,  14826,  19720,    545,   -799,     66},
+    {    21,   -247,  -1406,  14481,  19969,    719,   -838,     69},
+    {    19,   -222,  -1466,  14134,  20208,    901,   -877,     71},
+    {    17,   -199,  -1521,  13784,  20442,   1089,   -918,     74},
+    {    15,   -177,  -1570,  13433,  20665,   1283,   -958,     77},
+    {    13,   -156,  -1614,  13080,  20879,   1485,   -998,     79},
+    {    12,   -136,  -1654,  12726,  21084,   1694,  -1039,     81},
+    {    10,   -117,  -1688,  12371,  21280,   1909,  -1080,     83},
+    {     9,    -99,  -1718,  12015,  21466,   2131,  -1121,     85},
+    {     8,    -82,  -1743,  11660,  21639,   2360,  -1161,     87},
+    {     7,    -66,  -1764,  11305,  21805,   2595,  -1202,     88},
+    {     6,    -50,  -1781,  10950,  21958,   2837,  -1242,     90},
+    {     5,    -36,  -1793,  10596,  22102,   3086,  -1282,     90},
+    {     4,    -23,  -1802,  10244,  22234,   3341,  -1321,     91},
+    {     3,    -10,  -1807,   9893,  22356,   3602,  -1360,     91},
+    {     2,      2,  -1809,   9543,  22468,   3869,  -1398,     91},
+    {     2,     12,  -1807,   9196,  22566,   4143,  -1435,     91},
+    {     1,     22,  -1802,   8852,  22654,   4422,  -1471,     90},
+    {     1,     32,  -1793,   8509,  22729,   4707,  -1506,     89},
+    {     1,     40,  -1782,   8170,  22794,   4998,  -1540,     87},
+    {     0,     48,  -1768,   7835,  22847,   5294,  -1573,     85},
+    {     0,     55,  -1751,   7502,  22888,   5595,  -1604,     83},
+    {     0,     61,  -1732,   7174,  22918,   5901,  -1633,     79},
+    {     0,     66,  -1710,   6849,  22935,   6213,  -1661,     76},
+    {     0,     71,  -1687,   6529,  22942,   6529,  -1687,     71},
+};
+
+// Called once per frame from speccy_run() - 'samples' is how many we produce for each scanline.
+// The steps are only rebuilt when the T-States per sample change (machine, turbo or DSi mode).
+void beeper_set_timing(u32 line_span, u32 samples)
+{
+    u32 span = line_span / samples;
+
+    beeper_line_span = line_span;
+    if (span == beeper_sample_span) return;
+
+    beeper_sample_span = span;
+    beeper_recip = ((1 << 20) / span) + 1;
+
+    for (u32 phase=0; phase<span; phase++)
+    {
+        // The middle of this T-State in 1/64ths of a sample (and 1/256ths of that) - each row
+        // is linearly interpolated from the master and then trimmed so it still sums to 32768
+        u32 pos = ((2 * phase + 1) << 13) / span;
+        const s16 *a = beeper_master[pos >> 8];
+        const s16 *b = beeper_master[(pos >> 8) + 1];
+        s32 w = pos & 0xFF, sum = 0;
+
+        for (u32 tap=0; tap<BEEPER_TAPS; tap++)
+        {
+            beeper_step[phase][tap] = (a[tap] * (256 - w) + b[tap] * w + 128) >> 8;
+            sum += beeper_step[phase][tap];
+        }
+        beeper_step[phase][(pos < 0x2000) ? 3:4] += 32768 - sum;
+    }
+}
+
+// Tape loading - drop the edges and leave the speaker where port FE says it is
+void beeper_drop(void)
+{
+    beeper_target = BEEPER_PORT_LEVEL();
+    beeper_edge_count = 0;
+    beeper_level = beeper_target << 15;
+    memset(beeper_blep, 0x00, sizeof(beeper_blep));
+}
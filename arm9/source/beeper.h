@@ -0,0 +1,99 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+
+#ifndef __BEEPER_H
+#define __BEEPER_H
+
+#include <nds.h>
+#include "SpeccySE.h"
+
+// --------------------------------------------------------------------------------------------
+// The beeper is sampled after each run of scanlines (processDirectAudio in SpeccySE.c). Every
+// speaker edge the CPU made on the run was logged with its T-State (see cpu_writeport_speccy)
+// and each one is laid down as a band-limited step: a short windowed-sinc impulse (8 taps, one
+// phase for every T-State of a sample) is added into beeper_blep[] and the output is the running
+// sum of that. So the edges land between the samples exactly where they really happened, without
+// the harsh aliasing of a plain square wave, and the work is per edge rather than per sample. The
+// step is delayed 3 samples so the impulse never reaches back into samples already sent out.
+// --------------------------------------------------------------------------------------------
+#define BEEPER_BLEP_SIZE    32      // Ring of pending impulse sums - must be a power of 2
+#define BEEPER_LEVEL        0x4000  // Speaker on is this much louder than speaker off
+#define BEEPER_TAPS         8       // Samples each step is spread over
+#define BEEPER_SPAN_MAX     228     // T-States per sample at most - 2 samples a 128K line at 7MHz turbo
+
+extern u8  portFE;
+
+extern u32 beeper_line_span;
+extern u32 beeper_sample_span;
+extern u32 beeper_recip;
+extern s32 beeper_target;
+extern s32 beeper_level;
+extern u32 beeper_blep_idx;
+extern s32 beeper_blep[BEEPER_BLEP_SIZE];
+extern s16 beeper_step[BEEPER_SPAN_MAX][BEEPER_TAPS];
+
+extern void beeper_set_timing(u32 line_span, u32 samples);
+extern void beeper_drop(void);
+
+// Where port FE says the speaker is - beeper_target follows bit 4 edge by edge
+#define BEEPER_PORT_LEVEL() ((portFE & 0x10) ? BEEPER_LEVEL : 0)
+
+// One edge, offset T-States into the scanline whose samples come out next
+static inline void beeper_edge_step(u32 offset)
+{
+    u32 sample = (offset * beeper_recip) >> 20;
+    u32 phase = offset - (sample * beeper_sample_span);     // The T-State within that sample
+    s32 delta = (beeper_target ? -BEEPER_LEVEL : BEEPER_LEVEL);
+    beeper_target ^= BEEPER_LEVEL;
+
+    const s16 *step = beeper_step[phase];
+    u32 idx = beeper_blep_idx + sample;
+    for (u32 tap=0; tap<BEEPER_TAPS; tap++)
+    {
+        beeper_blep[(idx + tap) & (BEEPER_BLEP_SIZE-1)] += delta * step[tap];
+    }
+}
+
+// Lay down the band-limited steps for the speaker edges (from edge on) of the scanline ending at
+// line_end. Edges past the end belong to the next line of the run - unless this is the last one.
+// After the last one the speaker has to be where port FE left it: if the run had more edges than
+// beeper_edges[] holds (or a state was loaded) the difference goes in as one more step.
+static inline u32 beeper_steps(u32 line_end, u32 edge, u8 last)
+{
+    u32 line_start = line_end - beeper_line_span;
+
+    for (; edge<beeper_edge_count; edge++)
+    {
+        s32 offset = (s32)(beeper_edges[edge] - line_start);
+        if (offset >= (s32)beeper_line_span)                                    // The next line has it
+        {
+            if (!last) break;
+            offset = beeper_line_span-1;                                        // Or the instruction ran past this one
+        }
+        else if (offset < 0) offset = 0;                                        // Just over the end of the last run
+
+        beeper_edge_step((u32)offset);
+    }
+
+    if (last && (beeper_target != BEEPER_PORT_LEVEL())) beeper_edge_step(beeper_line_span-1);
+    return edge;
+}
+
+// The next beeper sample out of the ring
+static inline s32 beeper_sample(void)
+{
+    beeper_level += beeper_blep[beeper_blep_idx];
+    beeper_blep[beeper_blep_idx] = 0;
+    beeper_blep_idx = (beeper_blep_idx + 1) & (BEEPER_BLEP_SIZE-1);
+    return beeper_level >> 15;
+}
+
+#endif
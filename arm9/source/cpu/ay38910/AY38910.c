@@ -0,0 +1,326 @@
+//
+//  AY38910.c
+//  Portable C version of the AY-3-8910 / YM2149 sound chip emulator.
+//
+//  Translated to C from AY38910.s on 2026-10-16.
+//  AY38910.s was created by Fredrik Ahlström on 2006-03-07.
+//  Copyright © 2006-2026 Fredrik Ahlström. All rights reserved.
+//
+//  This is a straight translation of Fredrik's AY38910.s so the chip can be
+//  built and measured on other machines, it's only used when not building
+//  for arm32. The copyright above covers it as a derived work of the asm.
+//  Every step of the mixer is done the same way as the asm (same counters,
+//  same carries, same bit positions in ayChState/ayChDisable/ayEnvType/
+//  ayEnvAddr) so the output is sample for sample the same.
+//
+#ifndef __arm__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int16_t s16;
+typedef int32_t s32;
+
+#include "AY38910.h"
+
+#define NSEED	0x10000			// Noise Seed
+#define WFEED	0x12000			// White Noise Feedback, according to MAME.
+#define WFEED3	0x14000			// White Noise Feedback for AY-3-8930, according to MAME.
+
+#ifdef AY_UPSHIFT
+	#define USHIFT AY_UPSHIFT
+#else
+	#define USHIFT 0
+#endif
+#ifndef AYFILTER
+	#define AYFILTER 1
+#endif
+
+#define AYNOISEADD 0x08000000
+#define AYTONEADD  0x00100000
+#define AYENVADD   0x00010000
+
+// each step * 0.70710678 (-3dB?)
+static const u32 attenuation[32] = {
+	0x0000, 0x00AB, 0x00F1, 0x0155, 0x01E3, 0x02AB, 0x03C5, 0x0555,
+	0x078B, 0x0AAB, 0x0F16, 0x1555, 0x1E2B, 0x2AAB, 0x3C57, 0x5555,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+};
+
+static const u8 regMask[16] = {
+	0xFF,0x0F,0xFF,0x0F,0xFF,0x0F,0x1F,0xFF, 0x1F,0x1F,0x1F,0xFF,0xFF,0x0F,0xFF,0xFF
+};
+
+static void dummyOutFunc(u8 value) {
+}
+
+// These never get called, ay38910DataR reads ayPortAIn/ayPortBIn when they are set.
+static u8 portAInDummy(u8 value, int inout) {
+	return 0xFF;
+}
+
+static u8 portBInDummy(u8 value, int inout) {
+	return 0xFF;
+}
+
+// Add with the carry out, like "adds".
+static inline int addCarry(u32 *reg, u32 add) {
+	u32 old = *reg;
+	*reg = old + add;
+	return *reg < old;
+}
+
+//---------------------------------------------------------------------------
+// Works out the mixed volume for each of the 8 combinations of channels
+// being high, and marks which channels use the envelope (bits 7-9 of the
+// channel state, the low 2 bits of ayChDisable are bits 8 & 9).
+//---------------------------------------------------------------------------
+static u32 calculateVolumes(AY38910 *chip, u32 state, const u32 *envVol) {
+	u32 vol[3];
+	int ch, i;
+
+	state &= ~0x0380;			// Bits used to show which channels use the envelope.
+	for (ch = 0; ch < 3; ch++) {
+		u32 att = chip->ayRegs[0x8 + ch] & 0x1F;
+		vol[ch] = envVol[att];	// Envelope mode (bit 4) reads 0 from the table.
+		if (att & 0x10) {
+			state |= 0x0080 << ch;
+		}
+	}
+	for (i = 7; i > 0; i--) {
+		u32 sum = (i & 1) ? vol[0] : 0;
+		if (i & 4) sum += vol[2];
+		if (i & 2) sum += vol[1];
+		chip->ayCalculatedVolumes[i] = (s16)sum;
+	}
+	chip->ayAttChg = 0;
+	return state;
+}
+
+//---------------------------------------------------------------------------
+void ay38910Mixer(int count, s16 *dest, AY38910 *chip) {
+	u32 ch0 = chip->ch0Freq | ((u32)chip->ch0Addr << 16);
+	u32 ch1 = chip->ch1Freq | ((u32)chip->ch1Addr << 16);
+	u32 ch2 = chip->ch2Freq | ((u32)chip->ch2Addr << 16);
+	u32 ch3 = chip->ch3Freq | ((u32)chip->ch3Addr << 16);
+	u32 rng = chip->ayRng;
+	u32 envFreq = chip->ayEnvFreq;
+	u32 state = chip->ayChState | ((u32)chip->ayChDisable << 8)
+			| ((u32)chip->ayEnvType << 16) | ((u32)chip->ayEnvAddr << 24);
+	u32 mix = chip->ayOldSample;
+	const u32 *envVol = (const u32 *)chip->ayEnvVolumePtr;
+	u32 len = (u32)count;
+	u32 out, envIdx, oldLen;
+	int i;
+
+	if (chip->ayAttChg) {
+		state = calculateVolumes(chip, state, envVol);
+	}
+
+	do {
+		mix -= mix >> AYFILTER;
+		for (i = 0; i < (1 << USHIFT); i++) {
+			if (addCarry(&ch0, AYTONEADD)) {
+				ch0 -= ch0 << 20;
+				state ^= 0x00000001;	// Channel A
+			}
+			if (addCarry(&ch1, AYTONEADD)) {
+				ch1 -= ch1 << 20;
+				state ^= 0x00000002;	// Channel B
+			}
+			if (addCarry(&ch2, AYTONEADD)) {
+				ch2 -= ch2 << 20;
+				state ^= 0x00000004;	// Channel C
+			}
+
+			if (addCarry(&ch3, AYNOISEADD)) {
+				ch3 -= ch3 << 27;
+				state |= 0x00000038;	// Clear noise channel.
+				if (rng & 1) {
+					rng = (rng >> 1) ^ WFEED;
+					state ^= 0x00000038;	// Noise channel.
+				}
+				else {
+					rng >>= 1;
+				}
+			}
+
+			if (addCarry(&envFreq, AYENVADD)) {
+				envFreq -= envFreq << 16;
+				state += 0x08000000;
+			}
+			if ((state & (state << 15)) & 0x80000000) {	// Envelope Hold
+				state &= ~0x78000000;
+			}
+			out = state | (state >> 10);	// Channels disable.
+			out &= out >> 3;				// Noise disable.
+			out <<= 29;
+			mix += (u16)chip->ayCalculatedVolumes[out >> 29];
+
+			envIdx = state & 0x78000000;
+			// Envelope Alternate (allready flipped from Hold) and Attack
+			if (!(((state & (state << 14)) ^ (state << 13)) & 0x80000000)) {
+				envIdx ^= 0x78000000;
+			}
+
+			out &= state << 22;				// Check if any channels use envelope
+			if (out) {
+				u32 vol = envVol[envIdx >> 27];
+				if (out & 0x80000000) mix += vol;
+				if (out & 0x40000000) mix += vol;
+				if (out & 0x20000000) mix += vol;
+			}
+		}
+		oldLen = len--;
+		if ((s32)len >= 0) {
+			*dest++ = (s16)(u16)((mix >> (AYFILTER + USHIFT)) ^ 0x8000);
+		}
+	} while (oldLen > 1);
+
+	chip->ch0Freq = (u16)ch0; chip->ch0Addr = (u16)(ch0 >> 16);
+	chip->ch1Freq = (u16)ch1; chip->ch1Addr = (u16)(ch1 >> 16);
+	chip->ch2Freq = (u16)ch2; chip->ch2Addr = (u16)(ch2 >> 16);
+	chip->ch3Freq = (u16)ch3; chip->ch3Addr = (u16)(ch3 >> 16);
+	chip->ayRng = rng;
+	chip->ayEnvFreq = envFreq;
+	chip->ayChState = (u8)state;
+	chip->ayChDisable = (u8)(state >> 8);
+	chip->ayEnvType = (u8)(state >> 16);
+	chip->ayEnvAddr = (u8)(state >> 24);
+	chip->ayOldSample = mix;
+}
+
+//---------------------------------------------------------------------------
+static void updateAllRegisters(AY38910 *chip) {
+	int i;
+	for (i = 0; i < 0x10; i++) {
+		ay38910IndexW(i, chip);
+		ay38910DataW(chip->ayRegs[i], chip);
+	}
+}
+
+//---------------------------------------------------------------------------
+void ay38910Reset(AY38910 *chip) {
+	memset(chip, 0, offsetof(AY38910, ayPortAInFptr));	// Clear AY38910 state
+
+	updateAllRegisters(chip);
+
+	chip->ayEnvVolumePtr = (u16 *)attenuation;
+	chip->ayPortAOutFptr = dummyOutFunc;
+	chip->ayPortBOutFptr = dummyOutFunc;
+	chip->ayPortAInFptr = portAInDummy;
+	chip->ayPortBInFptr = portBInDummy;
+
+	chip->ayPortAIn = 0xFF;
+	chip->ayPortBIn = 0xFF;
+	chip->ayRng = NSEED;
+}
+
+//---------------------------------------------------------------------------
+int ay38910SaveState(void *dest, const AY38910 *chip) {
+	memcpy(dest, chip->ayRegs, 0x10);
+	return 0x10;
+}
+
+//---------------------------------------------------------------------------
+int ay38910LoadState(AY38910 *chip, const void *source) {
+	memcpy(chip->ayRegs, source, 0x10);
+	updateAllRegisters(chip);
+	return 0x10;
+}
+
+//---------------------------------------------------------------------------
+int ay38910GetStateSize(void) {
+	return 0x10;
+}
+
+//---------------------------------------------------------------------------
+void ay38910IndexW(u8 index, AY38910 *chip) {
+	if (!(index & 0xF0)) {
+		chip->ayRegIndex = index;
+	}
+}
+
+//---------------------------------------------------------------------------
+void ay38910DataW(u8 value, AY38910 *chip) {
+	int reg = chip->ayRegIndex;
+	u32 freq;
+
+	value &= regMask[reg];
+	chip->ayRegs[reg] = value;
+	switch (reg) {
+		case 0x0:				// Frequency fine
+		case 0x1:				// Frequency coarse
+		case 0x2:
+		case 0x3:
+		case 0x4:
+		case 0x5:
+			reg &= ~1;
+			freq = chip->ayRegs[reg] | (chip->ayRegs[reg + 1] << 8);
+			if (freq == 0) freq = 1;
+			if (reg == 0) chip->ch0Freq = freq;
+			else if (reg == 2) chip->ch1Freq = freq;
+			else chip->ch2Freq = freq;
+			break;
+		case 0x6:				// Frequency coarse noise
+			chip->ch3Freq = (value ? value : 1);
+			break;
+		case 0x7:				// Channel disable
+			chip->ayChDisable = (chip->ayChDisable & 3) | (value << 2);	// Save top envelope enable bits.
+			break;
+		case 0x8:				// Attenuation
+		case 0x9:
+		case 0xA:
+			chip->ayAttChg = reg;
+			break;
+		case 0xB:				// Envelope frequency
+		case 0xC:
+			freq = chip->ayRegs[0xB] | (chip->ayRegs[0xC] << 8);
+			chip->ayEnvFreq = (chip->ayEnvFreq & 0xFFFF0000) | (freq ? freq : 1);
+			break;
+		case 0xD:				// Envelope type
+			if (value < 4) value = 9;
+			if (value < 8) value = 0xF;
+			if (value & 1) value ^= 2;	// ALT ^= Hold
+			chip->ayEnvType = value;
+			chip->ayEnvAddr = 0;		// Also clear Envelope addr
+			break;
+		case 0xE:
+			chip->ayPortAOut = value;
+			if (chip->ayRegs[7] & 0x40) chip->ayPortAOutFptr(value);
+			break;
+		case 0xF:
+			chip->ayPortBOut = value;
+			if (chip->ayRegs[7] & 0x80) chip->ayPortBOutFptr(value);
+			break;
+	}
+}
+
+//---------------------------------------------------------------------------
+// For a port set to input the asm leaves the chip pointer in r0 as the value
+// passed to the read function, so that's what we hand over too (as a u8 the
+// read function only sees the low byte, same as it does from the asm).
+//---------------------------------------------------------------------------
+u8 ay38910DataR(AY38910 *chip) {
+	int reg = chip->ayRegIndex;
+	int inout;
+
+	if (reg == 0xE) {
+		inout = chip->ayRegs[7] & 0x40;
+		if (chip->ayPortAInFptr == portAInDummy) return chip->ayPortAIn;
+		return chip->ayPortAInFptr(inout ? chip->ayPortAOut : (u8)(uintptr_t)chip, inout);
+	}
+	if (reg == 0xF) {
+		inout = chip->ayRegs[7] & 0x80;
+		if (chip->ayPortBInFptr == portBInDummy) return chip->ayPortBIn;
+		return chip->ayPortBInFptr(inout ? chip->ayPortBOut : (u8)(uintptr_t)chip, inout);
+	}
+	return chip->ayRegs[reg];
+}
+
+#endif // #ifndef __arm__
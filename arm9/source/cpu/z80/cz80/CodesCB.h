@@ -21,201 +21,201 @@
 /**     changes to this file.                               **/
 /*************************************************************/
 
-case RLC_B: M_RLC(CPU.BC.B.h);break;  case RLC_C: M_RLC(CPU.BC.B.l);break;  //8:44
-case RLC_D: M_RLC(CPU.DE.B.h);break;  case RLC_E: M_RLC(CPU.DE.B.l);break;
-case RLC_H: M_RLC(CPU.HL.B.h);break;  case RLC_L: M_RLC(CPU.HL.B.l);break;
-case RLC_A: M_RLC(CPU.AF.B.h);break;
-
-case RRC_B: M_RRC(CPU.BC.B.h);break;  case RRC_C: M_RRC(CPU.BC.B.l);break;  //8:44
-case RRC_D: M_RRC(CPU.DE.B.h);break;  case RRC_E: M_RRC(CPU.DE.B.l);break;
-case RRC_H: M_RRC(CPU.HL.B.h);break;  case RRC_L: M_RRC(CPU.HL.B.l);break;
-case RRC_A: M_RRC(CPU.AF.B.h);break;
-
-case RL_B: M_RL(CPU.BC.B.h);break;  case RL_C: M_RL(CPU.BC.B.l);break;      //8:44
-case RL_D: M_RL(CPU.DE.B.h);break;  case RL_E: M_RL(CPU.DE.B.l);break;
-case RL_H: M_RL(CPU.HL.B.h);break;  case RL_L: M_RL(CPU.HL.B.l);break;
-case RL_A: M_RL(CPU.AF.B.h);break;
-
-case RR_B: M_RR(CPU.BC.B.h);break;  case RR_C: M_RR(CPU.BC.B.l);break;      //8:44
-case RR_D: M_RR(CPU.DE.B.h);break;  case RR_E: M_RR(CPU.DE.B.l);break;
-case RR_H: M_RR(CPU.HL.B.h);break;  case RR_L: M_RR(CPU.HL.B.l);break;
-case RR_A: M_RR(CPU.AF.B.h);break;
-
-case SLA_B: M_SLA(CPU.BC.B.h);break;  case SLA_C: M_SLA(CPU.BC.B.l);break;  //8:44
-case SLA_D: M_SLA(CPU.DE.B.h);break;  case SLA_E: M_SLA(CPU.DE.B.l);break;
-case SLA_H: M_SLA(CPU.HL.B.h);break;  case SLA_L: M_SLA(CPU.HL.B.l);break;
-case SLA_A: M_SLA(CPU.AF.B.h);break;
-
-case SRA_B: M_SRA(CPU.BC.B.h);break;  case SRA_C: M_SRA(CPU.BC.B.l);break;  //8:44
-case SRA_D: M_SRA(CPU.DE.B.h);break;  case SRA_E: M_SRA(CPU.DE.B.l);break;
-case SRA_H: M_SRA(CPU.HL.B.h);break;  case SRA_L: M_SRA(CPU.HL.B.l);break;
-case SRA_A: M_SRA(CPU.AF.B.h);break;
-
-case SLL_B: M_SLL(CPU.BC.B.h);break;  case SLL_C: M_SLL(CPU.BC.B.l);break;  //8:44
-case SLL_D: M_SLL(CPU.DE.B.h);break;  case SLL_E: M_SLL(CPU.DE.B.l);break;
-case SLL_H: M_SLL(CPU.HL.B.h);break;  case SLL_L: M_SLL(CPU.HL.B.l);break;
-case SLL_A: M_SLL(CPU.AF.B.h);break;
-
-case SRL_B: M_SRL(CPU.BC.B.h);break;  case SRL_C: M_SRL(CPU.BC.B.l);break;  //8:44
-case SRL_D: M_SRL(CPU.DE.B.h);break;  case SRL_E: M_SRL(CPU.DE.B.l);break;
-case SRL_H: M_SRL(CPU.HL.B.h);break;  case SRL_L: M_SRL(CPU.HL.B.l);break;
-case SRL_A: M_SRL(CPU.AF.B.h);break;
-
-case RLC_xHL: I=RdZ80(CPU.HL.W);   M_RLC(I);  T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
-case RRC_xHL: I=RdZ80(CPU.HL.W);   M_RRC(I);  T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
-case RL_xHL:  I=RdZ80(CPU.HL.W);   M_RL(I);   T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
-case RR_xHL:  I=RdZ80(CPU.HL.W);   M_RR(I);   T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
-case SLA_xHL: I=RdZ80(CPU.HL.W);   M_SLA(I);  T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
-case SRA_xHL: I=RdZ80(CPU.HL.W);   M_SRA(I);  T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
-case SLL_xHL: I=RdZ80(CPU.HL.W);   M_SLL(I);  T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
-case SRL_xHL: I=RdZ80(CPU.HL.W);   M_SRL(I);  T_INC(1);  WrZ80(CPU.HL.W,I);break;  //15:4443
+OPCODE(RLC_B): M_RLC(CPU.BC.B.h);NEXT_OP;  OPCODE(RLC_C): M_RLC(CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RLC_D): M_RLC(CPU.DE.B.h);NEXT_OP;  OPCODE(RLC_E): M_RLC(CPU.DE.B.l);NEXT_OP;
+OPCODE(RLC_H): M_RLC(CPU_HL.B.h);NEXT_OP;  OPCODE(RLC_L): M_RLC(CPU_HL.B.l);NEXT_OP;
+OPCODE(RLC_A): M_RLC(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RRC_B): M_RRC(CPU.BC.B.h);NEXT_OP;  OPCODE(RRC_C): M_RRC(CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RRC_D): M_RRC(CPU.DE.B.h);NEXT_OP;  OPCODE(RRC_E): M_RRC(CPU.DE.B.l);NEXT_OP;
+OPCODE(RRC_H): M_RRC(CPU_HL.B.h);NEXT_OP;  OPCODE(RRC_L): M_RRC(CPU_HL.B.l);NEXT_OP;
+OPCODE(RRC_A): M_RRC(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RL_B): M_RL(CPU.BC.B.h);NEXT_OP;  OPCODE(RL_C): M_RL(CPU.BC.B.l);NEXT_OP;    //8:44
+OPCODE(RL_D): M_RL(CPU.DE.B.h);NEXT_OP;  OPCODE(RL_E): M_RL(CPU.DE.B.l);NEXT_OP;
+OPCODE(RL_H): M_RL(CPU_HL.B.h);NEXT_OP;  OPCODE(RL_L): M_RL(CPU_HL.B.l);NEXT_OP;
+OPCODE(RL_A): M_RL(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RR_B): M_RR(CPU.BC.B.h);NEXT_OP;  OPCODE(RR_C): M_RR(CPU.BC.B.l);NEXT_OP;    //8:44
+OPCODE(RR_D): M_RR(CPU.DE.B.h);NEXT_OP;  OPCODE(RR_E): M_RR(CPU.DE.B.l);NEXT_OP;
+OPCODE(RR_H): M_RR(CPU_HL.B.h);NEXT_OP;  OPCODE(RR_L): M_RR(CPU_HL.B.l);NEXT_OP;
+OPCODE(RR_A): M_RR(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SLA_B): M_SLA(CPU.BC.B.h);NEXT_OP;  OPCODE(SLA_C): M_SLA(CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SLA_D): M_SLA(CPU.DE.B.h);NEXT_OP;  OPCODE(SLA_E): M_SLA(CPU.DE.B.l);NEXT_OP;
+OPCODE(SLA_H): M_SLA(CPU_HL.B.h);NEXT_OP;  OPCODE(SLA_L): M_SLA(CPU_HL.B.l);NEXT_OP;
+OPCODE(SLA_A): M_SLA(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SRA_B): M_SRA(CPU.BC.B.h);NEXT_OP;  OPCODE(SRA_C): M_SRA(CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SRA_D): M_SRA(CPU.DE.B.h);NEXT_OP;  OPCODE(SRA_E): M_SRA(CPU.DE.B.l);NEXT_OP;
+OPCODE(SRA_H): M_SRA(CPU_HL.B.h);NEXT_OP;  OPCODE(SRA_L): M_SRA(CPU_HL.B.l);NEXT_OP;
+OPCODE(SRA_A): M_SRA(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SLL_B): M_SLL(CPU.BC.B.h);NEXT_OP;  OPCODE(SLL_C): M_SLL(CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SLL_D): M_SLL(CPU.DE.B.h);NEXT_OP;  OPCODE(SLL_E): M_SLL(CPU.DE.B.l);NEXT_OP;
+OPCODE(SLL_H): M_SLL(CPU_HL.B.h);NEXT_OP;  OPCODE(SLL_L): M_SLL(CPU_HL.B.l);NEXT_OP;
+OPCODE(SLL_A): M_SLL(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SRL_B): M_SRL(CPU.BC.B.h);NEXT_OP;  OPCODE(SRL_C): M_SRL(CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SRL_D): M_SRL(CPU.DE.B.h);NEXT_OP;  OPCODE(SRL_E): M_SRL(CPU.DE.B.l);NEXT_OP;
+OPCODE(SRL_H): M_SRL(CPU_HL.B.h);NEXT_OP;  OPCODE(SRL_L): M_SRL(CPU_HL.B.l);NEXT_OP;
+OPCODE(SRL_A): M_SRL(CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RLC_xHL): I=RdZ80(CPU_HL.W);   M_RLC(I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
+OPCODE(RRC_xHL): I=RdZ80(CPU_HL.W);   M_RRC(I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
+OPCODE(RL_xHL):  I=RdZ80(CPU_HL.W);   M_RL(I);   T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
+OPCODE(RR_xHL):  I=RdZ80(CPU_HL.W);   M_RR(I);   T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
+OPCODE(SLA_xHL): I=RdZ80(CPU_HL.W);   M_SLA(I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
+OPCODE(SRA_xHL): I=RdZ80(CPU_HL.W);   M_SRA(I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
+OPCODE(SLL_xHL): I=RdZ80(CPU_HL.W);   M_SLL(I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
+OPCODE(SRL_xHL): I=RdZ80(CPU_HL.W);   M_SRL(I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP;  //15:4443
 
     
-case BIT0_B: M_BIT(0,CPU.BC.B.h);break;  case BIT0_C: M_BIT(0,CPU.BC.B.l);break;    //8:44
-case BIT0_D: M_BIT(0,CPU.DE.B.h);break;  case BIT0_E: M_BIT(0,CPU.DE.B.l);break;
-case BIT0_H: M_BIT(0,CPU.HL.B.h);break;  case BIT0_L: M_BIT(0,CPU.HL.B.l);break;
-case BIT0_A: M_BIT(0,CPU.AF.B.h);break;
-
-case BIT1_B: M_BIT(1,CPU.BC.B.h);break;  case BIT1_C: M_BIT(1,CPU.BC.B.l);break;    //8:44
-case BIT1_D: M_BIT(1,CPU.DE.B.h);break;  case BIT1_E: M_BIT(1,CPU.DE.B.l);break;
-case BIT1_H: M_BIT(1,CPU.HL.B.h);break;  case BIT1_L: M_BIT(1,CPU.HL.B.l);break;
-case BIT1_A: M_BIT(1,CPU.AF.B.h);break;
-
-case BIT2_B: M_BIT(2,CPU.BC.B.h);break;  case BIT2_C: M_BIT(2,CPU.BC.B.l);break;    //8:44
-case BIT2_D: M_BIT(2,CPU.DE.B.h);break;  case BIT2_E: M_BIT(2,CPU.DE.B.l);break;
-case BIT2_H: M_BIT(2,CPU.HL.B.h);break;  case BIT2_L: M_BIT(2,CPU.HL.B.l);break;
-case BIT2_A: M_BIT(2,CPU.AF.B.h);break;
-
-case BIT3_B: M_BIT(3,CPU.BC.B.h);break;  case BIT3_C: M_BIT(3,CPU.BC.B.l);break;    //8:44
-case BIT3_D: M_BIT(3,CPU.DE.B.h);break;  case BIT3_E: M_BIT(3,CPU.DE.B.l);break;
-case BIT3_H: M_BIT(3,CPU.HL.B.h);break;  case BIT3_L: M_BIT(3,CPU.HL.B.l);break;
-case BIT3_A: M_BIT(3,CPU.AF.B.h);break;
-
-case BIT4_B: M_BIT(4,CPU.BC.B.h);break;  case BIT4_C: M_BIT(4,CPU.BC.B.l);break;    //8:44
-case BIT4_D: M_BIT(4,CPU.DE.B.h);break;  case BIT4_E: M_BIT(4,CPU.DE.B.l);break;
-case BIT4_H: M_BIT(4,CPU.HL.B.h);break;  case BIT4_L: M_BIT(4,CPU.HL.B.l);break;
-case BIT4_A: M_BIT(4,CPU.AF.B.h);break;
-
-case BIT5_B: M_BIT(5,CPU.BC.B.h);break;  case BIT5_C: M_BIT(5,CPU.BC.B.l);break;    //8:44
-case BIT5_D: M_BIT(5,CPU.DE.B.h);break;  case BIT5_E: M_BIT(5,CPU.DE.B.l);break;
-case BIT5_H: M_BIT(5,CPU.HL.B.h);break;  case BIT5_L: M_BIT(5,CPU.HL.B.l);break;
-case BIT5_A: M_BIT(5,CPU.AF.B.h);break;
-
-case BIT6_B: M_BIT(6,CPU.BC.B.h);break;  case BIT6_C: M_BIT(6,CPU.BC.B.l);break;    //8:44
-case BIT6_D: M_BIT(6,CPU.DE.B.h);break;  case BIT6_E: M_BIT(6,CPU.DE.B.l);break;
-case BIT6_H: M_BIT(6,CPU.HL.B.h);break;  case BIT6_L: M_BIT(6,CPU.HL.B.l);break;
-case BIT6_A: M_BIT(6,CPU.AF.B.h);break;
-
-case BIT7_B: M_BIT(7,CPU.BC.B.h);break;  case BIT7_C: M_BIT(7,CPU.BC.B.l);break;    //8:44
-case BIT7_D: M_BIT(7,CPU.DE.B.h);break;  case BIT7_E: M_BIT(7,CPU.DE.B.l);break;
-case BIT7_H: M_BIT(7,CPU.HL.B.h);break;  case BIT7_L: M_BIT(7,CPU.HL.B.l);break;
-case BIT7_A: M_BIT(7,CPU.AF.B.h);break;
-
-case BIT0_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(0,I);break; //12:444
-case BIT1_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(1,I);break; //12:444
-case BIT2_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(2,I);break; //12:444
-case BIT3_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(3,I);break; //12:444
-case BIT4_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(4,I);break; //12:444
-case BIT5_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(5,I);break; //12:444
-case BIT6_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(6,I);break; //12:444
-case BIT7_xHL: I=RdZ80(CPU.HL.W);  T_INC(1);  M_BIT(7,I);break; //12:444
-
-
-case RES0_B: M_RES(0,CPU.BC.B.h);break;  case RES0_C: M_RES(0,CPU.BC.B.l);break;    //8:44
-case RES0_D: M_RES(0,CPU.DE.B.h);break;  case RES0_E: M_RES(0,CPU.DE.B.l);break;
-case RES0_H: M_RES(0,CPU.HL.B.h);break;  case RES0_L: M_RES(0,CPU.HL.B.l);break;
-case RES0_A: M_RES(0,CPU.AF.B.h);break;
-
-case RES1_B: M_RES(1,CPU.BC.B.h);break;  case RES1_C: M_RES(1,CPU.BC.B.l);break;    //8:44
-case RES1_D: M_RES(1,CPU.DE.B.h);break;  case RES1_E: M_RES(1,CPU.DE.B.l);break;
-case RES1_H: M_RES(1,CPU.HL.B.h);break;  case RES1_L: M_RES(1,CPU.HL.B.l);break;
-case RES1_A: M_RES(1,CPU.AF.B.h);break;
-
-case RES2_B: M_RES(2,CPU.BC.B.h);break;  case RES2_C: M_RES(2,CPU.BC.B.l);break;    //8:44
-case RES2_D: M_RES(2,CPU.DE.B.h);break;  case RES2_E: M_RES(2,CPU.DE.B.l);break;
-case RES2_H: M_RES(2,CPU.HL.B.h);break;  case RES2_L: M_RES(2,CPU.HL.B.l);break;
-case RES2_A: M_RES(2,CPU.AF.B.h);break;
-
-case RES3_B: M_RES(3,CPU.BC.B.h);break;  case RES3_C: M_RES(3,CPU.BC.B.l);break;    //8:44
-case RES3_D: M_RES(3,CPU.DE.B.h);break;  case RES3_E: M_RES(3,CPU.DE.B.l);break;
-case RES3_H: M_RES(3,CPU.HL.B.h);break;  case RES3_L: M_RES(3,CPU.HL.B.l);break;
-case RES3_A: M_RES(3,CPU.AF.B.h);break;
-
-case RES4_B: M_RES(4,CPU.BC.B.h);break;  case RES4_C: M_RES(4,CPU.BC.B.l);break;    //8:44
-case RES4_D: M_RES(4,CPU.DE.B.h);break;  case RES4_E: M_RES(4,CPU.DE.B.l);break;
-case RES4_H: M_RES(4,CPU.HL.B.h);break;  case RES4_L: M_RES(4,CPU.HL.B.l);break;
-case RES4_A: M_RES(4,CPU.AF.B.h);break;
-
-case RES5_B: M_RES(5,CPU.BC.B.h);break;  case RES5_C: M_RES(5,CPU.BC.B.l);break;    //8:44
-case RES5_D: M_RES(5,CPU.DE.B.h);break;  case RES5_E: M_RES(5,CPU.DE.B.l);break;
-case RES5_H: M_RES(5,CPU.HL.B.h);break;  case RES5_L: M_RES(5,CPU.HL.B.l);break;
-case RES5_A: M_RES(5,CPU.AF.B.h);break;
-
-case RES6_B: M_RES(6,CPU.BC.B.h);break;  case RES6_C: M_RES(6,CPU.BC.B.l);break;    //8:44
-case RES6_D: M_RES(6,CPU.DE.B.h);break;  case RES6_E: M_RES(6,CPU.DE.B.l);break;
-case RES6_H: M_RES(6,CPU.HL.B.h);break;  case RES6_L: M_RES(6,CPU.HL.B.l);break;
-case RES6_A: M_RES(6,CPU.AF.B.h);break;
-
-case RES7_B: M_RES(7,CPU.BC.B.h);break;  case RES7_C: M_RES(7,CPU.BC.B.l);break;    //8:44
-case RES7_D: M_RES(7,CPU.DE.B.h);break;  case RES7_E: M_RES(7,CPU.DE.B.l);break;
-case RES7_H: M_RES(7,CPU.HL.B.h);break;  case RES7_L: M_RES(7,CPU.HL.B.l);break;
-case RES7_A: M_RES(7,CPU.AF.B.h);break;
-
-case RES0_xHL: I=RdZ80(CPU.HL.W);  M_RES(0,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case RES1_xHL: I=RdZ80(CPU.HL.W);  M_RES(1,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case RES2_xHL: I=RdZ80(CPU.HL.W);  M_RES(2,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case RES3_xHL: I=RdZ80(CPU.HL.W);  M_RES(3,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case RES4_xHL: I=RdZ80(CPU.HL.W);  M_RES(4,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case RES5_xHL: I=RdZ80(CPU.HL.W);  M_RES(5,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case RES6_xHL: I=RdZ80(CPU.HL.W);  M_RES(6,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case RES7_xHL: I=RdZ80(CPU.HL.W);  M_RES(7,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-
-
-case SET0_B: M_SET(0,CPU.BC.B.h);break;  case SET0_C: M_SET(0,CPU.BC.B.l);break;    //8:44
-case SET0_D: M_SET(0,CPU.DE.B.h);break;  case SET0_E: M_SET(0,CPU.DE.B.l);break;
-case SET0_H: M_SET(0,CPU.HL.B.h);break;  case SET0_L: M_SET(0,CPU.HL.B.l);break;
-case SET0_A: M_SET(0,CPU.AF.B.h);break;
-
-case SET1_B: M_SET(1,CPU.BC.B.h);break;  case SET1_C: M_SET(1,CPU.BC.B.l);break;    //8:44
-case SET1_D: M_SET(1,CPU.DE.B.h);break;  case SET1_E: M_SET(1,CPU.DE.B.l);break;
-case SET1_H: M_SET(1,CPU.HL.B.h);break;  case SET1_L: M_SET(1,CPU.HL.B.l);break;
-case SET1_A: M_SET(1,CPU.AF.B.h);break;
-
-case SET2_B: M_SET(2,CPU.BC.B.h);break;  case SET2_C: M_SET(2,CPU.BC.B.l);break;    //8:44
-case SET2_D: M_SET(2,CPU.DE.B.h);break;  case SET2_E: M_SET(2,CPU.DE.B.l);break;
-case SET2_H: M_SET(2,CPU.HL.B.h);break;  case SET2_L: M_SET(2,CPU.HL.B.l);break;
-case SET2_A: M_SET(2,CPU.AF.B.h);break;
-
-case SET3_B: M_SET(3,CPU.BC.B.h);break;  case SET3_C: M_SET(3,CPU.BC.B.l);break;    //8:44
-case SET3_D: M_SET(3,CPU.DE.B.h);break;  case SET3_E: M_SET(3,CPU.DE.B.l);break;
-case SET3_H: M_SET(3,CPU.HL.B.h);break;  case SET3_L: M_SET(3,CPU.HL.B.l);break;
-case SET3_A: M_SET(3,CPU.AF.B.h);break;
-
-case SET4_B: M_SET(4,CPU.BC.B.h);break;  case SET4_C: M_SET(4,CPU.BC.B.l);break;    //8:44
-case SET4_D: M_SET(4,CPU.DE.B.h);break;  case SET4_E: M_SET(4,CPU.DE.B.l);break;
-case SET4_H: M_SET(4,CPU.HL.B.h);break;  case SET4_L: M_SET(4,CPU.HL.B.l);break;
-case SET4_A: M_SET(4,CPU.AF.B.h);break;
-
-case SET5_B: M_SET(5,CPU.BC.B.h);break;  case SET5_C: M_SET(5,CPU.BC.B.l);break;    //8:44
-case SET5_D: M_SET(5,CPU.DE.B.h);break;  case SET5_E: M_SET(5,CPU.DE.B.l);break;
-case SET5_H: M_SET(5,CPU.HL.B.h);break;  case SET5_L: M_SET(5,CPU.HL.B.l);break;
-case SET5_A: M_SET(5,CPU.AF.B.h);break;
-
-case SET6_B: M_SET(6,CPU.BC.B.h);break;  case SET6_C: M_SET(6,CPU.BC.B.l);break;    //8:44
-case SET6_D: M_SET(6,CPU.DE.B.h);break;  case SET6_E: M_SET(6,CPU.DE.B.l);break;
-case SET6_H: M_SET(6,CPU.HL.B.h);break;  case SET6_L: M_SET(6,CPU.HL.B.l);break;
-case SET6_A: M_SET(6,CPU.AF.B.h);break;
-
-case SET7_B: M_SET(7,CPU.BC.B.h);break;  case SET7_C: M_SET(7,CPU.BC.B.l);break;    //8:44
-case SET7_D: M_SET(7,CPU.DE.B.h);break;  case SET7_E: M_SET(7,CPU.DE.B.l);break;
-case SET7_H: M_SET(7,CPU.HL.B.h);break;  case SET7_L: M_SET(7,CPU.HL.B.l);break;
-case SET7_A: M_SET(7,CPU.AF.B.h);break;
-
-case SET0_xHL: I=RdZ80(CPU.HL.W);  M_SET(0,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case SET1_xHL: I=RdZ80(CPU.HL.W);  M_SET(1,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case SET2_xHL: I=RdZ80(CPU.HL.W);  M_SET(2,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case SET3_xHL: I=RdZ80(CPU.HL.W);  M_SET(3,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case SET4_xHL: I=RdZ80(CPU.HL.W);  M_SET(4,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case SET5_xHL: I=RdZ80(CPU.HL.W);  M_SET(5,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case SET6_xHL: I=RdZ80(CPU.HL.W);  M_SET(6,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
-case SET7_xHL: I=RdZ80(CPU.HL.W);  M_SET(7,I);  T_INC(1);  WrZ80(CPU.HL.W,I);break; // 15:4443
+OPCODE(BIT0_B): M_BIT(0,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT0_C): M_BIT(0,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT0_D): M_BIT(0,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT0_E): M_BIT(0,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT0_H): M_BIT(0,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT0_L): M_BIT(0,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT0_A): M_BIT(0,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT1_B): M_BIT(1,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT1_C): M_BIT(1,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT1_D): M_BIT(1,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT1_E): M_BIT(1,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT1_H): M_BIT(1,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT1_L): M_BIT(1,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT1_A): M_BIT(1,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT2_B): M_BIT(2,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT2_C): M_BIT(2,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT2_D): M_BIT(2,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT2_E): M_BIT(2,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT2_H): M_BIT(2,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT2_L): M_BIT(2,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT2_A): M_BIT(2,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT3_B): M_BIT(3,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT3_C): M_BIT(3,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT3_D): M_BIT(3,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT3_E): M_BIT(3,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT3_H): M_BIT(3,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT3_L): M_BIT(3,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT3_A): M_BIT(3,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT4_B): M_BIT(4,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT4_C): M_BIT(4,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT4_D): M_BIT(4,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT4_E): M_BIT(4,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT4_H): M_BIT(4,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT4_L): M_BIT(4,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT4_A): M_BIT(4,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT5_B): M_BIT(5,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT5_C): M_BIT(5,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT5_D): M_BIT(5,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT5_E): M_BIT(5,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT5_H): M_BIT(5,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT5_L): M_BIT(5,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT5_A): M_BIT(5,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT6_B): M_BIT(6,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT6_C): M_BIT(6,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT6_D): M_BIT(6,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT6_E): M_BIT(6,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT6_H): M_BIT(6,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT6_L): M_BIT(6,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT6_A): M_BIT(6,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT7_B): M_BIT(7,CPU.BC.B.h);NEXT_OP;  OPCODE(BIT7_C): M_BIT(7,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(BIT7_D): M_BIT(7,CPU.DE.B.h);NEXT_OP;  OPCODE(BIT7_E): M_BIT(7,CPU.DE.B.l);NEXT_OP;
+OPCODE(BIT7_H): M_BIT(7,CPU_HL.B.h);NEXT_OP;  OPCODE(BIT7_L): M_BIT(7,CPU_HL.B.l);NEXT_OP;
+OPCODE(BIT7_A): M_BIT(7,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(BIT0_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(0,I);NEXT_OP; //12:444
+OPCODE(BIT1_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(1,I);NEXT_OP; //12:444
+OPCODE(BIT2_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(2,I);NEXT_OP; //12:444
+OPCODE(BIT3_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(3,I);NEXT_OP; //12:444
+OPCODE(BIT4_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(4,I);NEXT_OP; //12:444
+OPCODE(BIT5_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(5,I);NEXT_OP; //12:444
+OPCODE(BIT6_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(6,I);NEXT_OP; //12:444
+OPCODE(BIT7_xHL): I=RdZ80(CPU_HL.W);  T_INC(1);  M_BIT(7,I);NEXT_OP; //12:444
+
+
+OPCODE(RES0_B): M_RES(0,CPU.BC.B.h);NEXT_OP;  OPCODE(RES0_C): M_RES(0,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES0_D): M_RES(0,CPU.DE.B.h);NEXT_OP;  OPCODE(RES0_E): M_RES(0,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES0_H): M_RES(0,CPU_HL.B.h);NEXT_OP;  OPCODE(RES0_L): M_RES(0,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES0_A): M_RES(0,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES1_B): M_RES(1,CPU.BC.B.h);NEXT_OP;  OPCODE(RES1_C): M_RES(1,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES1_D): M_RES(1,CPU.DE.B.h);NEXT_OP;  OPCODE(RES1_E): M_RES(1,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES1_H): M_RES(1,CPU_HL.B.h);NEXT_OP;  OPCODE(RES1_L): M_RES(1,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES1_A): M_RES(1,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES2_B): M_RES(2,CPU.BC.B.h);NEXT_OP;  OPCODE(RES2_C): M_RES(2,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES2_D): M_RES(2,CPU.DE.B.h);NEXT_OP;  OPCODE(RES2_E): M_RES(2,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES2_H): M_RES(2,CPU_HL.B.h);NEXT_OP;  OPCODE(RES2_L): M_RES(2,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES2_A): M_RES(2,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES3_B): M_RES(3,CPU.BC.B.h);NEXT_OP;  OPCODE(RES3_C): M_RES(3,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES3_D): M_RES(3,CPU.DE.B.h);NEXT_OP;  OPCODE(RES3_E): M_RES(3,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES3_H): M_RES(3,CPU_HL.B.h);NEXT_OP;  OPCODE(RES3_L): M_RES(3,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES3_A): M_RES(3,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES4_B): M_RES(4,CPU.BC.B.h);NEXT_OP;  OPCODE(RES4_C): M_RES(4,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES4_D): M_RES(4,CPU.DE.B.h);NEXT_OP;  OPCODE(RES4_E): M_RES(4,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES4_H): M_RES(4,CPU_HL.B.h);NEXT_OP;  OPCODE(RES4_L): M_RES(4,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES4_A): M_RES(4,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES5_B): M_RES(5,CPU.BC.B.h);NEXT_OP;  OPCODE(RES5_C): M_RES(5,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES5_D): M_RES(5,CPU.DE.B.h);NEXT_OP;  OPCODE(RES5_E): M_RES(5,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES5_H): M_RES(5,CPU_HL.B.h);NEXT_OP;  OPCODE(RES5_L): M_RES(5,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES5_A): M_RES(5,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES6_B): M_RES(6,CPU.BC.B.h);NEXT_OP;  OPCODE(RES6_C): M_RES(6,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES6_D): M_RES(6,CPU.DE.B.h);NEXT_OP;  OPCODE(RES6_E): M_RES(6,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES6_H): M_RES(6,CPU_HL.B.h);NEXT_OP;  OPCODE(RES6_L): M_RES(6,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES6_A): M_RES(6,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES7_B): M_RES(7,CPU.BC.B.h);NEXT_OP;  OPCODE(RES7_C): M_RES(7,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(RES7_D): M_RES(7,CPU.DE.B.h);NEXT_OP;  OPCODE(RES7_E): M_RES(7,CPU.DE.B.l);NEXT_OP;
+OPCODE(RES7_H): M_RES(7,CPU_HL.B.h);NEXT_OP;  OPCODE(RES7_L): M_RES(7,CPU_HL.B.l);NEXT_OP;
+OPCODE(RES7_A): M_RES(7,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(RES0_xHL): I=RdZ80(CPU_HL.W);  M_RES(0,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(RES1_xHL): I=RdZ80(CPU_HL.W);  M_RES(1,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(RES2_xHL): I=RdZ80(CPU_HL.W);  M_RES(2,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(RES3_xHL): I=RdZ80(CPU_HL.W);  M_RES(3,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(RES4_xHL): I=RdZ80(CPU_HL.W);  M_RES(4,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(RES5_xHL): I=RdZ80(CPU_HL.W);  M_RES(5,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(RES6_xHL): I=RdZ80(CPU_HL.W);  M_RES(6,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(RES7_xHL): I=RdZ80(CPU_HL.W);  M_RES(7,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+
+
+OPCODE(SET0_B): M_SET(0,CPU.BC.B.h);NEXT_OP;  OPCODE(SET0_C): M_SET(0,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET0_D): M_SET(0,CPU.DE.B.h);NEXT_OP;  OPCODE(SET0_E): M_SET(0,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET0_H): M_SET(0,CPU_HL.B.h);NEXT_OP;  OPCODE(SET0_L): M_SET(0,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET0_A): M_SET(0,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET1_B): M_SET(1,CPU.BC.B.h);NEXT_OP;  OPCODE(SET1_C): M_SET(1,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET1_D): M_SET(1,CPU.DE.B.h);NEXT_OP;  OPCODE(SET1_E): M_SET(1,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET1_H): M_SET(1,CPU_HL.B.h);NEXT_OP;  OPCODE(SET1_L): M_SET(1,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET1_A): M_SET(1,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET2_B): M_SET(2,CPU.BC.B.h);NEXT_OP;  OPCODE(SET2_C): M_SET(2,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET2_D): M_SET(2,CPU.DE.B.h);NEXT_OP;  OPCODE(SET2_E): M_SET(2,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET2_H): M_SET(2,CPU_HL.B.h);NEXT_OP;  OPCODE(SET2_L): M_SET(2,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET2_A): M_SET(2,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET3_B): M_SET(3,CPU.BC.B.h);NEXT_OP;  OPCODE(SET3_C): M_SET(3,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET3_D): M_SET(3,CPU.DE.B.h);NEXT_OP;  OPCODE(SET3_E): M_SET(3,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET3_H): M_SET(3,CPU_HL.B.h);NEXT_OP;  OPCODE(SET3_L): M_SET(3,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET3_A): M_SET(3,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET4_B): M_SET(4,CPU.BC.B.h);NEXT_OP;  OPCODE(SET4_C): M_SET(4,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET4_D): M_SET(4,CPU.DE.B.h);NEXT_OP;  OPCODE(SET4_E): M_SET(4,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET4_H): M_SET(4,CPU_HL.B.h);NEXT_OP;  OPCODE(SET4_L): M_SET(4,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET4_A): M_SET(4,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET5_B): M_SET(5,CPU.BC.B.h);NEXT_OP;  OPCODE(SET5_C): M_SET(5,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET5_D): M_SET(5,CPU.DE.B.h);NEXT_OP;  OPCODE(SET5_E): M_SET(5,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET5_H): M_SET(5,CPU_HL.B.h);NEXT_OP;  OPCODE(SET5_L): M_SET(5,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET5_A): M_SET(5,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET6_B): M_SET(6,CPU.BC.B.h);NEXT_OP;  OPCODE(SET6_C): M_SET(6,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET6_D): M_SET(6,CPU.DE.B.h);NEXT_OP;  OPCODE(SET6_E): M_SET(6,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET6_H): M_SET(6,CPU_HL.B.h);NEXT_OP;  OPCODE(SET6_L): M_SET(6,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET6_A): M_SET(6,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET7_B): M_SET(7,CPU.BC.B.h);NEXT_OP;  OPCODE(SET7_C): M_SET(7,CPU.BC.B.l);NEXT_OP;  //8:44
+OPCODE(SET7_D): M_SET(7,CPU.DE.B.h);NEXT_OP;  OPCODE(SET7_E): M_SET(7,CPU.DE.B.l);NEXT_OP;
+OPCODE(SET7_H): M_SET(7,CPU_HL.B.h);NEXT_OP;  OPCODE(SET7_L): M_SET(7,CPU_HL.B.l);NEXT_OP;
+OPCODE(SET7_A): M_SET(7,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(SET0_xHL): I=RdZ80(CPU_HL.W);  M_SET(0,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(SET1_xHL): I=RdZ80(CPU_HL.W);  M_SET(1,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(SET2_xHL): I=RdZ80(CPU_HL.W);  M_SET(2,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(SET3_xHL): I=RdZ80(CPU_HL.W);  M_SET(3,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(SET4_xHL): I=RdZ80(CPU_HL.W);  M_SET(4,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(SET5_xHL): I=RdZ80(CPU_HL.W);  M_SET(5,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(SET6_xHL): I=RdZ80(CPU_HL.W);  M_SET(6,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
+OPCODE(SET7_xHL): I=RdZ80(CPU_HL.W);  M_SET(7,I);  T_INC(1);  WrZ80(CPU_HL.W,I);NEXT_OP; // 15:4443
@@ -0,0 +1,193 @@
+/******************************************************************************
+*  SpeccySE Z80 CPU
+*
+* Note: Most of this file is from the ColEm emulator core by Marat Fayzullin
+*       but heavily modified for specific NDS use. If you want to use this
+*       code, you are advised to seek out the much more portable ColEm core
+*       and contact Marat.
+*
+******************************************************************************/
+
+// -------------------------------------------------------------------------------------
+// Jump tables for the threaded (computed-goto) dispatch of the accurate Z80 cores. Each
+// table is indexed by opcode exactly like the switch() in the non-threaded build and
+// points at the OPCODE() labels that the Codes*.h files expand to when OP_GROUP is set.
+// Any opcode without a handler goes to the group default (the old switch default:).
+// The group G is pasted onto each label so the same Codes*.h can be included more than
+// once in the same function (e.g. CodesXX.h for both the DD and FD prefixes).
+// -------------------------------------------------------------------------------------
+
+#define JT_CODES(G)  {  \
+    &&G##_NOP,          &&G##_LD_BC_WORD,   &&G##_LD_xBC_A,     &&G##_INC_BC,       &&G##_INC_B,        &&G##_DEC_B,        &&G##_LD_B_BYTE,    &&G##_RLCA,         /* 0x00 */ \
+    &&G##_EX_AF_AF,     &&G##_ADD_HL_BC,    &&G##_LD_A_xBC,     &&G##_DEC_BC,       &&G##_INC_C,        &&G##_DEC_C,        &&G##_LD_C_BYTE,    &&G##_RRCA,         /* 0x08 */ \
+    &&G##_DJNZ,         &&G##_LD_DE_WORD,   &&G##_LD_xDE_A,     &&G##_INC_DE,       &&G##_INC_D,        &&G##_DEC_D,        &&G##_LD_D_BYTE,    &&G##_RLA,          /* 0x10 */ \
+    &&G##_JR,           &&G##_ADD_HL_DE,    &&G##_LD_A_xDE,     &&G##_DEC_DE,       &&G##_INC_E,        &&G##_DEC_E,        &&G##_LD_E_BYTE,    &&G##_RRA,          /* 0x18 */ \
+    &&G##_JR_NZ,        &&G##_LD_HL_WORD,   &&G##_LD_xWORD_HL,  &&G##_INC_HL,       &&G##_INC_H,        &&G##_DEC_H,        &&G##_LD_H_BYTE,    &&G##_DAA,          /* 0x20 */ \
+    &&G##_JR_Z,         &&G##_ADD_HL_HL,    &&G##_LD_HL_xWORD,  &&G##_DEC_HL,       &&G##_INC_L,        &&G##_DEC_L,        &&G##_LD_L_BYTE,    &&G##_CPL,          /* 0x28 */ \
+    &&G##_JR_NC,        &&G##_LD_SP_WORD,   &&G##_LD_xWORD_A,   &&G##_INC_SP,       &&G##_INC_xHL,      &&G##_DEC_xHL,      &&G##_LD_xHL_BYTE,  &&G##_SCF,          /* 0x30 */ \
+    &&G##_JR_C,         &&G##_ADD_HL_SP,    &&G##_LD_A_xWORD,   &&G##_DEC_SP,       &&G##_INC_A,        &&G##_DEC_A,        &&G##_LD_A_BYTE,    &&G##_CCF,          /* 0x38 */ \
+    &&G##_LD_B_B,       &&G##_LD_B_C,       &&G##_LD_B_D,       &&G##_LD_B_E,       &&G##_LD_B_H,       &&G##_LD_B_L,       &&G##_LD_B_xHL,     &&G##_LD_B_A,       /* 0x40 */ \
+    &&G##_LD_C_B,       &&G##_LD_C_C,       &&G##_LD_C_D,       &&G##_LD_C_E,       &&G##_LD_C_H,       &&G##_LD_C_L,       &&G##_LD_C_xHL,     &&G##_LD_C_A,       /* 0x48 */ \
+    &&G##_LD_D_B,       &&G##_LD_D_C,       &&G##_LD_D_D,       &&G##_LD_D_E,       &&G##_LD_D_H,       &&G##_LD_D_L,       &&G##_LD_D_xHL,     &&G##_LD_D_A,       /* 0x50 */ \
+    &&G##_LD_E_B,       &&G##_LD_E_C,       &&G##_LD_E_D,       &&G##_LD_E_E,       &&G##_LD_E_H,       &&G##_LD_E_L,       &&G##_LD_E_xHL,     &&G##_LD_E_A,       /* 0x58 */ \
+    &&G##_LD_H_B,       &&G##_LD_H_C,       &&G##_LD_H_D,       &&G##_LD_H_E,       &&G##_LD_H_H,       &&G##_LD_H_L,       &&G##_LD_H_xHL,     &&G##_LD_H_A,       /* 0x60 */ \
+    &&G##_LD_L_B,       &&G##_LD_L_C,       &&G##_LD_L_D,       &&G##_LD_L_E,       &&G##_LD_L_H,       &&G##_LD_L_L,       &&G##_LD_L_xHL,     &&G##_LD_L_A,       /* 0x68 */ \
+    &&G##_LD_xHL_B,     &&G##_LD_xHL_C,     &&G##_LD_xHL_D,     &&G##_LD_xHL_E,     &&G##_LD_xHL_H,     &&G##_LD_xHL_L,     &&G##_HALT,         &&G##_LD_xHL_A,     /* 0x70 */ \
+    &&G##_LD_A_B,       &&G##_LD_A_C,       &&G##_LD_A_D,       &&G##_LD_A_E,       &&G##_LD_A_H,       &&G##_LD_A_L,       &&G##_LD_A_xHL,     &&G##_LD_A_A,       /* 0x78 */ \
+    &&G##_ADD_B,        &&G##_ADD_C,        &&G##_ADD_D,        &&G##_ADD_E,        &&G##_ADD_H,        &&G##_ADD_L,        &&G##_ADD_xHL,      &&G##_ADD_A,        /* 0x80 */ \
+    &&G##_ADC_B,        &&G##_ADC_C,        &&G##_ADC_D,        &&G##_ADC_E,        &&G##_ADC_H,        &&G##_ADC_L,        &&G##_ADC_xHL,      &&G##_ADC_A,        /* 0x88 */ \
+    &&G##_SUB_B,        &&G##_SUB_C,        &&G##_SUB_D,        &&G##_SUB_E,        &&G##_SUB_H,        &&G##_SUB_L,        &&G##_SUB_xHL,      &&G##_SUB_A,        /* 0x90 */ \
+    &&G##_SBC_B,        &&G##_SBC_C,        &&G##_SBC_D,        &&G##_SBC_E,        &&G##_SBC_H,        &&G##_SBC_L,        &&G##_SBC_xHL,      &&G##_SBC_A,        /* 0x98 */ \
+    &&G##_AND_B,        &&G##_AND_C,        &&G##_AND_D,        &&G##_AND_E,        &&G##_AND_H,        &&G##_AND_L,        &&G##_AND_xHL,      &&G##_AND_A,        /* 0xA0 */ \
+    &&G##_XOR_B,        &&G##_XOR_C,        &&G##_XOR_D,        &&G##_XOR_E,        &&G##_XOR_H,        &&G##_XOR_L,        &&G##_XOR_xHL,      &&G##_XOR_A,        /* 0xA8 */ \
+    &&G##_OR_B,         &&G##_OR_C,         &&G##_OR_D,         &&G##_OR_E,         &&G##_OR_H,         &&G##_OR_L,         &&G##_OR_xHL,       &&G##_OR_A,         /* 0xB0 */ \
+    &&G##_CP_B,         &&G##_CP_C,         &&G##_CP_D,         &&G##_CP_E,         &&G##_CP_H,         &&G##_CP_L,         &&G##_CP_xHL,       &&G##_CP_A,         /* 0xB8 */ \
+    &&G##_RET_NZ,       &&G##_POP_BC,       &&G##_JP_NZ,        &&G##_JP,           &&G##_CALL_NZ,      &&G##_PUSH_BC,      &&G##_ADD_BYTE,     &&G##_RST00,        /* 0xC0 */ \
+    &&G##_RET_Z,        &&G##_RET,          &&G##_JP_Z,         &&G##_PFX_CB,       &&G##_CALL_Z,       &&G##_CALL,         &&G##_ADC_BYTE,     &&G##_RST08,        /* 0xC8 */ \
+    &&G##_RET_NC,       &&G##_POP_DE,       &&G##_JP_NC,        &&G##_OUTA,         &&G##_CALL_NC,      &&G##_PUSH_DE,      &&G##_SUB_BYTE,     &&G##_RST10,        /* 0xD0 */ \
+    &&G##_RET_C,        &&G##_EXX,          &&G##_JP_C,         &&G##_INA,          &&G##_CALL_C,       &&G##_PFX_DD,       &&G##_SBC_BYTE,     &&G##_RST18,        /* 0xD8 */ \
+    &&G##_RET_PO,       &&G##_POP_HL,       &&G##_JP_PO,        &&G##_EX_HL_xSP,    &&G##_CALL_PO,      &&G##_PUSH_HL,      &&G##_AND_BYTE,     &&G##_RST20,        /* 0xE0 */ \
+    &&G##_RET_PE,       &&G##_LD_PC_HL,     &&G##_JP_PE,        &&G##_EX_DE_HL,     &&G##_CALL_PE,      &&G##_PFX_ED,       &&G##_XOR_BYTE,     &&G##_RST28,        /* 0xE8 */ \
+    &&G##_RET_P,        &&G##_POP_AF,       &&G##_JP_P,         &&G##_DI,           &&G##_CALL_P,       &&G##_PUSH_AF,      &&G##_OR_BYTE,      &&G##_RST30,        /* 0xF0 */ \
+    &&G##_RET_M,        &&G##_LD_SP_HL,     &&G##_JP_M,         &&G##_EI,           &&G##_CALL_M,       &&G##_PFX_FD,       &&G##_CP_BYTE,      &&G##_RST38         /* 0xF8 */ \
+}
+
+#define JT_CODES_CB(G)  {  \
+    &&G##_RLC_B,     &&G##_RLC_C,     &&G##_RLC_D,     &&G##_RLC_E,     &&G##_RLC_H,     &&G##_RLC_L,     &&G##_RLC_xHL,   &&G##_RLC_A,     /* 0x00 */ \
+    &&G##_RRC_B,     &&G##_RRC_C,     &&G##_RRC_D,     &&G##_RRC_E,     &&G##_RRC_H,     &&G##_RRC_L,     &&G##_RRC_xHL,   &&G##_RRC_A,     /* 0x08 */ \
+    &&G##_RL_B,      &&G##_RL_C,      &&G##_RL_D,      &&G##_RL_E,      &&G##_RL_H,      &&G##_RL_L,      &&G##_RL_xHL,    &&G##_RL_A,      /* 0x10 */ \
+    &&G##_RR_B,      &&G##_RR_C,      &&G##_RR_D,      &&G##_RR_E,      &&G##_RR_H,      &&G##_RR_L,      &&G##_RR_xHL,    &&G##_RR_A,      /* 0x18 */ \
+    &&G##_SLA_B,     &&G##_SLA_C,     &&G##_SLA_D,     &&G##_SLA_E,     &&G##_SLA_H,     &&G##_SLA_L,     &&G##_SLA_xHL,   &&G##_SLA_A,     /* 0x20 */ \
+    &&G##_SRA_B,     &&G##_SRA_C,     &&G##_SRA_D,     &&G##_SRA_E,     &&G##_SRA_H,     &&G##_SRA_L,     &&G##_SRA_xHL,   &&G##_SRA_A,     /* 0x28 */ \
+    &&G##_SLL_B,     &&G##_SLL_C,     &&G##_SLL_D,     &&G##_SLL_E,     &&G##_SLL_H,     &&G##_SLL_L,     &&G##_SLL_xHL,   &&G##_SLL_A,     /* 0x30 */ \
+    &&G##_SRL_B,     &&G##_SRL_C,     &&G##_SRL_D,     &&G##_SRL_E,     &&G##_SRL_H,     &&G##_SRL_L,     &&G##_SRL_xHL,   &&G##_SRL_A,     /* 0x38 */ \
+    &&G##_BIT0_B,    &&G##_BIT0_C,    &&G##_BIT0_D,    &&G##_BIT0_E,    &&G##_BIT0_H,    &&G##_BIT0_L,    &&G##_BIT0_xHL,  &&G##_BIT0_A,    /* 0x40 */ \
+    &&G##_BIT1_B,    &&G##_BIT1_C,    &&G##_BIT1_D,    &&G##_BIT1_E,    &&G##_BIT1_H,    &&G##_BIT1_L,    &&G##_BIT1_xHL,  &&G##_BIT1_A,    /* 0x48 */ \
+    &&G##_BIT2_B,    &&G##_BIT2_C,    &&G##_BIT2_D,    &&G##_BIT2_E,    &&G##_BIT2_H,    &&G##_BIT2_L,    &&G##_BIT2_xHL,  &&G##_BIT2_A,    /* 0x50 */ \
+    &&G##_BIT3_B,    &&G##_BIT3_C,    &&G##_BIT3_D,    &&G##_BIT3_E,    &&G##_BIT3_H,    &&G##_BIT3_L,    &&G##_BIT3_xHL,  &&G##_BIT3_A,    /* 0x58 */ \
+    &&G##_BIT4_B,    &&G##_BIT4_C,    &&G##_BIT4_D,    &&G##_BIT4_E,    &&G##_BIT4_H,    &&G##_BIT4_L,    &&G##_BIT4_xHL,  &&G##_BIT4_A,    /* 0x60 */ \
+    &&G##_BIT5_B,    &&G##_BIT5_C,    &&G##_BIT5_D,    &&G##_BIT5_E,    &&G##_BIT5_H,    &&G##_BIT5_L,    &&G##_BIT5_xHL,  &&G##_BIT5_A,    /* 0x68 */ \
+    &&G##_BIT6_B,    &&G##_BIT6_C,    &&G##_BIT6_D,    &&G##_BIT6_E,    &&G##_BIT6_H,    &&G##_BIT6_L,    &&G##_BIT6_xHL,  &&G##_BIT6_A,    /* 0x70 */ \
+    &&G##_BIT7_B,    &&G##_BIT7_C,    &&G##_BIT7_D,    &&G##_BIT7_E,    &&G##_BIT7_H,    &&G##_BIT7_L,    &&G##_BIT7_xHL,  &&G##_BIT7_A,    /* 0x78 */ \
+    &&G##_RES0_B,    &&G##_RES0_C,    &&G##_RES0_D,    &&G##_RES0_E,    &&G##_RES0_H,    &&G##_RES0_L,    &&G##_RES0_xHL,  &&G##_RES0_A,    /* 0x80 */ \
+    &&G##_RES1_B,    &&G##_RES1_C,    &&G##_RES1_D,    &&G##_RES1_E,    &&G##_RES1_H,    &&G##_RES1_L,    &&G##_RES1_xHL,  &&G##_RES1_A,    /* 0x88 */ \
+    &&G##_RES2_B,    &&G##_RES2_C,    &&G##_RES2_D,    &&G##_RES2_E,    &&G##_RES2_H,    &&G##_RES2_L,    &&G##_RES2_xHL,  &&G##_RES2_A,    /* 0x90 */ \
+    &&G##_RES3_B,    &&G##_RES3_C,    &&G##_RES3_D,    &&G##_RES3_E,    &&G##_RES3_H,    &&G##_RES3_L,    &&G##_RES3_xHL,  &&G##_RES3_A,    /* 0x98 */ \
+    &&G##_RES4_B,    &&G##_RES4_C,    &&G##_RES4_D,    &&G##_RES4_E,    &&G##_RES4_H,    &&G##_RES4_L,    &&G##_RES4_xHL,  &&G##_RES4_A,    /* 0xA0 */ \
+    &&G##_RES5_B,    &&G##_RES5_C,    &&G##_RES5_D,    &&G##_RES5_E,    &&G##_RES5_H,    &&G##_RES5_L,    &&G##_RES5_xHL,  &&G##_RES5_A,    /* 0xA8 */ \
+    &&G##_RES6_B,    &&G##_RES6_C,    &&G##_RES6_D,    &&G##_RES6_E,    &&G##_RES6_H,    &&G##_RES6_L,    &&G##_RES6_xHL,  &&G##_RES6_A,    /* 0xB0 */ \
+    &&G##_RES7_B,    &&G##_RES7_C,    &&G##_RES7_D,    &&G##_RES7_E,    &&G##_RES7_H,    &&G##_RES7_L,    &&G##_RES7_xHL,  &&G##_RES7_A,    /* 0xB8 */ \
+    &&G##_SET0_B,    &&G##_SET0_C,    &&G##_SET0_D,    &&G##_SET0_E,    &&G##_SET0_H,    &&G##_SET0_L,    &&G##_SET0_xHL,  &&G##_SET0_A,    /* 0xC0 */ \
+    &&G##_SET1_B,    &&G##_SET1_C,    &&G##_SET1_D,    &&G##_SET1_E,    &&G##_SET1_H,    &&G##_SET1_L,    &&G##_SET1_xHL,  &&G##_SET1_A,    /* 0xC8 */ \
+    &&G##_SET2_B,    &&G##_SET2_C,    &&G##_SET2_D,    &&G##_SET2_E,    &&G##_SET2_H,    &&G##_SET2_L,    &&G##_SET2_xHL,  &&G##_SET2_A,    /* 0xD0 */ \
+    &&G##_SET3_B,    &&G##_SET3_C,    &&G##_SET3_D,    &&G##_SET3_E,    &&G##_SET3_H,    &&G##_SET3_L,    &&G##_SET3_xHL,  &&G##_SET3_A,    /* 0xD8 */ \
+    &&G##_SET4_B,    &&G##_SET4_C,    &&G##_SET4_D,    &&G##_SET4_E,    &&G##_SET4_H,    &&G##_SET4_L,    &&G##_SET4_xHL,  &&G##_SET4_A,    /* 0xE0 */ \
+    &&G##_SET5_B,    &&G##_SET5_C,    &&G##_SET5_D,    &&G##_SET5_E,    &&G##_SET5_H,    &&G##_SET5_L,    &&G##_SET5_xHL,  &&G##_SET5_A,    /* 0xE8 */ \
+    &&G##_SET6_B,    &&G##_SET6_C,    &&G##_SET6_D,    &&G##_SET6_E,    &&G##_SET6_H,    &&G##_SET6_L,    &&G##_SET6_xHL,  &&G##_SET6_A,    /* 0xF0 */ \
+    &&G##_SET7_B,    &&G##_SET7_C,    &&G##_SET7_D,    &&G##_SET7_E,    &&G##_SET7_H,    &&G##_SET7_L,    &&G##_SET7_xHL,  &&G##_SET7_A     /* 0xF8 */ \
+}
+
+#define JT_CODES_ED(G)  {  \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x00 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x08 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x10 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x18 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x20 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x28 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x30 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x38 */ \
+    &&G##_IN_B_xC,       &&G##_OUT_xC_B,      &&G##_SBC_HL_BC,     &&G##_LD_xWORDe_BC,  &&G##_NEG,           &&G##_RETN,          &&G##_IM_0,          &&G##_LD_I_A,        /* 0x40 */ \
+    &&G##_IN_C_xC,       &&G##_OUT_xC_C,      &&G##_ADC_HL_BC,     &&G##_LD_BC_xWORDe,  &&G##_default,       &&G##_RETI,          &&G##_default,       &&G##_LD_R_A,        /* 0x48 */ \
+    &&G##_IN_D_xC,       &&G##_OUT_xC_D,      &&G##_SBC_HL_DE,     &&G##_LD_xWORDe_DE,  &&G##_default,       &&G##_default,       &&G##_IM_1,          &&G##_LD_A_I,        /* 0x50 */ \
+    &&G##_IN_E_xC,       &&G##_OUT_xC_E,      &&G##_ADC_HL_DE,     &&G##_LD_DE_xWORDe,  &&G##_default,       &&G##_default,       &&G##_IM_2,          &&G##_LD_A_R,        /* 0x58 */ \
+    &&G##_IN_H_xC,       &&G##_OUT_xC_H,      &&G##_SBC_HL_HL,     &&G##_LD_xWORDe_HL,  &&G##_default,       &&G##_default,       &&G##_default,       &&G##_RRD,           /* 0x60 */ \
+    &&G##_IN_L_xC,       &&G##_OUT_xC_L,      &&G##_ADC_HL_HL,     &&G##_LD_HL_xWORDe,  &&G##_default,       &&G##_default,       &&G##_default,       &&G##_RLD,           /* 0x68 */ \
+    &&G##_IN_F_xC,       &&G##_OUT_xC_F,      &&G##_SBC_HL_SP,     &&G##_LD_xWORDe_SP,  &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x70 */ \
+    &&G##_IN_A_xC,       &&G##_OUT_xC_A,      &&G##_ADC_HL_SP,     &&G##_LD_SP_xWORDe,  &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x78 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x80 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x88 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x90 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0x98 */ \
+    &&G##_LDI,           &&G##_CPI,           &&G##_INI,           &&G##_OUTI,          &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xA0 */ \
+    &&G##_LDD,           &&G##_CPD,           &&G##_IND,           &&G##_OUTD,          &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xA8 */ \
+    &&G##_LDIR,          &&G##_CPIR,          &&G##_INIR,          &&G##_OTIR,          &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xB0 */ \
+    &&G##_LDDR,          &&G##_CPDR,          &&G##_INDR,          &&G##_OTDR,          &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xB8 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xC0 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xC8 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xD0 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xD8 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xE0 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_PFX_ED,        &&G##_default,       &&G##_default,       /* 0xE8 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       /* 0xF0 */ \
+    &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default,       &&G##_default        /* 0xF8 */ \
+}
+
+#define JT_CODES_XX(G)  {  \
+    &&G##_NOP,          &&G##_LD_BC_WORD,   &&G##_LD_xBC_A,     &&G##_INC_BC,       &&G##_INC_B,        &&G##_DEC_B,        &&G##_LD_B_BYTE,    &&G##_RLCA,         /* 0x00 */ \
+    &&G##_EX_AF_AF,     &&G##_ADD_HL_BC,    &&G##_LD_A_xBC,     &&G##_DEC_BC,       &&G##_INC_C,        &&G##_DEC_C,        &&G##_LD_C_BYTE,    &&G##_RRCA,         /* 0x08 */ \
+    &&G##_default,      &&G##_LD_DE_WORD,   &&G##_LD_xDE_A,     &&G##_INC_DE,       &&G##_INC_D,        &&G##_DEC_D,        &&G##_LD_D_BYTE,    &&G##_RLA,          /* 0x10 */ \
+    &&G##_default,      &&G##_ADD_HL_DE,    &&G##_LD_A_xDE,     &&G##_DEC_DE,       &&G##_INC_E,        &&G##_DEC_E,        &&G##_LD_E_BYTE,    &&G##_RRA,          /* 0x18 */ \
+    &&G##_default,      &&G##_LD_HL_WORD,   &&G##_LD_xWORD_HL,  &&G##_INC_HL,       &&G##_INC_H,        &&G##_DEC_H,        &&G##_LD_H_BYTE,    &&G##_default,      /* 0x20 */ \
+    &&G##_default,      &&G##_ADD_HL_HL,    &&G##_LD_HL_xWORD,  &&G##_DEC_HL,       &&G##_INC_L,        &&G##_DEC_L,        &&G##_LD_L_BYTE,    &&G##_CPL,          /* 0x28 */ \
+    &&G##_default,      &&G##_LD_SP_WORD,   &&G##_LD_xWORD_A,   &&G##_INC_SP,       &&G##_INC_xHL,      &&G##_DEC_xHL,      &&G##_LD_xHL_BYTE,  &&G##_SCF,          /* 0x30 */ \
+    &&G##_default,      &&G##_ADD_HL_SP,    &&G##_LD_A_xWORD,   &&G##_DEC_SP,       &&G##_INC_A,        &&G##_DEC_A,        &&G##_LD_A_BYTE,    &&G##_default,      /* 0x38 */ \
+    &&G##_LD_B_B,       &&G##_LD_B_C,       &&G##_LD_B_D,       &&G##_LD_B_E,       &&G##_LD_B_H,       &&G##_LD_B_L,       &&G##_LD_B_xHL,     &&G##_LD_B_A,       /* 0x40 */ \
+    &&G##_LD_C_B,       &&G##_LD_C_C,       &&G##_LD_C_D,       &&G##_LD_C_E,       &&G##_LD_C_H,       &&G##_LD_C_L,       &&G##_LD_C_xHL,     &&G##_LD_C_A,       /* 0x48 */ \
+    &&G##_LD_D_B,       &&G##_LD_D_C,       &&G##_LD_D_D,       &&G##_LD_D_E,       &&G##_LD_D_H,       &&G##_LD_D_L,       &&G##_LD_D_xHL,     &&G##_LD_D_A,       /* 0x50 */ \
+    &&G##_LD_E_B,       &&G##_LD_E_C,       &&G##_LD_E_D,       &&G##_LD_E_E,       &&G##_LD_E_H,       &&G##_LD_E_L,       &&G##_LD_E_xHL,     &&G##_LD_E_A,       /* 0x58 */ \
+    &&G##_LD_H_B,       &&G##_LD_H_C,       &&G##_LD_H_D,       &&G##_LD_H_E,       &&G##_LD_H_H,       &&G##_LD_H_L,       &&G##_LD_H_xHL,     &&G##_LD_H_A,       /* 0x60 */ \
+    &&G##_LD_L_B,       &&G##_LD_L_C,       &&G##_LD_L_D,       &&G##_LD_L_E,       &&G##_LD_L_H,       &&G##_LD_L_L,       &&G##_LD_L_xHL,     &&G##_LD_L_A,       /* 0x68 */ \
+    &&G##_LD_xHL_B,     &&G##_LD_xHL_C,     &&G##_LD_xHL_D,     &&G##_LD_xHL_E,     &&G##_LD_xHL_H,     &&G##_LD_xHL_L,     &&G##_default,      &&G##_LD_xHL_A,     /* 0x70 */ \
+    &&G##_LD_A_B,       &&G##_LD_A_C,       &&G##_LD_A_D,       &&G##_LD_A_E,       &&G##_LD_A_H,       &&G##_LD_A_L,       &&G##_LD_A_xHL,     &&G##_LD_A_A,       /* 0x78 */ \
+    &&G##_ADD_B,        &&G##_ADD_C,        &&G##_ADD_D,        &&G##_ADD_E,        &&G##_ADD_H,        &&G##_ADD_L,        &&G##_ADD_xHL,      &&G##_ADD_A,        /* 0x80 */ \
+    &&G##_ADC_B,        &&G##_ADC_C,        &&G##_ADC_D,        &&G##_ADC_E,        &&G##_ADC_H,        &&G##_ADC_L,        &&G##_ADC_xHL,      &&G##_ADC_A,        /* 0x88 */ \
+    &&G##_SUB_B,        &&G##_SUB_C,        &&G##_SUB_D,        &&G##_SUB_E,        &&G##_SUB_H,        &&G##_SUB_L,        &&G##_SUB_xHL,      &&G##_SUB_A,        /* 0x90 */ \
+    &&G##_SBC_B,        &&G##_SBC_C,        &&G##_SBC_D,        &&G##_SBC_E,        &&G##_SBC_H,        &&G##_SBC_L,        &&G##_SBC_xHL,      &&G##_SBC_A,        /* 0x98 */ \
+    &&G##_AND_B,        &&G##_AND_C,        &&G##_AND_D,        &&G##_AND_E,        &&G##_AND_H,        &&G##_AND_L,        &&G##_AND_xHL,      &&G##_AND_A,        /* 0xA0 */ \
+    &&G##_XOR_B,        &&G##_XOR_C,        &&G##_XOR_D,        &&G##_XOR_E,        &&G##_XOR_H,        &&G##_XOR_L,        &&G##_XOR_xHL,      &&G##_XOR_A,        /* 0xA8 */ \
+    &&G##_OR_B,         &&G##_OR_C,         &&G##_OR_D,         &&G##_OR_E,         &&G##_OR_H,         &&G##_OR_L,         &&G##_OR_xHL,       &&G##_OR_A,         /* 0xB0 */ \
+    &&G##_CP_B,         &&G##_CP_C,         &&G##_CP_D,         &&G##_CP_E,         &&G##_CP_H,         &&G##_CP_L,         &&G##_CP_xHL,       &&G##_CP_A,         /* 0xB8 */ \
+    &&G##_default,      &&G##_POP_BC,       &&G##_default,      &&G##_default,      &&G##_default,      &&G##_PUSH_BC,      &&G##_ADD_BYTE,     &&G##_RST00,        /* 0xC0 */ \
+    &&G##_default,      &&G##_default,      &&G##_default,      &&G##_PFX_CB,       &&G##_default,      &&G##_default,      &&G##_ADC_BYTE,     &&G##_RST08,        /* 0xC8 */ \
+    &&G##_default,      &&G##_POP_DE,       &&G##_default,      &&G##_OUTA,         &&G##_default,      &&G##_PUSH_DE,      &&G##_SUB_BYTE,     &&G##_RST10,        /* 0xD0 */ \
+    &&G##_default,      &&G##_default,      &&G##_default,      &&G##_INA,          &&G##_default,      &&G##_PFX_DD,       &&G##_SBC_BYTE,     &&G##_RST18,        /* 0xD8 */ \
+    &&G##_default,      &&G##_POP_HL,       &&G##_default,      &&G##_EX_HL_xSP,    &&G##_default,      &&G##_PUSH_HL,      &&G##_AND_BYTE,     &&G##_RST20,        /* 0xE0 */ \
+    &&G##_default,      &&G##_LD_PC_HL,     &&G##_default,      &&G##_EX_DE_HL,     &&G##_default,      &&G##_default,      &&G##_XOR_BYTE,     &&G##_RST28,        /* 0xE8 */ \
+    &&G##_default,      &&G##_POP_AF,       &&G##_default,      &&G##_default,      &&G##_default,      &&G##_PUSH_AF,      &&G##_OR_BYTE,      &&G##_RST30,        /* 0xF0 */ \
+    &&G##_default,      &&G##_LD_SP_HL,     &&G##_default,      &&G##_default,      &&G##_default,      &&G##_PFX_FD,       &&G##_CP_BYTE,      &&G##_RST38         /* 0xF8 */ \
+}
+
+#define JT_CODES_XCB(G)  {  \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RLC_xHL,   &&G##_default,   /* 0x00 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RRC_xHL,   &&G##_default,   /* 0x08 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RL_xHL,    &&G##_default,   /* 0x10 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RR_xHL,    &&G##_default,   /* 0x18 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SLA_xHL,   &&G##_default,   /* 0x20 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SRA_xHL,   &&G##_default,   /* 0x28 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SLL_xHL,   &&G##_default,   /* 0x30 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SRL_xHL,   &&G##_default,   /* 0x38 */ \
+    &&G##_BIT0_B,    &&G##_BIT0_C,    &&G##_BIT0_D,    &&G##_BIT0_E,    &&G##_BIT0_H,    &&G##_BIT0_L,    &&G##_BIT0_xHL,  &&G##_BIT0_A,    /* 0x40 */ \
+    &&G##_BIT1_B,    &&G##_BIT1_C,    &&G##_BIT1_D,    &&G##_BIT1_E,    &&G##_BIT1_H,    &&G##_BIT1_L,    &&G##_BIT1_xHL,  &&G##_BIT1_A,    /* 0x48 */ \
+    &&G##_BIT2_B,    &&G##_BIT2_C,    &&G##_BIT2_D,    &&G##_BIT2_E,    &&G##_BIT2_H,    &&G##_BIT2_L,    &&G##_BIT2_xHL,  &&G##_BIT2_A,    /* 0x50 */ \
+    &&G##_BIT3_B,    &&G##_BIT3_C,    &&G##_BIT3_D,    &&G##_BIT3_E,    &&G##_BIT3_H,    &&G##_BIT3_L,    &&G##_BIT3_xHL,  &&G##_BIT3_A,    /* 0x58 */ \
+    &&G##_BIT4_B,    &&G##_BIT4_C,    &&G##_BIT4_D,    &&G##_BIT4_E,    &&G##_BIT4_H,    &&G##_BIT4_L,    &&G##_BIT4_xHL,  &&G##_BIT4_A,    /* 0x60 */ \
+    &&G##_BIT5_B,    &&G##_BIT5_C,    &&G##_BIT5_D,    &&G##_BIT5_E,    &&G##_BIT5_H,    &&G##_BIT5_L,    &&G##_BIT5_xHL,  &&G##_BIT5_A,    /* 0x68 */ \
+    &&G##_BIT6_B,    &&G##_BIT6_C,    &&G##_BIT6_D,    &&G##_BIT6_E,    &&G##_BIT6_H,    &&G##_BIT6_L,    &&G##_BIT6_xHL,  &&G##_BIT6_A,    /* 0x70 */ \
+    &&G##_BIT7_B,    &&G##_BIT7_C,    &&G##_BIT7_D,    &&G##_BIT7_E,    &&G##_BIT7_H,    &&G##_BIT7_L,    &&G##_BIT7_xHL,  &&G##_BIT7_A,    /* 0x78 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES0_xHL,  &&G##_RES0_A,    /* 0x80 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES1_xHL,  &&G##_RES1_A,    /* 0x88 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES2_xHL,  &&G##_RES2_A,    /* 0x90 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES3_xHL,  &&G##_RES3_A,    /* 0x98 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES4_xHL,  &&G##_RES4_A,    /* 0xA0 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES5_xHL,  &&G##_RES5_A,    /* 0xA8 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES6_xHL,  &&G##_RES6_A,    /* 0xB0 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_RES7_xHL,  &&G##_RES7_A,    /* 0xB8 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET0_xHL,  &&G##_SET0_A,    /* 0xC0 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET1_xHL,  &&G##_SET1_A,    /* 0xC8 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET2_xHL,  &&G##_SET2_A,    /* 0xD0 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET3_xHL,  &&G##_SET3_A,    /* 0xD8 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET4_xHL,  &&G##_SET4_A,    /* 0xE0 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET5_xHL,  &&G##_SET5_A,    /* 0xE8 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET6_xHL,  &&G##_SET6_A,    /* 0xF0 */ \
+    &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_default,   &&G##_SET7_xHL,  &&G##_SET7_A     /* 0xF8 */ \
+}
@@ -21,295 +21,299 @@
 /**     changes to this file.                               **/
 /*************************************************************/
 
-case ADD_B:    M_ADD(CPU.BC.B.h);break; 
-case ADD_C:    M_ADD(CPU.BC.B.l);break;
-case ADD_D:    M_ADD(CPU.DE.B.h);break;
-case ADD_E:    M_ADD(CPU.DE.B.l);break;
-case ADD_H:    M_ADD(CPU.XX.B.h);break;
-case ADD_L:    M_ADD(CPU.XX.B.l);break;
-case ADD_A:    M_ADD(CPU.AF.B.h);break;
-case ADD_BYTE: I=RdZ80(CPU.PC.W++);M_ADD(I);break;
-
-case SUB_B:    M_SUB(CPU.BC.B.h);break;
-case SUB_C:    M_SUB(CPU.BC.B.l);break;
-case SUB_D:    M_SUB(CPU.DE.B.h);break;
-case SUB_E:    M_SUB(CPU.DE.B.l);break;
-case SUB_H:    M_SUB(CPU.XX.B.h);break;
-case SUB_L:    M_SUB(CPU.XX.B.l);break;
-case SUB_A:    CPU.AF.B.h=0;CPU.AF.B.l=N_FLAG|Z_FLAG;break;
-case SUB_BYTE: I=RdZ80(CPU.PC.W++);M_SUB(I);break;
-
-case AND_B:    M_AND(CPU.BC.B.h);break;
-case AND_C:    M_AND(CPU.BC.B.l);break;
-case AND_D:    M_AND(CPU.DE.B.h);break;
-case AND_E:    M_AND(CPU.DE.B.l);break;
-case AND_H:    M_AND(CPU.XX.B.h);break;
-case AND_L:    M_AND(CPU.XX.B.l);break;
-case AND_A:    M_AND(CPU.AF.B.h);break;
-case AND_BYTE: I=RdZ80(CPU.PC.W++);M_AND(I);break;
-
-case OR_B:     M_OR(CPU.BC.B.h);break;
-case OR_C:     M_OR(CPU.BC.B.l);break;
-case OR_D:     M_OR(CPU.DE.B.h);break;
-case OR_E:     M_OR(CPU.DE.B.l);break;
-case OR_H:     M_OR(CPU.XX.B.h);break;
-case OR_L:     M_OR(CPU.XX.B.l);break;
-case OR_A:     M_OR(CPU.AF.B.h);break;
-case OR_BYTE:  I=RdZ80(CPU.PC.W++);M_OR(I);break;
-
-case ADC_B:    M_ADC(CPU.BC.B.h);break;
-case ADC_C:    M_ADC(CPU.BC.B.l);break;
-case ADC_D:    M_ADC(CPU.DE.B.h);break;
-case ADC_E:    M_ADC(CPU.DE.B.l);break;
-case ADC_H:    M_ADC(CPU.XX.B.h);break;
-case ADC_L:    M_ADC(CPU.XX.B.l);break;
-case ADC_A:    M_ADC(CPU.AF.B.h);break;
-case ADC_BYTE: I=RdZ80(CPU.PC.W++);M_ADC(I);break;
-
-case SBC_B:    M_SBC(CPU.BC.B.h);break;
-case SBC_C:    M_SBC(CPU.BC.B.l);break;
-case SBC_D:    M_SBC(CPU.DE.B.h);break;
-case SBC_E:    M_SBC(CPU.DE.B.l);break;
-case SBC_H:    M_SBC(CPU.XX.B.h);break;
-case SBC_L:    M_SBC(CPU.XX.B.l);break;
-case SBC_A:    M_SBC(CPU.AF.B.h);break;
-case SBC_BYTE: I=RdZ80(CPU.PC.W++);M_SBC(I);break;
-
-case XOR_B:    M_XOR(CPU.BC.B.h);break;
-case XOR_C:    M_XOR(CPU.BC.B.l);break;
-case XOR_D:    M_XOR(CPU.DE.B.h);break;
-case XOR_E:    M_XOR(CPU.DE.B.l);break;
-case XOR_H:    M_XOR(CPU.XX.B.h);break;
-case XOR_L:    M_XOR(CPU.XX.B.l);break;
-case XOR_A:    CPU.AF.B.h=0;CPU.AF.B.l=P_FLAG|Z_FLAG;break;
-case XOR_BYTE: I=RdZ80(CPU.PC.W++);M_XOR(I);break;
-
-case CP_B:     M_CP(CPU.BC.B.h);break;
-case CP_C:     M_CP(CPU.BC.B.l);break;
-case CP_D:     M_CP(CPU.DE.B.h);break;
-case CP_E:     M_CP(CPU.DE.B.l);break;
-case CP_H:     M_CP(CPU.XX.B.h);break;
-case CP_L:     M_CP(CPU.XX.B.l);break;
-case CP_A:     CPU.AF.B.l=N_FLAG|Z_FLAG;break;
-case CP_BYTE:  I=RdZ80(CPU.PC.W++);M_CP(I);break;
-
-case ADD_xHL:  K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_ADD(I);break; //19:44353
-case SUB_xHL:  K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_SUB(I);break; //19:44353
-case AND_xHL:  K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_AND(I);break; //19:44353
-case OR_xHL:   K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_OR(I); break; //19:44353
-case ADC_xHL:  K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_ADC(I);break; //19:44353
-case SBC_xHL:  K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_SBC(I);break; //19:44353
-case XOR_xHL:  K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_XOR(I);break; //19:44353
-case CP_xHL:   K=RdZ80(CPU.PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_CP(I); break; //19:44353
-
-case LD_BC_WORD: M_LDWORD(BC);break;
-case LD_DE_WORD: M_LDWORD(DE);break;
-case LD_HL_WORD: M_LDWORD(XX);break;
-case LD_SP_WORD: M_LDWORD(SP);break;
-
-case LD_PC_HL: CPU.PC.W=CPU.XX.W;JumpZ80(CPU.PC.W);break;
-case LD_SP_HL: CPU.SP.W=CPU.XX.W;break;
-case LD_A_xBC: CPU.AF.B.h=RdZ80(CPU.BC.W);break;
-case LD_A_xDE: CPU.AF.B.h=RdZ80(CPU.DE.W);break;
-
-case ADD_HL_BC:  M_ADDW(XX,BC);T_INC(7);break; //15:4443
-case ADD_HL_DE:  M_ADDW(XX,DE);T_INC(7);break; //15:4443
-case ADD_HL_HL:  M_ADDW(XX,XX);T_INC(7);break; //15:4443
-case ADD_HL_SP:  M_ADDW(XX,SP);T_INC(7);break; //15:4443
-
-case DEC_BC:   CPU.BC.W--;T_INC(2);break;
-case DEC_DE:   CPU.DE.W--;T_INC(2);break;
-case DEC_HL:   CPU.XX.W--;T_INC(2);break;
-case DEC_SP:   CPU.SP.W--;T_INC(2);break;
-
-case INC_BC:   CPU.BC.W++;T_INC(2);break;
-case INC_DE:   CPU.DE.W++;T_INC(2);break;
-case INC_HL:   CPU.XX.W++;T_INC(2);break;
-case INC_SP:   CPU.SP.W++;T_INC(2);break;
-
-case DEC_B:    M_DEC(CPU.BC.B.h);break;
-case DEC_C:    M_DEC(CPU.BC.B.l);break;
-case DEC_D:    M_DEC(CPU.DE.B.h);break;
-case DEC_E:    M_DEC(CPU.DE.B.l);break;
-case DEC_H:    M_DEC(CPU.XX.B.h);break;
-case DEC_L:    M_DEC(CPU.XX.B.l);break;
-case DEC_A:    M_DEC(CPU.AF.B.h);break;
-case DEC_xHL:  K=RdZ80(CPU.PC.W++); T_INC(2); I=RdZ80(CPU.XX.W+(offset)K);  //23:443543
+OPCODE(ADD_B):    M_ADD(CPU.BC.B.h);NEXT_OP; 
+OPCODE(ADD_C):    M_ADD(CPU.BC.B.l);NEXT_OP;
+OPCODE(ADD_D):    M_ADD(CPU.DE.B.h);NEXT_OP;
+OPCODE(ADD_E):    M_ADD(CPU.DE.B.l);NEXT_OP;
+OPCODE(ADD_H):    M_ADD(CPU.XX.B.h);NEXT_OP;
+OPCODE(ADD_L):    M_ADD(CPU.XX.B.l);NEXT_OP;
+OPCODE(ADD_A):    M_ADD(CPU_AF.B.h);NEXT_OP;
+OPCODE(ADD_BYTE): I=RdZ80(CPU_PC.W++);M_ADD(I);NEXT_OP;
+
+OPCODE(SUB_B):    M_SUB(CPU.BC.B.h);NEXT_OP;
+OPCODE(SUB_C):    M_SUB(CPU.BC.B.l);NEXT_OP;
+OPCODE(SUB_D):    M_SUB(CPU.DE.B.h);NEXT_OP;
+OPCODE(SUB_E):    M_SUB(CPU.DE.B.l);NEXT_OP;
+OPCODE(SUB_H):    M_SUB(CPU.XX.B.h);NEXT_OP;
+OPCODE(SUB_L):    M_SUB(CPU.XX.B.l);NEXT_OP;
+OPCODE(SUB_A):    FLAGS_DROP(); CPU_AF.B.h=0;CPU_AF.B.l=N_FLAG|Z_FLAG;NEXT_OP;
+OPCODE(SUB_BYTE): I=RdZ80(CPU_PC.W++);M_SUB(I);NEXT_OP;
+
+OPCODE(AND_B):    M_AND(CPU.BC.B.h);NEXT_OP;
+OPCODE(AND_C):    M_AND(CPU.BC.B.l);NEXT_OP;
+OPCODE(AND_D):    M_AND(CPU.DE.B.h);NEXT_OP;
+OPCODE(AND_E):    M_AND(CPU.DE.B.l);NEXT_OP;
+OPCODE(AND_H):    M_AND(CPU.XX.B.h);NEXT_OP;
+OPCODE(AND_L):    M_AND(CPU.XX.B.l);NEXT_OP;
+OPCODE(AND_A):    M_AND(CPU_AF.B.h);NEXT_OP;
+OPCODE(AND_BYTE): I=RdZ80(CPU_PC.W++);M_AND(I);NEXT_OP;
+
+OPCODE(OR_B):     M_OR(CPU.BC.B.h);NEXT_OP;
+OPCODE(OR_C):     M_OR(CPU.BC.B.l);NEXT_OP;
+OPCODE(OR_D):     M_OR(CPU.DE.B.h);NEXT_OP;
+OPCODE(OR_E):     M_OR(CPU.DE.B.l);NEXT_OP;
+OPCODE(OR_H):     M_OR(CPU.XX.B.h);NEXT_OP;
+OPCODE(OR_L):     M_OR(CPU.XX.B.l);NEXT_OP;
+OPCODE(OR_A):     M_OR(CPU_AF.B.h);NEXT_OP;
+OPCODE(OR_BYTE):  I=RdZ80(CPU_PC.W++);M_OR(I);NEXT_OP;
+
+OPCODE(ADC_B):    M_ADC(CPU.BC.B.h);NEXT_OP;
+OPCODE(ADC_C):    M_ADC(CPU.BC.B.l);NEXT_OP;
+OPCODE(ADC_D):    M_ADC(CPU.DE.B.h);NEXT_OP;
+OPCODE(ADC_E):    M_ADC(CPU.DE.B.l);NEXT_OP;
+OPCODE(ADC_H):    M_ADC(CPU.XX.B.h);NEXT_OP;
+OPCODE(ADC_L):    M_ADC(CPU.XX.B.l);NEXT_OP;
+OPCODE(ADC_A):    M_ADC(CPU_AF.B.h);NEXT_OP;
+OPCODE(ADC_BYTE): I=RdZ80(CPU_PC.W++);M_ADC(I);NEXT_OP;
+
+OPCODE(SBC_B):    M_SBC(CPU.BC.B.h);NEXT_OP;
+OPCODE(SBC_C):    M_SBC(CPU.BC.B.l);NEXT_OP;
+OPCODE(SBC_D):    M_SBC(CPU.DE.B.h);NEXT_OP;
+OPCODE(SBC_E):    M_SBC(CPU.DE.B.l);NEXT_OP;
+OPCODE(SBC_H):    M_SBC(CPU.XX.B.h);NEXT_OP;
+OPCODE(SBC_L):    M_SBC(CPU.XX.B.l);NEXT_OP;
+OPCODE(SBC_A):    M_SBC(CPU_AF.B.h);NEXT_OP;
+OPCODE(SBC_BYTE): I=RdZ80(CPU_PC.W++);M_SBC(I);NEXT_OP;
+
+OPCODE(XOR_B):    M_XOR(CPU.BC.B.h);NEXT_OP;
+OPCODE(XOR_C):    M_XOR(CPU.BC.B.l);NEXT_OP;
+OPCODE(XOR_D):    M_XOR(CPU.DE.B.h);NEXT_OP;
+OPCODE(XOR_E):    M_XOR(CPU.DE.B.l);NEXT_OP;
+OPCODE(XOR_H):    M_XOR(CPU.XX.B.h);NEXT_OP;
+OPCODE(XOR_L):    M_XOR(CPU.XX.B.l);NEXT_OP;
+OPCODE(XOR_A):    FLAGS_DROP(); CPU_AF.B.h=0;CPU_AF.B.l=P_FLAG|Z_FLAG;NEXT_OP;
+OPCODE(XOR_BYTE): I=RdZ80(CPU_PC.W++);M_XOR(I);NEXT_OP;
+
+OPCODE(CP_B):     M_CP(CPU.BC.B.h);NEXT_OP;
+OPCODE(CP_C):     M_CP(CPU.BC.B.l);NEXT_OP;
+OPCODE(CP_D):     M_CP(CPU.DE.B.h);NEXT_OP;
+OPCODE(CP_E):     M_CP(CPU.DE.B.l);NEXT_OP;
+OPCODE(CP_H):     M_CP(CPU.XX.B.h);NEXT_OP;
+OPCODE(CP_L):     M_CP(CPU.XX.B.l);NEXT_OP;
+OPCODE(CP_A):     FLAGS_DROP(); CPU_AF.B.l=N_FLAG|Z_FLAG;NEXT_OP;
+OPCODE(CP_BYTE):  I=RdZ80(CPU_PC.W++);M_CP(I);NEXT_OP;
+
+OPCODE(ADD_xHL):  K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_ADD(I);NEXT_OP; //19:44353
+OPCODE(SUB_xHL):  K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_SUB(I);NEXT_OP; //19:44353
+OPCODE(AND_xHL):  K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_AND(I);NEXT_OP; //19:44353
+OPCODE(OR_xHL):   K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_OR(I); NEXT_OP; //19:44353
+OPCODE(ADC_xHL):  K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_ADC(I);NEXT_OP; //19:44353
+OPCODE(SBC_xHL):  K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_SBC(I);NEXT_OP; //19:44353
+OPCODE(XOR_xHL):  K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_XOR(I);NEXT_OP; //19:44353
+OPCODE(CP_xHL):   K=RdZ80(CPU_PC.W++);  T_INC(5);  I=RdZ80(CPU.XX.W+(offset)K);   M_CP(I); NEXT_OP; //19:44353
+
+OPCODE(LD_BC_WORD): M_LDWORD(BC);NEXT_OP;
+OPCODE(LD_DE_WORD): M_LDWORD(DE);NEXT_OP;
+OPCODE(LD_HL_WORD): M_LDWORD(XX);NEXT_OP;
+OPCODE(LD_SP_WORD): M_LDWORD(SP);NEXT_OP;
+
+OPCODE(LD_PC_HL): CPU_PC.W=CPU.XX.W;JumpZ80(CPU_PC.W);NEXT_OP;
+OPCODE(LD_SP_HL): CPU.SP.W=CPU.XX.W;NEXT_OP;
+OPCODE(LD_A_xBC): CPU_AF.B.h=RdZ80(CPU.BC.W);NEXT_OP;
+OPCODE(LD_A_xDE): CPU_AF.B.h=RdZ80(CPU.DE.W);NEXT_OP;
+
+OPCODE(ADD_HL_BC):  M_ADDW(XX,BC);T_INC(7);NEXT_OP; //15:4443
+OPCODE(ADD_HL_DE):  M_ADDW(XX,DE);T_INC(7);NEXT_OP; //15:4443
+OPCODE(ADD_HL_HL):  M_ADDW(XX,XX);T_INC(7);NEXT_OP; //15:4443
+OPCODE(ADD_HL_SP):  M_ADDW(XX,SP);T_INC(7);NEXT_OP; //15:4443
+
+OPCODE(DEC_BC):   CPU.BC.W--;T_INC(2);NEXT_OP;
+OPCODE(DEC_DE):   CPU.DE.W--;T_INC(2);NEXT_OP;
+OPCODE(DEC_HL):   CPU.XX.W--;T_INC(2);NEXT_OP;
+OPCODE(DEC_SP):   CPU.SP.W--;T_INC(2);NEXT_OP;
+
+OPCODE(INC_BC):   CPU.BC.W++;T_INC(2);NEXT_OP;
+OPCODE(INC_DE):   CPU.DE.W++;T_INC(2);NEXT_OP;
+OPCODE(INC_HL):   CPU.XX.W++;T_INC(2);NEXT_OP;
+OPCODE(INC_SP):   CPU.SP.W++;T_INC(2);NEXT_OP;
+
+OPCODE(DEC_B):    M_DEC(CPU.BC.B.h);NEXT_OP;
+OPCODE(DEC_C):    M_DEC(CPU.BC.B.l);NEXT_OP;
+OPCODE(DEC_D):    M_DEC(CPU.DE.B.h);NEXT_OP;
+OPCODE(DEC_E):    M_DEC(CPU.DE.B.l);NEXT_OP;
+OPCODE(DEC_H):    M_DEC(CPU.XX.B.h);NEXT_OP;
+OPCODE(DEC_L):    M_DEC(CPU.XX.B.l);NEXT_OP;
+OPCODE(DEC_A):    M_DEC(CPU_AF.B.h);NEXT_OP;
+OPCODE(DEC_xHL):  K=RdZ80(CPU_PC.W++); T_INC(2); I=RdZ80(CPU.XX.W+(offset)K);  //23:443543
                M_DEC(I); T_INC(1);
                WrZ80(CPU.XX.W+(offset)K,I);
-               break;
-
-case INC_B:    M_INC(CPU.BC.B.h);break;
-case INC_C:    M_INC(CPU.BC.B.l);break;
-case INC_D:    M_INC(CPU.DE.B.h);break;
-case INC_E:    M_INC(CPU.DE.B.l);break;
-case INC_H:    M_INC(CPU.XX.B.h);break;
-case INC_L:    M_INC(CPU.XX.B.l);break;
-case INC_A:    M_INC(CPU.AF.B.h);break;
-case INC_xHL:  K=RdZ80(CPU.PC.W++); T_INC(2); I=RdZ80(CPU.XX.W+(offset)K);  //23:443543
+               NEXT_OP;
+
+OPCODE(INC_B):    M_INC(CPU.BC.B.h);NEXT_OP;
+OPCODE(INC_C):    M_INC(CPU.BC.B.l);NEXT_OP;
+OPCODE(INC_D):    M_INC(CPU.DE.B.h);NEXT_OP;
+OPCODE(INC_E):    M_INC(CPU.DE.B.l);NEXT_OP;
+OPCODE(INC_H):    M_INC(CPU.XX.B.h);NEXT_OP;
+OPCODE(INC_L):    M_INC(CPU.XX.B.l);NEXT_OP;
+OPCODE(INC_A):    M_INC(CPU_AF.B.h);NEXT_OP;
+OPCODE(INC_xHL):  K=RdZ80(CPU_PC.W++); T_INC(2); I=RdZ80(CPU.XX.W+(offset)K);  //23:443543
                M_INC(I); T_INC(1);
                WrZ80(CPU.XX.W+(offset)K,I);
-               break;
-case RLCA:
-  I=(CPU.AF.B.h&0x80? C_FLAG:0);
-  CPU.AF.B.h=(CPU.AF.B.h<<1)|I;
-  CPU.AF.B.l=(CPU.AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
-  break;
-case RLA:
-  I=(CPU.AF.B.h&0x80? C_FLAG:0);
-  CPU.AF.B.h=(CPU.AF.B.h<<1)|(CPU.AF.B.l&C_FLAG);
-  CPU.AF.B.l=(CPU.AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
-  break;
-case RRCA:
-  I=CPU.AF.B.h&0x01;
-  CPU.AF.B.h=(CPU.AF.B.h>>1)|(I? 0x80:0);
-  CPU.AF.B.l=(CPU.AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
-  break;
-case RRA:
-  I=CPU.AF.B.h&0x01;
-  CPU.AF.B.h=(CPU.AF.B.h>>1)|(CPU.AF.B.l&C_FLAG? 0x80:0);
-  CPU.AF.B.l=(CPU.AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
-  break;
-
-case RST00:    M_RST(0x0000);break;
-case RST08:    M_RST(0x0008);break;
-case RST10:    M_RST(0x0010);break;
-case RST18:    M_RST(0x0018);break;
-case RST20:    M_RST(0x0020);break;
-case RST28:    M_RST(0x0028);break;
-case RST30:    M_RST(0x0030);break;
-case RST38:    M_RST(0x0038);break;
-
-case PUSH_BC:  M_PUSH(BC);break;
-case PUSH_DE:  M_PUSH(DE);break;
-case PUSH_HL:  T_INC(1); M_PUSH(XX);break;
-case PUSH_AF:  M_PUSH(AF);break;
-
-case POP_BC:   M_POP(BC);break;
-case POP_DE:   M_POP(DE);break;
-case POP_HL:   M_POP(XX);break;
-case POP_AF:   M_POP(AF);break;
-
-case SCF:  S(C_FLAG);R(N_FLAG|H_FLAG);break;
-case CPL:  CPU.AF.B.h=~CPU.AF.B.h;S(N_FLAG|H_FLAG);break;
-case NOP:  break;
-case OUTA: I=RdZ80(CPU.PC.W++);OutZ80(I|(CPU.AF.W&0xFF00),CPU.AF.B.h);break;
-case INA:  I=RdZ80(CPU.PC.W++);CPU.AF.B.h=InZ80(I|(CPU.AF.W&0xFF00));break;
-
-case EX_DE_HL: J.W=CPU.DE.W;CPU.DE.W=CPU.HL.W;CPU.HL.W=J.W;break;   //8:44
-case EX_AF_AF: J.W=CPU.AF.W;CPU.AF.W=CPU.AF1.W;CPU.AF1.W=J.W;break; //8:44 
+               NEXT_OP;
+OPCODE(RLCA):
+  FLAGS_SYNC();
+  I=(CPU_AF.B.h&0x80? C_FLAG:0);
+  CPU_AF.B.h=(CPU_AF.B.h<<1)|I;
+  CPU_AF.B.l=(CPU_AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
+  NEXT_OP;
+OPCODE(RLA):
+  FLAGS_SYNC();
+  I=(CPU_AF.B.h&0x80? C_FLAG:0);
+  CPU_AF.B.h=(CPU_AF.B.h<<1)|(CPU_AF.B.l&C_FLAG);
+  CPU_AF.B.l=(CPU_AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
+  NEXT_OP;
+OPCODE(RRCA):
+  FLAGS_SYNC();
+  I=CPU_AF.B.h&0x01;
+  CPU_AF.B.h=(CPU_AF.B.h>>1)|(I? 0x80:0);
+  CPU_AF.B.l=(CPU_AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
+  NEXT_OP;
+OPCODE(RRA):
+  FLAGS_SYNC();
+  I=CPU_AF.B.h&0x01;
+  CPU_AF.B.h=(CPU_AF.B.h>>1)|(CPU_AF.B.l&C_FLAG? 0x80:0);
+  CPU_AF.B.l=(CPU_AF.B.l&~(C_FLAG|N_FLAG|H_FLAG))|I;
+  NEXT_OP;
+
+OPCODE(RST00):    M_RST(0x0000);NEXT_OP;
+OPCODE(RST08):    M_RST(0x0008);NEXT_OP;
+OPCODE(RST10):    M_RST(0x0010);NEXT_OP;
+OPCODE(RST18):    M_RST(0x0018);NEXT_OP;
+OPCODE(RST20):    M_RST(0x0020);NEXT_OP;
+OPCODE(RST28):    M_RST(0x0028);NEXT_OP;
+OPCODE(RST30):    M_RST(0x0030);NEXT_OP;
+OPCODE(RST38):    M_RST(0x0038);NEXT_OP;
+
+OPCODE(PUSH_BC):  M_PUSH(BC);NEXT_OP;
+OPCODE(PUSH_DE):  M_PUSH(DE);NEXT_OP;
+OPCODE(PUSH_HL):  T_INC(1); M_PUSH(XX);NEXT_OP;
+OPCODE(PUSH_AF):  FLAGS_SYNC(); M_PUSH(AF);NEXT_OP;
+
+OPCODE(POP_BC):   M_POP(BC);NEXT_OP;
+OPCODE(POP_DE):   M_POP(DE);NEXT_OP;
+OPCODE(POP_HL):   M_POP(XX);NEXT_OP;
+OPCODE(POP_AF):   FLAGS_DROP(); M_POP(AF);NEXT_OP;
+
+OPCODE(SCF):  S(C_FLAG);R(N_FLAG|H_FLAG);NEXT_OP;
+OPCODE(CPL):  CPU_AF.B.h=~CPU_AF.B.h;S(N_FLAG|H_FLAG);NEXT_OP;
+OPCODE(NOP):  NEXT_OP;
+OPCODE(OUTA): I=RdZ80(CPU_PC.W++);OutZ80(I|(CPU_AF.W&0xFF00),CPU_AF.B.h);NEXT_OP;
+OPCODE(INA):  I=RdZ80(CPU_PC.W++);CPU_AF.B.h=InZ80(I|(CPU_AF.W&0xFF00));NEXT_OP;
+
+OPCODE(EX_DE_HL): J.W=CPU.DE.W;CPU.DE.W=CPU_HL.W;CPU_HL.W=J.W;NEXT_OP; //8:44
+OPCODE(EX_AF_AF): FLAGS_SYNC(); J.W=CPU_AF.W;CPU_AF.W=CPU.AF1.W;CPU.AF1.W=J.W;NEXT_OP; //8:44 
   
-case LD_B_B:   CPU.BC.B.h=CPU.BC.B.h;break; //8:44 
-case LD_C_B:   CPU.BC.B.l=CPU.BC.B.h;break; //8:44 
-case LD_D_B:   CPU.DE.B.h=CPU.BC.B.h;break; //8:44 
-case LD_E_B:   CPU.DE.B.l=CPU.BC.B.h;break; //8:44 
-case LD_H_B:   CPU.XX.B.h=CPU.BC.B.h;break; //8:44 
-case LD_L_B:   CPU.XX.B.l=CPU.BC.B.h;break; //8:44 
-case LD_A_B:   CPU.AF.B.h=CPU.BC.B.h;break; //8:44 
-case LD_xHL_B: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++);T_INC(5);WrZ80(J.W,CPU.BC.B.h);break;//19:44353
-
-case LD_B_C:   CPU.BC.B.h=CPU.BC.B.l;break; //8:44 
-case LD_C_C:   CPU.BC.B.l=CPU.BC.B.l;break; //8:44 
-case LD_D_C:   CPU.DE.B.h=CPU.BC.B.l;break; //8:44 
-case LD_E_C:   CPU.DE.B.l=CPU.BC.B.l;break; //8:44 
-case LD_H_C:   CPU.XX.B.h=CPU.BC.B.l;break; //8:44 
-case LD_L_C:   CPU.XX.B.l=CPU.BC.B.l;break; //8:44 
-case LD_A_C:   CPU.AF.B.h=CPU.BC.B.l;break; //8:44 
-case LD_xHL_C: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++);T_INC(5);WrZ80(J.W,CPU.BC.B.l);break;//19:44353
-
-case LD_B_D:   CPU.BC.B.h=CPU.DE.B.h;break;
-case LD_C_D:   CPU.BC.B.l=CPU.DE.B.h;break;
-case LD_D_D:   CPU.DE.B.h=CPU.DE.B.h;break;
-case LD_E_D:   CPU.DE.B.l=CPU.DE.B.h;break;
-case LD_H_D:   CPU.XX.B.h=CPU.DE.B.h;break;
-case LD_L_D:   CPU.XX.B.l=CPU.DE.B.h;break;
-case LD_A_D:   CPU.AF.B.h=CPU.DE.B.h;break;
-case LD_xHL_D: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++);T_INC(5);WrZ80(J.W,CPU.DE.B.h);break;//19:44353
-
-case LD_B_E:   CPU.BC.B.h=CPU.DE.B.l;break;
-case LD_C_E:   CPU.BC.B.l=CPU.DE.B.l;break;
-case LD_D_E:   CPU.DE.B.h=CPU.DE.B.l;break;
-case LD_E_E:   CPU.DE.B.l=CPU.DE.B.l;break;
-case LD_H_E:   CPU.XX.B.h=CPU.DE.B.l;break;
-case LD_L_E:   CPU.XX.B.l=CPU.DE.B.l;break;
-case LD_A_E:   CPU.AF.B.h=CPU.DE.B.l;break;
-case LD_xHL_E: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++);T_INC(5);WrZ80(J.W,CPU.DE.B.l);break;//19:44353
-
-case LD_B_H:   CPU.BC.B.h=CPU.XX.B.h;break;
-case LD_C_H:   CPU.BC.B.l=CPU.XX.B.h;break;
-case LD_D_H:   CPU.DE.B.h=CPU.XX.B.h;break;
-case LD_E_H:   CPU.DE.B.l=CPU.XX.B.h;break;
-case LD_H_H:   CPU.XX.B.h=CPU.XX.B.h;break;
-case LD_L_H:   CPU.XX.B.l=CPU.XX.B.h;break;
-case LD_A_H:   CPU.AF.B.h=CPU.XX.B.h;break;
-case LD_xHL_H: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++);T_INC(5);WrZ80(J.W,CPU.HL.B.h);break;//19:44353
-
-case LD_B_L:   CPU.BC.B.h=CPU.XX.B.l;break;
-case LD_C_L:   CPU.BC.B.l=CPU.XX.B.l;break;
-case LD_D_L:   CPU.DE.B.h=CPU.XX.B.l;break;
-case LD_E_L:   CPU.DE.B.l=CPU.XX.B.l;break;
-case LD_H_L:   CPU.XX.B.h=CPU.XX.B.l;break;
-case LD_L_L:   CPU.XX.B.l=CPU.XX.B.l;break;
-case LD_A_L:   CPU.AF.B.h=CPU.XX.B.l;break;
-case LD_xHL_L: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++);T_INC(5); WrZ80(J.W,CPU.HL.B.l);break;//19:44353
-
-case LD_B_A:   CPU.BC.B.h=CPU.AF.B.h;break;
-case LD_C_A:   CPU.BC.B.l=CPU.AF.B.h;break;
-case LD_D_A:   CPU.DE.B.h=CPU.AF.B.h;break;
-case LD_E_A:   CPU.DE.B.l=CPU.AF.B.h;break;
-case LD_H_A:   CPU.XX.B.h=CPU.AF.B.h;break;
-case LD_L_A:   CPU.XX.B.l=CPU.AF.B.h;break;
-case LD_A_A:   CPU.AF.B.h=CPU.AF.B.h;break;
-case LD_xHL_A: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++); T_INC(5); WrZ80(J.W,CPU.AF.B.h);break;//19:44353
-
-case LD_xBC_A: WrZ80(CPU.BC.W,CPU.AF.B.h);break;
-case LD_xDE_A: WrZ80(CPU.DE.W,CPU.AF.B.h);break;
-
-case LD_B_xHL:    K=RdZ80(CPU.PC.W++);  T_INC(5); CPU.BC.B.h=RdZ80(CPU.XX.W+(offset)K);  break;   //19:44353
-case LD_C_xHL:    K=RdZ80(CPU.PC.W++);  T_INC(5); CPU.BC.B.l=RdZ80(CPU.XX.W+(offset)K);  break;   //19:44353
-case LD_D_xHL:    K=RdZ80(CPU.PC.W++);  T_INC(5); CPU.DE.B.h=RdZ80(CPU.XX.W+(offset)K);  break;   //19:44353
-case LD_E_xHL:    K=RdZ80(CPU.PC.W++);  T_INC(5); CPU.DE.B.l=RdZ80(CPU.XX.W+(offset)K);  break;   //19:44353
-case LD_H_xHL:    K=RdZ80(CPU.PC.W++);  T_INC(5); CPU.HL.B.h=RdZ80(CPU.XX.W+(offset)K);  break;   //19:44353
-case LD_L_xHL:    K=RdZ80(CPU.PC.W++);  T_INC(5); CPU.HL.B.l=RdZ80(CPU.XX.W+(offset)K);  break;   //19:44353
-case LD_A_xHL:    K=RdZ80(CPU.PC.W++);  T_INC(5); CPU.AF.B.h=RdZ80(CPU.XX.W+(offset)K);  break;   //19:44353
-
-case LD_B_BYTE:   CPU.BC.B.h=RdZ80(CPU.PC.W++);break;
-case LD_C_BYTE:   CPU.BC.B.l=RdZ80(CPU.PC.W++);break;
-case LD_D_BYTE:   CPU.DE.B.h=RdZ80(CPU.PC.W++);break;
-case LD_E_BYTE:   CPU.DE.B.l=RdZ80(CPU.PC.W++);break;
-case LD_H_BYTE:   CPU.XX.B.h=RdZ80(CPU.PC.W++);break;
-case LD_L_BYTE:   CPU.XX.B.l=RdZ80(CPU.PC.W++);break;
-case LD_A_BYTE:   CPU.AF.B.h=RdZ80(CPU.PC.W++);break;
-case LD_xHL_BYTE: J.W=CPU.XX.W+(offset)RdZ80(CPU.PC.W++);  T_INC(2);  WrZ80(J.W,RdZ80(CPU.PC.W++));break;
-
-case LD_xWORD_HL:
-  J.B.l=RdZ80(CPU.PC.W++);
-  J.B.h=RdZ80(CPU.PC.W++);
+OPCODE(LD_B_B):   CPU.BC.B.h=CPU.BC.B.h;NEXT_OP; //8:44 
+OPCODE(LD_C_B):   CPU.BC.B.l=CPU.BC.B.h;NEXT_OP; //8:44 
+OPCODE(LD_D_B):   CPU.DE.B.h=CPU.BC.B.h;NEXT_OP; //8:44 
+OPCODE(LD_E_B):   CPU.DE.B.l=CPU.BC.B.h;NEXT_OP; //8:44 
+OPCODE(LD_H_B):   CPU.XX.B.h=CPU.BC.B.h;NEXT_OP; //8:44 
+OPCODE(LD_L_B):   CPU.XX.B.l=CPU.BC.B.h;NEXT_OP; //8:44 
+OPCODE(LD_A_B):   CPU_AF.B.h=CPU.BC.B.h;NEXT_OP; //8:44 
+OPCODE(LD_xHL_B): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);T_INC(5);WrZ80(J.W,CPU.BC.B.h);NEXT_OP;//19:44353
+
+OPCODE(LD_B_C):   CPU.BC.B.h=CPU.BC.B.l;NEXT_OP; //8:44 
+OPCODE(LD_C_C):   CPU.BC.B.l=CPU.BC.B.l;NEXT_OP; //8:44 
+OPCODE(LD_D_C):   CPU.DE.B.h=CPU.BC.B.l;NEXT_OP; //8:44 
+OPCODE(LD_E_C):   CPU.DE.B.l=CPU.BC.B.l;NEXT_OP; //8:44 
+OPCODE(LD_H_C):   CPU.XX.B.h=CPU.BC.B.l;NEXT_OP; //8:44 
+OPCODE(LD_L_C):   CPU.XX.B.l=CPU.BC.B.l;NEXT_OP; //8:44 
+OPCODE(LD_A_C):   CPU_AF.B.h=CPU.BC.B.l;NEXT_OP; //8:44 
+OPCODE(LD_xHL_C): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);T_INC(5);WrZ80(J.W,CPU.BC.B.l);NEXT_OP;//19:44353
+
+OPCODE(LD_B_D):   CPU.BC.B.h=CPU.DE.B.h;NEXT_OP;
+OPCODE(LD_C_D):   CPU.BC.B.l=CPU.DE.B.h;NEXT_OP;
+OPCODE(LD_D_D):   CPU.DE.B.h=CPU.DE.B.h;NEXT_OP;
+OPCODE(LD_E_D):   CPU.DE.B.l=CPU.DE.B.h;NEXT_OP;
+OPCODE(LD_H_D):   CPU.XX.B.h=CPU.DE.B.h;NEXT_OP;
+OPCODE(LD_L_D):   CPU.XX.B.l=CPU.DE.B.h;NEXT_OP;
+OPCODE(LD_A_D):   CPU_AF.B.h=CPU.DE.B.h;NEXT_OP;
+OPCODE(LD_xHL_D): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);T_INC(5);WrZ80(J.W,CPU.DE.B.h);NEXT_OP;//19:44353
+
+OPCODE(LD_B_E):   CPU.BC.B.h=CPU.DE.B.l;NEXT_OP;
+OPCODE(LD_C_E):   CPU.BC.B.l=CPU.DE.B.l;NEXT_OP;
+OPCODE(LD_D_E):   CPU.DE.B.h=CPU.DE.B.l;NEXT_OP;
+OPCODE(LD_E_E):   CPU.DE.B.l=CPU.DE.B.l;NEXT_OP;
+OPCODE(LD_H_E):   CPU.XX.B.h=CPU.DE.B.l;NEXT_OP;
+OPCODE(LD_L_E):   CPU.XX.B.l=CPU.DE.B.l;NEXT_OP;
+OPCODE(LD_A_E):   CPU_AF.B.h=CPU.DE.B.l;NEXT_OP;
+OPCODE(LD_xHL_E): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);T_INC(5);WrZ80(J.W,CPU.DE.B.l);NEXT_OP;//19:44353
+
+OPCODE(LD_B_H):   CPU.BC.B.h=CPU.XX.B.h;NEXT_OP;
+OPCODE(LD_C_H):   CPU.BC.B.l=CPU.XX.B.h;NEXT_OP;
+OPCODE(LD_D_H):   CPU.DE.B.h=CPU.XX.B.h;NEXT_OP;
+OPCODE(LD_E_H):   CPU.DE.B.l=CPU.XX.B.h;NEXT_OP;
+OPCODE(LD_H_H):   CPU.XX.B.h=CPU.XX.B.h;NEXT_OP;
+OPCODE(LD_L_H):   CPU.XX.B.l=CPU.XX.B.h;NEXT_OP;
+OPCODE(LD_A_H):   CPU_AF.B.h=CPU.XX.B.h;NEXT_OP;
+OPCODE(LD_xHL_H): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);T_INC(5);WrZ80(J.W,CPU_HL.B.h);NEXT_OP;//19:44353
+
+OPCODE(LD_B_L):   CPU.BC.B.h=CPU.XX.B.l;NEXT_OP;
+OPCODE(LD_C_L):   CPU.BC.B.l=CPU.XX.B.l;NEXT_OP;
+OPCODE(LD_D_L):   CPU.DE.B.h=CPU.XX.B.l;NEXT_OP;
+OPCODE(LD_E_L):   CPU.DE.B.l=CPU.XX.B.l;NEXT_OP;
+OPCODE(LD_H_L):   CPU.XX.B.h=CPU.XX.B.l;NEXT_OP;
+OPCODE(LD_L_L):   CPU.XX.B.l=CPU.XX.B.l;NEXT_OP;
+OPCODE(LD_A_L):   CPU_AF.B.h=CPU.XX.B.l;NEXT_OP;
+OPCODE(LD_xHL_L): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);T_INC(5); WrZ80(J.W,CPU_HL.B.l);NEXT_OP;//19:44353
+
+OPCODE(LD_B_A):   CPU.BC.B.h=CPU_AF.B.h;NEXT_OP;
+OPCODE(LD_C_A):   CPU.BC.B.l=CPU_AF.B.h;NEXT_OP;
+OPCODE(LD_D_A):   CPU.DE.B.h=CPU_AF.B.h;NEXT_OP;
+OPCODE(LD_E_A):   CPU.DE.B.l=CPU_AF.B.h;NEXT_OP;
+OPCODE(LD_H_A):   CPU.XX.B.h=CPU_AF.B.h;NEXT_OP;
+OPCODE(LD_L_A):   CPU.XX.B.l=CPU_AF.B.h;NEXT_OP;
+OPCODE(LD_A_A):   CPU_AF.B.h=CPU_AF.B.h;NEXT_OP;
+OPCODE(LD_xHL_A): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++); T_INC(5); WrZ80(J.W,CPU_AF.B.h);NEXT_OP;//19:44353
+
+OPCODE(LD_xBC_A): WrZ80(CPU.BC.W,CPU_AF.B.h);NEXT_OP;
+OPCODE(LD_xDE_A): WrZ80(CPU.DE.W,CPU_AF.B.h);NEXT_OP;
+
+OPCODE(LD_B_xHL):    K=RdZ80(CPU_PC.W++);  T_INC(5); CPU.BC.B.h=RdZ80(CPU.XX.W+(offset)K);  NEXT_OP; //19:44353
+OPCODE(LD_C_xHL):    K=RdZ80(CPU_PC.W++);  T_INC(5); CPU.BC.B.l=RdZ80(CPU.XX.W+(offset)K);  NEXT_OP; //19:44353
+OPCODE(LD_D_xHL):    K=RdZ80(CPU_PC.W++);  T_INC(5); CPU.DE.B.h=RdZ80(CPU.XX.W+(offset)K);  NEXT_OP; //19:44353
+OPCODE(LD_E_xHL):    K=RdZ80(CPU_PC.W++);  T_INC(5); CPU.DE.B.l=RdZ80(CPU.XX.W+(offset)K);  NEXT_OP; //19:44353
+OPCODE(LD_H_xHL):    K=RdZ80(CPU_PC.W++);  T_INC(5); CPU_HL.B.h=RdZ80(CPU.XX.W+(offset)K);  NEXT_OP; //19:44353
+OPCODE(LD_L_xHL):    K=RdZ80(CPU_PC.W++);  T_INC(5); CPU_HL.B.l=RdZ80(CPU.XX.W+(offset)K);  NEXT_OP; //19:44353
+OPCODE(LD_A_xHL):    K=RdZ80(CPU_PC.W++);  T_INC(5); CPU_AF.B.h=RdZ80(CPU.XX.W+(offset)K);  NEXT_OP; //19:44353
+
+OPCODE(LD_B_BYTE):   CPU.BC.B.h=RdZ80(CPU_PC.W++);NEXT_OP;
+OPCODE(LD_C_BYTE):   CPU.BC.B.l=RdZ80(CPU_PC.W++);NEXT_OP;
+OPCODE(LD_D_BYTE):   CPU.DE.B.h=RdZ80(CPU_PC.W++);NEXT_OP;
+OPCODE(LD_E_BYTE):   CPU.DE.B.l=RdZ80(CPU_PC.W++);NEXT_OP;
+OPCODE(LD_H_BYTE):   CPU.XX.B.h=RdZ80(CPU_PC.W++);NEXT_OP;
+OPCODE(LD_L_BYTE):   CPU.XX.B.l=RdZ80(CPU_PC.W++);NEXT_OP;
+OPCODE(LD_A_BYTE):   CPU_AF.B.h=RdZ80(CPU_PC.W++);NEXT_OP;
+OPCODE(LD_xHL_BYTE): J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);  T_INC(2);  WrZ80(J.W,RdZ80(CPU_PC.W++));NEXT_OP;
+
+OPCODE(LD_xWORD_HL):
+  J.B.l=RdZ80(CPU_PC.W++);
+  J.B.h=RdZ80(CPU_PC.W++);
   WrZ80(J.W++,CPU.XX.B.l);
   WrZ80(J.W,CPU.XX.B.h);
-  break;
+  NEXT_OP;
 
-case LD_HL_xWORD:
-  J.B.l=RdZ80(CPU.PC.W++);
-  J.B.h=RdZ80(CPU.PC.W++);
+OPCODE(LD_HL_xWORD):
+  J.B.l=RdZ80(CPU_PC.W++);
+  J.B.h=RdZ80(CPU_PC.W++);
   CPU.XX.B.l=RdZ80(J.W++);
   CPU.XX.B.h=RdZ80(J.W);
-  break;
+  NEXT_OP;
 
-case LD_A_xWORD:
-  J.B.l=RdZ80(CPU.PC.W++);
-  J.B.h=RdZ80(CPU.PC.W++);
-  CPU.AF.B.h=RdZ80(J.W);
-  break;
+OPCODE(LD_A_xWORD):
+  J.B.l=RdZ80(CPU_PC.W++);
+  J.B.h=RdZ80(CPU_PC.W++);
+  CPU_AF.B.h=RdZ80(J.W);
+  NEXT_OP;
 
-case LD_xWORD_A:
-  J.B.l=RdZ80(CPU.PC.W++);
-  J.B.h=RdZ80(CPU.PC.W++);
-  WrZ80(J.W,CPU.AF.B.h);
-  break;
+OPCODE(LD_xWORD_A):
+  J.B.l=RdZ80(CPU_PC.W++);
+  J.B.h=RdZ80(CPU_PC.W++);
+  WrZ80(J.W,CPU_AF.B.h);
+  NEXT_OP;
 
-case EX_HL_xSP: //23:443435
+OPCODE(EX_HL_xSP): //23:443435
   J.B.l=RdZ80(CPU.SP.W);WrZ80(CPU.SP.W++,CPU.XX.B.l);T_INC(1);
   J.B.h=RdZ80(CPU.SP.W);T_INC(2);WrZ80(CPU.SP.W--,CPU.XX.B.h);
   CPU.XX.W=J.W;
-  break;
+  NEXT_OP;
@@ -0,0 +1,211 @@
+/******************************************************************************
+*  SpeccySE Z80 CPU
+*
+* Note: Most of this file is from the ColEm emulator core by Marat Fayzullin
+*       but heavily modified for specific NDS use. If you want to use this
+*       code, you are advised to seek out the much more portable ColEm core
+*       and contact Marat.
+*
+******************************************************************************/
+
+// -----------------------------------------------------------------------------------------
+// Threaded (computed-goto) body of the accurate Z80 cores. This is included as the body of
+// ExecZ80_Speccy_128() and ExecZ80_Speccy_48() in Z80_a.c when Z80_THREADED_DISPATCH is
+// defined and uses whatever OpZ80/RdZ80/WrZ80/EI_Enable are mapped in at that point.
+// With the register cache the CPU_xx registers are locals (see CORE_REG_CACHE).
+//
+// Instead of a switch() per opcode group plus a function call for each prefix, every
+// opcode body is a label and we jump straight to it through the tables in CodesJT.h.
+// The prefixes (CB, ED, DD, FD, DDCB, FDCB) all live inside this one function so a
+// prefixed instruction is just a second table lookup. The opcode bodies are the very
+// same Codes*.h files used by the switch() build so the T-State accounting is identical.
+// Anything executing out of the (read-only) lower 16K goes through the RomDecode[] cache
+// instead so even prefixed ROM instructions cost just the one table lookup to dispatch.
+// -----------------------------------------------------------------------------------------
+  register byte I,K;
+  register pair J;
+  register u32 D = 0;
+
+  static const void * const JumpTable[256]     = JT_CODES(op);
+  static const void * const JumpTableCB[256]   = JT_CODES_CB(cb);
+  static const void * const JumpTableED[256]   = JT_CODES_ED(ed);
+  static const void * const JumpTableDD[256]   = JT_CODES_XX(dd);
+  static const void * const JumpTableFD[256]   = JT_CODES_XX(fd);
+  static const void * const JumpTableDDCB[256] = JT_CODES_XCB(ddcb);
+  static const void * const JumpTableFDCB[256] = JT_CODES_XCB(fdcb);
+  static const void * const JumpTableROM[8]     = { &&RomFill, &&RomOp, &&RomCB, &&RomED, &&RomDD, &&RomFD, &&RomDDCB, &&RomFDCB };
+
+#undef  OPCODE
+#undef  NEXT_OP
+#define OP_LABEL_(G,Code)   G##_##Code
+#define OP_LABEL(G,Code)    OP_LABEL_(G,Code)
+#define OPCODE(Code)        OP_LABEL(OP_GROUP,Code)
+#define NEXT_OP             goto NextOpcode
+
+NextOpcode:
+  if (CPU_TStates >= CPU_RunTo) { FLAGS_SYNC(); CPU_FLUSH(); return; }
+
+  /* Lower 16K is always ROM - use the pre-decoded form of the instruction */
+  if (CPU_PC.W < 0x4000)
+  {
+      D = RomDecode[CPU_PC.W] ^ RomDecodeTag;   /* Top byte is zero only if decoded from this page */
+      if (D >> 24) goto RomFill;
+      I = (byte)D;
+      goto *JumpTableROM[D >> 16];
+  }
+
+  I=OpZ80(CPU_PC.W++);
+
+  /* R register incremented on each M1 cycle */
+  INCR(1);
+
+  /* Interpret opcode */
+  goto *JumpTable[I];
+
+// ------------------------------------------------------
+// Pre-decoded ROM instructions. The ROM is never subject
+// to contention so each prefix fetch is a flat 4 cycles
+// (and 3 for the xxCB displacement read) and we can skip
+// straight to the final handler with the PC, T-States, R
+// and J exactly as the byte-by-byte decode leaves them.
+// ------------------------------------------------------
+RomFill:
+  D = rom_decode_fill(CPU_PC.W);
+  I = (byte)D;
+  goto *JumpTableROM[D >> 16];
+
+RomOp:
+  CPU_PC.W += 1; MEM_CYCLES(4); INCR(1);
+  goto *JumpTable[I];
+
+RomCB:
+  CPU_PC.W += 2; MEM_CYCLES(8); INCR(1); INCR(1);
+  goto *JumpTableCB[I];
+
+RomED:
+  CPU_PC.W += 2; MEM_CYCLES(8); INCR(1); INCR(1);
+  goto *JumpTableED[I];
+
+RomDD:
+  CPU_PC.W += 2; MEM_CYCLES(8); INCR(1); INCR(1);
+  goto *JumpTableDD[I];
+
+RomFD:
+  CPU_PC.W += 2; MEM_CYCLES(8); INCR(1); INCR(1);
+  goto *JumpTableFD[I];
+
+RomDDCB:
+  J.W = CPU.IX.W + (offset)(byte)(D >> 8);
+  CPU_PC.W += 4; MEM_CYCLES(15); INCR(1); INCR(1);
+  goto *JumpTableDDCB[I];
+
+RomFDCB:
+  J.W = CPU.IY.W + (offset)(byte)(D >> 8);
+  CPU_PC.W += 4; MEM_CYCLES(15); INCR(1); INCR(1);
+  goto *JumpTableFDCB[I];
+
+// ------------------------------------------------------
+// Main opcode table and the jumps into the prefix tables
+// ------------------------------------------------------
+#define OP_GROUP op
+#include "Codes.h"
+
+OPCODE(PFX_CB):
+  I=OpZ80(CPU_PC.W++);
+  INCR(1);
+  goto *JumpTableCB[I];
+
+OPCODE(PFX_ED):
+  I=OpZ80(CPU_PC.W++);
+  INCR(1);
+  goto *JumpTableED[I];
+
+OPCODE(PFX_DD):
+  I=OpZ80(CPU_PC.W++);
+  INCR(1);
+  goto *JumpTableDD[I];
+
+OPCODE(PFX_FD):
+  I=OpZ80(CPU_PC.W++);
+  INCR(1);
+  goto *JumpTableFD[I];
+#undef OP_GROUP
+
+// ------------------------------------------------------
+// CB prefix
+// ------------------------------------------------------
+#define OP_GROUP cb
+#include "CodesCB.h"
+#undef OP_GROUP
+
+// ------------------------------------------------------
+// ED prefix
+// ------------------------------------------------------
+#define OP_GROUP ed
+#include "CodesED.h"
+OPCODE(PFX_ED):
+  CPU_PC.W--;NEXT_OP;
+OPCODE(default):
+  if(CPU.TrapBadOps) Trap_Bad_Ops(" ED ", I, CPU_PC.W-4);
+  NEXT_OP;
+#undef OP_GROUP
+
+// ------------------------------------------------------
+// DD prefix (and DDCB)
+// ------------------------------------------------------
+#define XX IX
+#define OP_GROUP dd
+#include "CodesXX.h"
+OPCODE(PFX_FD):
+OPCODE(PFX_DD):
+  CPU_PC.W--;NEXT_OP;
+OPCODE(PFX_CB):
+  /* Get offset, read opcode and count cycles */
+  J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);
+  I=OpZ80(CPU_PC.W++);
+  goto *JumpTableDDCB[I];
+OPCODE(default):
+  if(CPU.TrapBadOps)  Trap_Bad_Ops(" DD ", I, CPU_PC.W-2);
+  NEXT_OP;
+#undef OP_GROUP
+
+#define OP_GROUP ddcb
+#include "CodesXCB.h"
+OPCODE(default):
+  if(CPU.TrapBadOps)  Trap_Bad_Ops("DDCB", I, CPU_PC.W-4);
+  NEXT_OP;
+#undef OP_GROUP
+#undef XX
+
+// ------------------------------------------------------
+// FD prefix (and FDCB)
+// ------------------------------------------------------
+#define XX IY
+#define OP_GROUP fd
+#include "CodesXX.h"
+OPCODE(PFX_FD):
+OPCODE(PFX_DD):
+  CPU_PC.W--;NEXT_OP;
+OPCODE(PFX_CB):
+  /* Get offset, read opcode and count cycles */
+  J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);
+  I=OpZ80(CPU_PC.W++);
+  goto *JumpTableFDCB[I];
+OPCODE(default):
+  if(CPU.TrapBadOps)  Trap_Bad_Ops(" FD ", I, CPU_PC.W-2);
+  NEXT_OP;
+#undef OP_GROUP
+
+#define OP_GROUP fdcb
+#include "CodesXCB.h"
+OPCODE(default):
+  if(CPU.TrapBadOps)  Trap_Bad_Ops("FDCB", I, CPU_PC.W-4);
+  NEXT_OP;
+#undef OP_GROUP
+#undef XX
+
+// Put the switch() flavor of the opcode macros back for anything that follows
+#undef  OPCODE
+#undef  NEXT_OP
+#define OPCODE(Code)    case Code
+#define NEXT_OP         break
@@ -35,6 +35,14 @@ extern const byte PZSTable[256];
 extern const byte PZSHTable_BIT[129];
 extern const word DAATable[2048];
 
+// ---------------------------------------------------------------------------------
+// The Codes*.h opcode bodies are written against these two macros so that they can
+// be compiled either as switch() cases (the default) or as computed-goto labels by
+// the threaded dispatch cores in Z80_a.c (see Z80_THREADED_DISPATCH).
+// ---------------------------------------------------------------------------------
+#define OPCODE(Code)    case Code
+#define NEXT_OP         break
+
 enum Codes
 {
   NOP,      LD_BC_WORD, LD_xBC_A,    INC_BC,     INC_B,      DEC_B,      LD_B_BYTE,   RLCA,       // 0x00
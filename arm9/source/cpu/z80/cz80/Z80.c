@@ -34,65 +34,22 @@ extern Z80 CPU;
 extern u32 debug[];
 extern u32 DX,DY;
 extern u8 zx_128k_mode, portFD;
-static void EI_Enable(void);
 void ResetZ80(Z80 *R);
 
-#define T_INC(X)
-#define PhantomRdZ80(A)
-#define J_ADJ   CPU.TStates -= 5;
-#define R_ADJ   CPU.TStates += 6;
-#define C_ADJ   CPU.TStates += 7;
-
-#define INLINE static inline
-
 /** System-Dependent Stuff ***********************************/
 /** This is system-dependent code put here to speed things  **/
 /** up. It has to stay inlined to be fast.                  **/
 /*************************************************************/
 extern u8 *MemoryMap[4];
 
-typedef u8 (*patchFunc)(void);
-#define PatchLookup ((patchFunc*)0x06860000)
-
-// ------------------------------------------------------
-// These defines and inline functions are to map maximum
-// speed/efficiency onto the memory system we have.
-// ------------------------------------------------------
-extern unsigned char cpu_readport_speccy(register unsigned short Port);
-extern void cpu_writeport_speccy(register unsigned short Port,register unsigned char Value);
-
-// ------------------------------------------------------------------------------
-// This is how we access the Z80 memory. We indirect through the MemoryMap[] to
-// allow for easy mapping by the 128K machines. It's slightly slower than direct
-// RAM access but much faster than having to move around chunks of bank memory.
-//
-// Note that the MemoryMap[] here has each of the 4 segments offset by the
-// segment * 16K. This allows us to not have to mask the Address with 0x3FFF
-// and can instead just index directly knowing that MemoryMap[] has been offset
-// properly when it was setup (e.g. on a 48K machine, each MemoryMap[] segment
-// would point to the start of RAM_Memory[] such that this just turns into a 
-// simple index by the address without having to mask. This buys us 10% speed.
-// ------------------------------------------------------------------------------
-inline byte OpZ80(word A)
-{
-    return MemoryMap[(A)>>14][A];
-}
-
-
-inline byte RdZ80(word A)
-{
-    return MemoryMap[(A)>>14][A];
-}
-
-#define RdZ80_noc   RdZ80 // Nothing unique about a memory read - same as an OpZ80 opcode fetch
-
 // -------------------------------------------------------------------------------------------------------------
 // ZX-Dandanator support is fairly basic - we're not supporting the full set of Dandanator functionality, only
 // enough that we can do basic BANK swapping into the 512K ROM area and some basic handling on resets and
 // disables via the 'special command 40'
 // We use a command settle time of 35 T-States which is borrowed from ZEsarUX and a peek at the PIC code
-// for the dandanator. This seems to work fine for the majority of Dandanator ROMs out there - mainly this is
-// going to be used for Sword of Ianna and maybe Castlevania - Spectral Interlude plus a few compilation carts.
+// for the dandanator - the command is carried out by a CPU event that many T-States after it was given.
+// This seems to work fine for the majority of Dandanator ROMs out there - mainly this is going to be used
+// for Sword of Ianna and maybe Castlevania - Spectral Interlude plus a few compilation carts.
 // -------------------------------------------------------------------------------------------------------------
 
 #define DANDANATOR_COMMAND_TIME  35     // 35 T-States. Value doesn't have to be exact, but some delay must be used.
@@ -105,6 +62,11 @@ u8 dandy_disabled   = 0;
 u8 dandy_locked     = 0;
 u8 dan_counter      = 0;
 u8 dan_state        = 0;    // 0=Idle/Ready, 1=Command/Processing
+u8 dan_settle       = 0;    // Which command is waiting for CPU_EVT_DANDANATOR (DAN_SETTLE_xxx)
+
+#define DAN_SETTLE_NONE     0
+#define DAN_SETTLE_CONFIRM  1   // Command Confirm - cmd, data1 and data2
+#define DAN_SETTLE_COUNT    2   // The write pulses reached the latched command
 
 // -----------------------------------------------------------------------------
 // We use 'rom_special_bank' below to indicate that the Dandanator has control
@@ -133,6 +95,19 @@ void dandanator_switch_banks(u8 bank)
         }
         rom_special_bank = 0;
     }
+    rom_decode_remap();
+}
+
+// ---------------------------------------------------------------------------
+// The Dandanator takes a little while to carry out a command. The CPU keeps
+// running in the meantime (with re-entrancy disabled) and CPU_EVT_DANDANATOR
+// comes due exactly DANDANATOR_COMMAND_TIME T-States after the command write.
+// ---------------------------------------------------------------------------
+static void dandanator_settle_after(u8 settle)
+{
+    dan_settle = settle;
+    dandy_disabled=1;
+    speccy_cpu_event(CPU.TStates + DANDANATOR_COMMAND_TIME, CPU_EVT_DANDANATOR);
 }
 
 __attribute__((noinline)) void dandanator_flash_write(word A, byte value)
@@ -145,36 +120,7 @@ __attribute__((noinline)) void dandanator_flash_write(word A, byte value)
     {
         // Command Confirm
         case 0x00:
-            dandy_disabled=1;
-            ExecZ80_Speccy(CPU.TStates + DANDANATOR_COMMAND_TIME);
-            dandy_disabled=0;
-
-            // --------------------------------------------------------------------
-            // Special command... data1 is the bank to swap in, data2 has some
-            // bits that allow us to disable the dandanator or reset the CPU, etc.
-            // --------------------------------------------------------------------
-            if (dandanator_cmd == 40)
-            {
-                if (dandanator_data1 && (dandanator_data1 <= 33)) dandanator_switch_banks(dandanator_data1); // Bank 35 means 'keep previous bank'
-
-                if (dandanator_data2 & 0x08) dandy_disabled = 1;
-                if (dandanator_data2 & 0x04) dandy_locked = 1;  // We don't handle this yet... we assume programs are well behaved.
-                if (dandanator_data2 & 0x02) IntZ80(&CPU, INT_NMI);
-                if (dandanator_data2 & 0x01) ResetZ80(&CPU);
-            }
-            else if (dandanator_cmd && (dandanator_cmd <= 34))
-            {
-                dandanator_switch_banks(dandanator_cmd);
-            }
-            else if (dandanator_cmd == 36)
-            {
-                ResetZ80(&CPU);
-            }
-            else if (dandanator_cmd == 46)
-            {
-                DY++;  // This command is mainly used to lock/unlock Dandanator access. Not used in emulation.
-            }
-            dan_state = 0;
+            dandanator_settle_after(DAN_SETTLE_CONFIRM);
             break;
 
         // Command
@@ -198,24 +144,7 @@ __attribute__((noinline)) void dandanator_flash_write(word A, byte value)
                 dan_counter++;
                 if ((dandanator_cmd < 40) && (dan_counter == dan_latched_cmd))
                 {
-                    // ---------------------------------------------------------------
-                    // Poor-mans way of handling the delay between the command and
-                    // the dandanator finishing execution - we simply allow the CPU
-                    // to run a few instructions - temporarily disabling re-entrancy.
-                    // ---------------------------------------------------------------
-                    dandy_disabled=1;
-                    ExecZ80_Speccy(CPU.TStates + DANDANATOR_COMMAND_TIME);
-                    dandy_disabled=0;
-
-                    if (dan_latched_cmd && (dan_latched_cmd <= 34))
-                    {
-                        dandanator_switch_banks(dan_latched_cmd);
-                    }
-                    else if (dan_latched_cmd == 36)
-                    {
-                        ResetZ80(&CPU);
-                    }
-                    dan_state = 0;
+                    dandanator_settle_after(DAN_SETTLE_COUNT);
                 }
                 else
                 {
@@ -240,7 +169,57 @@ __attribute__((noinline)) void dandanator_flash_write(word A, byte value)
             dandanator_data2 = value;
             break;
     }
-    
+}
+
+// -----------------------------------------------------------------------------------
+// The command has settled (CPU_EVT_DANDANATOR) - now the Dandanator carries it out.
+// -----------------------------------------------------------------------------------
+void dandanator_settle(void)
+{
+    dandy_disabled=0;
+
+    if (dan_settle == DAN_SETTLE_CONFIRM)
+    {
+        // --------------------------------------------------------------------
+        // Special command... data1 is the bank to swap in, data2 has some
+        // bits that allow us to disable the dandanator or reset the CPU, etc.
+        // --------------------------------------------------------------------
+        if (dandanator_cmd == 40)
+        {
+            if (dandanator_data1 && (dandanator_data1 <= 33)) dandanator_switch_banks(dandanator_data1); // Bank 35 means 'keep previous bank'
+
+            if (dandanator_data2 & 0x08) dandy_disabled = 1;
+            if (dandanator_data2 & 0x04) dandy_locked = 1;  // We don't handle this yet... we assume programs are well behaved.
+            if (dandanator_data2 & 0x02) IntZ80(&CPU, INT_NMI);
+            if (dandanator_data2 & 0x01) ResetZ80(&CPU);
+        }
+        else if (dandanator_cmd && (dandanator_cmd <= 34))
+        {
+            dandanator_switch_banks(dandanator_cmd);
+        }
+        else if (dandanator_cmd == 36)
+        {
+            ResetZ80(&CPU);
+        }
+        else if (dandanator_cmd == 46)
+        {
+            DY++;  // This command is mainly used to lock/unlock Dandanator access. Not used in emulation.
+        }
+    }
+    else if (dan_settle == DAN_SETTLE_COUNT)
+    {
+        if (dan_latched_cmd && (dan_latched_cmd <= 34))
+        {
+            dandanator_switch_banks(dan_latched_cmd);
+        }
+        else if (dan_latched_cmd == 36)
+        {
+            ResetZ80(&CPU);
+        }
+    }
+    dan_state = 0;
+    dan_settle = DAN_SETTLE_NONE;
+
     // If we have disabled the Dandanator... swap back the original Speccy BIOS
     if (dandy_disabled)
     {
@@ -252,173 +231,66 @@ __attribute__((noinline)) void dandanator_flash_write(word A, byte value)
         {
             MemoryMap[0] = SpectrumBios;
         }
+        rom_decode_remap();
     }
 }
 
-// -------------------------------------------------------------------------------------------
-// The only extra protection we have in writes is to ensure we don't write into the ROM area.
-// We support the possibility of a Dandanator ROM which writes to the first few addresses
-// of the ROM space ($0000 to $0003) and that's handled by dandanator_flash_write().
-// -------------------------------------------------------------------------------------------
-static void WrZ80(word A, byte value)   {if (A & 0xC000) MemoryMap[(A)>>14][A] = value; else dandanator_flash_write(A,value);}
-static void WrZ80_fast(word A, byte value)   {MemoryMap[(A)>>14][A] = value;} // For Stack Writes, assume no flash/dandanator handling needed, no ROM write protect
-
-// -------------------------------------------------------------------
-// And these two macros will give us access to the Z80 I/O ports...
-// -------------------------------------------------------------------
-#define OutZ80(P,V)     cpu_writeport_speccy(P,V)
-#define InZ80(P)        cpu_readport_speccy(P)
-
-
-/** Macros for use through the CPU subsystem */
-#define S(Fl)        CPU.AF.B.l|=Fl
-#define R(Fl)        CPU.AF.B.l&=~(Fl)
-#define FLAGS(Rg,Fl) CPU.AF.B.l=Fl|ZSTable[Rg]
-#define INCR(N)      CPU.R++       // Faster to just increment this odd 7-bit RAM Refresh counter here and mask off and OR the high bit back in when asked for in CodesED.h
-
-#define M_RLC(Rg)      \
-  CPU.AF.B.l=Rg>>7;Rg=(Rg<<1)|CPU.AF.B.l;CPU.AF.B.l|=PZSTable[Rg]
-#define M_RRC(Rg)      \
-  CPU.AF.B.l=Rg&0x01;Rg=(Rg>>1)|(CPU.AF.B.l<<7);CPU.AF.B.l|=PZSTable[Rg]
-#define M_RL(Rg)       \
-  if(Rg&0x80)          \
-  {                    \
-    Rg=(Rg<<1)|(CPU.AF.B.l&C_FLAG); \
-    CPU.AF.B.l=PZSTable[Rg]|C_FLAG; \
-  }                    \
-  else                 \
-  {                    \
-    Rg=(Rg<<1)|(CPU.AF.B.l&C_FLAG); \
-    CPU.AF.B.l=PZSTable[Rg];        \
-  }
-#define M_RR(Rg)       \
-  if(Rg&0x01)          \
-  {                    \
-    Rg=(Rg>>1)|(CPU.AF.B.l<<7);     \
-    CPU.AF.B.l=PZSTable[Rg]|C_FLAG; \
-  }                    \
-  else                 \
-  {                    \
-    Rg=(Rg>>1)|(CPU.AF.B.l<<7);     \
-    CPU.AF.B.l=PZSTable[Rg];        \
-  }
+// -----------------------------------------------------------------------------------
+// The T-State the running core stops at (CPU_RunTo in Z80_core.h). ExecZ80 sets it
+// from RunToCycles and speccy_cpu_event() pulls it in when something has to happen
+// sooner than that.
+// -----------------------------------------------------------------------------------
+u32 zx_run_limit __attribute__((section(".dtcm"))) = 0;
 
-#define M_SLA(Rg)      \
-  CPU.AF.B.l=Rg>>7;Rg<<=1;CPU.AF.B.l|=PZSTable[Rg]
-#define M_SRA(Rg)      \
-  CPU.AF.B.l=Rg&C_FLAG;Rg=(Rg>>1)|(Rg&0x80);CPU.AF.B.l|=PZSTable[Rg]
-
-#define M_SLL(Rg)      \
-  CPU.AF.B.l=Rg>>7;Rg=(Rg<<1)|0x01;CPU.AF.B.l|=PZSTable[Rg]
-#define M_SRL(Rg)      \
-  CPU.AF.B.l=Rg&0x01;Rg>>=1;CPU.AF.B.l|=PZSTable[Rg]
-
-#define M_BIT(Bit,Rg)  \
-  CPU.AF.B.l=(CPU.AF.B.l&C_FLAG)|PZSHTable_BIT[Rg&(1<<Bit)]
-
-#define M_SET(Bit,Rg) Rg|=1<<Bit
-#define M_RES(Bit,Rg) Rg&=~(1<<Bit)
-
-#define M_POP(Rg)   CPU.Rg.B.l=RdZ80(CPU.SP.W++);CPU.Rg.B.h=RdZ80(CPU.SP.W++)
-#define M_PUSH(Rg)  WrZ80_fast(--CPU.SP.W,CPU.Rg.B.h);WrZ80_fast(--CPU.SP.W,CPU.Rg.B.l)
-
-#define M_CALL         \
-  J.B.l=RdZ80(CPU.PC.W++);J.B.h=RdZ80(CPU.PC.W++); T_INC(1); \
-  WrZ80_fast(--CPU.SP.W,CPU.PC.B.h);WrZ80_fast(--CPU.SP.W,CPU.PC.B.l); \
-  CPU.PC.W=J.W; \
-  JumpZ80(J.W)
-
-#define M_JP  CPU.PC.W = (u32)RdZ80(CPU.PC.W) | ((u32)RdZ80(CPU.PC.W+1) << 8);
-#define M_JR  CPU.PC.W+=(offset)RdZ80(CPU.PC.W)+1;JumpZ80(CPU.PC.W)
-#define M_RET CPU.PC.B.l=RdZ80(CPU.SP.W++);CPU.PC.B.h=RdZ80(CPU.SP.W++);JumpZ80(CPU.PC.W)
-#define M_RST(Ad)    WrZ80_fast(--CPU.SP.W,CPU.PC.B.h);WrZ80_fast(--CPU.SP.W,CPU.PC.B.l);CPU.PC.W=Ad;JumpZ80(Ad)
-#define M_LDWORD(Rg) CPU.Rg.B.l=RdZ80(CPU.PC.W++);CPU.Rg.B.h=RdZ80(CPU.PC.W++)
-
-#define M_ADD(Rg)      \
-  J.W=CPU.AF.B.h+Rg;    \
-  CPU.AF.B.l=           \
-    (~(CPU.AF.B.h^Rg)&(Rg^J.B.l)&0x80? V_FLAG:0)| \
-    J.B.h|ZSTable[J.B.l]|                        \
-    ((CPU.AF.B.h^Rg^J.B.l)&H_FLAG);               \
-  CPU.AF.B.h=J.B.l
-
-#define M_SUB(Rg)      \
-  J.W=CPU.AF.B.h-Rg;    \
-  CPU.AF.B.l=           \
-    ((CPU.AF.B.h^Rg)&(CPU.AF.B.h^J.B.l)&0x80? V_FLAG:0)| \
-    N_FLAG|-J.B.h|ZSTable[J.B.l]|                      \
-    ((CPU.AF.B.h^Rg^J.B.l)&H_FLAG);                     \
-  CPU.AF.B.h=J.B.l
-
-#define M_ADC(Rg)      \
-  J.W=CPU.AF.B.h+Rg+(CPU.AF.B.l&C_FLAG); \
-  CPU.AF.B.l=                           \
-    (~(CPU.AF.B.h^Rg)&(Rg^J.B.l)&0x80? V_FLAG:0)| \
-    J.B.h|ZSTable[J.B.l]|              \
-    ((CPU.AF.B.h^Rg^J.B.l)&H_FLAG);     \
-  CPU.AF.B.h=J.B.l
-
-#define M_SBC(Rg)      \
-  J.W=CPU.AF.B.h-Rg-(CPU.AF.B.l&C_FLAG); \
-  CPU.AF.B.l=                           \
-    ((CPU.AF.B.h^Rg)&(CPU.AF.B.h^J.B.l)&0x80? V_FLAG:0)| \
-    N_FLAG|-J.B.h|ZSTable[J.B.l]|      \
-    ((CPU.AF.B.h^Rg^J.B.l)&H_FLAG);     \
-  CPU.AF.B.h=J.B.l
-
-#define M_CP(Rg)       \
-  J.W=CPU.AF.B.h-Rg;    \
-  CPU.AF.B.l=           \
-    ((CPU.AF.B.h^Rg)&(CPU.AF.B.h^J.B.l)&0x80? V_FLAG:0)| \
-    N_FLAG|-J.B.h|ZSTable[J.B.l]|                      \
-    ((CPU.AF.B.h^Rg^J.B.l)&H_FLAG)
-
-#define M_AND(Rg) CPU.AF.B.h&=Rg;CPU.AF.B.l=H_FLAG|PZSTable[CPU.AF.B.h]
-#define M_OR(Rg)  CPU.AF.B.h|=Rg;CPU.AF.B.l=PZSTable[CPU.AF.B.h]
-#define M_XOR(Rg) CPU.AF.B.h^=Rg;CPU.AF.B.l=PZSTable[CPU.AF.B.h]
-
-#define M_IN(Rg)        \
-  Rg=InZ80(CPU.BC.W);  \
-  CPU.AF.B.l=PZSTable[Rg]|(CPU.AF.B.l&C_FLAG)
-
-#define M_INC(Rg)       \
-  Rg++;                 \
-  CPU.AF.B.l=(CPU.AF.B.l&C_FLAG)|ZSTable_INC[Rg];
-
-#define M_DEC(Rg)       \
-  Rg--;                 \
-  CPU.AF.B.l= (CPU.AF.B.l&C_FLAG)|ZSTable_DEC[Rg];
-
-#define M_ADDW(Rg1,Rg2) \
-  J.W=(CPU.Rg1.W+CPU.Rg2.W)&0xFFFF;                        \
-  CPU.AF.B.l=                                             \
-    (CPU.AF.B.l&~(H_FLAG|N_FLAG|C_FLAG))|                 \
-    ((CPU.Rg1.W^CPU.Rg2.W^J.W)&0x1000? H_FLAG:0)| (J.B.h & 0x28)| \
-    (((long)CPU.Rg1.W+(long)CPU.Rg2.W)&0x10000? C_FLAG:0); \
-  CPU.Rg1.W=J.W
-
-#define M_ADCW(Rg)      \
-  I=CPU.AF.B.l&C_FLAG;J.W=(CPU.HL.W+CPU.Rg.W+I)&0xFFFF;           \
-  CPU.AF.B.l=                                                   \
-    (((long)CPU.HL.W+(long)CPU.Rg.W+(long)I)&0x10000? C_FLAG:0)| \
-    (~(CPU.HL.W^CPU.Rg.W)&(CPU.Rg.W^J.W)&0x8000? V_FLAG:0)|       \
-    ((CPU.HL.W^CPU.Rg.W^J.W)&0x1000? H_FLAG:0)| (J.B.h & 0x28)| \
-    (J.W? 0:Z_FLAG)|(J.B.h&S_FLAG);                            \
-  CPU.HL.W=J.W
-
-#define M_SBCW(Rg)      \
-  I=CPU.AF.B.l&C_FLAG;J.W=(CPU.HL.W-CPU.Rg.W-I)&0xFFFF;           \
-  CPU.AF.B.l=                                                   \
-    N_FLAG|                                                    \
-    (((long)CPU.HL.W-(long)CPU.Rg.W-(long)I)&0x10000? C_FLAG:0)| \
-    ((CPU.HL.W^CPU.Rg.W)&(CPU.HL.W^J.W)&0x8000? V_FLAG:0)|        \
-    ((CPU.HL.W^CPU.Rg.W^J.W)&0x1000? H_FLAG:0)| (J.B.h & 0x28)| \
-    (J.W? 0:Z_FLAG)|(J.B.h&S_FLAG);                            \
-  CPU.HL.W=J.W
-
-
-
-extern void Trap_Bad_Ops(char *, byte, word);
+// -----------------------------------------------------------------------------------
+// The fast Z80 core - no memory contention and the instruction timing comes from
+// the Cycles[] tables. This is the heart of the system so it goes into fast memory.
+// -----------------------------------------------------------------------------------
+#define CORE_SUFFIX         _Speccy_Fast
+#define CORE_CYCLE_TABLES   1
+#define CORE_CONTENDED      0
+#define CORE_DANDANATOR     1
+#define CORE_STACK_CHECKED  0
+#define CORE_SECTION        ITCM_CODE
+#include "Z80_core.h"
+
+// IntZ80() reads the IM2 vector with the fast core's memory accessors. The PC push
+// takes the ROM-protected write path as a stack that wanders into the lower 16K must
+// not alter the ROM (the accurate cores keep pre-decoded ROM instructions around).
+#define RdZ80       RdZ80_Speccy_Fast
+#define WrZ80_fast  WrZ80_Speccy_Fast
+
+#ifdef Z80_LAZY_FLAGS
+// -----------------------------------------------------------------------------------
+// The pending 8-bit arithmetic op whose flags have not been built yet (see LAZY_xxx in
+// Z80_core.h) packed as Kind<<16 | A<<8 | Operand. Zero when F is already up to date.
+// -----------------------------------------------------------------------------------
+u32 LazyFlags __attribute__((section(".dtcm"))) = 0;
+
+// Build F exactly the way the eager M_ADD/M_ADC/M_SUB/M_SBC/M_CP macros would have. The
+// caller stores it as the core might be holding AF in a local (see CORE_REG_CACHE).
+ITCM_CODE __attribute__((noinline)) byte FlagsEvalZ80(void)
+{
+    register pair J;
+    byte Kind = LazyFlags >> 16;
+    byte A    = LazyFlags >> 8;
+    byte Rg   = LazyFlags;
+
+    LazyFlags = 0;
+    if (Kind <= LAZY_ADC)
+    {
+        J.W=A+Rg+(Kind-LAZY_ADD);
+        return (~(A^Rg)&(Rg^J.B.l)&0x80? V_FLAG:0)|
+               J.B.h|ZSTable[J.B.l]|
+               ((A^Rg^J.B.l)&H_FLAG);
+    }
+
+    J.W=A-Rg-(Kind-LAZY_SUB);
+    return ((A^Rg)&(A^J.B.l)&0x80? V_FLAG:0)|
+           N_FLAG|-J.B.h|ZSTable[J.B.l]|
+           ((A^Rg^J.B.l)&H_FLAG);
+}
+#endif
 
 // ----------------------------------------------------------------------------
 // For when the tape patch no longer applies (memory may have been repurposed).
@@ -429,6 +301,209 @@ void unpatch_DEC_A(void)
     M_DEC(CPU.AF.B.h);
 }
 
+// ------------------------------------------------------------------------------------------
+// Idle loop detection (see IDLE_LOOP() in Z80_core.h). We track the target of the last taken
+// conditional JR along with the T-States and R register at that point so that when we decide
+// a loop is idle we know exactly what one pass around it costs. The counters are per game
+// (cleared in ResetZ80) and shown on the debugger screen to see how often we are skipping.
+// ------------------------------------------------------------------------------------------
+u16 idle_loop_pc        __attribute__((section(".dtcm"))) = 0x0000;
+u8  idle_loop_hits      __attribute__((section(".dtcm"))) = 0;
+u32 idle_loop_tstates   __attribute__((section(".dtcm"))) = 0;
+u32 idle_loop_r         __attribute__((section(".dtcm"))) = 0;
+u32 idle_loop_skips     = 0;   // How many times we fast-forwarded through an idle loop
+u32 idle_loop_cycles    = 0;   // And how many CPU cycles we got to skip because of it
+
+#define IDLE_MAX_OPS    8
+
+#define IDL_A   0x001
+#define IDL_F   0x002
+#define IDL_B   0x004
+#define IDL_C   0x008
+#define IDL_D   0x010
+#define IDL_E   0x020
+#define IDL_H   0x040
+#define IDL_L   0x080
+#define IDL_IX  0x100
+#define IDL_IY  0x200
+#define IDL_HL  (IDL_H|IDL_L)
+
+static const u16 IdleRegs[8] = {IDL_B, IDL_C, IDL_D, IDL_E, IDL_H, IDL_L, IDL_HL, IDL_A}; // Index 6 is (HL)
+
+#define IdlePeek(A) MemoryMap[((word)(A))>>14][(word)(A)]
+#define IdleWord(A) (IdlePeek(A) | (IdlePeek((A)+1) << 8))
+#define IdlePage(A) (1 << (((word)(A))>>14))
+
+// ----------------------------------------------------------------------------------------------
+// Decode one instruction of a possible idle loop. We only accept instructions that read memory
+// or registers and write registers - no memory writes, no I/O, no stack and no flow control. For
+// each we note its length, how many M1 cycles it has and which registers it reads and writes.
+// ALU k is ADD,ADC,SUB,SBC,AND,XOR,OR,CP - only ADC/SBC read the flags and CP doesn't write A.
+// BIT preserves the carry it 'reads' so it counts as only writing the flags. Returns 0 if not OK.
+// The 16K pages of any memory it reads are added to *pages - the address registers hold the
+// same values on every pass (or the loop is turned down anyway) so the ones in CPU now will do.
+// ----------------------------------------------------------------------------------------------
+static u8 IdleDecode(word A, u8 *len, u8 *m1, u16 *rd, u16 *wr, u8 *pages)
+{
+    byte op = IdlePeek(A);
+    u8 k;
+
+    *m1 = 1; *rd = 0; *wr = 0;
+
+    if ((op == 0xDD) || (op == 0xFD))
+    {
+        u16 xx = (op == 0xDD) ? IDL_IX : IDL_IY;
+        *pages |= IdlePage(((op == 0xDD) ? CPU.IX.W : CPU.IY.W) + (offset)IdlePeek(A+2));
+        op = IdlePeek(A+1);
+        *m1 = 2;
+        if (op == 0xCB)                                          // BIT b,(IX+d)
+        {
+            if ((IdlePeek(A+3) & 0xC7) != 0x46) return 0;
+            *len = 4; *rd = xx; *wr = IDL_F;
+            return 1;
+        }
+        if (((op & 0xC7) == 0x46) && (op != 0x76))               // LD r,(IX+d)
+        {
+            *len = 3; *rd = xx; *wr = IdleRegs[(op>>3)&7];
+            return 1;
+        }
+        if ((op & 0xC7) == 0x86)                                 // ALU (IX+d)
+        {
+            k = (op>>3)&7;
+            *len = 3; *rd = xx | IDL_A | ((k==1 || k==3) ? IDL_F:0); *wr = IDL_F | ((k==7) ? 0:IDL_A);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (op == 0xCB)                                              // BIT b,r and BIT b,(HL)
+    {
+        op = IdlePeek(A+1);
+        if ((op & 0xC0) != 0x40) return 0;
+        if ((op & 0x07) == 6) *pages |= IdlePage(CPU.HL.W);
+        *len = 2; *m1 = 2; *rd = IdleRegs[op&7]; *wr = IDL_F;
+        return 1;
+    }
+
+    if ((op >= 0x40) && (op < 0x80))                             // LD r,r' and LD r,(HL)
+    {
+        if ((op == 0x76) || ((op & 0x38) == 0x30)) return 0;     // HALT or LD (HL),r writes memory
+        if ((op & 0x07) == 6) *pages |= IdlePage(CPU.HL.W);
+        *len = 1; *rd = IdleRegs[op&7]; *wr = IdleRegs[(op>>3)&7];
+        return 1;
+    }
+
+    if ((op >= 0x80) && (op < 0xC0))                             // ALU r and ALU (HL)
+    {
+        if ((op & 0x07) == 6) *pages |= IdlePage(CPU.HL.W);
+        k = (op>>3)&7;
+        *len = 1; *rd = IdleRegs[op&7] | IDL_A | ((k==1 || k==3) ? IDL_F:0); *wr = IDL_F | ((k==7) ? 0:IDL_A);
+        return 1;
+    }
+
+    if ((op & 0xC7) == 0xC6)                                     // ALU n
+    {
+        k = (op>>3)&7;
+        *len = 2; *rd = IDL_A | ((k==1 || k==3) ? IDL_F:0); *wr = IDL_F | ((k==7) ? 0:IDL_A);
+        return 1;
+    }
+
+    if (((op & 0xC7) == 0x06) && (op != 0x36))                   // LD r,n
+    {
+        *len = 2; *wr = IdleRegs[(op>>3)&7];
+        return 1;
+    }
+
+    switch (op)
+    {
+        case 0x00: *len = 1; return 1;                                      // NOP
+        case 0x0A: *len = 1; *rd = IDL_B|IDL_C; *wr = IDL_A; *pages |= IdlePage(CPU.BC.W); return 1;   // LD A,(BC)
+        case 0x1A: *len = 1; *rd = IDL_D|IDL_E; *wr = IDL_A; *pages |= IdlePage(CPU.DE.W); return 1;   // LD A,(DE)
+        case 0x3A: *len = 3; *wr = IDL_A; *pages |= IdlePage(IdleWord(A+1)); return 1;                          // LD A,(nn)
+        case 0x2A: *len = 3; *wr = IDL_HL; *pages |= IdlePage(IdleWord(A+1)) | IdlePage(IdleWord(A+1)+1); return 1;     // LD HL,(nn)
+        case 0x01: *len = 3; *wr = IDL_B|IDL_C; return 1;                   // LD BC,nn
+        case 0x11: *len = 3; *wr = IDL_D|IDL_E; return 1;                   // LD DE,nn
+        case 0x21: *len = 3; *wr = IDL_HL; return 1;                        // LD HL,nn
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------------------------
+// Called when a conditional JR at JR_Addr has taken us back to the same PC a few times in a row.
+// If the body of the loop (from the PC up to the JR) only reads memory into registers and every
+// register it writes is written before it is read, then each pass leaves the machine in exactly
+// the same state - only the interrupt routine can break us out. So we do in one go what the CPU
+// would do: as many whole passes as fit before RunToCycles, with R bumped to match. The CPU runs
+// the last pass itself so it stops on the same instruction it would have without the skip.
+// Each pass has to cost exactly what the measured one did, so for the Contended cores every
+// opcode fetch and memory read of the loop must be outside the pages ContendMap[] flags.
+// RunToCycles is the next scheduled event - in the bottom border that's the frame interrupt and
+// anything on the way (e.g. an AY batch) is handled by speccy_run() before we come back here.
+// ----------------------------------------------------------------------------------------------
+void IdleLoopZ80(word JR_Addr, u32 RunToCycles, u8 Contended)
+{
+    u16 rd[IDLE_MAX_OPS+1], wr[IDLE_MAX_OPS+1];
+    u16 loop_wr = 0, written = 0;
+    u8  len, m1, ops = 0, loop_m1 = 1;  // The JR itself is 1 M1 cycle
+    u8  pages = IdlePage(JR_Addr) | IdlePage(JR_Addr + 1);
+    word A = CPU.PC.W;
+
+    idle_loop_hits = 0xFF; // Assume not idle - we park here until the CPU loops somewhere else
+
+    if ((word)(JR_Addr - A) > IDLE_MAX_BYTES) return; // Not a short backwards loop
+
+    while (A != JR_Addr)
+    {
+        if ((ops == IDLE_MAX_OPS) || !IdleDecode(A, &len, &m1, &rd[ops], &wr[ops], &pages)) return;
+        pages |= IdlePage(A) | IdlePage(A + len - 1);
+        loop_wr |= wr[ops++];
+        loop_m1 += m1;
+        A += len;
+        if ((word)(JR_Addr - A) > IDLE_MAX_BYTES) return; // Stepped past the JR
+    }
+
+    rd[ops] = IDL_F; wr[ops++] = 0; // And the JR looks at the flags
+
+    if (Contended)
+    {
+        for (u8 page=0; page<4; page++)
+        {
+            if ((pages & (1 << page)) && ContendMap[page]) return; // A pass could cost more or less next time
+        }
+    }
+
+    for (u8 i=0; i<ops; i++)
+    {
+        if (rd[i] & loop_wr & ~written) return; // Depends on something the previous pass changed
+        written |= wr[i];
+    }
+
+    // -----------------------------------------------------------------------------
+    // It's idle. The last pass must have been a clean one - no interrupt, no frame
+    // reset of the T-States - so we can trust what it cost. Otherwise check again
+    // next time around.
+    // -----------------------------------------------------------------------------
+    u32 pass_cycles = CPU.TStates - idle_loop_tstates;
+    if (((CPU.R - idle_loop_r) != loop_m1) || (pass_cycles == 0) || (pass_cycles > 256))
+    {
+        idle_loop_hits = IDLE_LOOP_TRIGGER-1;
+        return;
+    }
+
+    idle_loop_hits = IDLE_LOOP_TRIGGER; // Keep skipping on each pass
+
+    // Only whole passes that end short of RunToCycles - the CPU finishes the last one itself
+    u32 passes = (CPU.TStates < RunToCycles) ? ((RunToCycles - 1 - CPU.TStates) / pass_cycles) : 0;
+    if (passes)
+    {
+        CPU.TStates += passes * pass_cycles;
+        CPU.R += passes * loop_m1;
+        idle_loop_skips++;
+        idle_loop_cycles += passes * pass_cycles;
+    }
+}
+
 /** ResetZ80() ***********************************************/
 /** This function can be used to reset the register struct  **/
 /** before starting execution with Z80(). It sets the       **/
@@ -460,6 +535,11 @@ void ResetZ80(Z80 *R)
   CPU.TStates_IRequest = 0;
   CPU.TStates = 0;
 
+  idle_loop_pc = 0x0000;
+  idle_loop_hits = 0;
+  idle_loop_skips = 0;
+  idle_loop_cycles = 0;
+
   JumpZ80(CPU.PC.W);
 }
 
@@ -533,147 +613,13 @@ void IntZ80(Z80 *R,word Vector)
 }
 
 
-static void CodesCB_Speccy(void)
-{
-  register byte I;
-
-  /* Read opcode and count cycles */
-  I=OpZ80(CPU.PC.W++);
-  CPU.TStates += CyclesCB[I];
-
-  /* R register incremented on each M1 cycle */
-  INCR(1);
-
-  switch(I)
-  {
-#include "CodesCB.h"
-    default:
-      if(CPU.TrapBadOps)  Trap_Bad_Ops(" CB ", I, CPU.PC.W-2);
-  }
-}
-
-static void CodesDDCB_Speccy(void)
-{
-  register pair J;
-  register byte I;
-
-#define XX IX
-  /* Get offset, read opcode and count cycles */
-  J.W=CPU.XX.W+(offset)OpZ80(CPU.PC.W++);
-  I=OpZ80(CPU.PC.W++);
-  CPU.TStates += CyclesXXCB[I];
-
-  switch(I)
-  {
-#include "CodesXCB.h"
-    default:
-      if(CPU.TrapBadOps)  Trap_Bad_Ops("DDCB", I, CPU.PC.W-4);
-  }
-#undef XX
-}
-
-static void CodesFDCB_Speccy(void)
-{
-  register pair J;
-  register byte I;
-
-#define XX IY
-  /* Get offset, read opcode and count cycles */
-  J.W=CPU.XX.W+(offset)OpZ80(CPU.PC.W++);
-  I=OpZ80(CPU.PC.W++);
-  CPU.TStates += CyclesXXCB[I];
-
-  switch(I)
-  {
-#include "CodesXCB.h"
-    default:
-      if(CPU.TrapBadOps)  Trap_Bad_Ops("FDCB", I, CPU.PC.W-4);
-  }
-#undef XX
-}
-
-ITCM_CODE static void CodesED_Speccy(void)
-{
-  register byte I;
-  register pair J;
-
-  /* Read opcode and count cycles */
-  I=OpZ80(CPU.PC.W++);
-  CPU.TStates += CyclesED[I];
-
-  /* R register incremented on each M1 cycle */
-  INCR(1);
-
-  switch(I)
-  {
-#include "CodesED.h"
-    case PFX_ED:
-      CPU.PC.W--;break;
-    default:
-      if(CPU.TrapBadOps) Trap_Bad_Ops(" ED ", I, CPU.PC.W-4);
-  }
-}
-
-static void CodesDD_Speccy(void)
-{
-  register byte I,K;
-  register pair J;
-
-#define XX IX
-  /* Read opcode and count cycles */
-  I=OpZ80(CPU.PC.W++);
-  CPU.TStates += CyclesXX[I];
-
-  /* R register incremented on each M1 cycle */
-  INCR(1);
-
-  switch(I)
-  {
-#include "CodesXX.h"
-    case PFX_FD:
-    case PFX_DD:
-      CPU.PC.W--;break;
-    case PFX_CB:
-      CodesDDCB_Speccy();break;
-    default:
-      if(CPU.TrapBadOps)  Trap_Bad_Ops(" DD ", I, CPU.PC.W-2);
-  }
-#undef XX
-}
-
-static void CodesFD_Speccy(void)
-{
-  register byte I,K;
-  register pair J;
-
-#define XX IY
-  /* Read opcode and count cycles */
-  I=OpZ80(CPU.PC.W++);
-  CPU.TStates += CyclesXX[I];
-
-  /* R register incremented on each M1 cycle */
-  INCR(1);
-
-  switch(I)
-  {
-#include "CodesXX.h"
-    case PFX_FD:
-    case PFX_DD:
-      CPU.PC.W--;break;
-    case PFX_CB:
-      CodesFDCB_Speccy();break;
-    default:
-        if(CPU.TrapBadOps)  Trap_Bad_Ops(" FD ", I, CPU.PC.W-2);
-  }
-#undef XX
-}
-
 // ------------------------------------------------------------------------
-// The Enable Interrupt is delayed 1 M1 instruction and we must also check
-// to see if we are within the 32 TState period where the ZX Spectrum ULA
-// would hold the Interrupt Request pulse...
+// The Enable Interrupt should be delayed 1 M1 instruction but we avoid
+// this complexity completely and simply check to make sure we are still
+// within the 32 TState period where the ZX Spectrum ULA would hold the
+// Interrupt Request pulse and trigger the interrupt. Shared by all cores.
 // ------------------------------------------------------------------------
-static void EI_Enable(void)
+void EI_Enable(void)
 {
    CPU.IFF=(CPU.IFF&~IFF_EI)|IFF_1;
    if (CPU.IRequest != INT_NONE)
@@ -684,36 +630,24 @@ static void EI_Enable(void)
 }
 
 // -----------------------------------------------------------------------------------
-// The main Z80 instruction loop. We put this 15K chunk into fast memory as we
-// want to make the Z80 run as quickly as possible - this is the heart of the system.
+// The main Z80 entry point. The accurate cores handle contended memory and are used
+// while the ULA is drawing the screen; the fast core handles everything else.
 // -----------------------------------------------------------------------------------
 ITCM_CODE void ExecZ80_Speccy(u32 RunToCycles)
 {
-  if (accurate_emulation)
+  do
   {
-      if (myConfig.machine) return ExecZ80_Speccy_128(RunToCycles);
-      else                  return ExecZ80_Speccy_48(RunToCycles);
-  }
-  
-  register byte I;
-  register pair J;
-
-  while (CPU.TStates < RunToCycles)
-  {
-      I=OpZ80(CPU.PC.W++);
-      CPU.TStates += Cycles[I];
+      // Never run past anything due at an exact T-State (see speccy_cpu_event)
+      u32 RunTo = (cpu_event_next < RunToCycles) ? cpu_event_next : RunToCycles;
 
-      /* R register incremented on each M1 cycle */
-      INCR(1);
-
-      /* Interpret opcode */
-      switch(I)
+      if (accurate_emulation)
       {
-#include "Codes.h"
-        case PFX_CB: CodesCB_Speccy();break;
-        case PFX_ED: CodesED_Speccy();break;
-        case PFX_FD: CodesFD_Speccy();break;
-        case PFX_DD: CodesDD_Speccy();break;
+          if (myConfig.machine) ExecZ80_Speccy_128(RunTo);
+          else                  ExecZ80_Speccy_48(RunTo);
       }
+      else ExecZ80_Speccy_Fast(RunTo);
+
+      if (CPU.TStates >= cpu_event_next) speccy_cpu_events();
   }
+  while (CPU.TStates < RunToCycles);
 }
@@ -113,6 +113,35 @@ typedef struct
 } Z80;
 
 extern u8 accurate_emulation;
+extern u32 idle_loop_skips;     // Per-game count of idle loops we fast-forwarded (see IdleLoopZ80)
+extern u32 idle_loop_cycles;    // And the CPU cycles those skips saved
+
+/** ContendDelay() *******************************************/
+/** Look up the ULA contention delay for the given T-State  **/
+/** without a divide (the ARM946E-S doesn't have one). We   **/
+/** track where the current scanline started and fall back  **/
+/** to the modulo only if the CPU has jumped more than one  **/
+/** scanline ahead (new frame, tape, snapshot load, etc).   **/
+/*************************************************************/
+extern u8  cpu_contended_delay_128[CYCLES_PER_SCANLINE_128];
+extern u8  cpu_contended_delay_48[CYCLES_PER_SCANLINE_48];
+extern u32 contend_line_base_128;
+extern u32 contend_line_base_48;
+
+inline __attribute__((always_inline)) static u8 ContendDelay(const u8 *Table, u32 *LineBase, const u32 Scanline, u32 TStates)
+{
+    u32 pos = TStates - *LineBase;
+    if (pos >= Scanline)
+    {
+        if (pos < (Scanline<<1)) *LineBase += Scanline;              // Just moved onto the next scanline
+        else *LineBase = TStates - (TStates % Scanline);             // Jumped further than that - resync
+        pos = TStates - *LineBase;
+    }
+    return Table[pos];
+}
+
+#define ContendDelay_128(T)  ContendDelay(cpu_contended_delay_128, &contend_line_base_128, CYCLES_PER_SCANLINE_128, (T))
+#define ContendDelay_48(T)   ContendDelay(cpu_contended_delay_48,  &contend_line_base_48,  CYCLES_PER_SCANLINE_48,  (T))
 
 void ExecZ80_Speccy_128(u32 RunToCycles);
 void ExecZ80_Speccy_48(u32 RunToCycles);
@@ -0,0 +1,824 @@
+/******************************************************************************
+*  SpeccySE Z80 CPU
+*
+* Note: Most of this file is from the ColEm emulator core by Marat Fayzullin
+*       but heavily modified for specific NDS use. If you want to use this
+*       code, you are advised to seek out the much more portable ColEm core
+*       and contact Marat.
+*
+******************************************************************************/
+
+/** Z80: portable Z80 emulator *******************************/
+/**                                                         **/
+/**                         Z80_core.h                      **/
+/**                                                         **/
+/** This file contains the Z80 instruction loop. It is      **/
+/** included once per machine variant (from Z80.c and      **/
+/** Z80_a.c) after the variant's traits have been defined.  **/
+/**                                                         **/
+/** Copyright (C) Marat Fayzullin 1994-2021                 **/
+/**     You are not allowed to distribute this software     **/
+/**     commercially. Please, notify me, if you make any    **/
+/**     changes to this file.                               **/
+/*************************************************************/
+
+// -----------------------------------------------------------------------------------------
+// We used to carry three hand-copied Z80 cores (the fast core plus the 48K and 128K accurate
+// cores) which only differed in how memory was accessed and how cycles were counted. Now
+// there is one core and each variant is stamped out from a small set of machine traits that
+// must be defined before including this file. Everything folds at compile time so each
+// instance is just as fast as the hand-copied version was:
+//
+//   CORE_SUFFIX         Appended to the name of every function of this instance
+//                       (e.g. _Speccy_128 gives ExecZ80_Speccy_128)
+//   CORE_CYCLE_TABLES   1 = whole-instruction timing from the Cycles[] tables (fast core)
+//                       0 = timing is accumulated on each memory access (accurate core)
+//   CORE_CONTENDED      1 = apply ULA memory contention for pages flagged in ContendMap[]
+//   CORE_CONTEND_DELAY  Contention delay lookup for a T-State - ContendDelay_48/128
+//   CORE_DANDANATOR     1 = writes into the ROM area go to dandanator_flash_write()
+//   CORE_STACK_CHECKED  1 = stack writes (PUSH/CALL/RST) take the WrZ80() path with the ROM check
+//   CORE_SECTION        Where the main loop lives (ITCM_CODE or empty for main RAM)
+// -----------------------------------------------------------------------------------------
+
+#ifndef Z80_CORE_COMMON
+#define Z80_CORE_COMMON
+
+extern Z80 CPU;
+extern u8 *MemoryMap[4];
+extern u8 ContendMap[4];
+
+typedef u8 (*patchFunc)(void);
+#define PatchLookup ((patchFunc*)0x06860000)
+
+extern void EI_Enable(void);
+extern void Trap_Bad_Ops(char *, byte, word);
+extern void dandanator_flash_write(word A, byte value);
+extern u8 *zx_screen_page;
+extern u32 zx_screen_window;
+extern void zx_screen_write(u8 *Ptr, byte value, u32 tstates);
+extern u32 zx_run_limit;
+
+#ifdef Z80_THREADED_DISPATCH
+// Opcode groups for the pre-decoded ROM instructions (see rom_decode_fill() in Z80_a.c)
+#define ROM_DECODE_OP       1
+#define ROM_DECODE_CB       2
+#define ROM_DECODE_ED       3
+#define ROM_DECODE_DD       4
+#define ROM_DECODE_FD       5
+#define ROM_DECODE_DDCB     6
+#define ROM_DECODE_FDCB     7
+
+extern u32 RomDecode[0x4000];
+extern u32 RomDecodeTag;
+extern u32 rom_decode_fill(word A);
+#endif
+
+// ------------------------------------------------------
+// These defines and inline functions are to map maximum
+// speed/efficiency onto the memory system we have.
+// ------------------------------------------------------
+extern unsigned char cpu_readport_speccy(register unsigned short Port);
+extern void cpu_writeport_speccy(register unsigned short Port,register unsigned char Value);
+
+// ------------------------------------------------------------------------------------
+// Every write into RAM ends up here. Anything landing on the displayed screen is handed
+// to zx_screen_write() so the renderer knows which lines need re-drawing (spectrum.c).
+// The caller passes its own T-States as CPU.TStates is behind in a register cache core
+// (this is too hot a path for a CPU_CALLOUT).
+// ------------------------------------------------------------------------------------
+inline __attribute__((always_inline)) static void RamWrZ80(word A, byte value, u32 TStates)
+{
+    u8 *Ptr = &MemoryMap[(A)>>14][A];
+    if ((u32)(Ptr - zx_screen_page) < zx_screen_window) zx_screen_write(Ptr, value, TStates);
+    else *Ptr = value;
+}
+
+#define CORE_FN__(Name,Suffix)  Name##Suffix
+#define CORE_FN_(Name,Suffix)   CORE_FN__(Name,Suffix)
+#define CORE_FN(Name)           CORE_FN_(Name,CORE_SUFFIX)
+
+// -------------------------------------------------------------------
+// And these two macros will give us access to the Z80 I/O ports...
+// -------------------------------------------------------------------
+#define OutZ80(P,V)     cpu_writeport_speccy(P,V)
+#define InZ80(P)        cpu_readport_speccy(P)
+
+// ---------------------------------------------------------------------------------
+// The opcode bodies name the hot registers through these aliases rather than going
+// to the CPU struct directly. Normally they are just the CPU struct but a core built
+// with the register cache (see CORE_REG_CACHE below) points them at locals instead.
+// CPU_REG() lets the macros that take a register name (M_PUSH(HL), M_ADDW(XX,BC))
+// pick up the alias - XX is expanded to IX/IY first.
+// ---------------------------------------------------------------------------------
+#define CPU_PC          CPU.PC
+#define CPU_AF          CPU.AF
+#define CPU_HL          CPU.HL
+#define CPU_TStates     CPU.TStates
+#define CPU_R           CPU.R
+#define CPU_BC          CPU.BC
+#define CPU_DE          CPU.DE
+#define CPU_IX          CPU.IX
+#define CPU_IY          CPU.IY
+#define CPU_SP          CPU.SP
+
+// Where the CPU stops - ExecZ80 starts with its RunToCycles but anything called out of the
+// core can pull it in by lowering zx_run_limit (see speccy_cpu_event() in spectrum.c).
+#define CPU_RunTo       zx_run_limit
+
+#define CPU_REG_(Rg)    CPU_##Rg
+#define CPU_REG(Rg)     CPU_REG_(Rg)
+
+// Anything outside the core that looks at or changes the CPU struct goes through this
+#define CPU_FLUSH()
+#define CPU_RELOAD()
+#define CPU_CALLOUT(Call)   Call
+
+#ifdef Z80_REG_CACHE
+typedef struct
+{
+  pair PC, AF, HL;
+  u32  TStates, R, RunTo;
+} Z80Regs;
+#endif
+
+// ---------------------------------------------------------------------------------
+// Lazy flags (make Z80_FLAGS=lazy). The 8-bit ADD/ADC/SUB/SBC/CP only record the op
+// and the two operands in LazyFlags and the F register is built by FlagsEvalZ80()
+// the first time anything looks at it. Most of those flags are overwritten without
+// ever being read. Every opcode that reads or partially updates F does a FLAGS_SYNC
+// first and anything that writes all of F just does a FLAGS_DROP of the pending op.
+// The cores sync on the way out so nothing outside the CPU ever sees a stale F.
+// ---------------------------------------------------------------------------------
+#ifdef Z80_LAZY_FLAGS
+#define LAZY_ADD    1   // ADD and ADC with no carry in
+#define LAZY_ADC    2   // ADC with carry in
+#define LAZY_SUB    3   // SUB, CP and SBC with no carry in
+#define LAZY_SBC    4   // SBC with carry in
+
+extern u32 LazyFlags;
+extern byte FlagsEvalZ80(void);
+
+#define FLAGS_SYNC()            if (LazyFlags) CPU_AF.B.l=FlagsEvalZ80()
+#define FLAGS_DROP()            LazyFlags = 0
+#define FLAGS_LAZY(Kind,A,Rg)   LazyFlags = ((Kind) << 16) | ((A) << 8) | (Rg)
+#else
+#define FLAGS_SYNC()
+#define FLAGS_DROP()
+#endif
+
+/** Macros for use through the CPU subsystem */
+#define S(Fl)        FLAGS_SYNC();CPU_AF.B.l|=Fl
+#define R(Fl)        FLAGS_SYNC();CPU_AF.B.l&=~(Fl)
+#define FLAGS(Rg,Fl) FLAGS_DROP();CPU_AF.B.l=Fl|ZSTable[Rg]
+#define INCR(N)      CPU_R++       // Faster to just increment this odd 7-bit RAM Refresh counter here and mask off and OR the high bit back in when asked for in CodesED.h
+
+#define M_RLC(Rg)      \
+  FLAGS_DROP();CPU_AF.B.l=Rg>>7;Rg=(Rg<<1)|CPU_AF.B.l;CPU_AF.B.l|=PZSTable[Rg]
+#define M_RRC(Rg)      \
+  FLAGS_DROP();CPU_AF.B.l=Rg&0x01;Rg=(Rg>>1)|(CPU_AF.B.l<<7);CPU_AF.B.l|=PZSTable[Rg]
+#define M_RL(Rg)       \
+  FLAGS_SYNC();        \
+  if(Rg&0x80)          \
+  {                    \
+    Rg=(Rg<<1)|(CPU_AF.B.l&C_FLAG); \
+    CPU_AF.B.l=PZSTable[Rg]|C_FLAG; \
+  }                    \
+  else                 \
+  {                    \
+    Rg=(Rg<<1)|(CPU_AF.B.l&C_FLAG); \
+    CPU_AF.B.l=PZSTable[Rg];        \
+  }
+#define M_RR(Rg)       \
+  FLAGS_SYNC();        \
+  if(Rg&0x01)          \
+  {                    \
+    Rg=(Rg>>1)|(CPU_AF.B.l<<7);     \
+    CPU_AF.B.l=PZSTable[Rg]|C_FLAG; \
+  }                    \
+  else                 \
+  {                    \
+    Rg=(Rg>>1)|(CPU_AF.B.l<<7);     \
+    CPU_AF.B.l=PZSTable[Rg];        \
+  }
+
+#define M_SLA(Rg)      FLAGS_DROP();CPU_AF.B.l=Rg>>7;Rg<<=1;CPU_AF.B.l|=PZSTable[Rg]
+#define M_SRA(Rg)      FLAGS_DROP();CPU_AF.B.l=Rg&C_FLAG;Rg=(Rg>>1)|(Rg&0x80);CPU_AF.B.l|=PZSTable[Rg]
+
+#define M_SLL(Rg)      FLAGS_DROP();CPU_AF.B.l=Rg>>7;Rg=(Rg<<1)|0x01;CPU_AF.B.l|=PZSTable[Rg]
+#define M_SRL(Rg)      FLAGS_DROP();CPU_AF.B.l=Rg&0x01;Rg>>=1;CPU_AF.B.l|=PZSTable[Rg]
+
+#define M_BIT(Bit,Rg)  FLAGS_SYNC();CPU_AF.B.l=(CPU_AF.B.l&C_FLAG)|PZSHTable_BIT[Rg&(1<<Bit)]
+
+#define M_SET(Bit,Rg)  Rg|=1<<Bit
+#define M_RES(Bit,Rg)  Rg&=~(1<<Bit)
+
+
+#define M_CALL         \
+  J.B.l=RdZ80(CPU_PC.W++);J.B.h=RdZ80(CPU_PC.W++); T_INC(1); \
+  WrZ80_fast(--CPU.SP.W,CPU_PC.B.h);WrZ80_fast(--CPU.SP.W,CPU_PC.B.l); \
+  CPU_PC.W=J.W; \
+  JumpZ80(J.W)
+
+#define M_JP         CPU_PC.W = (u32)RdZ80(CPU_PC.W) | ((u32)RdZ80(CPU_PC.W+1) << 8);
+#define M_JR         CPU_PC.W+=(offset)RdZ80(CPU_PC.W)+1;JumpZ80(CPU_PC.W)
+
+#define M_RET        CPU_PC.B.l=RdZ80(CPU.SP.W++);CPU_PC.B.h=RdZ80_noc(CPU.SP.W++);JumpZ80(CPU_PC.W) // TBD: HACK!! Remove noc() when fixed.
+#define M_POP(Rg)    CPU_REG(Rg).B.l=RdZ80(CPU.SP.W++);CPU_REG(Rg).B.h=RdZ80_noc(CPU.SP.W++);                  // TBD: HACK!! Remove noc() when fixed.
+
+#define M_PUSH(Rg)   WrZ80_fast(--CPU.SP.W,CPU_REG(Rg).B.h);WrZ80_fast(--CPU.SP.W,CPU_REG(Rg).B.l)
+#define M_RST(Ad)    WrZ80_fast(--CPU.SP.W,CPU_PC.B.h);WrZ80_fast(--CPU.SP.W,CPU_PC.B.l);CPU_PC.W=Ad;JumpZ80(Ad)
+
+// ------------------------------------------------------------------------------------------
+// Idle loop detection. Many games wait for the next frame by spinning on a memory location the
+// interrupt routine changes (e.g. LD A,(23672) / CP B / JR Z,loop). Every taken conditional JR
+// back a few bytes to the same spot bumps a hit counter and once we've seen it go around a few
+// times we let IdleLoopZ80() take a look - if it's a side-effect-free spin it fast-forwards us
+// through whole passes up to the run limit (the next scheduled event). If it isn't, the hit
+// counter is parked above the trigger until the CPU loops somewhere else. The backwards test
+// is done on values already in registers so any other taken JR costs one compare, and the
+// pass timing is only stored once the same loop has come around again.
+// ------------------------------------------------------------------------------------------
+#define IDLE_LOOP_TRIGGER   3
+#define IDLE_MAX_BYTES      16      // The spin loops we look for are tiny - anything bigger is real work
+
+extern u16 idle_loop_pc;
+extern u8  idle_loop_hits;
+extern u32 idle_loop_tstates;
+extern u32 idle_loop_r;
+extern void IdleLoopZ80(word JR_Addr, u32 RunToCycles, u8 Contended);
+
+#define IDLE_LOOP_TRACK(JR_Addr)                                                            \
+  if ((word)((JR_Addr) - CPU_PC.W) <= IDLE_MAX_BYTES)                                       \
+  {                                                                                         \
+    if (CPU_PC.W != idle_loop_pc) { idle_loop_pc = CPU_PC.W; idle_loop_hits = 0; }          \
+    else if (idle_loop_hits <= IDLE_LOOP_TRIGGER)                                           \
+    {                                                                                       \
+      if (idle_loop_hits == IDLE_LOOP_TRIGGER) CPU_CALLOUT(IdleLoopZ80(JR_Addr, CPU_RunTo, CORE_CONTENDED)); \
+      else idle_loop_hits++;                                                                \
+      idle_loop_tstates = CPU_TStates; idle_loop_r = CPU_R;                                 \
+    }                                                                                       \
+  }
+
+#define M_LDWORD(Rg) CPU_REG(Rg).B.l=RdZ80(CPU_PC.W++);CPU_REG(Rg).B.h=RdZ80(CPU_PC.W++)
+
+#ifdef Z80_LAZY_FLAGS
+#define M_ADD(Rg)      \
+  FLAGS_LAZY(LAZY_ADD,CPU_AF.B.h,Rg); \
+  CPU_AF.B.h+=Rg
+
+#define M_SUB(Rg)      \
+  FLAGS_LAZY(LAZY_SUB,CPU_AF.B.h,Rg); \
+  CPU_AF.B.h-=Rg
+
+#define M_ADC(Rg)      \
+  FLAGS_SYNC();        \
+  FLAGS_LAZY(LAZY_ADD+(CPU_AF.B.l&C_FLAG),CPU_AF.B.h,Rg); \
+  CPU_AF.B.h+=Rg+(CPU_AF.B.l&C_FLAG)
+
+#define M_SBC(Rg)      \
+  FLAGS_SYNC();        \
+  FLAGS_LAZY(LAZY_SUB+(CPU_AF.B.l&C_FLAG),CPU_AF.B.h,Rg); \
+  CPU_AF.B.h-=Rg+(CPU_AF.B.l&C_FLAG)
+
+#define M_CP(Rg)       \
+  FLAGS_LAZY(LAZY_SUB,CPU_AF.B.h,Rg)
+
+#else
+#define M_ADD(Rg)      \
+  J.W=CPU_AF.B.h+Rg;    \
+  CPU_AF.B.l=           \
+    (~(CPU_AF.B.h^Rg)&(Rg^J.B.l)&0x80? V_FLAG:0)| \
+    J.B.h|ZSTable[J.B.l]|                        \
+    ((CPU_AF.B.h^Rg^J.B.l)&H_FLAG);               \
+  CPU_AF.B.h=J.B.l
+
+#define M_SUB(Rg)      \
+  J.W=CPU_AF.B.h-Rg;    \
+  CPU_AF.B.l=           \
+    ((CPU_AF.B.h^Rg)&(CPU_AF.B.h^J.B.l)&0x80? V_FLAG:0)| \
+    N_FLAG|-J.B.h|ZSTable[J.B.l]|                      \
+    ((CPU_AF.B.h^Rg^J.B.l)&H_FLAG);                     \
+  CPU_AF.B.h=J.B.l
+
+#define M_ADC(Rg)      \
+  J.W=CPU_AF.B.h+Rg+(CPU_AF.B.l&C_FLAG); \
+  CPU_AF.B.l=                           \
+    (~(CPU_AF.B.h^Rg)&(Rg^J.B.l)&0x80? V_FLAG:0)| \
+    J.B.h|ZSTable[J.B.l]|              \
+    ((CPU_AF.B.h^Rg^J.B.l)&H_FLAG);     \
+  CPU_AF.B.h=J.B.l
+
+#define M_SBC(Rg)      \
+  J.W=CPU_AF.B.h-Rg-(CPU_AF.B.l&C_FLAG); \
+  CPU_AF.B.l=                           \
+    ((CPU_AF.B.h^Rg)&(CPU_AF.B.h^J.B.l)&0x80? V_FLAG:0)| \
+    N_FLAG|-J.B.h|ZSTable[J.B.l]|      \
+    ((CPU_AF.B.h^Rg^J.B.l)&H_FLAG);     \
+  CPU_AF.B.h=J.B.l
+
+#define M_CP(Rg)       \
+  J.W=CPU_AF.B.h-Rg;    \
+  CPU_AF.B.l=           \
+    ((CPU_AF.B.h^Rg)&(CPU_AF.B.h^J.B.l)&0x80? V_FLAG:0)| \
+    N_FLAG|-J.B.h|ZSTable[J.B.l]|                      \
+    ((CPU_AF.B.h^Rg^J.B.l)&H_FLAG)
+#endif
+
+#define M_AND(Rg) FLAGS_DROP();CPU_AF.B.h&=Rg;CPU_AF.B.l=H_FLAG|PZSTable[CPU_AF.B.h]
+#define M_OR(Rg)  FLAGS_DROP();CPU_AF.B.h|=Rg;CPU_AF.B.l=PZSTable[CPU_AF.B.h]
+#define M_XOR(Rg) FLAGS_DROP();CPU_AF.B.h^=Rg;CPU_AF.B.l=PZSTable[CPU_AF.B.h]
+
+#define M_IN(Rg)        \
+  FLAGS_SYNC();         \
+  Rg=InZ80(CPU.BC.W);  \
+  CPU_AF.B.l=PZSTable[Rg]|(CPU_AF.B.l&C_FLAG)
+
+#define M_INC(Rg)       \
+  FLAGS_SYNC();         \
+  Rg++;                 \
+  CPU_AF.B.l=(CPU_AF.B.l&C_FLAG)|ZSTable_INC[Rg];
+
+#define M_DEC(Rg)       \
+  FLAGS_SYNC();         \
+  Rg--;                 \
+  CPU_AF.B.l= (CPU_AF.B.l&C_FLAG)|ZSTable_DEC[Rg];
+
+#define M_ADDW(Rg1,Rg2) \
+  FLAGS_SYNC();         \
+  J.W=(CPU_REG(Rg1).W+CPU_REG(Rg2).W)&0xFFFF;                        \
+  CPU_AF.B.l=                                             \
+    (CPU_AF.B.l&~(H_FLAG|N_FLAG|C_FLAG))|                 \
+    ((CPU_REG(Rg1).W^CPU_REG(Rg2).W^J.W)&0x1000? H_FLAG:0)| (J.B.h & 0x28)| \
+    (((long)CPU_REG(Rg1).W+(long)CPU_REG(Rg2).W)&0x10000? C_FLAG:0); \
+  CPU_REG(Rg1).W=J.W
+
+#define M_ADCW(Rg)      \
+  FLAGS_SYNC();         \
+  I=CPU_AF.B.l&C_FLAG;J.W=(CPU_HL.W+CPU_REG(Rg).W+I)&0xFFFF;           \
+  CPU_AF.B.l=                                                   \
+    (((long)CPU_HL.W+(long)CPU_REG(Rg).W+(long)I)&0x10000? C_FLAG:0)| \
+    (~(CPU_HL.W^CPU_REG(Rg).W)&(CPU_REG(Rg).W^J.W)&0x8000? V_FLAG:0)|       \
+    ((CPU_HL.W^CPU_REG(Rg).W^J.W)&0x1000? H_FLAG:0)| (J.B.h & 0x28)| \
+    (J.W? 0:Z_FLAG)|(J.B.h&S_FLAG);                            \
+  CPU_HL.W=J.W
+
+#define M_SBCW(Rg)      \
+  FLAGS_SYNC();         \
+  I=CPU_AF.B.l&C_FLAG;J.W=(CPU_HL.W-CPU_REG(Rg).W-I)&0xFFFF;           \
+  CPU_AF.B.l=                                                   \
+    N_FLAG|                                                    \
+    (((long)CPU_HL.W-(long)CPU_REG(Rg).W-(long)I)&0x10000? C_FLAG:0)| \
+    ((CPU_HL.W^CPU_REG(Rg).W)&(CPU_HL.W^J.W)&0x8000? V_FLAG:0)|        \
+    ((CPU_HL.W^CPU_REG(Rg).W^J.W)&0x1000? H_FLAG:0)| (J.B.h & 0x28)| \
+    (J.W? 0:Z_FLAG)|(J.B.h&S_FLAG);                            \
+  CPU_HL.W=J.W
+
+#endif // Z80_CORE_COMMON
+
+
+// -----------------------------------------------------------------------
+// Everything below is stamped out once per instance. The accessor names
+// used by the Codes*.h bodies map onto this instance's own functions.
+// -----------------------------------------------------------------------
+#if defined(Z80_REG_CACHE) && defined(Z80_THREADED_DISPATCH) && !CORE_CYCLE_TABLES
+#define CORE_REG_CACHE  1
+#else
+#define CORE_REG_CACHE  0
+#endif
+
+#if CORE_REG_CACHE
+// ------------------------------------------------------------------------------------------
+// Register cache (make Z80_REGS=cached). The threaded core is one big function so it can keep
+// the registers touched by nearly every opcode - PC, AF, HL, R and the T-States - in locals
+// that the compiler is free to hold in ARM registers, rather than loading and storing the CPU
+// struct each time. The memory accessors are always inlined and are handed the same locals.
+//
+// The contract: the CPU struct is only up to date across a CPU_FLUSH() and anything changed
+// there is only picked up by a CPU_RELOAD(). ExecZ80 reloads on entry and flushes on exit,
+// and every call out of the core that might look at or change the CPU is made through
+// CPU_CALLOUT() which does both - the port handlers (they read the T-States), the tape
+// patches, EI_Enable() (can run IntZ80), IdleLoopZ80() and dandanator_flash_write() (can
+// pull in zx_run_limit). The lazy flags are built into the cached F as FlagsEvalZ80() returns
+// it. A new call out of the core that is not made through CPU_CALLOUT() sees stale registers.
+// ------------------------------------------------------------------------------------------
+#pragma push_macro("CPU_PC")
+#pragma push_macro("CPU_AF")
+#pragma push_macro("CPU_HL")
+#pragma push_macro("CPU_TStates")
+#pragma push_macro("CPU_R")
+#pragma push_macro("CPU_RunTo")
+#pragma push_macro("CPU_FLUSH")
+#pragma push_macro("CPU_RELOAD")
+#pragma push_macro("CPU_CALLOUT")
+#pragma push_macro("InZ80")
+#pragma push_macro("OutZ80")
+#undef  CPU_PC
+#undef  CPU_AF
+#undef  CPU_HL
+#undef  CPU_TStates
+#undef  CPU_R
+#undef  CPU_RunTo
+#undef  CPU_FLUSH
+#undef  CPU_RELOAD
+#undef  CPU_CALLOUT
+#undef  InZ80
+#undef  OutZ80
+#define CPU_PC          Regs->PC
+#define CPU_AF          Regs->AF
+#define CPU_HL          Regs->HL
+#define CPU_TStates     Regs->TStates
+#define CPU_R           Regs->R
+#define CPU_RunTo       Regs->RunTo
+#define CPU_FLUSH()     CPU.PC=Regs->PC;CPU.AF=Regs->AF;CPU.HL=Regs->HL;CPU.TStates=Regs->TStates;CPU.R=Regs->R
+#define CPU_RELOAD()    Regs->PC=CPU.PC;Regs->AF=CPU.AF;Regs->HL=CPU.HL;Regs->TStates=CPU.TStates;Regs->R=CPU.R;Regs->RunTo=zx_run_limit
+#define CPU_CALLOUT(Call)   do { CPU_FLUSH(); Call; CPU_RELOAD(); } while (0)
+#define OutZ80(P,V)     CPU_CALLOUT(cpu_writeport_speccy(P,V))
+#define InZ80(P)        ({ byte InV; CPU_CALLOUT(InV=cpu_readport_speccy(P)); InV; })
+#define CORE_REGS       , Z80Regs *Regs
+#define CORE_REGS_ARG   , Regs
+#else
+#define CORE_REGS
+#define CORE_REGS_ARG
+#endif
+
+#define ContendMemory   CORE_FN(ContendMemory)
+#define OpZ80(A)        CORE_FN(OpZ80)((A) CORE_REGS_ARG)
+#define RdZ80(A)        CORE_FN(RdZ80)((A) CORE_REGS_ARG)
+#define RdZ80_noc(A)    CORE_FN(RdZ80_noc)((A) CORE_REGS_ARG)
+#define WrZ80(A,V)      CORE_FN(WrZ80)((A),(V) CORE_REGS_ARG)
+#define WrZ80_fast(A,V) CORE_FN(WrZ80_fast)((A),(V) CORE_REGS_ARG)
+
+#if CORE_CYCLE_TABLES
+// ----------------------------------------------------------------------------
+// The Cycles[] tables hold the full instruction time and assume conditional
+// jumps are taken (and returns are not) so we compensate when that's not so.
+// ----------------------------------------------------------------------------
+#define T_INC(X)
+#define J_ADJ               CPU_TStates -= 5;
+#define R_ADJ               CPU_TStates += 6;
+#define C_ADJ               CPU_TStates += 7;
+#define PhantomRdZ80(A)
+#define OP_CYCLES(Table)    CPU_TStates += Table[I]
+#define MEM_CYCLES(X)
+#else
+// ----------------------------------------------------------------------------
+// Cycles are accumulated as we go - every opcode fetch, memory read and
+// memory write adds its own time (and contention) and T_INC() adds the rest.
+// ----------------------------------------------------------------------------
+#define T_INC(X)            CPU_TStates +=(X);
+#define J_ADJ
+#define R_ADJ
+#define C_ADJ
+#define PhantomRdZ80(A)     RdZ80(A)
+#define OP_CYCLES(Table)
+#define MEM_CYCLES(X)       CPU_TStates += (X);
+#endif
+
+#if CORE_CONTENDED
+// ------------------------------------------------------------------------------------------
+// This happens only 5-10% of the time so we don't inline to provide better ARM code density
+// ------------------------------------------------------------------------------------------
+ITCM_CODE __attribute__((noinline)) static u32 ContendMemory(u32 TStates)
+{
+    return TStates + CORE_CONTEND_DELAY(TStates);
+}
+#define CONTEND(A)          if (ContendMap[(A)>>14]) CPU_TStates = ContendMemory(CPU_TStates);
+#else
+#define CONTEND(A)
+#endif
+
+// ---------------------------------------------------------------------------------------
+// Every core looks for idle loops. With ULA contention a pass costs more or less depending
+// on where in the line it falls, so the contended cores only get to skip a loop that runs
+// and reads entirely outside the contended pages (IdleLoopZ80 checks). Z80_NO_IDLE_LOOP
+// leaves them all out - the host tests (tests/z80_idle.c) build it to check the skips by.
+// ---------------------------------------------------------------------------------------
+#ifdef Z80_NO_IDLE_LOOP
+#define IDLE_LOOP(JR_Addr)
+#else
+#define IDLE_LOOP(JR_Addr)  IDLE_LOOP_TRACK(JR_Addr)
+#endif
+
+// ------------------------------------------------------------------------------
+// This is how we access the Z80 memory. We indirect through the MemoryMap[] to
+// allow for easy mapping by the 128K machines. It's slightly slower than direct
+// RAM access but much faster than having to move around chunks of bank memory.
+//
+// Note that the MemoryMap[] here has each of the 4 segments offset by the
+// segment * 16K. This allows us to not have to mask the Address with 0x3FFF
+// and can instead just index directly knowing that MemoryMap[] has been offset
+// properly when it was setup (e.g. on a 48K machine, each MemoryMap[] segment
+// would point to the start of RAM_Memory[] such that this just turns into a
+// simple index by the address without having to mask. This buys us 10% speed.
+// ------------------------------------------------------------------------------
+inline __attribute__((always_inline)) static byte CORE_FN(OpZ80)(word A CORE_REGS)
+{
+    CONTEND(A)
+    MEM_CYCLES(4)  // OpCode reads and process are 4 cycles
+    return MemoryMap[(A)>>14][A];
+}
+
+inline __attribute__((always_inline)) static byte CORE_FN(RdZ80)(word A CORE_REGS)
+{
+    CONTEND(A)
+    MEM_CYCLES(3)  // Memory reads are 3 cycles
+    return MemoryMap[(A)>>14][A];
+}
+
+inline __attribute__((always_inline)) static byte CORE_FN(RdZ80_noc)(word A CORE_REGS)
+{
+    MEM_CYCLES(3)  // Memory reads are 3 cycles
+    return MemoryMap[(A)>>14][A];
+}
+
+// -------------------------------------------------------------------------------------------
+// The only extra protection we have in writes is to ensure we don't write into the ROM area.
+// We support the possibility of a Dandanator ROM which writes to the first few addresses
+// of the ROM space ($0000 to $0003) and that's handled by dandanator_flash_write().
+// -------------------------------------------------------------------------------------------
+inline __attribute__((always_inline)) static void CORE_FN(WrZ80)(word A, byte value CORE_REGS)
+{
+    if (A & 0xC000)
+    {
+        CONTEND(A)
+        RamWrZ80(A, value, CPU_TStates);
+    }
+#if CORE_DANDANATOR
+    else CPU_CALLOUT(dandanator_flash_write(A,value));
+#endif
+
+    MEM_CYCLES(3)  // Memory writes are 3 cycles
+}
+
+// ----------------------------------------------------------------------------------
+// For Stack Writes, we are assuming there would be no possibility of a write into the
+// ROM area (otherwise something really bad has happened) unless CORE_STACK_CHECKED
+// says to take the normal write path.
+// ----------------------------------------------------------------------------------
+inline __attribute__((always_inline)) static void CORE_FN(WrZ80_fast)(word A, byte value CORE_REGS)
+{
+#if CORE_STACK_CHECKED
+    WrZ80(A, value);
+#else
+    CONTEND(A)
+    RamWrZ80(A, value, CPU_TStates);
+    MEM_CYCLES(3)  // Memory writes are 3 cycles
+#endif
+}
+
+// ------------------------------------------------------------------------------------------
+// The repeating block instructions (LDIR, LDDR, CPIR, INIR and OTIR) rewind the PC by 2 and
+// let the main loop fetch them all over again for every byte. Instead we loop the body right
+// inside the one dispatch - doing the very same ED prefix and opcode fetch the main loop
+// would (so contention, T-States and the R register all come out identical). We only keep
+// going while we are short of CPU_RunTo and the instruction is still sitting untouched at
+// the PC (the block might have overwritten itself or an OUT might have paged the bank out).
+// The _WR flavor also stops before the next write lands in the ROM/Dandanator area as the
+// flash handler can page the ROM and schedule the command to settle.
+// ------------------------------------------------------------------------------------------
+#if CORE_CYCLE_TABLES
+#define BLOCK_CYCLES(Code)  CPU_TStates += Cycles[PFX_ED] + CyclesED[Code]
+#else
+#define BLOCK_CYCLES(Code)  (void)0
+#endif
+
+// Z80_NO_BLOCK_AGAIN gives back the one repeat per dispatch core - the host tests
+// (tests/z80_block.c) build it that way to check the looped version against.
+#ifdef Z80_NO_BLOCK_AGAIN
+#define BLOCK_AGAIN(Code,Repeat)  0
+#else
+#define BLOCK_AGAIN(Code,Repeat)                                                \
+  ((Repeat) && (CPU_TStates < CPU_RunTo) &&                                   \
+   (MemoryMap[CPU_PC.W>>14][CPU_PC.W] == PFX_ED) &&                             \
+   (MemoryMap[(word)(CPU_PC.W+1)>>14][(word)(CPU_PC.W+1)] == (Code)) &&         \
+   (OpZ80(CPU_PC.W++), BLOCK_CYCLES(Code), INCR(1), OpZ80(CPU_PC.W++), INCR(1), 1))
+#endif
+
+#define BLOCK_AGAIN_WR(Code,Repeat,A) BLOCK_AGAIN(Code,(Repeat) && ((A) & 0xC000))
+
+#if defined(Z80_THREADED_DISPATCH) && !CORE_CYCLE_TABLES
+
+// -----------------------------------------------------------------------------------
+// The main Z80 instruction loop - threaded dispatch flavor (see ExecThreaded.h).
+// -----------------------------------------------------------------------------------
+CORE_SECTION void CORE_FN(ExecZ80)(u32 RunToCycles)
+{
+  zx_run_limit = RunToCycles;
+#if CORE_REG_CACHE
+  Z80Regs Cache, *Regs = &Cache;
+  CPU_RELOAD();
+#endif
+#include "ExecThreaded.h"
+}
+
+#else
+
+static void CORE_FN(CodesCB)(void)
+{
+  register byte I;
+
+  /* Read opcode and count cycles */
+  I=OpZ80(CPU_PC.W++);
+  OP_CYCLES(CyclesCB);
+
+  /* R register incremented on each M1 cycle */
+  INCR(1);
+
+  // Every one of the 256 CB opcodes has a case - nothing can be a bad op here
+  switch(I)
+  {
+#include "CodesCB.h"
+  }
+}
+
+static void CORE_FN(CodesDDCB)(void)
+{
+  register pair J;
+  register byte I;
+
+#define XX IX
+  /* Get offset, read opcode and count cycles */
+  J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);
+  I=OpZ80(CPU_PC.W++);
+  OP_CYCLES(CyclesXXCB);
+
+  switch(I)
+  {
+#include "CodesXCB.h"
+    default:
+      if(CPU.TrapBadOps)  Trap_Bad_Ops("DDCB", I, CPU_PC.W-4);
+  }
+#undef XX
+}
+
+static void CORE_FN(CodesFDCB)(void)
+{
+  register pair J;
+  register byte I;
+
+#define XX IY
+  /* Get offset, read opcode and count cycles */
+  J.W=CPU.XX.W+(offset)RdZ80(CPU_PC.W++);
+  I=OpZ80(CPU_PC.W++);
+  OP_CYCLES(CyclesXXCB);
+
+  switch(I)
+  {
+#include "CodesXCB.h"
+    default:
+      if(CPU.TrapBadOps)  Trap_Bad_Ops("FDCB", I, CPU_PC.W-4);
+  }
+#undef XX
+}
+
+CORE_SECTION static void CORE_FN(CodesED)(void)
+{
+  register byte I;
+  register pair J;
+
+  /* Read opcode and count cycles */
+  I=OpZ80(CPU_PC.W++);
+  OP_CYCLES(CyclesED);
+
+  /* R register incremented on each M1 cycle */
+  INCR(1);
+
+  switch(I)
+  {
+#include "CodesED.h"
+    case PFX_ED:
+      CPU_PC.W--;break;
+    default:
+      if(CPU.TrapBadOps) Trap_Bad_Ops(" ED ", I, CPU_PC.W-4);
+  }
+}
+
+static void CORE_FN(CodesDD)(void)
+{
+  register byte I,K;
+  register pair J;
+
+#define XX IX
+  /* Read opcode and count cycles */
+  I=OpZ80(CPU_PC.W++);
+  OP_CYCLES(CyclesXX);
+
+  /* R register incremented on each M1 cycle */
+  INCR(1);
+
+  switch(I)
+  {
+#include "CodesXX.h"
+    case PFX_FD:
+    case PFX_DD:
+      CPU_PC.W--;break;
+    case PFX_CB:
+      CORE_FN(CodesDDCB)();break;
+    default:
+      if(CPU.TrapBadOps)  Trap_Bad_Ops(" DD ", I, CPU_PC.W-2);
+  }
+#undef XX
+}
+
+static void CORE_FN(CodesFD)(void)
+{
+  register byte I,K;
+  register pair J;
+
+#define XX IY
+  /* Read opcode and count cycles */
+  I=OpZ80(CPU_PC.W++);
+  OP_CYCLES(CyclesXX);
+
+  /* R register incremented on each M1 cycle */
+  INCR(1);
+
+  switch(I)
+  {
+#include "CodesXX.h"
+    case PFX_FD:
+    case PFX_DD:
+      CPU_PC.W--;break;
+    case PFX_CB:
+      CORE_FN(CodesFDCB)();break;
+    default:
+        if(CPU.TrapBadOps)  Trap_Bad_Ops(" FD ", I, CPU_PC.W-2);
+  }
+#undef XX
+}
+
+// -----------------------------------------------------------------------------------
+// The main Z80 instruction loop. This is the heart of the system so the fast core
+// puts this chunk into ITCM fast memory via CORE_SECTION.
+// -----------------------------------------------------------------------------------
+CORE_SECTION void CORE_FN(ExecZ80)(u32 RunToCycles)
+{
+  register byte I;
+  register pair J;
+
+  zx_run_limit = RunToCycles;
+  while (CPU_TStates < CPU_RunTo)
+  {
+      I=OpZ80(CPU_PC.W++);
+      OP_CYCLES(Cycles);
+
+      /* R register incremented on each M1 cycle */
+      INCR(1);
+
+      /* Interpret opcode */
+      switch(I)
+      {
+#include "Codes.h"
+        case PFX_CB: CORE_FN(CodesCB)();break;
+        case PFX_ED: CORE_FN(CodesED)();break;
+        case PFX_FD: CORE_FN(CodesFD)();break;
+        case PFX_DD: CORE_FN(CodesDD)();break;
+      }
+  }
+  FLAGS_SYNC();
+}
+
+#endif // Z80_THREADED_DISPATCH
+
+// The traits and accessor names only describe this one instance...
+#if CORE_REG_CACHE
+#pragma pop_macro("CPU_PC")
+#pragma pop_macro("CPU_AF")
+#pragma pop_macro("CPU_HL")
+#pragma pop_macro("CPU_TStates")
+#pragma pop_macro("CPU_R")
+#pragma pop_macro("CPU_RunTo")
+#pragma pop_macro("CPU_FLUSH")
+#pragma pop_macro("CPU_RELOAD")
+#pragma pop_macro("CPU_CALLOUT")
+#pragma pop_macro("InZ80")
+#pragma pop_macro("OutZ80")
+#endif
+#undef CORE_REG_CACHE
+#undef CORE_REGS
+#undef CORE_REGS_ARG
+#undef ContendMemory
+#undef OpZ80
+#undef RdZ80
+#undef RdZ80_noc
+#undef WrZ80
+#undef WrZ80_fast
+#undef T_INC
+#undef J_ADJ
+#undef R_ADJ
+#undef C_ADJ
+#undef PhantomRdZ80
+#undef OP_CYCLES
+#undef MEM_CYCLES
+#undef CONTEND
+#undef IDLE_LOOP
+#undef BLOCK_CYCLES
+#undef BLOCK_AGAIN
+#undef BLOCK_AGAIN_WR
+#undef CORE_SUFFIX
+#undef CORE_CYCLE_TABLES
+#undef CORE_CONTENDED
+#undef CORE_CONTEND_DELAY
+#undef CORE_DANDANATOR
+#undef CORE_STACK_CHECKED
+#undef CORE_SECTION
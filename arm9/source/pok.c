@@ -105,6 +105,7 @@ void pok_apply(u8 sel)
             }
         }
     }
+    zx_screen_dirty_all(); // In case any of the pokes landed on the screen
 }
 
 u8 num_pokes = 0;
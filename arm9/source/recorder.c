@@ -0,0 +1,255 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#include <nds.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fat.h>
+
+#include "SpeccySE.h"
+#include "SpeccyUtils.h"
+#include "recorder.h"
+#include "printf.h"
+
+#include "lzav.h"
+
+// ------------------------------------------------------------------------------------------
+// Gameplay recorder. Rather than video, we record what the Spectrum itself would need to draw
+// the picture - the 6912 bytes of screen memory each frame plus the border color, the ULA+
+// palette and the Timex screen mode (only when they change) - along with the mixed audio
+// samples for that frame. While the Timex mode is hi-colour or hi-res the 6144 bytes of the
+// second display file (the 8x1 attributes or the odd hi-res columns) go in each frame as well.
+//
+// The screen is XOR'd against the previous frame so anything that didn't move is zero and a
+// handful of frames at a time are packed with lzav - the fast (not 'hi') compressor with a
+// small hash table - before being written to the SD card. A chunk is only 4 frames so the
+// compression and the write are spread out and never stall a frame for long.
+//
+// tools/zxr2video turns a recording into an AVI on the PC (tools/zxr.c reads the format below
+// and tests/zxr_roundtrip.c runs this file through both, so change all three together).
+//
+// File layout (all values little endian):
+//
+//   Header     "ZXRC" u8 version, u8 machine (0=48K, 1=128K), u16 frames per second,
+//              u32 audio sample rate, u32 reserved (0)
+//   Chunk      u32 raw length, u32 compressed length, then the lzav compressed frames
+//   Frame      u8 flags  (bit0 = border follows, bit1 = palette follows, bit2 = ULA+ on,
+//                         bit3 = Timex mode follows)
+//              u8 border color 0-7                 (if bit0)
+//              u8 ULA+ palette[64]                 (if bit1)
+//              u8 Timex screen mode (port 0xFF)    (if bit3)
+//              u16 number of audio samples
+//              u8 screen[6912] XOR previous frame  (the first frame is XOR all zeros)
+//              u8 screen2[6144] XOR previous frame (only while the Timex mode has bit 1 set)
+//              s16 audio samples[]                 (signed 16-bit mono)
+//
+// Version 1 recordings are the same without the Timex mode or the second display file.
+// ------------------------------------------------------------------------------------------
+#define REC_VERSION         2
+#define REC_FRAMES_CHUNK    4
+#define REC_MAX_SAMPLES     1536    // More than a 50Hz frame's worth at the DSi mixer rate
+#define REC_FRAME_MAX       (1 + 1 + 64 + 1 + 2 + 6912 + 6144 + (REC_MAX_SAMPLES * 2))
+#define REC_HASH_SIZE       (16*1024)
+
+#define REC_FLAG_BORDER     0x01
+#define REC_FLAG_PALETTE    0x02
+#define REC_FLAG_ULAPLUS    0x04
+#define REC_FLAG_TIMEX      0x08
+
+u8  recorder_active = 0;
+
+static FILE *rec_file = NULL;
+static u8  *rec_raw = NULL;         // REC_FRAMES_CHUNK frames waiting to be compressed
+static u8  *rec_comp = NULL;        // And where they are compressed to
+static u8  *rec_hash = NULL;        // Hash table for lzav so it doesn't go to the heap on every chunk
+static u8   rec_last_screen[6912];  // The screen as of the previous frame for the XOR delta
+static u8   rec_last_screen2[6144]; // And the same for the Timex second display file
+static u8   rec_last_palette[64];
+static u8   rec_last_border = 0xFF;
+static u8   rec_last_ulaplus = 0;
+static u8   rec_last_timex = 0;
+static u16  rec_mixer_tail = 0;     // Where we got to in the mixer ring buffer
+static u32  rec_raw_len = 0;
+static u8   rec_frames = 0;
+static char rec_path[64];
+
+static void write32(u8 *p, u32 value)
+{
+    p[0] = value & 0xFF; p[1] = (value >> 8) & 0xFF; p[2] = (value >> 16) & 0xFF; p[3] = (value >> 24) & 0xFF;
+}
+
+// Compress and write out whatever frames are buffered
+static void recorder_flush(void)
+{
+    if (rec_raw_len == 0) return;
+
+    u8 lens[8];
+    int max_len = lzav_compress_bound(rec_raw_len);
+    int comp_len = lzav_compress(rec_raw, rec_comp, rec_raw_len, max_len, rec_hash, REC_HASH_SIZE);
+
+    write32(&lens[0], rec_raw_len);
+    write32(&lens[4], comp_len);
+    if ((comp_len == 0) || (fwrite(lens, 8, 1, rec_file) != 1) || (fwrite(rec_comp, comp_len, 1, rec_file) != 1))
+    {
+        recorder_stop(); // SD card full or gone... not much else we can do
+        return;
+    }
+
+    rec_raw_len = 0;
+    rec_frames = 0;
+}
+
+// ------------------------------------------------------------------------------
+// Start recording to a time-stamped .zxr file in the current directory (same
+// naming as the screenshots). The sample rate is only noted in the header.
+// With ZX_AUDIO=arm7 the AY is mixed on the ARM7 and never goes through the
+// mixer ring we record from - rather than a recording with the music missing
+// there is no recording at all.
+// ------------------------------------------------------------------------------
+void recorder_start(u32 sample_rate)
+{
+    if (recorder_active) return;
+#ifdef ZX_AY_ARM7
+    return;
+#endif
+
+    time_t unixTime = time(NULL);
+    struct tm* timeStruct = gmtime((const time_t *)&unixTime);
+    sprintf(rec_path, "REC-%02d-%02d-%04d-%02d-%02d-%02d.zxr", timeStruct->tm_mday, timeStruct->tm_mon+1, timeStruct->tm_year+1900, timeStruct->tm_hour, timeStruct->tm_min, timeStruct->tm_sec);
+
+    rec_raw  = malloc(REC_FRAMES_CHUNK * REC_FRAME_MAX);
+    rec_comp = malloc(lzav_compress_bound(REC_FRAMES_CHUNK * REC_FRAME_MAX));
+    rec_hash = malloc(REC_HASH_SIZE);
+    rec_file = fopen(rec_path, "wb");
+
+    if (!rec_raw || !rec_comp || !rec_hash || !rec_file)
+    {
+        recorder_active = 1; // So recorder_stop() cleans up
+        recorder_stop();
+        return;
+    }
+
+    u8 header[16];
+    memcpy(header, "ZXRC", 4);
+    header[4] = REC_VERSION;
+    header[5] = (zx_128k_mode ? 1:0);
+    header[6] = 50; header[7] = 0;
+    write32(&header[8], sample_rate);
+    write32(&header[12], 0);
+    fwrite(header, sizeof(header), 1, rec_file);
+
+    memset(rec_last_screen, 0x00, sizeof(rec_last_screen));
+    memset(rec_last_screen2, 0x00, sizeof(rec_last_screen2));
+    rec_last_border = 0xFF;     // Forces the border, palette and Timex mode into the first frame
+    rec_last_ulaplus = 0xFF;
+    rec_last_timex = 0xFF;
+    rec_raw_len = 0;
+    rec_frames = 0;
+    rec_mixer_tail = 0xFFFF;    // Picked up on the first frame
+    recorder_active = 1;
+}
+
+void recorder_stop(void)
+{
+    if (!recorder_active) return;
+    recorder_active = 0;
+
+    if (rec_file)
+    {
+        if (rec_raw) recorder_flush();
+        fclose(rec_file);
+    }
+    rec_file = NULL;
+
+    free(rec_raw);  rec_raw = NULL;
+    free(rec_comp); rec_comp = NULL;
+    free(rec_hash); rec_hash = NULL;
+}
+
+// The screen bytes as the XOR against the last frame - a word at a time when we can
+static u8 *recorder_delta(u8 *out, const u8 *screen, u8 *last, u32 len)
+{
+    if ((uintptr_t)out & 3) // Not necessarily aligned...
+    {
+        for (u32 i=0; i<len; i++) {out[i] = screen[i] ^ last[i];}
+    }
+    else
+    {
+        u32 *src = (u32*)screen;
+        u32 *prev = (u32*)last;
+        u32 *dest = (u32*)out;
+        for (u32 i=0; i<len/4; i++) {dest[i] = src[i] ^ prev[i];}
+    }
+    memcpy(last, screen, len);
+    return out + len;
+}
+
+// ------------------------------------------------------------------------------------------
+// Called once at the end of every emulated frame. The audio is whatever the emulation added
+// to the mixer ring buffer since the last frame (up to mixer_head) so nothing extra has to be
+// done in the audio code itself.
+// ------------------------------------------------------------------------------------------
+void recorder_frame(const s16 *mixer_ring, u16 mixer_mask, u16 mixer_head)
+{
+    if (!recorder_active) return;
+
+    u8 *out = rec_raw + rec_raw_len;
+    u8 *flags = out++;
+    u8 border = portFE & 0x07;
+
+    *flags = (zx_ula_plus_enabled ? REC_FLAG_ULAPLUS : 0);
+    if (border != rec_last_border)
+    {
+        *flags |= REC_FLAG_BORDER;
+        *out++ = border;
+        rec_last_border = border;
+    }
+    if ((zx_ula_plus_enabled != rec_last_ulaplus) || memcmp(rec_last_palette, zx_ula_plus_palette, 64))
+    {
+        *flags |= REC_FLAG_PALETTE;
+        memcpy(out, zx_ula_plus_palette, 64); out += 64;
+        memcpy(rec_last_palette, zx_ula_plus_palette, 64);
+        rec_last_ulaplus = zx_ula_plus_enabled;
+    }
+    if (zx_timex_latched != rec_last_timex)
+    {
+        *flags |= REC_FLAG_TIMEX;
+        *out++ = zx_timex_latched;
+        rec_last_timex = zx_timex_latched;
+    }
+
+    if (rec_mixer_tail == 0xFFFF) rec_mixer_tail = mixer_head;
+    u32 samples = (mixer_head - rec_mixer_tail) & mixer_mask;
+    if (samples > REC_MAX_SAMPLES) {rec_mixer_tail = mixer_head; samples = 0;} // Mixer was reset (tape loading) - just pick up again
+    *out++ = samples & 0xFF;
+    *out++ = samples >> 8;
+
+    // The screen as the XOR against the last frame
+    out = recorder_delta(out, zx_screen_page, rec_last_screen, 6912);
+
+    // Hi-colour and hi-res need the second display file too (zx_screen_page is the first one then)
+    if (zx_timex_latched & 0x02) out = recorder_delta(out, zx_screen_page + 0x2000, rec_last_screen2, 6144);
+
+    for (u32 i=0; i<samples; i++)
+    {
+        s16 sample = mixer_ring[rec_mixer_tail];
+        *out++ = sample & 0xFF;
+        *out++ = (sample >> 8) & 0xFF;
+        rec_mixer_tail = (rec_mixer_tail + 1) & mixer_mask;
+    }
+
+    rec_raw_len = out - rec_raw;
+    if (++rec_frames == REC_FRAMES_CHUNK) recorder_flush();
+}
+
+// End of file
@@ -0,0 +1,23 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, it's source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave (SpeccySE)
+// and Marat Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty.
+// =====================================================================================
+
+#ifndef __RECORDER_H
+#define __RECORDER_H
+
+#include <nds.h>
+
+extern u8   recorder_active;
+
+extern void recorder_start(u32 sample_rate);
+extern void recorder_stop(void);
+extern void recorder_frame(const s16 *mixer_ring, u16 mixer_mask, u16 mixer_head);
+
+#endif
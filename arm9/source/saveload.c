@@ -151,7 +151,7 @@ void spectrumSaveState()
         if (retVal) retVal = fwrite(&flash_timer,               sizeof(flash_timer),                1, handle);
         if (retVal) retVal = fwrite(&bFlash,                    sizeof(bFlash),                     1, handle);
         if (retVal) retVal = fwrite(&zx_128k_mode,              sizeof(zx_128k_mode),               1, handle);
-        if (retVal) retVal = fwrite(&ay_sample_idx,             sizeof(ay_sample_idx),              1, handle);
+        if (retVal) retVal = fwrite(spare,                      sizeof(u32),                        1, handle);  // Was the AY sample index
         if (retVal) retVal = fwrite(&zx_current_line,           sizeof(zx_current_line),            1, handle);
         if (retVal) retVal = fwrite(&last_line_drawn,           sizeof(last_line_drawn),            1, handle);        
         if (retVal) retVal = fwrite(&emuActFrames,              sizeof(emuActFrames),               1, handle);
@@ -183,7 +183,8 @@ void spectrumSaveState()
         if (retVal) retVal = fwrite(&zx_ula_plus_palette_reg,   sizeof(zx_ula_plus_palette_reg),    1, handle);
         if (retVal) retVal = fwrite(&zx_ula_plus_palette,       sizeof(zx_ula_plus_palette),        1, handle);
         if (retVal) retVal = fwrite(ContendMap,                 sizeof(ContendMap),                 1, handle);
-        if (retVal) retVal = fwrite(spare,                      300,                                1, handle);
+        if (retVal) retVal = fwrite(&zx_timex_mode,             sizeof(zx_timex_mode),              1, handle);
+        if (retVal) retVal = fwrite(spare,                      299,                                1, handle);
 
         // Save Z80 Memory Map... either 48K or 128K
         u8 *ptr = (zx_128k_mode ? RAM_Memory128 : (RAM_Memory+0x4000));
@@ -265,6 +266,11 @@ void spectrumLoadState()
             u8 ay_save_buffer[64];  // The AY save state is only like 16 bytes... so this is more than enough...
             retVal = fread(ay_save_buffer, sizeof(ay_save_buffer), 1, handle);
             ay38910LoadState(&myAY, ay_save_buffer);
+#ifdef ZX_AY_ARM7
+            ay7_sync();
+#else
+            ay_render_sync();
+#endif
             
             // Load back the Memory Map - these were saved as offsets so we must reconstruct actual pointers
             if (retVal) retVal = fread(Offsets, sizeof(Offsets),1, handle);
@@ -295,6 +301,7 @@ void spectrumLoadState()
                     MemoryMap[i] = (u8 *) (Offsets[i].offset);
                 }
             }
+            rom_decode_flush();
         }
         else retVal = 0;
 
@@ -305,7 +312,7 @@ void spectrumLoadState()
         if (retVal) retVal = fread(&flash_timer,               sizeof(flash_timer),                1, handle);
         if (retVal) retVal = fread(&bFlash,                    sizeof(bFlash),                     1, handle);
         if (retVal) retVal = fread(&zx_128k_mode,              sizeof(zx_128k_mode),               1, handle);
-        if (retVal) retVal = fread(&ay_sample_idx,             sizeof(ay_sample_idx),              1, handle);
+        if (retVal) retVal = fread(spare,                      sizeof(u32),                        1, handle);  // Was the AY sample index
         if (retVal) retVal = fread(&zx_current_line,           sizeof(zx_current_line),            1, handle);
         if (retVal) retVal = fread(&last_line_drawn,           sizeof(last_line_drawn),            1, handle);
         if (retVal) retVal = fread(&emuActFrames,              sizeof(emuActFrames),               1, handle);
@@ -337,7 +344,8 @@ void spectrumLoadState()
         if (retVal) retVal = fread(&zx_ula_plus_palette_reg,   sizeof(zx_ula_plus_palette_reg),    1, handle);
         if (retVal) retVal = fread(&zx_ula_plus_palette,       sizeof(zx_ula_plus_palette),        1, handle);
         if (retVal) retVal = fread(ContendMap,                 sizeof(ContendMap),                 1, handle);
-        if (retVal) retVal = fread(spare,                      300,                                1, handle);
+        if (retVal) retVal = fread(&zx_timex_mode,             sizeof(zx_timex_mode),              1, handle);
+        if (retVal) retVal = fread(spare,                      299,                                1, handle);
 
         if (zx_ula_plus_enabled)
         {
@@ -361,6 +369,8 @@ void spectrumLoadState()
             (void)lzav_decompress( CompressBuffer, dest_memory, comp_len, mem_size );
         }
 
+        zx_screen_dirty_all(); // The whole screen is (probably) different now
+
         strcpy(tmpStr, (retVal ? "OK ":"ERR"));
         DSPrint(13,0,0,tmpStr);
 
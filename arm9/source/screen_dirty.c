@@ -0,0 +1,77 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#include <nds.h>
+
+#include <string.h>
+
+#include "screen_dirty.h"
+
+// --------------------------------------------------------------------------------------------
+// Which lines of the screen need re-drawing - see screen_dirty.h. The renderer in spectrum.c
+// takes each line as it draws it (zx_line_take) and everything that changes the whole picture
+// marks all of them (zx_screen_dirty_all).
+// --------------------------------------------------------------------------------------------
+u8  zx_line_dirty[192]  __attribute__((section(".dtcm"))) ALIGN(4);
+
+AttrWrite_t zx_attr_log[ATTR_LOG_SIZE];
+u8  zx_attr_log_count   __attribute__((section(".dtcm"))) = 0;
+u8  zx_attr_logging     __attribute__((section(".dtcm"))) = 0;  // Set for the visible lines when myConfig.multicolor
+u32 zx_attr_log_overflows = 0;                                  // Attribute writes that didn't fit in the log
+
+// Called from the Z80 cores for any write where Ptr is inside the 6912 bytes of zx_screen_page.
+// The core hands over its T-States - CPU.TStates is not kept up to date on this path.
+ITCM_CODE void zx_screen_write(u8 *Ptr, u8 value, u32 tstates)
+{
+    if (*Ptr == value) return; // Lots of games re-draw what's already there...
+
+    u32 offset = Ptr - zx_screen_page;
+    if (zx_attr_logging && ((offset - 0x1800) < 0x300))
+    {
+        if (zx_attr_log_count < ATTR_LOG_SIZE)
+        {
+            zx_attr_log[zx_attr_log_count].tstates = tstates;
+            zx_attr_log[zx_attr_log_count].offset = offset - 0x1800;
+            zx_attr_log[zx_attr_log_count].old = *Ptr;
+            zx_attr_log_count++;
+        }
+        else zx_attr_log_overflows++;
+    }
+    *Ptr = value;
+
+    if ((offset & 0x1FFF) < 0x1800) // Bitmap (or Timex second display file) - the line number is scattered across the address bits
+    {
+        zx_line_dirty[((offset >> 8) & 0x07) | ((offset >> 2) & 0x38) | ((offset >> 5) & 0xC0)] = ZX_DIRTY_BOTH;
+    }
+    else if (offset < 0x1B00) // Attribute - all 8 lines of the character row
+    {
+        u32 *rowDirty = (u32*)&zx_line_dirty[((offset - 0x1800) >> 5) << 3];
+        rowDirty[0] = rowDirty[1] = (ZX_DIRTY_BOTH * 0x01010101);
+    }
+}
+
+// When the FLASH state toggles, only the character rows with a flashing attribute change
+void zx_screen_dirty_flash(void)
+{
+    u8 *attrPtr = zx_screen_page + 0x1800;
+
+    for (int row = 0; row < 24; row++)
+    {
+        for (int x = 0; x < 32; x++)
+        {
+            if (attrPtr[x] & 0x80)
+            {
+                memset(&zx_line_dirty[row << 3], ZX_DIRTY_BOTH, 8);
+                break;
+            }
+        }
+        attrPtr += 32;
+    }
+}
@@ -0,0 +1,69 @@
+// =====================================================================================
+// Copyright (c) 2025-2026 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+
+#ifndef __SCREEN_DIRTY_H
+#define __SCREEN_DIRTY_H
+
+#include <nds.h>
+#include "cpu/z80/Z80_interface.h"
+
+// ------------------------------------------------------------------------------------------
+// Dirty line tracking. Every CPU write that lands on the displayed screen (bitmap or attributes)
+// goes through zx_screen_write() which flags the affected lines as needing a re-draw in both of
+// the VRAM pages (bit 0 is page 0 and bit 1 is page 1). A line is only rendered into a page if
+// its bit for that page is set. If a whole frame goes by without rendering a single line, the
+// back page is identical to what is already showing and we don't even bother to flip.
+// ------------------------------------------------------------------------------------------
+#define ZX_DIRTY_BOTH   0x03
+
+// ------------------------------------------------------------------------------------------
+// Multicolor (8x1, 8x2 like Nirvana and Bifrost) engines re-write the attributes of a character
+// row while the beam is part way through it, so the attributes in memory at the end of the line
+// are not the ones the ULA fetched for the line. With myConfig.multicolor on, every attribute
+// write during the visible lines is logged with its T-State and the value it replaced. When the
+// line is rendered, any write that landed after the beam fetched that cell is undone. The log is
+// emptied after every line so frames that don't touch the attributes mid-screen never see it.
+//
+// The fastest the Z80 can change screen bytes is PUSH - 2 bytes in 11 T-States - so one run of
+// the longest line (228 T-States on the 128K, twice that with turbo) plus the instruction that
+// carries us over the end can't log more than ATTR_LOG_SIZE writes. Should that ever not hold,
+// the write goes ahead without being logged (the line shows the new attribute a little early)
+// and zx_attr_log_overflows counts it for the debugger.
+// ------------------------------------------------------------------------------------------
+#define ATTR_LOG_SIZE   ((((CYCLES_PER_SCANLINE_128 << 1) + 23) * 2 / 11) + 1)
+
+typedef struct
+{
+    u32 tstates;    // CPU.TStates when written
+    u16 offset;     // Offset into the attribute area (0-767)
+    u8  old;        // The attribute byte it replaced
+} AttrWrite_t;
+
+extern u8  *zx_screen_page;
+extern u8   zx_line_dirty[192];
+extern AttrWrite_t zx_attr_log[ATTR_LOG_SIZE];
+extern u8   zx_attr_log_count;
+extern u8   zx_attr_logging;
+extern u32  zx_attr_log_overflows;
+
+extern void zx_screen_write(u8 *Ptr, u8 value, u32 tstates);
+extern void zx_screen_dirty_flash(void);
+
+// Does this line need drawing into the given VRAM page? If so it's taken as drawn there.
+inline __attribute__((always_inline)) static u8 zx_line_take(u32 line, u8 page)
+{
+    u8 bufferBit = 1 << page;
+    if (!(zx_line_dirty[line] & bufferBit)) return 0;
+    zx_line_dirty[line] &= ~bufferBit;
+    return 1;
+}
+
+#endif
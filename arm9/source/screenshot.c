@@ -44,16 +44,54 @@ void write32(void *address, u32 value) {
     *fourth = (value >> 24) & 0xff;
 }
 
+// ---------------------------------------------------------------------------
+// The two colors of a Spectrum character cell as BMP palette indexes. For the
+// normal ULA these are the 16 colors (BRIGHT is the high bit) and FLASH is
+// shown in whatever state it's currently in. For ULA+ it's the 64 palette
+// registers - 16 for each of the 4 groups (8 ink and then 8 paper).
+// ---------------------------------------------------------------------------
+static void cell_colors(u8 attr, u8 *ink, u8 *paper)
+{
+    if (zx_ula_plus_enabled)
+    {
+        *ink   = ((attr >> 2) & 0x30) | (attr & 0x07);
+        *paper = ((attr >> 2) & 0x30) | 0x08 | ((attr >> 3) & 0x07);
+    }
+    else
+    {
+        *ink   = (attr & 0x07) | ((attr >> 3) & 0x08);
+        *paper = (attr >> 3) & 0x0F;
+        if (attr & bFlash & 0x80) {u8 tmp = *ink; *ink = *paper; *paper = tmp;}
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Rather than capture the DS display and write out a 16-bit BMP (almost 100K),
+// we encode straight from the Spectrum screen memory into a palette indexed BMP.
+// The normal ULA only has 16 colors so that's 4 bits per pixel and about 25K.
+// ULA+ has 64 colors so it needs 8 bits per pixel (about 49K).
+//
+// The Timex screen modes go by the mode latched for this frame, the same as the
+// renderer (zx_screen_page already points at the alternate screen if that's on).
+// Hi-colour takes the attribute for each 8x1 pixels from the second display file
+// and hi-res is written out at its full 512 pixels across in its two colors.
+// ---------------------------------------------------------------------------
 bool screenshotbmp(const char* filename) {
     FILE *file = fopen(filename, "wb");
 
     if(!file) return false;
 
-    REG_DISPCAPCNT = DCAP_BANK(DCAP_BANK_VRAM_B) | DCAP_SIZE(DCAP_SIZE_256x192) | DCAP_ENABLE;
-    while(REG_DISPCAPCNT & DCAP_ENABLE);
+    u8  hires   = ((zx_timex_latched & 0x06) == 0x06);
+    u8  hicolor = (!hires && (zx_timex_latched & 0x02));
+    u8  ulaplus = (zx_ula_plus_enabled && !hires);     // Hi-res has just the two colors from the Timex port
+    u8  bits    = (ulaplus ? 8 : 4);
+    u32 colours = (ulaplus ? 64 : 16);
+    u32 width   = (hires ? 512 : 256);
+    u32 pitch   = (width * bits) / 8;
+    u32 offset  = sizeof(HEADER) + 40 + (colours * 4);   // The indexed BMP uses the basic 40 byte info header
 
     // ---------------------------------------------------------
-    // The screenshot requires a bit less than 100K of memory...
+    // The screenshot requires at most 50K of memory...
     // We steal this from the compression buffer which is not
     // otherwise used except when save/loading save states.
     // ---------------------------------------------------------
@@ -63,37 +101,84 @@ bool screenshotbmp(const char* filename) {
     INFOHEADER *infoheader = (INFOHEADER*)(temp + sizeof(HEADER));
 
     write16(&header->type, 0x4D42);
-    write32(&header->size, 256 * 192 * 2 + sizeof(INFOHEADER) + sizeof(HEADER));
+    write32(&header->size, offset + (pitch * 192));
     write32(&header->reserved1, 0);
     write32(&header->reserved2, 0);
-    write32(&header->offset, sizeof(INFOHEADER) + sizeof(HEADER));
+    write32(&header->offset, offset);
 
-    write32(&infoheader->size, sizeof(INFOHEADER));
-    write32(&infoheader->width, 256);
+    write32(&infoheader->size, 40);
+    write32(&infoheader->width, width);
     write32(&infoheader->height, 192);
     write16(&infoheader->planes, 1);
-    write16(&infoheader->bits, 16);
-    write32(&infoheader->compression, 3);
-    write32(&infoheader->imagesize, 256 * 192 * 2);
+    write16(&infoheader->bits, bits);
+    write32(&infoheader->compression, 0);
+    write32(&infoheader->imagesize, pitch * 192);
     write32(&infoheader->xresolution, 2835);
     write32(&infoheader->yresolution, 2835);
-    write32(&infoheader->ncolours, 0);
+    write32(&infoheader->ncolours, colours);
     write32(&infoheader->importantcolours, 0);
-    write32(&infoheader->redBitmask, 0xF800);
-    write32(&infoheader->greenBitmask, 0x07E0);
-    write32(&infoheader->blueBitmask, 0x001F);
-    write32(&infoheader->reserved, 0);
-
-    u16 *ptr = (u16*)(temp + sizeof(HEADER) + sizeof(INFOHEADER));
-    for(int y = 0; y < 192; y++) {
-        for(int x = 0; x < 256; x++) {
-            u16 color = VRAM_B[256 * 191 - y * 256 + x];
-            *(ptr++) = ((color >> 10) & 0x1F) | (color & (0x1F << 5)) << 1 | ((color & 0x1F) << 11);
+
+    // The palette follows the 40 byte info header as Blue, Green, Red, 0
+    u8 *pal = temp + sizeof(HEADER) + 40;
+    for (u32 i = 0; i < colours; i++)
+    {
+        if (ulaplus)
+        {
+            u8 r = (zx_ula_plus_palette[i] >> 2) & 7;
+            u8 g = (zx_ula_plus_palette[i] >> 5) & 7;
+            u8 b = (zx_ula_plus_palette[i] & 3) << 1 | ((zx_ula_plus_palette[i] & 3) ? 1:0);
+            *pal++ = (b << 5) | (b << 2) | (b >> 1);
+            *pal++ = (g << 5) | (g << 2) | (g >> 1);
+            *pal++ = (r << 5) | (r << 2) | (r >> 1);
+        }
+        else
+        {
+            *pal++ = ZX_Spectrum_palette[i*3+2];
+            *pal++ = ZX_Spectrum_palette[i*3+1];
+            *pal++ = ZX_Spectrum_palette[i*3+0];
+        }
+        *pal++ = 0;
+    }
+
+    // BMP rows go bottom-up. For 4 bits per pixel the leftmost pixel is the high nibble.
+    for (int y = 0; y < 192; y++) {
+        u8 *ptr = temp + offset + ((191 - y) * pitch);
+        u8 *pixelPtr = zx_screen_page + (((y&0x07) << 8) | ((y&0x38) << 2) | ((y&0xC0) << 5));
+        u8 *attrPtr = zx_screen_page + 0x1800 + ((y >> 3) * 32);
+
+        if (hicolor) attrPtr = pixelPtr + 0x2000;
+        if (hires)
+        {
+            // Each byte of the first display file is followed on screen by the same byte of the second
+            u8 ink   = (zx_hires_attr[0] & 0x07) | 0x08;           // Always BRIGHT and never FLASH
+            u8 paper = ((zx_hires_attr[0] >> 3) & 0x07) | 0x08;
+            for (int x = 0; x < 64; x++) {
+                u8 pixels = pixelPtr[(x >> 1) + ((x & 1) ? 0x2000 : 0)];
+                for (int bit = 6; bit >= 0; bit -= 2) {
+                    *(ptr++) = (((pixels >> (bit+1)) & 1) ? ink : paper) << 4 | (((pixels >> bit) & 1) ? ink : paper);
+                }
+            }
+            continue;
+        }
+
+        for (int x = 0; x < 32; x++) {
+            u8 ink, paper, pixels = pixelPtr[x];
+            cell_colors(attrPtr[x], &ink, &paper);
+
+            if (bits == 4) {
+                for (int bit = 6; bit >= 0; bit -= 2) {
+                    *(ptr++) = (((pixels >> (bit+1)) & 1) ? ink : paper) << 4 | (((pixels >> bit) & 1) ? ink : paper);
+                }
+            } else {
+                for (int bit = 7; bit >= 0; bit--) {
+                    *(ptr++) = ((pixels >> bit) & 1) ? ink : paper;
+                }
+            }
         }
     }
 
     DC_FlushAll();
-    fwrite(temp, 1, 256 * 192 * 2 + sizeof(INFOHEADER) + sizeof(HEADER), file);
+    fwrite(temp, 1, offset + (pitch * 192), file);
     fclose(file);
     return true;
 }
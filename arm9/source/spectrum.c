@@ -22,6 +22,9 @@
 #include "cpu/z80/Z80_interface.h"
 #include "SpeccyUtils.h"
 #include "printf.h"
+#include "ay7_ipc.h"
+#include "beeper.h"
+#include "screen_dirty.h"
 
 u8  portFE                  __attribute__((section(".dtcm"))) = 0x00;
 u8  portFD                  __attribute__((section(".dtcm"))) = 0x00;
@@ -32,6 +35,9 @@ u8  bFlash                  __attribute__((section(".dtcm"))) = 0;
 u8  zx_128k_mode            __attribute__((section(".dtcm"))) = 0;
 u8  zx_force_128k_mode      __attribute__((section(".dtcm"))) = 0;
 u32 zx_current_line         __attribute__((section(".dtcm"))) = 0;
+u32 zx_line_end             __attribute__((section(".dtcm"))) = 0;   // CPU.TStates at which zx_current_line ends
+u32 zx_line_span            __attribute__((section(".dtcm"))) = 0;   // And how many T-States each line of the run is
+u32 zx_run_line             __attribute__((section(".dtcm"))) = 0;   // The last line of the run the CPU is on
 u8  zx_special_key          __attribute__((section(".dtcm"))) = 0;
 u32 last_file_size          __attribute__((section(".dtcm"))) = 0;
 u8  tape_play_skip_frame    __attribute__((section(".dtcm"))) = 0;
@@ -42,10 +48,23 @@ u8  last_line_drawn         __attribute__((section(".dtcm"))) = 0;
 u8  backgroundRenderScreen  __attribute__((section(".dtcm"))) = 0;
 u8  bRenderSkipOnce         __attribute__((section(".dtcm"))) = 1;
 
+u8  zx_timex_mode           __attribute__((section(".dtcm"))) = 0x00;
+
 u8  zx_ula_plus_palette[64] = {0};
 u8  zx_ula_plus_group       = 0x00;
 u8  zx_ula_plus_palette_reg = 0x00;
 
+// ----------------------------------------------------------------------------------
+// Where ULA+ palette register 0-63 lives in the DS background palette. For the normal
+// bitmap display it's simply 0x80-0xBF. The tiled display puts the 16 colors of each
+// group (8 ink then 8 paper) in color 2-5 of the 16 palette banks - see zx_tiled_init()
+// ----------------------------------------------------------------------------------
+#ifdef ZX_TILED_DISPLAY
+#define ULA_PLUS_BG_INDEX(reg)      ((((reg) & 0x0F) << 4) | (2 + ((reg) >> 4)))
+#else
+#define ULA_PLUS_BG_INDEX(reg)      (0x80 | (reg))
+#endif
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Warray-bounds"
 
@@ -107,24 +126,24 @@ ITCM_CODE unsigned char cpu_readport_speccy(register unsigned short Port)
             {
                 if (ContendMap[Port>>14])  // high byte contended, even port: C:1, C:3
                 {
-                    CPU.TStates += cpu_contended_delay_128[(CPU.TStates+0) % CYCLES_PER_SCANLINE_128];
-                    CPU.TStates += cpu_contended_delay_128[(CPU.TStates+1) % CYCLES_PER_SCANLINE_128];
+                    CPU.TStates += ContendDelay_128(CPU.TStates+0);
+                    CPU.TStates += ContendDelay_128(CPU.TStates+1);
                 }
                 else //high byte uncontended, even port: N:1, C:3
                 {
-                    CPU.TStates += cpu_contended_delay_128[(CPU.TStates+1) % CYCLES_PER_SCANLINE_128];
+                    CPU.TStates += ContendDelay_128(CPU.TStates+1);
                 }
             }
             else // 48K
             {
                 if (ContendMap[Port>>14])
                 {
-                    CPU.TStates += cpu_contended_delay_48[(CPU.TStates+0) % CYCLES_PER_SCANLINE_48];
-                    CPU.TStates += cpu_contended_delay_48[(CPU.TStates+1) % CYCLES_PER_SCANLINE_48];
+                    CPU.TStates += ContendDelay_48(CPU.TStates+0);
+                    CPU.TStates += ContendDelay_48(CPU.TStates+1);
                 }
                 else
                 {
-                    CPU.TStates += cpu_contended_delay_48[(CPU.TStates+1) % CYCLES_PER_SCANLINE_48];
+                    CPU.TStates += ContendDelay_48(CPU.TStates+1);
                 }
             }
 
@@ -309,17 +328,17 @@ ITCM_CODE unsigned char cpu_readport_speccy(register unsigned short Port)
             {
                 if (myConfig.machine) // 128K
                 {
-                    CPU.TStates += cpu_contended_delay_128[(CPU.TStates+0) % CYCLES_PER_SCANLINE_128];
-                    CPU.TStates += cpu_contended_delay_128[(CPU.TStates+1) % CYCLES_PER_SCANLINE_128];
-                    CPU.TStates += cpu_contended_delay_128[(CPU.TStates+2) % CYCLES_PER_SCANLINE_128];
-                    CPU.TStates += cpu_contended_delay_128[(CPU.TStates+3) % CYCLES_PER_SCANLINE_128];
+                    CPU.TStates += ContendDelay_128(CPU.TStates+0);
+                    CPU.TStates += ContendDelay_128(CPU.TStates+1);
+                    CPU.TStates += ContendDelay_128(CPU.TStates+2);
+                    CPU.TStates += ContendDelay_128(CPU.TStates+3);
                 }
                 else // 48K
                 {
-                    CPU.TStates += cpu_contended_delay_48[(CPU.TStates+0) % CYCLES_PER_SCANLINE_48];
-                    CPU.TStates += cpu_contended_delay_48[(CPU.TStates+1) % CYCLES_PER_SCANLINE_48];
-                    CPU.TStates += cpu_contended_delay_48[(CPU.TStates+2) % CYCLES_PER_SCANLINE_48];
-                    CPU.TStates += cpu_contended_delay_48[(CPU.TStates+3) % CYCLES_PER_SCANLINE_48];
+                    CPU.TStates += ContendDelay_48(CPU.TStates+0);
+                    CPU.TStates += ContendDelay_48(CPU.TStates+1);
+                    CPU.TStates += ContendDelay_48(CPU.TStates+2);
+                    CPU.TStates += ContendDelay_48(CPU.TStates+3);
                 }
             }
             else
@@ -402,9 +421,12 @@ ITCM_CODE void zx_bank(u8 new_portFD)
         {
             MemoryMap[0] = SpectrumBios128 + ((new_portFD & 0x10) ? 0x4000 : 0x0000);
         }
+        rom_decode_remap();
     }
 
+    u8 screen_swap = (portFD ^ new_portFD) & 0x08;
     portFD = new_portFD;
+    if (screen_swap) zx_screen_dirty_all(); // Swapping between the bank 5 and bank 7 screen
 
     // Map in the correct page of banked memory to 0xC000
     MemoryMap[3] = RAM_Memory128 + ((portFD & 0x07) * 0x4000) - 0xC000;
@@ -429,6 +451,48 @@ u16 zx_border_colors[8] __attribute__((section(".dtcm"))) =
   (u16)RGB15(0xFD,0xFD,0xFD),   // White
 };
 
+// ------------------------------------------------------------------------------------------
+// Border change log. The border is color 1 of the bottom screen palette and most games just
+// set it and leave it alone - so every change is written straight to the palette as before.
+// But loading stripes and demo effects change it many times per frame so each change is also
+// logged with the T-State and scanline it happened on. At the end of the frame, if anything
+// was logged, the log becomes a table of border colors for the 192 DS scanlines (the whole
+// Spectrum frame squeezed into them) and an HBlank DMA writes it into the palette line by
+// line. A frame without any border changes costs nothing and turns the HBlank DMA off again.
+// ------------------------------------------------------------------------------------------
+#define BORDER_LOG_SIZE     320     // At most one entry per scanline - more than the 312 in a frame
+#define BORDER_DMA          0       // DMA channel for the per-line palette writes (3 is the screen copy)
+
+typedef struct
+{
+    u32 tstates;    // CPU.TStates at the time of the OUT
+    u16 line;       // The scanline (zx_current_line) it happened on
+    u8  color;      // New border color 0-7
+} BorderChange_t;
+
+BorderChange_t zx_border_log[BORDER_LOG_SIZE];
+u16 zx_border_log_count     __attribute__((section(".dtcm"))) = 0;
+u8  zx_border_start_color   __attribute__((section(".dtcm"))) = 0;  // The border color as the frame began
+u16 zx_border_lines[2][192] ALIGN(32);                              // Not in DTCM - the DMA can't see it there
+u8  zx_border_back          __attribute__((section(".dtcm"))) = 0;  // Which of them the end of the frame writes
+vu8 zx_border_offer         __attribute__((section(".dtcm"))) = 0;  // What irqVBlank() is to show next - one of BORDER_OFFER_xxx
+
+#define BORDER_OFFER_NONE   0       // Nothing new - keep showing what we are
+#define BORDER_OFFER_TABLE  1       // zx_border_lines[zx_border_back] is ready
+#define BORDER_OFFER_STATIC 2       // No changes this frame - the palette entry alone will do
+
+// ------------------------------------------------------------------------------------------
+// The CPU runs several scanlines at a time (see speccy_run) so while it is running we only
+// bring zx_current_line up to date when something actually needs to know the line.
+// ------------------------------------------------------------------------------------------
+static inline void speccy_line_sync(void)
+{
+    while ((CPU.TStates >= zx_line_end) && (zx_current_line < zx_run_line))
+    {
+        zx_current_line++;
+        zx_line_end += zx_line_span;
+    }
+}
 
 ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsigned char Value)
 {
@@ -438,17 +502,33 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
         if ((portFE ^ Value) & 0x07)
         {
              BG_PALETTE_SUB[1] = zx_border_colors[Value & 0x07];
+
+             // Log it for the per-line border - several changes on the same scanline only need the last
+             speccy_line_sync();
+             if (zx_border_log_count && (zx_border_log[zx_border_log_count-1].line == zx_current_line))
+             {
+                 zx_border_log[zx_border_log_count-1].tstates = CPU.TStates;
+                 zx_border_log[zx_border_log_count-1].color = Value & 0x07;
+             }
+             else if (zx_border_log_count < BORDER_LOG_SIZE)
+             {
+                 zx_border_log[zx_border_log_count].tstates = CPU.TStates;
+                 zx_border_log[zx_border_log_count].line = zx_current_line;
+                 zx_border_log[zx_border_log_count].color = Value & 0x07;
+                 zx_border_log_count++;
+             }
         }
 
         // -------------------------------------------------------------------------------
         // For rapid pulsing... Mojon Twin games and games like Multidude will hit the
-        // speaker hard in the intro screens so we just respond as fast as we can here...
+        // speaker hard in the intro screens so we note exactly when every edge happens
+        // and processDirectAudio() puts each one in the right place between samples.
         // -------------------------------------------------------------------------------
         if ((portFE ^ Value) & 0x10)
         {
-            if (beeper_pulses_idx < 4)
+            if (beeper_edge_count < BEEPER_EDGES_MAX)
             {
-                beeper_pulses_idx++;
+                beeper_edges[beeper_edge_count++] = CPU.TStates;
             }
         }
 
@@ -460,24 +540,24 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
              {
                  if (ContendMap[Port>>14]) // high byte contended, even port: C:1, C:3
                  {
-                     CPU.TStates += cpu_contended_delay_128[(CPU.TStates+0) % CYCLES_PER_SCANLINE_128];
-                     CPU.TStates += cpu_contended_delay_128[(CPU.TStates+1) % CYCLES_PER_SCANLINE_128];
+                     CPU.TStates += ContendDelay_128(CPU.TStates+0);
+                     CPU.TStates += ContendDelay_128(CPU.TStates+1);
                  }
                  else // high byte uncontended, even port: N:1, C:3
                  {
-                     CPU.TStates += cpu_contended_delay_128[(CPU.TStates+1) % CYCLES_PER_SCANLINE_128];
+                     CPU.TStates += ContendDelay_128(CPU.TStates+1);
                  }
              }
              else // 48K
              {
                 if (ContendMap[Port>>14])
                  {
-                     CPU.TStates += cpu_contended_delay_48[(CPU.TStates+0) % CYCLES_PER_SCANLINE_48];
-                     CPU.TStates += cpu_contended_delay_48[(CPU.TStates+1) % CYCLES_PER_SCANLINE_48];
+                     CPU.TStates += ContendDelay_48(CPU.TStates+0);
+                     CPU.TStates += ContendDelay_48(CPU.TStates+1);
                  }
                  else
                  {
-                     CPU.TStates += cpu_contended_delay_48[(CPU.TStates+1) % CYCLES_PER_SCANLINE_48];
+                     CPU.TStates += ContendDelay_48(CPU.TStates+1);
                  }
              }
 
@@ -492,17 +572,17 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
               {
                   if (myConfig.machine) // 128K
                   {
-                      CPU.TStates += cpu_contended_delay_128[(CPU.TStates+0) % CYCLES_PER_SCANLINE_128];
-                      CPU.TStates += cpu_contended_delay_128[(CPU.TStates+1) % CYCLES_PER_SCANLINE_128];
-                      CPU.TStates += cpu_contended_delay_128[(CPU.TStates+2) % CYCLES_PER_SCANLINE_128];
-                      CPU.TStates += cpu_contended_delay_128[(CPU.TStates+3) % CYCLES_PER_SCANLINE_128];
+                      CPU.TStates += ContendDelay_128(CPU.TStates+0);
+                      CPU.TStates += ContendDelay_128(CPU.TStates+1);
+                      CPU.TStates += ContendDelay_128(CPU.TStates+2);
+                      CPU.TStates += ContendDelay_128(CPU.TStates+3);
                   }
                   else // 48K
                   {
-                      CPU.TStates += cpu_contended_delay_48[(CPU.TStates+0) % CYCLES_PER_SCANLINE_48];
-                      CPU.TStates += cpu_contended_delay_48[(CPU.TStates+1) % CYCLES_PER_SCANLINE_48];
-                      CPU.TStates += cpu_contended_delay_48[(CPU.TStates+2) % CYCLES_PER_SCANLINE_48];
-                      CPU.TStates += cpu_contended_delay_48[(CPU.TStates+3) % CYCLES_PER_SCANLINE_48];
+                      CPU.TStates += ContendDelay_48(CPU.TStates+0);
+                      CPU.TStates += ContendDelay_48(CPU.TStates+1);
+                      CPU.TStates += ContendDelay_48(CPU.TStates+2);
+                      CPU.TStates += ContendDelay_48(CPU.TStates+3);
                   }
               }
               else
@@ -514,6 +594,13 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
          }
     }
 
+    // Timex SCLD screen mode - only decodes the low byte. Bits 0-5 are the screen mode and the
+    // hi-res color. Bit 6 (disable the ULA interrupt) and 7 (DOCK/EXROM paging) are ignored.
+    if (((Port & 0xFF) == 0xFF) && myConfig.ULAplus)
+    {
+        zx_timex_mode = Value & 0x3F;
+    }
+
     if (zx_128k_mode && ((Port & 0x8002) == 0x0000)) // 128K Bankswitch
     {
         zx_bank(Value);
@@ -527,6 +614,11 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
     else if ((Port & 0xc002) == 0x8000) // AY Data Write
     {
         ay38910DataW(Value, &myAY);
+#ifdef ZX_AY_ARM7
+        ay7_write(myAY.ayRegIndex, Value); // And the ARM7 does the rendering
+#else
+        ay_log_write(myAY.ayRegIndex, Value); // Rendered with the rest of the batch
+#endif
         if (zx_AY_index_written) zx_AY_enabled = 1;
     }
     else
@@ -543,9 +635,9 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
                 {
                     zx_ula_plus_palette_reg = (zx_ula_plus_group & 0x3F);
                 }
-                else
+                else if ((zx_ula_plus_group >> 6) == 0x01) // Mode Group - the lower 6 bits are the Timex screen mode
                 {
-                    // Mode Group selected... we don't support the Timex screen extensions.
+                    zx_timex_mode = (zx_ula_plus_group & 0x3F);
                 }
             }
             else if (Port == 0xFF3B)
@@ -559,12 +651,13 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
                     g = (g << 5) | (g << 2) | (g >> 1);
                     b = (b << 5) | (b << 2) | (b >> 1);
                     SPRITE_PALETTE[0x80|zx_ula_plus_palette_reg] = RGB15(r,g,b);
-                    BG_PALETTE[0x80|zx_ula_plus_palette_reg]     = RGB15(r,g,b);
+                    BG_PALETTE[ULA_PLUS_BG_INDEX(zx_ula_plus_palette_reg)] = RGB15(r,g,b);
                     zx_ula_plus_palette[zx_ula_plus_palette_reg] = Value;
                 }
                 else if ((zx_ula_plus_group >> 6) == 0x01) // Mode Group
                 {
                     zx_ula_plus_enabled = (Value & 1);
+                    zx_screen_dirty_all();
                 }
             }
         }
@@ -585,135 +678,320 @@ void apply_ula_plus_palette(void)
         g = (g << 5) | (g << 2) | (g >> 1);
         b = (b << 5) | (b << 2) | (b >> 1);
         SPRITE_PALETTE[0x80|reg] = RGB15(r,g,b);
-        BG_PALETTE[0x80|reg]     = RGB15(r,g,b);
+        BG_PALETTE[ULA_PLUS_BG_INDEX(reg)] = RGB15(r,g,b);
     }
 }
 
-// Adjust "__attribute__((section(".dtcm")))" to match your specific ARM9 toolchain SDK linker script
-u32 Pixel_maskTable_High[256] __attribute__((section(".dtcm"))) = {
-    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
-    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
-    0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000,
-    0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000,
-    0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000,
-    0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000,
-    0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000,
-    0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0xFFFF0000,
-    0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00,
-    0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00,
-    0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00,
-    0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00,
-    0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00,
-    0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00, 0x00FFFF00,
-    0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00,
-    0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00, 0xFFFFFF00,
-    0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF,
-    0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF,
-    0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF,
-    0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF, 0xFF0000FF,
-    0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF,
-    0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF,
-    0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF,
-    0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF, 0xFFFF00FF,
-    0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF,
-    0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF,
-    0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF,
-    0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF,
-    0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
-    0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
-    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
-    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
-};
+u8 skip_frames __attribute__((section(".dtcm")))  = 0;
 
-u32 Pixel_maskTable_Low[256] __attribute__((section(".dtcm"))) = {
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF,
-    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
-    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF
-};
+// ------------------------------------------------------------------------------------------
+// Page flipping to avoid tearing. VRAM bank A (128K) holds two 256x256 8bpp bitmap pages and we
+// draw into the back page while the other is showing. At the end of a frame that drew anything,
+// irqVBlank() just points BG3 at the back page - no copy. zx_display_page is the page on screen.
+// ------------------------------------------------------------------------------------------
+#define ZX_PAGE(page)   ((u8*)0x06000000 + ((page) << 16))
+
+u8 zx_back_page     __attribute__((section(".dtcm"))) = 1;
+u8 zx_display_page  __attribute__((section(".dtcm"))) = 0;
+
+// ------------------------------------------------------------------------------------------
+// Dirty line tracking (screen_dirty.c) - which lines need re-drawing into which VRAM page.
+// ------------------------------------------------------------------------------------------
+u8  zx_frame_dirty      __attribute__((section(".dtcm"))) = 0;
+u8 *zx_screen_page      __attribute__((section(".dtcm"))) = RAM_Memory + 0x4000;
+u32 zx_screen_window    __attribute__((section(".dtcm"))) = 0x1B00;    // CPU writes below zx_screen_page + this go to zx_screen_write()
+
+// ------------------------------------------------------------------------------------------
+// Timex SCLD screen modes (port 0xFF, or the ULA+ Mode Group). Bits 0-2 of the mode select:
+//   000 - Standard screen at 0x4000
+//   001 - Alternate screen at 0x6000 (handled by just moving zx_screen_page)
+//   010 - Hi-colour: the bitmap at 0x4000 and an attribute for every 8x1 pixels at 0x6000
+//   110 - Hi-res: 512x192 in two colors with the even columns at 0x4000 and odd at 0x6000
+// The mode is latched at the start of each frame (zx_timex_latch) and the line renderer for it
+// is picked once per line from that. Other than the standard screen, both display files are
+// watched for writes so the dirty line tracking still works.
+// ------------------------------------------------------------------------------------------
+#define TIMEX_STANDARD  0
+#define TIMEX_HICOLOR   1
+#define TIMEX_HIRES     2
+
+u8  zx_timex_latched    __attribute__((section(".dtcm"))) = 0x00;  // zx_timex_mode as of the start of this frame
+u8  zx_timex_render     __attribute__((section(".dtcm"))) = TIMEX_STANDARD;
+u8  zx_hires_attr[32]   __attribute__((section(".dtcm"))) ALIGN(32); // The one attribute for the whole hi-res screen
+u8  zx_hires_pixels[32] __attribute__((section(".dtcm"))) ALIGN(32); // One hi-res line squeezed down to 256 pixels
+u8  zx_hires_pack[256]  __attribute__((section(".dtcm"))) ALIGN(4);  // 8 hi-res pixels to 4 (a pair is set if either is)
+
+// Multicolor engines - the attributes as the beam saw them for the line being drawn (see the
+// attribute write log in screen_dirty.h)
+u8  zx_attr_line[32]    __attribute__((section(".dtcm"))) ALIGN(32);
+
+// ------------------------------------------------------------------------------------------
+// Something other than a CPU write changed what the screen looks like (reset, load state, bank
+// 7 paged in as the screen, ULA+ mode change, etc.) so everything gets re-drawn.
+// ------------------------------------------------------------------------------------------
+void zx_screen_dirty_all(void)
+{
+    if (zx_128k_mode) zx_screen_page = RAM_Memory128 + ((portFD & 0x08) ? 7:5) * 0x4000;
+    else zx_screen_page = RAM_Memory + 0x4000;
 
+    if ((zx_timex_latched & 0x07) == 0x01) zx_screen_page += 0x2000; // Timex alternate screen
+    zx_screen_window = ((zx_timex_render == TIMEX_STANDARD) ? 0x1B00 : 0x3800);
 
-// ----------------------------------------------------------------------------
-// ULA Plus render line - this repurposes the BRIGHT and FLASH bits as
-// palette select (0-3). Ink gets 8 colors and Paper gets 8 other colors
-// and this provides 4 palette 'banks' of 16 colors for a total of 64 colors.
-// ----------------------------------------------------------------------------
-ITCM_CODE void speccy_render_screen_line_ula_plus(u32 *vidBuf, u8* attrPtr, u8*pixelPtr)
+    memset(zx_line_dirty, ZX_DIRTY_BOTH, sizeof(zx_line_dirty));
+}
+
+// ------------------------------------------------------------------------------------------
+// The Timex screen mode changed since the last frame - work out which line renderer to use.
+// ------------------------------------------------------------------------------------------
+static void zx_timex_latch(void)
 {
-    // ---------------------------------------------------------------------
-    // With 8 pixels per byte, there are 32 bytes of horizontal screen data
-    // ---------------------------------------------------------------------
-    for (int x=0; x<32; x++)
+    zx_timex_latched = zx_timex_mode;
+
+    if ((zx_timex_mode & 0x06) == 0x06)
     {
-        u8 attr = *attrPtr++;           // The color attribute for ULA+
-        u8 pixel = *pixelPtr++;         // And here is 8 pixels to draw
+        zx_timex_render = TIMEX_HIRES;
 
-        u8 ink   = 0x80 | (((attr >> 6) * 16) + (attr & 0x07));            // Ink Color is the foreground
-        u8 paper = 0x80 | (((attr >> 6) * 16) + ((attr >> 3) & 0x07) + 8); // Paper is the background
-        u32 background = (paper << 24) | (paper << 16) | (paper << 8) | paper;
+        // Paper is bits 3-5 and the ink is its complement - always BRIGHT
+        u8 color = (zx_timex_mode >> 3) & 0x07;
+        memset(zx_hires_attr, 0x40 | (color << 3) | (color ^ 0x07), sizeof(zx_hires_attr));
 
-        // --------------------------------------------------------------------------
-        // And now the pixel drawing... We try to speed this up as much as possible.
-        // --------------------------------------------------------------------------
-        if (pixel) // Is at least one pixel on?
+        for (int i=0; i<256; i++)
         {
-            // -----------------------------------------------------------------------
-            // I've profiled and tried every possible bit-shift and table-lookup that
-            // might speed this up... but ultimately this was the fastest code block.
-            // -----------------------------------------------------------------------
-            u32 ink32 = (ink << 24) | (ink << 16) | (ink << 8) | ink;
-            u32 diff  = ink32 ^ background; // This is the "difference mask"
-            u32 mask1 = Pixel_maskTable_High[pixel];
-            u32 mask2 = Pixel_maskTable_Low[pixel];
-
-            // Perform fast XOR blend operations
-            *vidBuf++ = background ^ (diff & mask1);
-            *vidBuf++ = background ^ (diff & mask2);
+            zx_hires_pack[i] = ((i & 0xC0) ? 0x08:0) | ((i & 0x30) ? 0x04:0) | ((i & 0x0C) ? 0x02:0) | ((i & 0x03) ? 0x01:0);
         }
-        else // Just drawing all background which is common...
+    }
+    else if (zx_timex_mode & 0x02) zx_timex_render = TIMEX_HICOLOR;
+    else zx_timex_render = TIMEX_STANDARD;
+
+    zx_screen_dirty_all();
+}
+
+#ifdef ZX_TILED_DISPLAY
+// ------------------------------------------------------------------------------------------
+// Tiled display backend. The Spectrum screen is 32x24 character cells, each an 8x8 1bpp bitmap
+// with one attribute - which maps nicely onto two 4bpp DS text backgrounds:
+//
+//   BG0 (front) - one tile per cell. Set pixels are color 'shade' and clear pixels are color 0
+//                 (transparent). The map entry palette bank is the ink color.
+//   BG1 (back)  - every cell uses a solid tile of color 'shade'. The palette bank is the paper.
+//
+// For the normal ULA 'shade' is always 1 and BG_PALETTE[bank*16 + 1] holds the 16 Spectrum
+// colors (8 colors in 2 intensities) so the tile graphics only depend on the bitmap - changing
+// an attribute is just a map entry and FLASH simply swaps the ink and paper palette banks. For
+// ULA+ the ink is bank 0-7 and paper is bank 8-15, with 'shade' 2-5 picking the palette group
+// (see ULA_PLUS_BG_INDEX). Everything is built up in RAM and only the character cells which
+// changed are copied to VRAM during the DS vertical blank.
+//
+// Like the page flip of the bitmap display, only whole frames go to VRAM. At the end of each
+// emulated frame the cells drawn on it are latched into a second copy and that is what the
+// vertical blank copies from - so the DS never shows a frame the emulation is part way through.
+// If two frames end between vertical blanks the newer cells simply replace the older ones.
+// ------------------------------------------------------------------------------------------
+#define ZX_SOLID_TILE   768         // The 5 solid tiles (shades 1-5) sit after the 768 cell tiles
+
+u32 zx_tile_gfx[768*8]              ALIGN(32);  // The BG0 cell tiles - 8 rows of 4bpp pixels each
+u16 zx_tile_map[2][768]             ALIGN(32);  // The BG0 and BG1 map entries
+u32 zx_cell_dirty[24]               __attribute__((section(".dtcm"))) ALIGN(4); // One bit per cell of each character row
+u32 zx_tile_gfx_ready[768*8]        ALIGN(32);  // The cells of the last whole frame waiting for the vertical blank
+u16 zx_tile_map_ready[2][768]       ALIGN(32);
+u32 zx_cell_ready[24]               __attribute__((section(".dtcm"))) ALIGN(4); // Which of those aren't in VRAM yet
+vu8 zx_cell_latching                __attribute__((section(".dtcm"))) = 0;      // Set while zx_tiled_latch() is filling them in
+u32 zx_pixel_expand[256]            __attribute__((section(".dtcm"))) ALIGN(4); // 8 pixels to 8 nibbles of 0 or 1
+
+void zx_tiled_init(void)
+{
+    videoSetMode(MODE_0_2D | DISPLAY_BG0_ACTIVE | DISPLAY_BG1_ACTIVE);
+    REG_BG0CNT = BG_32x32 | BG_COLOR_16 | BG_MAP_BASE(0) | BG_TILE_BASE(1) | BG_PRIORITY(0);
+    REG_BG1CNT = BG_32x32 | BG_COLOR_16 | BG_MAP_BASE(1) | BG_TILE_BASE(1) | BG_PRIORITY(1);
+    REG_BG0HOFS = REG_BG0VOFS = 0;
+    REG_BG1HOFS = REG_BG1VOFS = 0;
+
+    // The leftmost Spectrum pixel is bit 7 but on the DS it's the low nibble
+    for (int i=0; i<256; i++)
+    {
+        zx_pixel_expand[i] = 0;
+        for (int bit=0; bit<8; bit++)
         {
-            // --------------------------------------------------------------------------------------
-            // Draw background directly to the screen - this is slightly faster than a lookup table.
-            // --------------------------------------------------------------------------------------
-            *vidBuf++ = background;
-            *vidBuf++ = background;
+            if (i & (0x80 >> bit)) zx_pixel_expand[i] |= (1 << (bit*4));
         }
     }
+
+    // Start with VRAM and our copy of it in agreement - all zero - and then force a full re-draw
+    memset(zx_tile_gfx, 0x00, sizeof(zx_tile_gfx));
+    memset(zx_tile_map, 0x00, sizeof(zx_tile_map));
+    memset(zx_cell_dirty, 0x00, sizeof(zx_cell_dirty));
+    memset(zx_tile_gfx_ready, 0x00, sizeof(zx_tile_gfx_ready));
+    memset(zx_tile_map_ready, 0x00, sizeof(zx_tile_map_ready));
+    memset(zx_cell_ready, 0x00, sizeof(zx_cell_ready));
+    dmaFillWords(0, BG_MAP_RAM(0), 0xC000);
+    for (int shade=1; shade<=5; shade++)
+    {
+        dmaFillWords(0x11111111 * shade, (u8*)BG_TILE_RAM(1) + ((ZX_SOLID_TILE + shade - 1) * 32), 32);
+    }
+    zx_screen_dirty_all();
 }
 
-u8 skip_frames __attribute__((section(".dtcm")))  = 0;
+// ------------------------------------------------------------------------------------------
+// Update one screen line in the cell tiles and maps, noting which cells need to go to VRAM.
+// There is only one attribute per cell so for Timex hi-colour it's whichever line of the
+// cell was drawn last.
+// ------------------------------------------------------------------------------------------
+ITCM_CODE void speccy_render_line_tiled(u8 line, u8 *attrPtr, u8 *pixelPtr)
+{
+    u32 row = line >> 3;
+    u32 *tileRow = &zx_tile_gfx[(row << 8) + (line & 0x07)];
+    u16 *frontMap = &zx_tile_map[0][row << 5];
+    u16 *backMap = &zx_tile_map[1][row << 5];
+    u32 dirty = 0;
 
-// Ping-pong screen buffers to avoid tearing...
-u8 screen_buffer_A[256*192];
-u8 screen_buffer_B[256*192];
+    for (u32 x=0; x<32; x++, tileRow += 8)
+    {
+        u32 attr = attrPtr[x];
+        u32 ink, paper, shade;
+
+        if (zx_ula_plus_enabled)
+        {
+            ink = attr & 0x07;
+            paper = 0x08 | ((attr >> 3) & 0x07);
+            shade = 2 + (attr >> 6);
+        }
+        else
+        {
+            ink = (attr & 0x07) | ((attr >> 3) & 0x08);
+            paper = (attr >> 3) & 0x0F;
+            if (attr & bFlash & 0x80) {u32 tmp = ink; ink = paper; paper = tmp;}
+            shade = 1;
+        }
+
+        u32 gfx = zx_pixel_expand[pixelPtr[x]] * shade;
+        u16 front = ((row << 5) + x) | (ink << 12);
+        u16 back = (ZX_SOLID_TILE + shade - 1) | (paper << 12);
+
+        if ((*tileRow != gfx) || (frontMap[x] != front) || (backMap[x] != back))
+        {
+            *tileRow = gfx;
+            frontMap[x] = front;
+            backMap[x] = back;
+            dirty |= (1 << x);
+        }
+    }
+
+    zx_cell_dirty[row] |= dirty;
+}
+
+// Called at the end of every emulated frame - the cells drawn on it are ready to be shown
+static void zx_tiled_latch(void)
+{
+    zx_cell_latching = 1;
+    asm volatile ("" ::: "memory"); // The copy has to stay between setting and clearing the flag
+
+    for (u32 row=0; row<24; row++)
+    {
+        u32 dirty = zx_cell_dirty[row];
+        if (!dirty) continue;
+        zx_cell_dirty[row] = 0;
+        zx_cell_ready[row] |= dirty;
+
+        while (dirty)
+        {
+            u32 cell = (row << 5) + __builtin_ctz(dirty);
+            dirty &= (dirty - 1);
+
+            u32 *src = &zx_tile_gfx[cell << 3];
+            u32 *dest = &zx_tile_gfx_ready[cell << 3];
+            dest[0] = src[0]; dest[1] = src[1]; dest[2] = src[2]; dest[3] = src[3];
+            dest[4] = src[4]; dest[5] = src[5]; dest[6] = src[6]; dest[7] = src[7];
+            zx_tile_map_ready[0][cell] = zx_tile_map[0][cell];
+            zx_tile_map_ready[1][cell] = zx_tile_map[1][cell];
+        }
+    }
+
+    asm volatile ("" ::: "memory");
+    zx_cell_latching = 0;
+}
+
+// Called from irqVBlank() to copy over only the character cells that changed. If the vertical
+// blank came in the middle of zx_tiled_latch() the cells wait for the next one.
+ITCM_CODE void zx_tiled_flush(void)
+{
+    if (zx_cell_latching) return;
+
+    for (u32 row=0; row<24; row++)
+    {
+        u32 ready = zx_cell_ready[row];
+        if (!ready) continue;
+        zx_cell_ready[row] = 0;
+
+        while (ready)
+        {
+            u32 cell = (row << 5) + __builtin_ctz(ready);
+            ready &= (ready - 1);
+
+            u32 *src = &zx_tile_gfx_ready[cell << 3];
+            u32 *dest = (u32*)BG_TILE_RAM(1) + (cell << 3);
+            dest[0] = src[0]; dest[1] = src[1]; dest[2] = src[2]; dest[3] = src[3];
+            dest[4] = src[4]; dest[5] = src[5]; dest[6] = src[6]; dest[7] = src[7];
+            BG_MAP_RAM(0)[cell] = zx_tile_map_ready[0][cell];
+            BG_MAP_RAM(1)[cell] = zx_tile_map_ready[1][cell];
+        }
+    }
+}
+#endif
+
+#ifndef ZX_TILED_DISPLAY // The tiled display has only one attribute per cell so can't show multicolor
+// ------------------------------------------------------------------------------------------
+// The attributes of this line as the ULA fetched them. The ULA reads 2 cells every 8 T-States
+// from the start of the line so any logged write to this character row at or after that time
+// is put back to what it replaced - going backwards so the earliest late write wins.
+// ------------------------------------------------------------------------------------------
+static u8 *speccy_beam_attributes(u8 line, u8 *attrPtr)
+{
+    u32 line_start = (myConfig.machine ? (CONTENTION_START_CYCLE_128 + (line * CYCLES_PER_SCANLINE_128)) :
+                                         (CONTENTION_START_CYCLE_48  + (line * CYCLES_PER_SCANLINE_48))) << myConfig.turbo;
+    u32 row_start = (line >> 3) << 5;
+
+    memcpy(zx_attr_line, attrPtr, 32);
+    for (int i = zx_attr_log_count-1; i >= 0; i--)
+    {
+        u32 x = zx_attr_log[i].offset - row_start;
+        if (x < 32)
+        {
+            if (zx_attr_log[i].tstates >= line_start + (((x >> 1) * 8) << myConfig.turbo)) zx_attr_line[x] = zx_attr_log[i].old;
+        }
+    }
+
+    return zx_attr_line;
+}
+#endif
+
+// ------------------------------------------------------------------------------------------
+// Timex hi-res is 512 pixels across - each byte of the first display file is followed on
+// screen by the same byte of the second. We only have 256 pixels so each pair of pixels
+// is squeezed into one which is set if either was - thin lines and text stay visible.
+// ------------------------------------------------------------------------------------------
+static inline u8 *speccy_hires_pixels(u8 *pixelPtr)
+{
+    for (int x=0; x<32; x++)
+    {
+        zx_hires_pixels[x] = (zx_hires_pack[pixelPtr[x]] << 4) | zx_hires_pack[pixelPtr[x+0x2000]];
+    }
+    return zx_hires_pixels;
+}
+
+#ifndef ZX_TILED_DISPLAY
+// Timex hi-colour - the attribute for this line is at the same offset in the second display file
+static inline void speccy_render_line_hicolor(u32 *vidBuf, u8 *pixelPtr)
+{
+    if (zx_ula_plus_enabled) speccy_render_line_ula_plus_asm(vidBuf, pixelPtr + 0x2000, pixelPtr);
+    else speccy_render_line_asm(vidBuf, pixelPtr + 0x2000, pixelPtr, bFlash);
+}
+
+// Timex hi-res - two colors (no FLASH) for the whole screen
+static inline void speccy_render_line_hires(u32 *vidBuf, u8 *pixelPtr)
+{
+    speccy_render_line_asm(vidBuf, zx_hires_attr, speccy_hires_pixels(pixelPtr), 0);
+}
+#endif
 
 // ----------------------------------------------------------------------------
 // Render one screen line of pixels. This is called on every visible scanline
@@ -722,31 +1000,38 @@ u8 screen_buffer_B[256*192];
 // ----------------------------------------------------------------------------
 ITCM_CODE void speccy_render_screen_line(u8 line)
 {
-    u32 *vidBuf;
-    u8 *zx_ScreenPage = 0;
-
     if (line == 0) // At start of each new frame, handle the flashing 'timer'
     {
+        if (zx_timex_mode != zx_timex_latched) zx_timex_latch(); // Timex screen mode only changes between frames
+
         if (!tape_is_playing()) // Double-buffer and draw the screen in the background - reduces tearing
         {
             if (bRenderSkipOnce) bRenderSkipOnce=0;
             else
             {
+                u8 skipped = skip_frames;
                 if (skip_frames)
                 {
                     skip_frames = 0;
                 }
-                else
+                else if (zx_frame_dirty) // If no line was drawn the back page is the same as what's on screen
                 {
-                    backgroundRenderScreen = 0x80 | (flash_timer & 1); // Since flash_timer is incremented below, this will render the buffer just drawn...
+                    backgroundRenderScreen = 0x80 | zx_back_page; // Show the page just drawn at the next vertical blank...
+                    zx_back_page ^= 1;                            // ...and start drawing into the other one
                 }
 
                 // ------------------------------------------------------------------------------
                 // For the DS-Lite/Phat, we skip 1 frames out of 4 frames to help the speed.
                 // This allows the older handheld to still double-buffer (to reduce tearing)
                 // and provides an 75% render rate which is smooth enough. User can disable.
+                // The adaptive setting only skips when the main loop sees we are about to
+                // fall behind (frameBehind) and never skips two frames in a row.
                 // ------------------------------------------------------------------------------
-                if ((tape_play_skip_frame & 0x3) == 3)
+                if (myConfig.frameSkip == 2)
+                {
+                    if (frameBehind && !skipped) skip_frames = 1;
+                }
+                else if ((tape_play_skip_frame & 0x3) == 3)
                 {
                     if (myConfig.frameSkip) skip_frames = 1;
                 }
@@ -754,26 +1039,58 @@ ITCM_CODE void speccy_render_screen_line(u8 line)
         }
         else skip_frames = 0; // Playing tape... which has its own frame skip handling...
 
+        zx_frame_dirty = 0;
         tape_play_skip_frame++;
-        if (++flash_timer & 0x10) {flash_timer=0; bFlash ^= 0xFF;} // Same timing as real ULA - 16 frames on and 16 frames off
+        if (++flash_timer & 0x10) // Same timing as real ULA - 16 frames on and 16 frames off
+        {
+            flash_timer=0; bFlash ^= 0xFF;
+            if (!zx_ula_plus_enabled) // ULA+ uses the FLASH bit as a palette select
+            {
+                if (zx_timex_render == TIMEX_STANDARD) zx_screen_dirty_flash();
+                else if (zx_timex_render == TIMEX_HICOLOR) memset(zx_line_dirty, ZX_DIRTY_BOTH, sizeof(zx_line_dirty));
+            }
+        }
     }
 
+#ifdef ZX_TILED_DISPLAY
+    // -------------------------------------------------------------------------
+    // The tiled display has no ping-pong pages - the cells are built up in RAM,
+    // latched at the end of the frame and irqVBlank() copies over just the ones
+    // that changed. While tape is loading we still only draw 1 out of every 8
+    // (DSi) or 16 (DS-Lite).
+    // -------------------------------------------------------------------------
+    if (skip_frames) return;
+    if (tape_is_playing() && (tape_play_skip_frame & (isDSiMode() ? 0x07:0x0F))) return;
+    if (!zx_line_dirty[line]) return;
+    zx_line_dirty[line] = 0;
+
+    u8 *pixelPtr = zx_screen_page + (((line&0x07) << 8) | ((line&0x38) << 2) | ((line&0xC0) << 5));
+    if (zx_timex_render == TIMEX_STANDARD) speccy_render_line_tiled(line, &zx_screen_page[0x1800 + ((line >> 3)*32)], pixelPtr);
+    else if (zx_timex_render == TIMEX_HICOLOR) speccy_render_line_tiled(line, pixelPtr + 0x2000, pixelPtr);
+    else speccy_render_line_tiled(line, zx_hires_attr, speccy_hires_pixels(pixelPtr));
+#else
+    u32 *vidBuf;
+
     // If the tape isn't playing, we double-buffer to ensure smooth reasonably tear-free display output
     if (!tape_is_playing())
     {
         if (skip_frames) return;
 
         // ------------------------------------------------------------------------------------
-        // Video buffer... write 32-bits at a time for maximum speed. Note these ping-pong
-        // buffers are reversed from what you see in SpeccySE.c where we render the screen.
-        // While we are building up buffer A, we want to output buffer B and vice-versa.
+        // Video buffer... write 32-bits at a time for maximum speed. This is the back page
+        // in VRAM - while we are building it up, irqVBlank() keeps showing the other one.
         // ------------------------------------------------------------------------------------
-        vidBuf = (u32*) ((flash_timer & 1 ? screen_buffer_A:screen_buffer_B) + (line << 8));
+        vidBuf = (u32*) (ZX_PAGE(zx_back_page) + (line << 8));
+
+        // Nothing on this line has changed since we last drew it into this page
+        if (!zx_line_take(line, zx_back_page)) return;
+        zx_frame_dirty = 1;
     }
     else // When tape is loading, we direct render for speed
     {
-        vidBuf = (u32*)(0x06000000 + (line << 8));    // Video buffer... write 32-bits at a time for maximum speed
+        vidBuf = (u32*)(ZX_PAGE(zx_display_page) + (line << 8));    // Video buffer... write 32-bits at a time for maximum speed
         bRenderSkipOnce = 1; // When we stop the tape, we want to allow the first frame to re-draw before rendering
+        zx_line_dirty[line] = ZX_DIRTY_BOTH; // And the back page doesn't have what we put on screen directly
     }
 
     // ------------------------------------------------------------------------------------
@@ -789,66 +1106,34 @@ ITCM_CODE void speccy_render_screen_line(u8 line)
     // -----------------------------------------------------------------------
     // Render the current line into our NDS video memory. For the ZX 128K, we
     // might be using page 7 for video display... it's rare, but possible...
+    // zx_screen_page is kept pointing at the right one by zx_bank().
     // -----------------------------------------------------------------------
-    if (zx_128k_mode) zx_ScreenPage = RAM_Memory128 + ((portFD & 0x08) ? 7:5) * 0x4000;
-    else zx_ScreenPage = RAM_Memory + 0x4000;
 
     // ----------------------------------------------------------------
     // The color attribute is stored independently from the pixel data
     // ----------------------------------------------------------------
-    u8 *attrPtr = &zx_ScreenPage[0x1800 + ((line/8)*32)];
+    u8 *attrPtr = &zx_screen_page[0x1800 + ((line/8)*32)];
     word offset = ((line&0x07) << 8) | ((line&0x38) << 2) | ((line&0xC0) << 5);
-    u8 *pixelPtr = zx_ScreenPage+offset;
+    u8 *pixelPtr = zx_screen_page+offset;
 
-    if (zx_ula_plus_enabled)
+    if (zx_timex_render != TIMEX_STANDARD) // Timex screen modes have their own line renderers
     {
-        speccy_render_screen_line_ula_plus(vidBuf, attrPtr, pixelPtr);
+        if (zx_timex_render == TIMEX_HICOLOR) speccy_render_line_hicolor(vidBuf, pixelPtr);
+        else speccy_render_line_hires(vidBuf, pixelPtr);
+        return;
     }
-    else
+
+    if (zx_attr_log_count) attrPtr = speccy_beam_attributes(line, attrPtr);
+
     // ---------------------------------------------------------------------
     // With 8 pixels per byte, there are 32 bytes of horizontal screen data
+    // and the hand-tuned ARM code in spectrum_render.s draws them all. The
+    // ULA Plus repurposes the BRIGHT and FLASH bits as palette select (0-3)
+    // so ink and paper each get 8 colors from 4 palette 'banks' of 16.
     // ---------------------------------------------------------------------
-    for (int x = 0; x < 32; x++)
-    {
-        u8 attr = *attrPtr++;
-        u8 paper = (attr >> 3) & 0x0F;
-        u8 pixel = *pixelPtr++;
-        u32 background = (paper << 24) | (paper << 16) | (paper << 8) | paper;
-
-        if (attr & 0x80)
-        {
-             pixel ^= bFlash; // Invert pixel if flashing
-        }
-
-        // --------------------------------------------------------------------------
-        // And now the pixel drawing... We try to speed this up as much as possible.
-        // --------------------------------------------------------------------------
-        if (pixel) // Is at least one pixel on?
-        {
-            u8 ink = (attr & 0x07) | ((attr & 0x40) >> 3);    // Ink Color is the foreground
-
-            // -----------------------------------------------------------------------
-            // I've profiled and tried every possible bit-shift and table-lookup that
-            // might speed this up... but ultimately this was the fastest code block.
-            // -----------------------------------------------------------------------
-            u32 ink32 = (ink << 24) | (ink << 16) | (ink << 8) | ink;
-            u32 diff  = ink32 ^ background; // This is the "difference mask"
-            u32 mask1 = Pixel_maskTable_High[pixel];
-            u32 mask2 = Pixel_maskTable_Low[pixel];
-
-            // Perform fast XOR blend operations
-            *vidBuf++ = background ^ (diff & mask1);
-            *vidBuf++ = background ^ (diff & mask2);
-        }
-        else // Just drawing all background which is common...
-        {
-            // --------------------------------------------------------------------------------------
-            // Draw background directly to the screen - this is slightly faster than a lookup table.
-            // --------------------------------------------------------------------------------------
-            *vidBuf++ = background;
-            *vidBuf++ = background;
-        }
-    }
+    if (zx_ula_plus_enabled) speccy_render_line_ula_plus_asm(vidBuf, attrPtr, pixelPtr);
+    else speccy_render_line_asm(vidBuf, attrPtr, pixelPtr, bFlash);
+#endif
 }
 
 
@@ -889,16 +1174,24 @@ void speccy_reset(void)
     rom_special_bank    = 0;   // Assume no special ROM in SLOT0 until proven otherwise below
 
     accurate_emulation  = 0;   // Set to 1 when we need to handle more accurate TState accounting / Contended Memory
+    zx_attr_log_overflows = 0;
+    cpu_event_pending   = 0;   // Nothing due at any T-State
+    cpu_event_next      = 0xFFFFFFFF;
 
     zx_ula_plus_enabled     = 0;   // Assume no ULA+ (normal Spectrum ULA)
     zx_ula_plus_group       = 0x00;
     zx_ula_plus_palette_reg = 0x00;
     memset(zx_ula_plus_palette, 0x00, sizeof(zx_ula_plus_palette));
 
+    zx_timex_mode           = 0x00;   // Standard screen
+    zx_timex_latched        = 0x00;
+    zx_timex_render         = TIMEX_STANDARD;
+
     tape_play_skip_frame   = 0;
 
     backgroundRenderScreen = 0;
     bRenderSkipOnce        = 1;
+    zx_back_page           = zx_display_page ^ 1;  // Any flip still pending is cancelled
 
     // ------------------------------------------------
     // Handle parsing of the .tap or .tzx tape formats
@@ -983,92 +1276,384 @@ void speccy_reset(void)
     {
         MemoryMap[0] = (zx_128k_mode ? SpectrumBios128 : SpectrumBios);
     }
+
+    // Nothing pre-decoded from the previous game/ROM can be trusted
+    rom_decode_flush();
+    zx_screen_dirty_all();
 }
 
 
-// -----------------------------------------------------------------------------
-// Run the emulation for exactly 1 scanline and handle the VDP interrupt if
-// the emulation has executed the last line of the frame.  This also handles
-// direct beeper and possibly AY sound emulation as well. Crude but effective.
-// -----------------------------------------------------------------------------
-ITCM_CODE u32 speccy_run(void)
+// ------------------------------------------------------------------------------------------
+// End of frame - turn the border log (if any) into a color for each of the 192 DS scanlines.
+// The Spectrum frame has more lines than that so each DS line shows the border color as it
+// was on the proportional Spectrum line.
+//
+// The table is written into the back one of the pair and offered to irqVBlank(), which swaps
+// the pair over when it takes it - so the table the HBlank DMA is reading is never written,
+// however many frames end between vertical blanks (tape loading runs flat out). A table still
+// on offer from an earlier frame is taken back first and then written over with the newer one.
+// ------------------------------------------------------------------------------------------
+static void speccy_border_frame(u16 frame_lines)
 {
-    const u8 ULATweak[] = {0, 14, 36, 72, 104, 130, 170, 230};
-    const int starting_line = (myConfig.machine ? 63:64); // And this is the first line we draw (48K machines start 1 line later)
-    const int ending_line   = (zx_128k_mode ? SCANLINES_PER_FRAME_128:SCANLINES_PER_FRAME_48);
-
-    ++zx_current_line; // This is the pixel line we're working on...
-
-    // ----------------------------------------------
-    // Execute 1 scanline worth of CPU instructions.
-    // -----------------------------------------------
-    if (tape_state)
+    if (zx_border_log_count == 0)
     {
-        // ---------------------------------------------------------------------------------------------
-        // If we are playing back the tape - just run the emulation as fast as possible and try not to
-        // touch CPU.TStates as we can use some speed-up tricks when accelerating the tape playback...
-        // ---------------------------------------------------------------------------------------------
-        ExecZ80_Speccy(CPU.TStates + (zx_128k_mode ? CYCLES_PER_SCANLINE_128:CYCLES_PER_SCANLINE_48));
+        zx_border_offer = BORDER_OFFER_STATIC; // The palette entry already has the right color
+    }
+    else
+    {
+        zx_border_offer = BORDER_OFFER_NONE;    // Now irqVBlank() can't swap the pair while we write
+        asm volatile ("" ::: "memory");
 
-        if (CPU.TStates > 0xFFFE0000) // Too close to the wrap point, should never happen but trap it out so we don't crash the emulation
+        u16 *table = zx_border_lines[zx_border_back];
+        u32 color = zx_border_start_color;
+        u32 idx = 0, line = 1, acc = 0;
+
+        for (u32 y=0; y<192; y++)
         {
-            CPU.TStates = 0;
-            last_edge = 0;
-            tape_stop();
+            while ((idx < zx_border_log_count) && (zx_border_log[idx].line <= line))
+            {
+                color = zx_border_log[idx++].color;
+            }
+            table[y] = zx_border_colors[color];
+
+            acc += frame_lines; // Step on to the Spectrum line for the next DS line
+            while (acc >= 192) {acc -= 192; line++;}
         }
+
+        DC_FlushRange(table, sizeof(zx_border_lines[0]));
+        asm volatile ("" ::: "memory");
+        zx_border_offer = BORDER_OFFER_TABLE;
     }
-    else
+
+    zx_border_log_count = 0;
+    zx_border_start_color = portFE & 0x07;
+}
+
+// ------------------------------------------------------------------------------------------
+// Called from irqVBlank(). Takes whatever the last frame offered and then (re)starts the
+// HBlank DMA from the table on show - it writes the color for the next line at the end of
+// each line, so line 0 gets its color here and the DMA starts from line 1.
+// ------------------------------------------------------------------------------------------
+ITCM_CODE void speccy_border_vblank(void)
+{
+    static u16 *dma_table = 0;
+    static u8 dma_running = 0;
+
+    if (zx_border_offer == BORDER_OFFER_TABLE)
+    {
+        dma_table = zx_border_lines[zx_border_back];
+        zx_border_back ^= 1;    // The next frame writes the other one
+    }
+    else if (zx_border_offer == BORDER_OFFER_STATIC) dma_table = 0;
+    zx_border_offer = BORDER_OFFER_NONE;
+
+    if (dma_table)
+    {
+        DMA_CR(BORDER_DMA) = 0;
+        BG_PALETTE_SUB[1] = dma_table[0];
+        DMA_SRC(BORDER_DMA) = (u32)&dma_table[1];
+        DMA_DEST(BORDER_DMA) = (u32)&BG_PALETTE_SUB[1];
+        DMA_CR(BORDER_DMA) = DMA_ENABLE | DMA_REPEAT | DMA_START_HBL | DMA_16_BIT | DMA_SRC_INC | DMA_DST_FIX | 1;
+        dma_running = 1;
+    }
+    else if (dma_running)
+    {
+        DMA_CR(BORDER_DMA) = 0;
+        BG_PALETTE_SUB[1] = zx_border_colors[portFE & 0x07];
+        dma_running = 0;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Machine events. Everything that has to happen at the end of some particular line sits in this
+// small queue - ordered by the line it is due on - and the CPU runs straight through to the end of
+// the line the head of the queue is due on. An event can repeat over a run of lines so the entire
+// visible screen is a single entry (one line per run there). The top and bottom border lines have
+// nothing due but the odd AY batch so they go by in a handful of runs, with the beeper samples for
+// each line of the run worked out afterwards from the T-State of every speaker edge.
+// ------------------------------------------------------------------------------------------------
+#define EVT_RENDER_LINE     0   // Render the line just run and turn on accurate (contended) emulation
+#define EVT_BORDER          1   // First line below the screen - back to uncontended emulation
+#define EVT_FRAME_END       2   // Last line of the frame - raise the ULA interrupt
+#define EVT_SCREEN_START    3   // Line before the screen - start logging attribute writes (multicolor)
+#define EVT_AY_BATCH        4   // Every AY_BATCH_LINES lines - render the AY and hand the samples over
+
+#define EVT_QUEUE_SIZE      8
+
+typedef struct
+{
+    u16 line;       // The scanline (as counted by zx_current_line) on which this event is next due
+    u16 repeat;     // How many more consecutive lines after that the event fires on
+    u8  event;      // One of the EVT_xxx from above
+} MachineEvent_t;
+
+MachineEvent_t event_queue[EVT_QUEUE_SIZE]  __attribute__((section(".dtcm")));
+u8             event_count                  __attribute__((section(".dtcm"))) = 0;
+
+// -------------------------------------------------------------------------------
+// Insert an event into the queue keeping it ordered by line. Events due on the
+// same line fire in the order they were scheduled. Lines already run are dropped.
+// -------------------------------------------------------------------------------
+void speccy_schedule_event(u16 line, u16 repeat, u8 event)
+{
+    if (line <= zx_current_line)
+    {
+        if ((line + repeat) <= zx_current_line) return;
+        repeat -= (zx_current_line + 1) - line;
+        line = zx_current_line + 1;
+    }
+
+    if (event_count == EVT_QUEUE_SIZE) return;
+
+    u8 idx = event_count++;
+    while (idx && (event_queue[idx-1].line > line))
+    {
+        event_queue[idx] = event_queue[idx-1];
+        idx--;
+    }
+    event_queue[idx].line   = line;
+    event_queue[idx].repeat = repeat;
+    event_queue[idx].event  = event;
+}
+
+// -------------------------------------------------------------------------------
+// Line 1 is the first line run after the interrupt. We render 192 lines starting
+// at scanline 63 or 64 (48K machines start 1 line later) and the ULA interrupt
+// comes at the end of the last line of the frame.
+// -------------------------------------------------------------------------------
+static void speccy_schedule_frame(void)
+{
+    const u16 starting_line = (myConfig.machine ? 63:64);
+    const u16 ending_line   = (zx_128k_mode ? SCANLINES_PER_FRAME_128:SCANLINES_PER_FRAME_48);
+
+    event_count = 0;
+    if (myConfig.multicolor && !tape_state) speccy_schedule_event(starting_line-1, 0, EVT_SCREEN_START);
+    speccy_schedule_event(starting_line, 191, EVT_RENDER_LINE);
+    speccy_schedule_event(starting_line+192, 0, EVT_BORDER);
+    speccy_schedule_event(AY_BATCH_LINES, 0, EVT_AY_BATCH);
+    speccy_schedule_event(ending_line, 0, EVT_FRAME_END);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Events at an exact T-State. A few things the CPU sets off itself have to happen a set number of
+// T-States later, wherever that falls in the line, so they don't go through the line queue above.
+// There is one slot for each kind. ExecZ80_Speccy() never runs the CPU past cpu_event_next and a
+// new event raised while the CPU is running pulls zx_run_limit in so the core stops right there.
+// ------------------------------------------------------------------------------------------------
+u32 cpu_event_time[CPU_EVT_COUNT];
+u8  cpu_event_pending       __attribute__((section(".dtcm"))) = 0;            // Bit for each CPU_EVT_xxx waiting
+u32 cpu_event_next          __attribute__((section(".dtcm"))) = 0xFFFFFFFF;   // The T-State the first of them is due
+
+void speccy_cpu_event(u32 tstates, u8 event)
+{
+    cpu_event_time[event] = tstates;
+    cpu_event_pending |= (1 << event);
+    if (tstates < cpu_event_next) cpu_event_next = tstates;
+    if (tstates < zx_run_limit) zx_run_limit = tstates;
+}
+
+// Called by ExecZ80_Speccy() once CPU.TStates reaches cpu_event_next
+void speccy_cpu_events(void)
+{
+    for (u8 event=0; event<CPU_EVT_COUNT; event++)
     {
-        // This puts the CPU exactly where we should be for the end of the scanline
-        ExecZ80_Speccy(((zx_128k_mode ? (CYCLES_PER_SCANLINE_128<<myConfig.turbo):(CYCLES_PER_SCANLINE_48<<myConfig.turbo)) * zx_current_line) + ULATweak[myConfig.ULAtiming]);
-
-        // Grab 4 samples worth of AY sound to mix with the beeper
-        if (isDSiMode()) processDirectAudioDSI(); else processDirectAudio();
-
-        // -----------------------------------------------------------------------
-        // If we are not playing the tape, we want to reset the TStates counter
-        // on every new frame to help us with the somewhat complex handling of
-        // the memory contention which is heavily dependent on CPU Cycle counts.
-        // -----------------------------------------------------------------------
-        if (zx_current_line == ending_line)
+        if ((cpu_event_pending & (1 << event)) && (cpu_event_time[event] <= CPU.TStates))
         {
-            CPU.TStates = 0;
-            last_edge = 0;
+            cpu_event_pending &= ~(1 << event);
+            switch (event)
+            {
+                case CPU_EVT_DANDANATOR:
+                    dandanator_settle();
+                    break;
+
+                case CPU_EVT_TAPE:
+                    accurate_emulation = 0; // The loader has the tape going - straight on to the fast core
+                    break;
+            }
         }
     }
 
-    // -----------------------------------------------------------
-    // Render one line if we're in the visible area of the screen
-    // This is scanline 64 (first visible scanline) to 255 (last
-    // visible scanline for a total of 192 scanlines).
-    // -----------------------------------------------------------
-    if ((zx_current_line >= starting_line) && (zx_current_line < 192+starting_line))
+    cpu_event_next = 0xFFFFFFFF;
+    for (u8 event=0; event<CPU_EVT_COUNT; event++)
     {
-        // Render one scanline...
-        speccy_render_screen_line(zx_current_line - starting_line);
-        last_line_drawn++;  // Used for floating bus handling
-        accurate_emulation = (tape_state ? 0 : 1); // If tape playing, skip accurate emulation
+        if ((cpu_event_pending & (1 << event)) && (cpu_event_time[event] < cpu_event_next)) cpu_event_next = cpu_event_time[event];
     }
-    else
+}
+
+// The frame is over and CPU.TStates goes back to zero - so does anything still to come
+static void speccy_cpu_events_rebase(u32 tstates)
+{
+    for (u8 event=0; event<CPU_EVT_COUNT; event++)
     {
-        last_line_drawn = 0;
-        accurate_emulation = 0; // If in top/bottom border areas, skip accurate cycle emulation (no contention)
-
-        // ---------------------------------------------------------------------------------
-        // Generate an interrupt only at end of frame. The ULA normally generates the
-        // interrupt 1 scanline before the top blanking begins but we aren't that accurate.
-        // ---------------------------------------------------------------------------------
-        if (zx_current_line == ending_line)
+        cpu_event_time[event] = (cpu_event_time[event] > tstates) ? (cpu_event_time[event] - tstates) : 0;
+    }
+    if (cpu_event_pending) cpu_event_next = (cpu_event_next > tstates) ? (cpu_event_next - tstates) : 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Run the emulation for one full frame - from one event to the next - handling whatever events
+// come due at the end of each run of lines and finishing with the ULA interrupt. This also
+// handles direct beeper and possibly AY sound emulation as well. Returns 0 at end of frame.
+// ---------------------------------------------------------------------------------------------
+ITCM_CODE u32 speccy_run(void)
+{
+    const u8 ULATweak[] = {0, 14, 36, 72, 104, 130, 170, 230};
+    const u32 line_cycles = (zx_128k_mode ? CYCLES_PER_SCANLINE_128:CYCLES_PER_SCANLINE_48);
+    const u32 line_cycles_turbo = line_cycles << myConfig.turbo;
+    const u32 ula_tweak = ULATweak[myConfig.ULAtiming];
+    const u16 ending_line = (zx_128k_mode ? SCANLINES_PER_FRAME_128:SCANLINES_PER_FRAME_48);
+    const u8 bDSi = isDSiMode();
+    u8 bTapeLine;
+
+    speccy_schedule_frame();
+    beeper_set_timing(line_cycles_turbo, (bDSi ? 4:2));
+    ay_scale = (AY_SAMPLES_PER_LINE << 16) / line_cycles_turbo;
+
+    while (1)
+    {
+        // ---------------------------------------------------------------------
+        // The CPU runs from the next line to the end of the line the event at
+        // the head of the queue is due on. The FRAME_END is always in there.
+        // ---------------------------------------------------------------------
+        const u16 event_line = event_queue[0].line;
+        const u32 lines = event_line - zx_current_line;
+
+        ++zx_current_line; // This is the pixel line we're working on...
+        zx_run_line = event_line;
+
+        bTapeLine = (tape_state ? 1:0);
+        if (bTapeLine)
         {
-            zx_current_line = 0;
-            CPU.IRequest = INT_RST38;
-            CPU.TStates_IRequest = CPU.TStates;
-            IntZ80(&CPU, CPU.IRequest);
-            return 0; // End of frame
+            // ---------------------------------------------------------------------------------------------
+            // If we are playing back the tape - just run the emulation as fast as possible and try not to
+            // touch CPU.TStates as we can use some speed-up tricks when accelerating the tape playback...
+            // ---------------------------------------------------------------------------------------------
+            zx_line_span = line_cycles;
+            zx_line_end = CPU.TStates + line_cycles;
+            ExecZ80_Speccy(zx_line_end + ((lines-1) * line_cycles));
+            if (beeper_edge_count) beeper_drop(); // No sound while the tape loads
+
+            if (CPU.TStates > 0xFFFE0000) // Too close to the wrap point, should never happen but trap it out so we don't crash the emulation
+            {
+                CPU.TStates = 0;
+                last_edge = 0;
+                tape_stop();
+            }
         }
-    }
+        else
+        {
+            // This puts the CPU exactly where we should be for the end of the last scanline of the run
+            zx_line_span = line_cycles_turbo;
+            zx_line_end = (line_cycles_turbo * zx_current_line) + ula_tweak;
+            u32 run_end = (line_cycles_turbo * event_line) + ula_tweak;
+            ExecZ80_Speccy(run_end);
+
+            // Grab 2 (DS) or 4 (DSi) samples worth of beeper for each line (the AY is added in batches)
+            if (bDSi) processDirectAudioDSI(run_end, lines); else processDirectAudio(run_end, lines);
+        }
+
+        zx_current_line = event_line;
+
+        // ----------------------------------------------------------------
+        // Handle everything due on this line - there can be more than one
+        // ----------------------------------------------------------------
+        while (event_queue[0].line == zx_current_line)
+        {
+            MachineEvent_t evt = event_queue[0];
 
-    return 1; // Not end of frame
+            if (evt.repeat) // Still more lines to go - just move it along to the next line (keeping the queue in order)
+            {
+                event_queue[0].line++;
+                event_queue[0].repeat--;
+                for (u8 i=1; (i<event_count) && (event_queue[i].line < event_queue[i-1].line); i++)
+                {
+                    MachineEvent_t swap = event_queue[i];
+                    event_queue[i] = event_queue[i-1];
+                    event_queue[i-1] = swap;
+                }
+            }
+            else // Done with this event - pop it off the head of the queue
+            {
+                for (u8 i=1; i<event_count; i++) event_queue[i-1] = event_queue[i];
+                event_count--;
+            }
+
+            switch (evt.event)
+            {
+                // -----------------------------------------------------------
+                // Render one line if we're in the visible area of the screen
+                // This is scanline 64 (first visible scanline) to 255 (last
+                // visible scanline for a total of 192 scanlines).
+                // -----------------------------------------------------------
+                case EVT_RENDER_LINE:
+                    speccy_render_screen_line(zx_current_line - (myConfig.machine ? 63:64));
+                    zx_attr_log_count = 0;
+                    last_line_drawn++;  // Used for floating bus handling
+                    accurate_emulation = (tape_state ? 0 : 1); // If tape playing, skip accurate emulation
+                    break;
+
+                // -----------------------------------------------------------------------------------
+                // In the bottom border area - skip accurate cycle emulation (no contention)
+                // -----------------------------------------------------------------------------------
+                case EVT_BORDER:
+                    last_line_drawn = 0;
+                    accurate_emulation = 0;
+                    zx_attr_logging = 0;
+                    zx_attr_log_count = 0;
+                    break;
+
+                // -----------------------------------------------------------------------------------
+                // About to run the first line of the screen - the attribute writes now matter
+                // -----------------------------------------------------------------------------------
+                case EVT_SCREEN_START:
+                    zx_attr_logging = 1;
+                    zx_attr_log_count = 0;
+                    break;
+
+                // -----------------------------------------------------------------------------------
+                // Time to render the AY for the last batch of lines - and the next batch after that
+                // -----------------------------------------------------------------------------------
+                case EVT_AY_BATCH:
+                    ay_batch_flush();
+                    if ((zx_current_line + AY_BATCH_LINES) < ending_line) speccy_schedule_event(zx_current_line + AY_BATCH_LINES, 0, EVT_AY_BATCH);
+                    break;
+
+                // ---------------------------------------------------------------------------------
+                // Generate an interrupt only at end of frame. The ULA normally generates the
+                // interrupt 1 scanline before the top blanking begins but we aren't that accurate.
+                // ---------------------------------------------------------------------------------
+                case EVT_FRAME_END:
+                    // -----------------------------------------------------------------------
+                    // If we are not playing the tape, we want to reset the TStates counter
+                    // on every new frame to help us with the somewhat complex handling of
+                    // the memory contention which is heavily dependent on CPU Cycle counts.
+                    // -----------------------------------------------------------------------
+                    if (!bTapeLine)
+                    {
+                        speccy_cpu_events_rebase(CPU.TStates);
+                        CPU.TStates = 0;
+                        last_edge = 0;
+                    }
+
+                    speccy_border_frame(zx_current_line);
+#ifdef ZX_TILED_DISPLAY
+                    zx_tiled_latch();   // The cells of this frame can now go to VRAM
+#endif
+                    ay_batch_flush();   // The AY batches never straddle two frames
+#ifdef ZX_AY_ARM7
+                    ay7_frame_end(zx_current_line * AY7_SAMPLES_PER_LINE);
+#endif
+
+                    last_line_drawn = 0;
+                    accurate_emulation = 0;
+                    zx_current_line = 0;
+                    CPU.IRequest = INT_RST38;
+                    CPU.TStates_IRequest = CPU.TStates;
+                    IntZ80(&CPU, CPU.IRequest);
+                    return 0; // End of frame
+            }
+        }
+    }
 }
 
 #pragma GCC diagnostic pop
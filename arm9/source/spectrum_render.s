@@ -0,0 +1,158 @@
+;@
+;@  spectrum_render.s
+;@  SpeccySE - ULA scanline renderer for the ARM9.
+;@
+;@  Renders one 256 pixel line (32 character cells) of the Spectrum screen into
+;@  an 8-bit-per-pixel buffer. This is called for every visible line of every
+;@  rendered frame so it's worth doing by hand. Each cell works out the 32-bit
+;@  replicated paper (background) and ink^paper (difference) in registers, then
+;@  the two 4-pixel masks come from a 16 entry nibble table so the output is just
+;@  background ^ (difference & mask). Four cells are built up in r4-r11 and go
+;@  out with a single STMIA of 8 words. FLASH is handled by picking one of two
+;@  loops once per line - inside the loop it's a conditional EOR, not a branch.
+;@
+;@  Exactly the same output as the original C renderer in spectrum.c which it
+;@  replaces (with the Pixel_maskTable_High[]/Low[] tables it used) - that C
+;@  lives on in tests/render_replay.c which checks the two byte for byte.
+;@
+#ifdef __arm__
+
+	.global speccy_render_line_asm
+	.global speccy_render_line_ula_plus_asm
+
+	.syntax unified
+	.arm
+
+#ifdef NDS
+	.section .itcm, "ax", %progbits		;@ For the NDS ARM9
+#else
+	.section .text
+#endif
+	.align 2
+;@----------------------------------------------------------------------------
+;@ r0  = video buffer (destination - 256 bytes)
+;@ r1  = attribute pointer (32 bytes, 32 byte aligned)
+;@ r2  = pixel pointer (32 bytes, 32 byte aligned)
+;@ r3  = pointer to pixelNibbles
+;@ r4-r11 = 8 output words (4 cells)
+;@ r12 = attribute / high mask
+;@ lr  = pixel byte / low mask
+;@----------------------------------------------------------------------------
+
+;@ The two 4-pixel masks for the pixel byte in lr, combined with the colors
+;@ in \bg and \diff - leaves the left 4 pixels in \bg and the right 4 in \diff.
+	.macro PIXELS bg, diff
+	and r12,lr,#0xF0
+	ldr r12,[r3,r12,lsr#2]		;@ Mask for the left 4 pixels
+	and lr,lr,#0x0F
+	ldr lr,[r3,lr,lsl#2]		;@ Mask for the right 4 pixels
+	and r12,r12,\diff
+	and lr,lr,\diff
+	eor \diff,\bg,lr
+	eor \bg,\bg,r12
+	.endm
+
+;@ One normal ULA cell: paper is bits 3-6 (with BRIGHT), ink is bits 0-2 + BRIGHT
+	.macro ULA_CELL bg, diff, flash
+	ldrb r12,[r1],#1			;@ Attribute
+	ldrb lr,[r2],#1				;@ 8 pixels
+	.if \flash
+	tst r12,#0x80
+	eorne lr,lr,#0xFF			;@ FLASH inverts the pixels
+	.endif
+	and \bg,r12,#0x78
+	mov \bg,\bg,lsr#3			;@ Paper
+	and \diff,r12,#0x07
+	tst r12,#0x40
+	orrne \diff,\diff,#0x08		;@ Ink
+	eor \diff,\diff,\bg
+	orr \bg,\bg,\bg,lsl#8
+	orr \bg,\bg,\bg,lsl#16		;@ Paper in all 4 bytes
+	orr \diff,\diff,\diff,lsl#8
+	orr \diff,\diff,\diff,lsl#16	;@ Ink^Paper in all 4 bytes
+	PIXELS \bg, \diff
+	.endm
+
+;@ One ULA+ cell: bits 6-7 select one of 4 palettes of 8 ink + 8 paper colors
+	.macro ULAPLUS_CELL bg, diff
+	ldrb r12,[r1],#1			;@ Attribute
+	ldrb lr,[r2],#1				;@ 8 pixels
+	and \bg,r12,#0x38
+	mov \bg,\bg,lsr#3			;@ Paper within the palette
+	and \diff,r12,#0x07
+	eor \diff,\diff,\bg
+	orr \diff,\diff,#0x08		;@ Ink^Paper (the palette select cancels out)
+	and r12,r12,#0xC0
+	orr \bg,\bg,r12,lsr#2
+	orr \bg,\bg,#0x88			;@ Paper is 0x80 + palette*16 + 8 + color
+	orr \bg,\bg,\bg,lsl#8
+	orr \bg,\bg,\bg,lsl#16		;@ Paper in all 4 bytes
+	orr \diff,\diff,\diff,lsl#8
+	orr \diff,\diff,\diff,lsl#16	;@ Ink^Paper in all 4 bytes
+	PIXELS \bg, \diff
+	.endm
+
+;@----------------------------------------------------------------------------
+speccy_render_line_asm:		;@ r0=vidBuf, r1=attrPtr, r2=pixelPtr, r3=bFlash
+	.type   speccy_render_line_asm STT_FUNC
+;@----------------------------------------------------------------------------
+	stmfd sp!,{r4-r11,lr}
+	tst r3,#0xFF
+	ldr r3,=pixelNibbles
+	bne flashLoop
+;@----------------------------------------------------------------------------
+normalLoop:
+	ULA_CELL r4, r5, 0
+	ULA_CELL r6, r7, 0
+	ULA_CELL r8, r9, 0
+	ULA_CELL r10, r11, 0
+	stmia r0!,{r4-r11}
+	tst r1,#0x1F				;@ Done with the 32 cells when we wrap to the next row
+	bne normalLoop
+
+	ldmfd sp!,{r4-r11,lr}
+	bx lr
+;@----------------------------------------------------------------------------
+flashLoop:
+	ULA_CELL r4, r5, 1
+	ULA_CELL r6, r7, 1
+	ULA_CELL r8, r9, 1
+	ULA_CELL r10, r11, 1
+	stmia r0!,{r4-r11}
+	tst r1,#0x1F
+	bne flashLoop
+
+	ldmfd sp!,{r4-r11,lr}
+	bx lr
+
+;@----------------------------------------------------------------------------
+speccy_render_line_ula_plus_asm:	;@ r0=vidBuf, r1=attrPtr, r2=pixelPtr
+	.type   speccy_render_line_ula_plus_asm STT_FUNC
+;@----------------------------------------------------------------------------
+	stmfd sp!,{r4-r11,lr}
+	ldr r3,=pixelNibbles
+ulaPlusLoop:
+	ULAPLUS_CELL r4, r5
+	ULAPLUS_CELL r6, r7
+	ULAPLUS_CELL r8, r9
+	ULAPLUS_CELL r10, r11
+	stmia r0!,{r4-r11}
+	tst r1,#0x1F
+	bne ulaPlusLoop
+
+	ldmfd sp!,{r4-r11,lr}
+	bx lr
+	.pool
+
+#ifdef NDS
+	.section .dtcm, "a", %progbits		;@ For the NDS ARM9
+	.align 2
+#endif
+;@----------------------------------------------------------------------------
+pixelNibbles:				;@ 4 pixels to 4 bytes - the leftmost pixel (bit 3) is the low byte
+	.long 0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000, 0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00
+	.long 0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF, 0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF
+;@----------------------------------------------------------------------------
+
+	.section .text
+#endif // #ifdef __arm__
@@ -528,6 +528,17 @@ void tape_play(void)
     DisplayStatusLine(false);
 }
 
+// ---------------------------------------------------------------
+// The loader went looking for an edge so the tape starts itself.
+// This happens with the CPU running - CPU_EVT_TAPE takes the CPU
+// off the contended core right away rather than at the next line.
+// ---------------------------------------------------------------
+void tape_autostart(void)
+{
+    tape_state = TAPE_START;
+    speccy_cpu_event(CPU.TStates, CPU_EVT_TAPE);
+}
+
 void tape_position(u8 newPos)
 {
     current_block = TapePositionTable[newPos].block_id;
@@ -1030,7 +1041,7 @@ u8 inline __attribute__((always_inline)) tape_pulse_fast_no_shift(void)
 //so that we can use this same routine when the standard loader is used in other memory locations.
 ITCM_CODE u8 tape_sample_standard(void)
 {
-    if (!tape_state) tape_state = TAPE_START; // If we aren't playing the tape, may as well do so as we're trying to find an edge
+    if (!tape_state) tape_autostart(); // If we aren't playing the tape, may as well do so as we're trying to find an edge
 
     int B = 255-CPU.BC.B.h;     // Very slight speedups to take these into local stack vars
     const u8 C = CPU.BC.B.l;    // Very slight speedups to take these into local stack vars
@@ -1093,7 +1104,7 @@ ld_sample:
 
 u8 tape_sample_speedlock(void)
 {
-    if (!tape_state) tape_state = TAPE_START;
+    if (!tape_state) tape_autostart();
 
     // The CyclesED[] table will consume the 18 cycles that the LDA, INA would have taken here...
     int B = 255-CPU.BC.B.h;
@@ -1160,7 +1171,7 @@ ld_sample:
 //        {2} JR Z,LD-SAMP        [+12/5] Jump back to LD-SAMP unless it has changed
 u8 tape_sample_alkatraz(void)
 {
-    if (!tape_state) tape_state = TAPE_START;
+    if (!tape_state) tape_autostart();
 
     // The CyclesED[] table will consume the 11 cycles that the IN A, (+FE) would have taken here...
     int B = 255-CPU.BC.B.h;
@@ -1236,7 +1247,7 @@ ld_sample:
 
 u8 tape_sample_microsphere_bleepload(void)
 {
-    if (!tape_state) tape_state = TAPE_START;
+    if (!tape_state) tape_autostart();
 
     // The CyclesED[] table will consume the 18 cycles that the LDA, INA would have taken here...
     int B = 255-CPU.BC.B.h;
@@ -1293,7 +1304,7 @@ ld_sample:
 
 u8 tape_sample_searchloader(void)
 {
-    if (!tape_state) tape_state = TAPE_START;
+    if (!tape_state) tape_autostart();
 
     // The CyclesED[] table will consume the 18 cycles that the LDA, INA would have taken here...
     int B = 255-CPU.BC.B.h;
@@ -1354,7 +1365,7 @@ ld_sample:
 //
 u8 tape_sample_variant_search(void)
 {
-    if (!tape_state) tape_state = TAPE_START;
+    if (!tape_state) tape_autostart();
 
     // The CyclesED[] table will consume the 18 cycles that the LDA, INA would have taken here...
     int B = 255-CPU.BC.B.h;
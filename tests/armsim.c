@@ -0,0 +1,558 @@
+// =====================================================================================
+// armsim - see armsim.h. This is written for clarity over speed: every instruction is
+// decoded from scratch each time it runs. The routines we test run a few million
+// instructions at most so it doesn't matter.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "armsim.h"
+
+#define HOST_BASE       0xFFFF0000      // Host functions live up here, one word each
+#define HOST_MAX        16
+#define RETURN_ADDR     0xFFFFFFF0      // armsim_call() returns when the ARM code jumps here
+
+#define MAX_SYMBOLS     1024
+
+static uint8_t arena[ARMSIM_SIZE];
+static uint32_t arena_next = ARMSIM_BASE;
+
+static struct { const char *name; armsim_host_fn fn; } host_fns[HOST_MAX];
+static int host_count = 0;
+
+static struct { char name[64]; uint32_t addr; } symbols[MAX_SYMBOLS];
+static int symbol_count = 0;
+
+static uint32_t r[16];
+static int N, Z, C, V;
+uint64_t armsim_steps = 0;
+
+static void fail(const char *what, uint32_t value)
+{
+    fprintf(stderr, "armsim: %s (%08X) at PC=%08X\n", what, value, r[15]);
+    exit(2);
+}
+
+void *armsim_ptr(uint32_t addr)
+{
+    if ((addr < ARMSIM_BASE) || (addr >= ARMSIM_BASE + ARMSIM_SIZE)) return NULL;
+    return &arena[addr - ARMSIM_BASE];
+}
+
+static uint8_t *mem(uint32_t addr, uint32_t size)
+{
+    if ((addr < ARMSIM_BASE) || (addr + size > ARMSIM_BASE + ARMSIM_SIZE)) fail("access outside the arena", addr);
+    return &arena[addr - ARMSIM_BASE];
+}
+
+static uint32_t rd32(uint32_t a)
+{
+    uint8_t *p = mem(a & ~3, 4);
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    uint32_t rot = (a & 3) * 8;     // An unaligned LDR rotates the word on the ARM9
+    return rot ? (v >> rot) | (v << (32 - rot)) : v;
+}
+static uint16_t rd16(uint32_t a)            { uint8_t *p = mem(a & ~1, 2); return p[0] | (p[1] << 8); }
+static uint8_t  rd8(uint32_t a)             { return *mem(a, 1); }
+static void wr32(uint32_t a, uint32_t v)    { uint8_t *p = mem(a & ~3, 4); p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+static void wr16(uint32_t a, uint32_t v)    { uint8_t *p = mem(a & ~1, 2); p[0] = v; p[1] = v >> 8; }
+static void wr8(uint32_t a, uint32_t v)     { *mem(a, 1) = v; }
+
+uint32_t armsim_alloc(uint32_t size)
+{
+    uint32_t addr = (arena_next + 31) & ~31;
+    if (addr + size > ARMSIM_BASE + ARMSIM_SIZE - 0x10000) fail("arena full", size); // Keep 64K for the stack
+    arena_next = addr + size;
+    memset(armsim_ptr(addr), 0, size);
+    return addr;
+}
+
+void armsim_host(const char *name, armsim_host_fn fn)
+{
+    if (host_count == HOST_MAX) fail("too many host functions", 0);
+    host_fns[host_count].name = name;
+    host_fns[host_count].fn = fn;
+    host_count++;
+}
+
+uint32_t armsim_symbol(const char *name)
+{
+    for (int i = 0; i < symbol_count; i++)
+    {
+        if (!strcmp(symbols[i].name, name)) return symbols[i].addr;
+    }
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+// ELF32 relocatable loader - only what an assembler puts out for our .s files.
+// -------------------------------------------------------------------------------------
+#define U16(p)  ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8))
+#define U32(p)  ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) | ((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24))
+
+#define SHT_SYMTAB      2
+#define SHT_NOBITS      8
+#define SHT_REL         9
+#define SHF_ALLOC       2
+#define SHN_ABS         0xFFF1
+
+#define R_ARM_NONE      0
+#define R_ARM_PC24      1
+#define R_ARM_ABS32     2
+#define R_ARM_REL32     3
+#define R_ARM_CALL      28
+#define R_ARM_JUMP24    29
+#define R_ARM_V4BX      40
+
+int armsim_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror(path); return 1; }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *elf = malloc(len);
+    if (fread(elf, 1, len, f) != (size_t)len) { fclose(f); free(elf); return 1; }
+    fclose(f);
+
+    if (memcmp(elf, "\177ELF\001\001", 6) || (U16(elf + 16) != 1) || (U16(elf + 18) != 40))
+    {
+        fprintf(stderr, "armsim: %s is not a little endian ARM relocatable object\n", path);
+        free(elf);
+        return 1;
+    }
+
+    uint32_t shoff = U32(elf + 32), shentsize = U16(elf + 46), shnum = U16(elf + 48);
+    #define SH(i)   (elf + shoff + (i) * shentsize)
+    uint32_t *base = calloc(shnum, sizeof(uint32_t));
+
+    // Place every section that takes up memory
+    for (uint32_t i = 1; i < shnum; i++)
+    {
+        uint8_t *sh = SH(i);
+        if (!(U32(sh + 8) & SHF_ALLOC)) continue;
+        uint32_t align = U32(sh + 32), size = U32(sh + 20);
+        if (align < 32) align = 32;
+        arena_next = (arena_next + align - 1) & ~(align - 1);
+        base[i] = armsim_alloc(size ? size : 4);
+        if (U32(sh + 4) != SHT_NOBITS) memcpy(armsim_ptr(base[i]), elf + U32(sh + 16), size);
+    }
+
+    // Remember the named symbols
+    for (uint32_t i = 1; i < shnum; i++)
+    {
+        uint8_t *sh = SH(i);
+        if (U32(sh + 4) != SHT_SYMTAB) continue;
+        const char *strtab = (const char *)elf + U32(SH(U32(sh + 24)) + 16);
+        for (uint32_t s = 16; s < U32(sh + 20); s += 16)
+        {
+            uint8_t *sym = elf + U32(sh + 16) + s;
+            uint32_t shndx = U16(sym + 14);
+            const char *name = strtab + U32(sym);
+            if (!*name || !shndx || (shndx >= shnum && shndx != SHN_ABS)) continue;
+            if (symbol_count == MAX_SYMBOLS) fail("too many symbols", s);
+            strncpy(symbols[symbol_count].name, name, sizeof(symbols[0].name) - 1);
+            symbols[symbol_count].addr = U32(sym + 4) + ((shndx == SHN_ABS) ? 0 : base[shndx]);
+            symbol_count++;
+        }
+    }
+
+    // And patch up the references
+    for (uint32_t i = 1; i < shnum; i++)
+    {
+        uint8_t *sh = SH(i);
+        if ((U32(sh + 4) != SHT_REL) || !base[U32(sh + 28)]) continue;
+        uint8_t *symtab = elf + U32(SH(U32(sh + 24)) + 16);
+        const char *strtab = (const char *)elf + U32(SH(U32(SH(U32(sh + 24)) + 24)) + 16);
+        for (uint32_t e = 0; e < U32(sh + 20); e += 8)
+        {
+            uint8_t *rel = elf + U32(sh + 16) + e;
+            uint32_t P = base[U32(sh + 28)] + U32(rel);
+            uint32_t type = U32(rel + 4) & 0xFF;
+            uint8_t *sym = symtab + (U32(rel + 4) >> 8) * 16;
+            uint32_t shndx = U16(sym + 14), S = U32(sym + 4);
+
+            if (shndx == 0)
+            {
+                const char *name = strtab + U32(sym);
+                int h;
+                for (h = 0; h < host_count; h++) if (!strcmp(host_fns[h].name, name)) break;
+                if (h == host_count) { fprintf(stderr, "armsim: %s needs %s\n", path, name); exit(2); }
+                S = HOST_BASE + h * 4;
+            }
+            else if (shndx != SHN_ABS) S += base[shndx];
+
+            uint32_t word = rd32(P);
+            switch (type)
+            {
+                case R_ARM_NONE:
+                case R_ARM_V4BX:
+                    break;
+                case R_ARM_ABS32:
+                    wr32(P, word + S);
+                    break;
+                case R_ARM_REL32:
+                    wr32(P, word + S - P);
+                    break;
+                case R_ARM_PC24:
+                case R_ARM_CALL:
+                case R_ARM_JUMP24:
+                {
+                    int32_t A = ((int32_t)(word << 8)) >> 6;
+                    wr32(P, (word & 0xFF000000) | (((S + A - P) >> 2) & 0x00FFFFFF));
+                    break;
+                }
+                default:
+                    fprintf(stderr, "armsim: %s has relocation type %u\n", path, type);
+                    exit(2);
+            }
+        }
+    }
+
+    free(base);
+    free(elf);
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+// The interpreter
+// -------------------------------------------------------------------------------------
+static int cond_passed(uint32_t cond)
+{
+    switch (cond)
+    {
+        case 0x0: return Z;
+        case 0x1: return !Z;
+        case 0x2: return C;
+        case 0x3: return !C;
+        case 0x4: return N;
+        case 0x5: return !N;
+        case 0x6: return V;
+        case 0x7: return !V;
+        case 0x8: return C && !Z;
+        case 0x9: return !C || Z;
+        case 0xA: return N == V;
+        case 0xB: return N != V;
+        case 0xC: return !Z && (N == V);
+        case 0xD: return Z || (N != V);
+        case 0xE: return 1;
+    }
+    return 0;
+}
+
+// Barrel shifter. by_reg selects the register-specified rules (amount 0 = no shift, >= 32 allowed).
+static uint32_t shift(uint32_t v, uint32_t type, uint32_t amount, int by_reg, int *carry)
+{
+    if (by_reg)
+    {
+        if (amount == 0) { *carry = C; return v; }
+        switch (type)
+        {
+            case 0:
+                if (amount < 32)  { *carry = (v >> (32 - amount)) & 1; return v << amount; }
+                *carry = (amount == 32) ? (v & 1) : 0;
+                return 0;
+            case 1:
+                if (amount < 32)  { *carry = (v >> (amount - 1)) & 1; return v >> amount; }
+                *carry = (amount == 32) ? (v >> 31) : 0;
+                return 0;
+            case 2:
+                if (amount < 32)  { *carry = ((int32_t)v >> (amount - 1)) & 1; return (int32_t)v >> amount; }
+                *carry = v >> 31;
+                return (int32_t)v >> 31;
+            default:
+                amount &= 31;
+                if (amount == 0)  { *carry = v >> 31; return v; }
+                *carry = (v >> (amount - 1)) & 1;
+                return (v >> amount) | (v << (32 - amount));
+        }
+    }
+
+    switch (type)
+    {
+        case 0:
+            if (amount == 0) { *carry = C; return v; }
+            *carry = (v >> (32 - amount)) & 1;
+            return v << amount;
+        case 1:
+            if (amount == 0) { *carry = v >> 31; return 0; }                            // LSR #32
+            *carry = (v >> (amount - 1)) & 1;
+            return v >> amount;
+        case 2:
+            if (amount == 0) { *carry = v >> 31; return (int32_t)v >> 31; }             // ASR #32
+            *carry = ((int32_t)v >> (amount - 1)) & 1;
+            return (int32_t)v >> amount;
+        default:
+            if (amount == 0) { *carry = v & 1; return (v >> 1) | ((uint32_t)C << 31); } // RRX
+            *carry = (v >> (amount - 1)) & 1;
+            return (v >> amount) | (v << (32 - amount));
+    }
+}
+
+static void set_nz(uint32_t v) { N = v >> 31; Z = (v == 0); }
+
+static uint32_t add_flags(uint32_t a, uint32_t b, uint32_t carry_in, int set)
+{
+    uint64_t wide = (uint64_t)a + b + carry_in;
+    uint32_t res = (uint32_t)wide;
+    if (set)
+    {
+        set_nz(res);
+        C = (wide >> 32) & 1;
+        V = ((~(a ^ b) & (a ^ res)) >> 31) & 1;
+    }
+    return res;
+}
+
+static void data_processing(uint32_t i, uint32_t pc)
+{
+    uint32_t op = (i >> 21) & 15, S = (i >> 20) & 1;
+    uint32_t Rn = (i >> 16) & 15, Rd = (i >> 12) & 15;
+    uint32_t a = r[Rn], b, res = 0;
+    int carry = C, write = 1;
+
+    if (i & (1 << 25))
+    {
+        uint32_t rot = ((i >> 8) & 15) * 2;
+        b = i & 0xFF;
+        if (rot) { b = (b >> rot) | (b << (32 - rot)); carry = b >> 31; }
+    }
+    else if (i & (1 << 4))
+    {
+        uint32_t Rm = i & 15, Rs = (i >> 8) & 15;
+        uint32_t vm = (Rm == 15) ? pc + 12 : r[Rm];
+        if (Rn == 15) a = pc + 12;
+        b = shift(vm, (i >> 5) & 3, r[Rs] & 0xFF, 1, &carry);
+    }
+    else
+    {
+        b = shift(r[i & 15], (i >> 5) & 3, (i >> 7) & 31, 0, &carry);
+    }
+
+    switch (op)
+    {
+        case 0x0: res = a & b; break;                                   // AND
+        case 0x1: res = a ^ b; break;                                   // EOR
+        case 0x2: res = add_flags(a, ~b, 1, S); break;                  // SUB
+        case 0x3: res = add_flags(b, ~a, 1, S); break;                  // RSB
+        case 0x4: res = add_flags(a, b, 0, S); break;                   // ADD
+        case 0x5: res = add_flags(a, b, C, S); break;                   // ADC
+        case 0x6: res = add_flags(a, ~b, C, S); break;                  // SBC
+        case 0x7: res = add_flags(b, ~a, C, S); break;                  // RSC
+        case 0x8: res = a & b; write = 0; break;                        // TST
+        case 0x9: res = a ^ b; write = 0; break;                        // TEQ
+        case 0xA: res = add_flags(a, ~b, 1, 1); write = 0; break;       // CMP
+        case 0xB: res = add_flags(a, b, 0, 1); write = 0; break;        // CMN
+        case 0xC: res = a | b; break;                                   // ORR
+        case 0xD: res = b; break;                                       // MOV
+        case 0xE: res = a & ~b; break;                                  // BIC
+        case 0xF: res = ~b; break;                                      // MVN
+    }
+
+    if (!write && !S) fail("MRS/MSR and friends are not supported", i);
+
+    // The logical ops take the carry from the shifter, the arithmetic ones set all four above
+    if (S && ((op < 2) || (op == 8) || (op == 9) || (op >= 12))) { set_nz(res); C = carry; }
+
+    if (write)
+    {
+        if ((Rd == 15) && S) fail("data processing into PC with S is not supported", i);
+        r[Rd] = res;
+    }
+}
+
+static void multiply(uint32_t i)
+{
+    uint32_t Rd = (i >> 16) & 15, Rn = (i >> 12) & 15, Rs = (i >> 8) & 15, Rm = i & 15;
+    uint32_t S = (i >> 20) & 1, A = (i >> 21) & 1;
+
+    if (!(i & (1 << 23)))
+    {
+        uint32_t res = r[Rm] * r[Rs] + (A ? r[Rn] : 0);
+        r[Rd] = res;
+        if (S) set_nz(res);
+        return;
+    }
+
+    uint64_t res;
+    if (i & (1 << 22)) res = (uint64_t)((int64_t)(int32_t)r[Rm] * (int32_t)r[Rs]);   // SMULL/SMLAL
+    else               res = (uint64_t)r[Rm] * r[Rs];                              // UMULL/UMLAL
+    if (A) res += ((uint64_t)r[Rd] << 32) | r[Rn];
+    r[Rn] = (uint32_t)res;
+    r[Rd] = (uint32_t)(res >> 32);
+    if (S) { N = res >> 63; Z = (res == 0); }
+}
+
+static void halfword_transfer(uint32_t i)
+{
+    uint32_t P = (i >> 24) & 1, U = (i >> 23) & 1, W = (i >> 21) & 1, L = (i >> 20) & 1;
+    uint32_t Rn = (i >> 16) & 15, Rd = (i >> 12) & 15, SH = (i >> 5) & 3;
+    uint32_t off = (i & (1 << 22)) ? (((i >> 4) & 0xF0) | (i & 15)) : r[i & 15];
+    uint32_t addr = P ? (U ? r[Rn] + off : r[Rn] - off) : r[Rn];
+    uint32_t val = 0;
+
+    if (L)
+    {
+        if (SH == 1) val = rd16(addr);
+        else if (SH == 2) val = (int32_t)(int8_t)rd8(addr);
+        else val = (int32_t)(int16_t)rd16(addr);
+    }
+    else if (SH == 1) wr16(addr, r[Rd]);
+    else if (SH == 3) { wr32(addr, r[Rd]); wr32(addr + 4, r[Rd + 1]); }                     // STRD
+    else { r[Rd] = rd32(addr); r[Rd + 1] = rd32(addr + 4); }                                  // LDRD
+
+    if (!P) r[Rn] = U ? r[Rn] + off : r[Rn] - off;
+    else if (W) r[Rn] = addr;
+    if (L) r[Rd] = val;
+}
+
+static void single_transfer(uint32_t i, uint32_t *next)
+{
+    uint32_t P = (i >> 24) & 1, U = (i >> 23) & 1, B = (i >> 22) & 1, W = (i >> 21) & 1, L = (i >> 20) & 1;
+    uint32_t Rn = (i >> 16) & 15, Rd = (i >> 12) & 15, off;
+    int carry;
+
+    if (i & (1 << 25)) off = shift(r[i & 15], (i >> 5) & 3, (i >> 7) & 31, 0, &carry);
+    else off = i & 0xFFF;
+
+    uint32_t addr = P ? (U ? r[Rn] + off : r[Rn] - off) : r[Rn];
+    uint32_t val = 0;
+
+    if (L) val = B ? rd8(addr) : rd32(addr);
+    else if (B) wr8(addr, r[Rd]);
+    else wr32(addr, (Rd == 15) ? r[15] + 4 : r[Rd]);
+
+    if (!P) r[Rn] = U ? r[Rn] + off : r[Rn] - off;
+    else if (W) r[Rn] = addr;
+
+    if (L)
+    {
+        if (Rd == 15) *next = val & ~1;
+        else r[Rd] = val;
+    }
+}
+
+static void block_transfer(uint32_t i, uint32_t *next)
+{
+    uint32_t P = (i >> 24) & 1, U = (i >> 23) & 1, W = (i >> 21) & 1, L = (i >> 20) & 1;
+    uint32_t Rn = (i >> 16) & 15, list = i & 0xFFFF;
+    uint32_t count = __builtin_popcount(list);
+    uint32_t addr, base = r[Rn];
+
+    if (i & (1 << 22)) fail("LDM/STM with the S bit is not supported", i);
+    if (!count) fail("empty register list", i);
+
+    if (U) addr = base + (P ? 4 : 0);
+    else addr = base - count * 4 + (P ? 0 : 4);
+
+    if (L)
+    {
+        if (W) r[Rn] = U ? base + count * 4 : base - count * 4;   // A loaded base wins
+        for (int n = 0; n < 16; n++)
+        {
+            if (!(list & (1 << n))) continue;
+            uint32_t v = rd32(addr);
+            addr += 4;
+            if (n == 15) *next = v & ~1;
+            else r[n] = v;
+        }
+    }
+    else
+    {
+        for (int n = 0; n < 16; n++)
+        {
+            if (!(list & (1 << n))) continue;
+            wr32(addr, (n == 15) ? r[15] + 4 : r[n]);
+            addr += 4;
+        }
+        if (W) r[Rn] = U ? base + count * 4 : base - count * 4;
+    }
+}
+
+uint32_t armsim_call(uint32_t fn, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    memset(r, 0, sizeof(r));
+    r[0] = a0; r[1] = a1; r[2] = a2; r[3] = a3;
+    r[13] = ARMSIM_BASE + ARMSIM_SIZE - 16;
+    r[14] = RETURN_ADDR;
+    uint32_t pc = fn;
+
+    while (pc != RETURN_ADDR)
+    {
+        if (pc >= HOST_BASE)
+        {
+            uint32_t h = (pc - HOST_BASE) / 4;
+            if (h >= (uint32_t)host_count) fail("jump into nowhere", pc);
+            r[15] = pc;
+            host_fns[h].fn(r);
+            pc = r[14] & ~1;
+            continue;
+        }
+
+        uint32_t i = rd32(pc);
+        uint32_t next = pc + 4;
+        r[15] = pc + 8;
+        armsim_steps++;
+
+        if ((i >> 28) == 0xF)
+        {
+            if ((i & 0x0D70F000) == 0x0550F000) { pc = next; continue; }   // PLD
+            fail("unsupported unconditional instruction", i);
+        }
+
+        if (cond_passed(i >> 28))
+        {
+            switch ((i >> 25) & 7)
+            {
+                case 0:
+                    if ((i & 0x0FFFFFD0) == 0x012FFF10)                     // BX / BLX register
+                    {
+                        if (i & (1 << 5)) r[14] = next;
+                        if (r[i & 15] & 1) fail("Thumb is not supported", r[i & 15]);
+                        next = r[i & 15];
+                    }
+                    else if ((i & 0x0FFF0FF0) == 0x016F0F10)                // CLZ
+                    {
+                        uint32_t v = r[i & 15];
+                        r[(i >> 12) & 15] = v ? __builtin_clz(v) : 32;
+                    }
+                    else if ((i & 0x0F0000F0) == 0x00000090)                // MUL/MLA and the long forms
+                    {
+                        multiply(i);
+                    }
+                    else if ((i & 0x0E000090) == 0x00000090)                // LDRH/STRH/LDRSB/LDRSH/LDRD/STRD
+                    {
+                        halfword_transfer(i);
+                    }
+                    else if ((i & 0x0F900000) == 0x01000000)                // MRS/MSR/SWP/DSP multiplies
+                    {
+                        fail("unsupported instruction", i);
+                    }
+                    else data_processing(i, pc);
+                    break;
+                case 1:
+                    data_processing(i, pc);
+                    break;
+                case 2:
+                case 3:
+                    if ((i & (1 << 25)) && (i & (1 << 4))) fail("undefined instruction", i);
+                    single_transfer(i, &next);
+                    break;
+                case 4:
+                    block_transfer(i, &next);
+                    break;
+                case 5:
+                    if (i & (1 << 24)) r[14] = next;
+                    next = pc + 8 + (((int32_t)(i << 8)) >> 6);
+                    break;
+                default:
+                    fail("unsupported instruction", i);
+            }
+
+            // Anything that wrote the PC as a plain register is a branch
+            if ((r[15] != pc + 8) && (next == pc + 4)) next = r[15] & ~3;
+        }
+        pc = next;
+    }
+    return r[0];
+}
@@ -0,0 +1,41 @@
+// =====================================================================================
+// armsim - just enough of an ARMv5TE (ARM state) interpreter to run our hand written
+// ARM9 routines (AY38910.s, spectrum_render.s) on the build machine so the host tests
+// can compare them against the C versions. It loads the relocatable object straight
+// out of the assembler (no linker needed), places every allocated section in a flat
+// arena and resolves anything the object calls but doesn't define (memcpy) to host
+// functions. Nothing about timing, modes or Thumb - it's a calculator, not an NDS.
+// =====================================================================================
+#ifndef ARMSIM_H
+#define ARMSIM_H
+
+#include <stdint.h>
+
+#define ARMSIM_BASE     0x02000000      // Where the arena starts in the ARM address space (main RAM)
+#define ARMSIM_SIZE     0x00400000      // 4MB is plenty for code, tables, buffers and the stack
+
+typedef void (*armsim_host_fn)(uint32_t *r);    // r[0..15] - result goes back in r[0]
+
+// Load an ELF32 ARM relocatable object. Returns 0 on success.
+int armsim_load(const char *path);
+
+// Address of a symbol defined in the loaded object (0 if missing).
+uint32_t armsim_symbol(const char *name);
+
+// Tell the loader what to do with a symbol the object references but doesn't define.
+// Must be called before armsim_load().
+void armsim_host(const char *name, armsim_host_fn fn);
+
+// Carve a block out of the arena for test data. Zeroed, 32 byte aligned.
+uint32_t armsim_alloc(uint32_t size);
+
+// Host pointer for an ARM address (NULL if outside the arena).
+void *armsim_ptr(uint32_t addr);
+
+// Call an ARM function with up to 4 arguments. Returns r0.
+uint32_t armsim_call(uint32_t fn, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+// Instructions executed since load.
+extern uint64_t armsim_steps;
+
+#endif
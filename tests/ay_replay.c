@@ -0,0 +1,282 @@
+// =====================================================================================
+// ay_replay - plays the same AY register streams through the ARM core (AY38910.s run
+// under armsim) and the portable C core (AY38910.c) and checks that every sample and
+// the chip state afterwards come out the same.
+//
+//   ay_replay AY38910.o     both cores, live - and prints the stream hashes
+//   ay_replay               the C core only, against golden/ay_replay.txt (hashes
+//                           taken from the ARM core with the line above)
+//   ay_replay -bench [AY38910.o]   how many samples/sec the C core mixes on this
+//                           machine (and ARM instructions/sample for the asm)
+//
+// The streams are made up here, one to look like a music player (all the registers
+// once per frame, envelopes restarted now and then) and one that pokes anything
+// anywhere including the mix lengths of 0 and 1 the ARM loop treats specially.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int16_t s16;
+typedef int32_t s32;
+
+#include "AY38910.h"
+#include "armsim.h"
+
+#define STREAMS         8
+#define FRAMES          50
+#define FRAME_SAMPLES   882             // 44.1kHz at 50 frames/sec
+#define ARM_AY_SIZE     92              // aySize in AY38910.i - the C struct has 64-bit pointers here
+#define ARM_AY_PTR      32              // ayEnvVolumePtr - the one pointer inside the compared state
+#define ARM_AY_STATE    76              // ayStateSize - everything from here on is function pointers
+
+static u32 rng;
+static u32 rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static uint64_t hash;
+static void mix_hash(const void *p, size_t n)
+{
+    const u8 *b = p;
+    while (n--) { hash ^= *b++; hash *= 1099511628211ULL; }
+}
+
+static int arm = 0;
+static u32 arm_chip, arm_buf, fnReset, fnIndexW, fnDataW, fnDataR, fnMixer;
+static AY38910 c_chip;
+static s16 c_buf[1024];
+static int failures = 0;
+
+static void host_memcpy(uint32_t *r) { memcpy(armsim_ptr(r[0]), armsim_ptr(r[1]), r[2]); }
+
+// The C struct laid out the way the ARM side sees it (pointer left as 0)
+static void c_state(u8 *out)
+{
+    memset(out, 0, ARM_AY_STATE);
+    memcpy(out, &c_chip, offsetof(AY38910, ayEnvVolumePtr));
+    memcpy(out + ARM_AY_PTR + 4, &c_chip.ayAttChg, ARM_AY_STATE - ARM_AY_PTR - 4);
+}
+
+static void check_state(int stream, int step)
+{
+    u8 c[ARM_AY_STATE];
+    c_state(c);
+    mix_hash(c, ARM_AY_STATE);
+    if (!arm) return;
+
+    u8 a[ARM_AY_STATE];
+    memcpy(a, armsim_ptr(arm_chip), ARM_AY_STATE);
+    memset(a + ARM_AY_PTR, 0, 4);
+    if (memcmp(a, c, ARM_AY_STATE))
+    {
+        for (int i = 0; i < ARM_AY_STATE; i++)
+        {
+            if (a[i] != c[i]) { printf("stream %d step %d: state byte %d is %02X (asm) vs %02X (C)\n", stream, step, i, a[i], c[i]); break; }
+        }
+        failures++;
+    }
+}
+
+static void reset(void)
+{
+    ay38910Reset(&c_chip);
+    if (arm) armsim_call(fnReset, arm_chip, 0, 0, 0);
+}
+
+static void write_reg(u8 reg, u8 value)
+{
+    ay38910IndexW(reg, &c_chip);
+    ay38910DataW(value, &c_chip);
+    if (arm)
+    {
+        armsim_call(fnIndexW, reg, arm_chip, 0, 0);
+        armsim_call(fnDataW, value, arm_chip, 0, 0);
+    }
+}
+
+static void read_reg(int stream, u8 reg)
+{
+    ay38910IndexW(reg, &c_chip);
+    u8 c = ay38910DataR(&c_chip);
+    mix_hash(&c, 1);
+    if (!arm) return;
+
+    armsim_call(fnIndexW, reg, arm_chip, 0, 0);
+    u8 a = armsim_call(fnDataR, arm_chip, 0, 0, 0);
+    if (a != c) { printf("stream %d: reading register %d gives %02X (asm) vs %02X (C)\n", stream, reg, a, c); failures++; }
+}
+
+static void mix(int stream, int step, int count)
+{
+    memset(c_buf, 0x55, sizeof(c_buf));
+    ay38910Mixer(count, c_buf, &c_chip);
+    mix_hash(c_buf, sizeof(c_buf));
+    if (arm)
+    {
+        memset(armsim_ptr(arm_buf), 0x55, sizeof(c_buf));
+        armsim_call(fnMixer, count, arm_buf, arm_chip, 0);
+        if (memcmp(armsim_ptr(arm_buf), c_buf, sizeof(c_buf)))
+        {
+            s16 *a = armsim_ptr(arm_buf);
+            for (int i = 0; i < (int)(sizeof(c_buf) / 2); i++)
+            {
+                if (a[i] != c_buf[i]) { printf("stream %d step %d: sample %d of %d is %d (asm) vs %d (C)\n", stream, step, i, count, a[i], c_buf[i]); break; }
+            }
+            failures++;
+        }
+    }
+    check_state(stream, step);
+}
+
+// -------------------------------------------------------------------------------------
+// Like a tracker player: every frame writes the tone, noise, mixer and volume registers,
+// the envelope period sometimes and the envelope shape (which restarts it) now and then.
+// The frame is mixed in a few uneven pieces, the way the emulator mixes line batches.
+// -------------------------------------------------------------------------------------
+static void stream_player(int stream)
+{
+    u16 tone[3] = {0x1AB, 0x0D5, 0x06A};
+    reset();
+    for (int f = 0; f < FRAMES; f++)
+    {
+        for (int ch = 0; ch < 3; ch++)
+        {
+            tone[ch] = (tone[ch] + (rnd() % 9) - 4) & 0xFFF;
+            if (!(rnd() % 16)) tone[ch] = rnd() & 0x3FF;
+            write_reg(ch * 2, tone[ch] & 0xFF);
+            write_reg(ch * 2 + 1, tone[ch] >> 8);
+        }
+        write_reg(6, rnd() & 0x1F);
+        write_reg(7, 0x38 | (rnd() & 0x3F));
+        for (int ch = 0; ch < 3; ch++) write_reg(8 + ch, (rnd() % 5) ? (rnd() & 0x0F) : 0x10);
+        if (!(f % 4)) { write_reg(11, rnd() & 0xFF); write_reg(12, rnd() % 3); }
+        if (!(rnd() % 6)) write_reg(13, rnd() & 0x0F);
+
+        int left = FRAME_SAMPLES, step = 0;
+        while (left)
+        {
+            int n = 1 + rnd() % 400;
+            if (n > left) n = left;
+            mix(stream, f * 100 + step++, n);
+            left -= n;
+        }
+    }
+    for (u8 reg = 0; reg < 16; reg++) read_reg(stream, reg);
+}
+
+// -------------------------------------------------------------------------------------
+// Anything goes - including register indexes over 15 (which the chip ignores), zero
+// periods and mixing 0 or 1 samples.
+// -------------------------------------------------------------------------------------
+static void stream_fuzz(int stream)
+{
+    reset();
+    for (int step = 0; step < FRAMES * 20; step++)
+    {
+        int writes = rnd() % 6;
+        while (writes--)
+        {
+            u8 reg = (rnd() % 8) ? (rnd() % 16) : (rnd() & 0xFF);
+            u8 value = (rnd() % 8) ? (rnd() & 0xFF) : 0;
+            if (reg > 15)
+            {
+                ay38910IndexW(reg, &c_chip);
+                if (arm) armsim_call(fnIndexW, reg, arm_chip, 0, 0);
+                continue;
+            }
+            write_reg(reg, value);
+        }
+        if (!(rnd() % 10)) read_reg(stream, rnd() % 16);
+        int n = rnd() % 8 ? rnd() % 300 : rnd() % 2;
+        mix(stream, step, n);
+    }
+}
+
+static uint64_t run_stream(int stream)
+{
+    rng = 0x9E3779B9u * (stream + 1);
+    hash = 14695981039346656037ULL;
+    if (stream & 1) stream_fuzz(stream);
+    else stream_player(stream);
+    return hash;
+}
+
+static int bench(void)
+{
+    static s16 buf[FRAME_SAMPLES];
+    u32 frames = 0;
+    rng = 1;
+    ay38910Reset(&c_chip);
+    clock_t start = clock(), now;
+    do
+    {
+        for (int i = 0; i < 50; i++, frames++)
+        {
+            for (u8 reg = 0; reg < 14; reg++) { ay38910IndexW(reg, &c_chip); ay38910DataW((reg == 13 && (frames % 8)) ? 0xFF : rnd(), &c_chip); }
+            ay38910Mixer(FRAME_SAMPLES, buf, &c_chip);
+        }
+        now = clock();
+    } while ((now - start) < CLOCKS_PER_SEC * 2);
+    double secs = (double)(now - start) / CLOCKS_PER_SEC;
+    printf("AY38910.c: %.1f Msamples/sec (%.0fx a 44.1kHz stream)\n", frames * FRAME_SAMPLES / secs / 1e6, frames * FRAME_SAMPLES / secs / 44100.0);
+
+    // armsim has no idea of time but the instruction count per sample is a fair guide for the ARM9
+    if (arm)
+    {
+        armsim_call(fnReset, arm_chip, 0, 0, 0);
+        uint64_t steps = armsim_steps;
+        for (frames = 0; frames < 50; frames++) armsim_call(fnMixer, FRAME_SAMPLES, arm_buf, arm_chip, 0);
+        printf("AY38910.s: %.1f ARM instructions/sample\n", (double)(armsim_steps - steps) / (50 * FRAME_SAMPLES));
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t golden[STREAMS] = {0};
+
+    int bench_only = (argc > 1) && !strcmp(argv[1], "-bench");
+    if (bench_only) { argc--; argv++; }
+
+    if (argc > 1)
+    {
+        armsim_host("memcpy", host_memcpy);
+        if (armsim_load(argv[1])) return 2;
+        fnReset  = armsim_symbol("ay38910Reset");
+        fnIndexW = armsim_symbol("ay38910IndexW");
+        fnDataW  = armsim_symbol("ay38910DataW");
+        fnDataR  = armsim_symbol("ay38910DataR");
+        fnMixer  = armsim_symbol("ay38910Mixer");
+        if (!fnReset || !fnIndexW || !fnDataW || !fnDataR || !fnMixer) { printf("%s: missing the AY38910 functions\n", argv[1]); return 2; }
+        arm_chip = armsim_alloc(ARM_AY_SIZE);
+        arm_buf  = armsim_alloc(sizeof(c_buf));
+        arm = 1;
+    }
+
+    if (bench_only) return bench();
+
+    if (!arm)
+    {
+        FILE *f = fopen("golden/ay_replay.txt", "r");
+        int n;
+        unsigned long long h;
+        if (!f) { printf("ay_replay: no golden/ay_replay.txt\n"); return 2; }
+        while (fscanf(f, " stream %d %llx", &n, &h) == 2) if (n < STREAMS) golden[n] = h;
+        fclose(f);
+    }
+
+    for (int s = 0; s < STREAMS; s++)
+    {
+        uint64_t h = run_stream(s);
+        if (arm) printf("stream %d %016llx\n", s, (unsigned long long)h);
+        else if (h != golden[s]) { printf("stream %d: hash %016llx, golden %016llx\n", s, (unsigned long long)h, (unsigned long long)golden[s]); failures++; }
+    }
+
+    printf("ay_replay: %s (%s, %d streams)\n", failures ? "FAILED" : "OK", arm ? "AY38910.s vs AY38910.c" : "AY38910.c vs golden", STREAMS);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,341 @@
+// =====================================================================================
+// beeper_purity - plays a few well known kinds of beeper engine through the band-limited
+// beeper (beeper.c/beeper.h) the way processDirectAudio() does - edges logged with their
+// T-State over runs of up to AY_BATCH_LINES lines, two samples a line on a 48K - and
+// looks at the spectrum of what comes out. Anything in the band that isn't a harmonic
+// of the notes being played is aliasing, and it has to stay well down.
+//
+// The log also shows each engine sampled the naive way (the speaker level at each sample,
+// which is what the old scanline-at-a-time beeper came down to) and through a long filter
+// in double precision, which is about as pure as it gets at this sample rate. Every engine
+// has to leave the level exactly on 0 or BEEPER_LEVEL once it stops, a run with more edges
+// than beeper_edges[] holds has to leave the speaker where port FE says it is, and the
+// steps beeper_set_timing() builds for every machine, turbo and DSi timing are checked.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "beeper.h"
+#include "cpu/z80/Z80_interface.h"
+
+#define LINE_CYCLES     CYCLES_PER_SCANLINE_48
+#define FRAME_LINES     SCANLINES_PER_FRAME_48
+#define FRAME_CYCLES    (LINE_CYCLES * FRAME_LINES)
+#define CLOCK           3500000.0
+#define LINE_SAMPLES    2
+#define SAMPLE_RATE     (CLOCK * LINE_SAMPLES / LINE_CYCLES)    // 31250Hz
+#define FFT_SIZE        65536           // A bit over 2 seconds
+#define SKIP            4096            // Samples to let the engine get going first
+#define LOW             40.0            // The band looked at - the steps roll off from ~11kHz
+#define HIGH            9000.0
+#define NOTE_BINS       6               // Either side of a harmonic that count as the note
+
+u8 portFE = 0x00;
+
+static int failures = 0;
+
+// -------------------------------------------------------------------------------------
+// The engines - each one says when its next OUT to port FE is and what speaker level it
+// writes (most engines write the speaker whether or not it changes)
+// -------------------------------------------------------------------------------------
+typedef struct
+{
+    u64 t;
+    u32 n, a, b;
+    u8 A, B;
+} EngineState;
+
+typedef struct
+{
+    const char *name;
+    u8 (*out)(EngineState *S);
+    double notes[2];        // What should be heard (0 = nothing more)
+    double min_purity;      // dB of the notes over everything else in the band
+} Engine;
+
+// The ROM BEEPER routine - a plain square wave, an OUT every half period
+static u8 out_rom(EngineState *S)
+{
+    S->t += 3977;
+    return (S->n++ & 1);
+}
+
+// A two channel music engine: a 120 T-State loop sends channel A to the speaker at the
+// top and channel B half way round, each a square wave flipping every so many loops. What
+// is heard is the two mixed - the 29kHz they are switched at has to go.
+static u8 out_two_channel(EngineState *S)
+{
+    S->t += 60;
+    if (S->n++ & 1) return S->B;
+    if (++S->a == 33) { S->a = 0; S->A ^= 1; }
+    if (++S->b == 26) { S->b = 0; S->B ^= 1; }
+    return S->A;
+}
+
+// Pulse width modulation, like the Mojon Twins intros: a 17.5kHz carrier whose duty
+// follows a sine. Only the sine should be heard.
+static u8 out_pwm(EngineState *S)
+{
+    if (S->n++ & 1)
+    {
+        S->t += 200 - S->a;
+        return 1;
+    }
+    S->a = (u32)lrint(100.0 + 80.0 * sin(2.0 * M_PI * 700.0 * (S->t + 200) / CLOCK));
+    S->t += S->a;
+    return 0;
+}
+
+static const Engine engines[] =
+{
+    {"rom_beep",     out_rom,         {CLOCK / (2 * 3977)},                            75.0},
+    {"two_channel",  out_two_channel, {CLOCK / (120 * 2 * 33), CLOCK / (120 * 2 * 26)}, 55.0},
+    {"pwm",          out_pwm,         {700.0},                                          55.0},
+};
+
+// -------------------------------------------------------------------------------------
+// Play an engine for FFT_SIZE samples (after SKIP) all three ways
+// -------------------------------------------------------------------------------------
+static s32 blep_out[SKIP + FFT_SIZE + 2 * FRAME_LINES * LINE_SAMPLES];
+static s32 naive_out[SKIP + FFT_SIZE + 2 * FRAME_LINES * LINE_SAMPLES];
+static double ideal_out[SKIP + FFT_SIZE + 2 * FRAME_LINES * LINE_SAMPLES];
+
+// The same edges through a long (256 tap Blackman windowed sinc at 0.9 x Nyquist) filter in
+// double precision - about as clean as the engine can sound at this sample rate
+#define IDEAL_TAPS      256
+
+static void ideal_edge(u64 tstates, double delta)
+{
+    double at = tstates * SAMPLE_RATE / CLOCK;
+    int first = (int)floor(at) - IDEAL_TAPS/2 + 1;
+    for (int k = 0; k < IDEAL_TAPS; k++)
+    {
+        int n = first + k;
+        double x = n - at;
+        if (n < 0 || n >= (int)(sizeof(ideal_out) / sizeof(ideal_out[0]))) continue;
+        double w = 0.42 + 0.5 * cos(2 * M_PI * x / IDEAL_TAPS) + 0.08 * cos(4 * M_PI * x / IDEAL_TAPS);
+        double h = (x == 0) ? 0.9 : sin(0.9 * M_PI * x) / (M_PI * x);
+        ideal_out[n] += delta * h * w;
+    }
+}
+
+// What cpu_writeport_speccy() does with an OUT to port FE
+static void port_fe(u32 tstates, u8 speaker)
+{
+    u8 Value = speaker ? 0x10 : 0x00;
+    if ((portFE ^ Value) & 0x10)
+    {
+        if (beeper_edge_count < BEEPER_EDGES_MAX) beeper_edges[beeper_edge_count++] = tstates;
+    }
+    portFE = Value;
+}
+
+// What processDirectAudio() does after each run of lines
+static u32 run_lines(u32 run_end, u32 lines, s32 *out)
+{
+    u32 line_end = run_end - ((lines-1) * beeper_line_span);
+    u32 edge = 0, n = 0;
+
+    while (1)
+    {
+        edge = beeper_steps(line_end, edge, (lines == 1));
+        for (int i=0; i<LINE_SAMPLES; i++) out[n++] = beeper_sample();
+        if (--lines == 0) break;
+        line_end += beeper_line_span;
+    }
+    beeper_edge_count = 0;
+    return n;
+}
+
+// The engine's next OUT - through port FE for the beeper and straight to the ideal filter
+static u8 engine_out(const Engine *E, EngineState *S, u64 frame_start, u8 *speaker, u8 level)
+{
+    port_fe((u32)(S->t - frame_start), level);
+    if (level != *speaker) ideal_edge(S->t, level ? BEEPER_LEVEL : -BEEPER_LEVEL);
+    *speaker = level;
+    return E->out(S);
+}
+
+static void reset(void)
+{
+    portFE = 0x00;
+    beeper_set_timing(LINE_CYCLES, LINE_SAMPLES);
+    beeper_edge_count = 0;
+    beeper_drop();
+}
+
+static void play(const Engine *E, u32 samples)
+{
+    EngineState S = {0};
+    u8 speaker = 0;
+    u32 n = 0;
+
+    reset();
+    memset(ideal_out, 0, sizeof(ideal_out));
+    u8 level = E->out(&S);
+    for (u64 frame = 0; n < samples; frame++)
+    {
+        u64 frame_start = frame * FRAME_CYCLES;
+        for (u32 line = 0; line < FRAME_LINES; )
+        {
+            // A run of lines - up to the next AY batch or the end of the frame
+            u32 lines = AY_BATCH_LINES - (line % AY_BATCH_LINES);
+            if (line + lines > FRAME_LINES) lines = FRAME_LINES - line;
+            u32 run_end = (line + lines) * LINE_CYCLES;
+
+            for (u32 l = line; l < line + lines; l++)
+            {
+                for (int i = 0; i < LINE_SAMPLES; i++)
+                {
+                    // The naive sample is the speaker at the start of its half of the line
+                    u64 at = frame_start + l * LINE_CYCLES + i * (LINE_CYCLES / LINE_SAMPLES);
+                    while (S.t < at) level = engine_out(E, &S, frame_start, &speaker, level);
+                    naive_out[n + (l - line) * LINE_SAMPLES + i] = speaker ? BEEPER_LEVEL : 0;
+                }
+            }
+            while (S.t < frame_start + run_end) level = engine_out(E, &S, frame_start, &speaker, level);
+            n += run_lines(run_end, lines, &blep_out[n]);
+            line += lines;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------
+// The spectrum - a Blackman-Harris window and a plain radix-2 FFT
+// -------------------------------------------------------------------------------------
+static double re[FFT_SIZE], im[FFT_SIZE];
+
+static void fft(void)
+{
+    for (u32 i = 1, j = 0; i < FFT_SIZE; i++)
+    {
+        u32 bit = FFT_SIZE >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) { double t = re[i]; re[i] = re[j]; re[j] = t; t = im[i]; im[i] = im[j]; im[j] = t; }
+    }
+    for (u32 len = 2; len <= FFT_SIZE; len <<= 1)
+    {
+        double a = -2.0 * M_PI / len;
+        for (u32 i = 0; i < FFT_SIZE; i += len)
+        {
+            for (u32 k = 0; k < len / 2; k++)
+            {
+                double wr = cos(a * k), wi = sin(a * k);
+                double xr = re[i+k+len/2] * wr - im[i+k+len/2] * wi;
+                double xi = re[i+k+len/2] * wi + im[i+k+len/2] * wr;
+                re[i+k+len/2] = re[i+k] - xr; im[i+k+len/2] = im[i+k] - xi;
+                re[i+k] += xr; im[i+k] += xi;
+            }
+        }
+    }
+}
+
+// dB of the harmonics of the notes over everything else between LOW and HIGH
+static double purity(const Engine *E, const s32 *samples, const double *dsamples)
+{
+    for (u32 i = 0; i < FFT_SIZE; i++)
+    {
+        double x = 2.0 * M_PI * i / (FFT_SIZE - 1);
+        double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x) - 0.01168 * cos(3 * x);
+        re[i] = (samples ? samples[SKIP + i] : dsamples[SKIP + i]) * w;
+        im[i] = 0.0;
+    }
+    fft();
+
+    static u8 is_note[FFT_SIZE / 2];
+    memset(is_note, 0, sizeof(is_note));
+    for (int n = 0; n < 2 && E->notes[n]; n++)
+    {
+        for (double f = E->notes[n]; f < HIGH + NOTE_BINS * SAMPLE_RATE / FFT_SIZE; f += E->notes[n])
+        {
+            int bin = (int)lrint(f * FFT_SIZE / SAMPLE_RATE);
+            for (int b = bin - NOTE_BINS; b <= bin + NOTE_BINS; b++) if (b > 0 && b < FFT_SIZE / 2) is_note[b] = 1;
+        }
+    }
+
+    double note = 0.0, other = 0.0;
+    for (u32 b = (u32)(LOW * FFT_SIZE / SAMPLE_RATE); b <= (u32)(HIGH * FFT_SIZE / SAMPLE_RATE); b++)
+    {
+        double p = re[b] * re[b] + im[b] * im[b];
+        if (is_note[b]) note += p; else other += p;
+    }
+    return 10.0 * log10(note / other);
+}
+
+// -------------------------------------------------------------------------------------
+// Once an engine stops the level must settle exactly where the speaker was left
+// -------------------------------------------------------------------------------------
+static void check_settles(const char *name)
+{
+    s32 out[LINE_SAMPLES * 32];
+    for (u32 line = 1; line <= 16; line++) run_lines(line * LINE_CYCLES, 1, out);
+    s32 want = (portFE & 0x10) ? BEEPER_LEVEL : 0;
+    if (beeper_target != want || beeper_level != (want << 15))
+    {
+        printf("beeper_purity: %s leaves the level at %.3f, the speaker is at %d\n", name, beeper_level / 32768.0, want);
+        failures++;
+    }
+}
+
+// More edges on a run than beeper_edges[] holds - an odd number so the ones that don't fit
+// leave the speaker the other way round from what the logged ones say
+static void check_overflow(void)
+{
+    const u32 edges = BEEPER_EDGES_MAX + 1;
+    s32 out[LINE_SAMPLES];
+
+    reset();
+    for (u32 i = 0; i < edges; i++) port_fe(LINE_CYCLES + (i * LINE_CYCLES) / edges, !(i & 1));
+    run_lines(2 * LINE_CYCLES, 2, out);
+    check_settles("a run of BEEPER_EDGES_MAX+1 edges");
+}
+
+// Every timing speccy_run() can ask for: each row of steps sums to exactly 32768 and every
+// T-State of a line finds its sample and phase
+static void check_timing(void)
+{
+    static const u32 spans[] = {CYCLES_PER_SCANLINE_48, CYCLES_PER_SCANLINE_128, CYCLES_PER_SCANLINE_48 << 1, CYCLES_PER_SCANLINE_128 << 1};
+
+    for (int s = 0; s < 4; s++)
+    {
+        for (u32 samples = 2; samples <= 4; samples += 2)
+        {
+            beeper_set_timing(spans[s], samples);
+            u32 span = spans[s] / samples;
+            for (u32 phase = 0; phase < span; phase++)
+            {
+                s32 sum = 0;
+                for (int tap = 0; tap < BEEPER_TAPS; tap++) sum += beeper_step[phase][tap];
+                if (sum != 32768) { printf("beeper_purity: line %u, %u samples - the step for T-State %u sums to %d\n", spans[s], samples, phase, sum); failures++; }
+            }
+            for (u32 offset = 0; offset < spans[s]; offset++)
+            {
+                u32 sample = (offset * beeper_recip) >> 20;
+                if (sample != offset / span) { printf("beeper_purity: line %u, %u samples - T-State %u is put in sample %u\n", spans[s], samples, offset, sample); failures++; break; }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    for (int e = 0; e < (int)(sizeof(engines) / sizeof(engines[0])); e++)
+    {
+        const Engine *E = &engines[e];
+        play(E, SKIP + FFT_SIZE);
+        check_settles(E->name);
+        for (u32 i = 1; i < SKIP + FFT_SIZE; i++) ideal_out[i] += ideal_out[i-1];
+        double blep = purity(E, blep_out, NULL);
+        double naive = purity(E, naive_out, NULL);
+        double ideal = purity(E, NULL, ideal_out);
+        printf("%-12s %5.1f dB (%5.1f dB sampled naively, %5.1f dB ideal)\n", E->name, blep, naive, ideal);
+        if (blep < E->min_purity) { printf("beeper_purity: %s is only %.1f dB pure (needs %.1f)\n", E->name, blep, E->min_purity); failures++; }
+    }
+    check_overflow();
+    check_timing();
+
+    printf("beeper_purity: %s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
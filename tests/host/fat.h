@@ -0,0 +1,7 @@
+// =====================================================================================
+// libfat stand-in - on the host the C library's stdio already goes to the disk.
+// =====================================================================================
+#ifndef HOST_FAT_H
+#define HOST_FAT_H
+
+#endif
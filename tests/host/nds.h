@@ -0,0 +1,36 @@
+// =====================================================================================
+// Just enough of libnds for the emulator sources the host tests compile (the Z80 cores
+// and their tables). The real one is only needed on the DS.
+// =====================================================================================
+#ifndef HOST_NDS_H
+#define HOST_NDS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef uint8_t     u8;
+typedef uint16_t    u16;
+typedef uint32_t    u32;
+typedef uint64_t    u64;
+typedef int8_t      s8;
+typedef int16_t     s16;
+typedef int32_t     s32;
+typedef int64_t     s64;
+typedef volatile u8  vu8;
+typedef volatile u16 vu16;
+typedef volatile u32 vu32;
+
+typedef int8_t      int8;
+typedef int16_t     int16;
+typedef int32_t     int32;
+typedef uint8_t     uint8;
+typedef uint16_t    uint16;
+typedef uint32_t    uint32;
+
+#define BIT(n)      (1 << (n))
+#define ITCM_CODE
+#define DTCM_DATA
+#define ALIGN(m)    __attribute__((aligned(m)))
+
+#endif
@@ -0,0 +1,282 @@
+// =====================================================================================
+// render_replay - draws the same screen lines with the ARM renderer (spectrum_render.s
+// run under armsim) and with the C renderer it replaced, and checks that every byte of
+// every line comes out the same.
+//
+//   render_replay spectrum_render.o    both renderers, live - and prints the hashes
+//   render_replay                      the C renderer only, against golden/render_replay.txt
+//                                      (hashes taken from the ARM code with the line above)
+//   render_replay -bench [spectrum_render.o]   how many lines/sec the C renderer draws on
+//                                      this machine (and ARM instructions/line for the asm)
+//
+// Each pass draws every attribute with every pixel byte (2048 lines of 32 cells) and
+// then random lines - once normal, once with FLASH inverted and once with ULA+ on.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+
+#include "armsim.h"
+
+#define PASSES          3
+#define RANDOM_LINES    4096
+#define GUARD           32              // Bytes either side of the line that must not be touched
+
+static const char *pass_name[PASSES] = {"normal", "flash", "ula_plus"};
+
+static u32 rng;
+static u32 rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static uint64_t hash;
+static void mix_hash(const void *p, size_t n)
+{
+    const u8 *b = p;
+    while (n--) { hash ^= *b++; hash *= 1099511628211ULL; }
+}
+
+static int arm = 0;
+static u32 arm_attr, arm_pixels, arm_line, fnRender, fnRenderUlaPlus;
+static int failures = 0;
+
+// -------------------------------------------------------------------------------------
+// The C renderer from spectrum.c before spectrum_render.s took over, tables and all
+// -------------------------------------------------------------------------------------
+static u32 Pixel_maskTable_High[256];
+static u32 Pixel_maskTable_Low[256];
+
+static void make_tables(void)
+{
+    for (int pixel = 0; pixel < 256; pixel++)
+    {
+        u32 high = 0, low = 0;
+        for (int bit = 0; bit < 4; bit++)
+        {
+            if (pixel & (0x80 >> bit)) high |= 0xFF << (bit * 8);
+            if (pixel & (0x08 >> bit)) low |= 0xFF << (bit * 8);
+        }
+        Pixel_maskTable_High[pixel] = high;
+        Pixel_maskTable_Low[pixel] = low;
+    }
+}
+
+static void speccy_render_screen_line_ula_plus(u32 *vidBuf, u8 *attrPtr, u8 *pixelPtr)
+{
+    for (int x = 0; x < 32; x++)
+    {
+        u8 attr = *attrPtr++;
+        u8 pixel = *pixelPtr++;
+
+        u8 ink   = 0x80 | (((attr >> 6) * 16) + (attr & 0x07));
+        u8 paper = 0x80 | (((attr >> 6) * 16) + ((attr >> 3) & 0x07) + 8);
+        u32 background = (paper << 24) | (paper << 16) | (paper << 8) | paper;
+
+        if (pixel)
+        {
+            u32 ink32 = (ink << 24) | (ink << 16) | (ink << 8) | ink;
+            u32 diff  = ink32 ^ background;
+            *vidBuf++ = background ^ (diff & Pixel_maskTable_High[pixel]);
+            *vidBuf++ = background ^ (diff & Pixel_maskTable_Low[pixel]);
+        }
+        else
+        {
+            *vidBuf++ = background;
+            *vidBuf++ = background;
+        }
+    }
+}
+
+static void speccy_render_screen_line(u32 *vidBuf, u8 *attrPtr, u8 *pixelPtr, u8 bFlash)
+{
+    for (int x = 0; x < 32; x++)
+    {
+        u8 attr = *attrPtr++;
+        u8 paper = (attr >> 3) & 0x0F;
+        u8 pixel = *pixelPtr++;
+        u32 background = (paper << 24) | (paper << 16) | (paper << 8) | paper;
+
+        if (attr & 0x80) pixel ^= bFlash;
+
+        if (pixel)
+        {
+            u8 ink = (attr & 0x07) | ((attr & 0x40) >> 3);
+            u32 ink32 = (ink << 24) | (ink << 16) | (ink << 8) | ink;
+            u32 diff  = ink32 ^ background;
+            *vidBuf++ = background ^ (diff & Pixel_maskTable_High[pixel]);
+            *vidBuf++ = background ^ (diff & Pixel_maskTable_Low[pixel]);
+        }
+        else
+        {
+            *vidBuf++ = background;
+            *vidBuf++ = background;
+        }
+    }
+}
+
+static void render_c(int pass, u8 *line, u8 *attr, u8 *pixels)
+{
+    if (pass == 2) speccy_render_screen_line_ula_plus((u32 *)line, attr, pixels);
+    else speccy_render_screen_line((u32 *)line, attr, pixels, pass ? 0xFF : 0x00);
+}
+
+static void render_arm(int pass)
+{
+    if (pass == 2) armsim_call(fnRenderUlaPlus, arm_line, arm_attr, arm_pixels, 0);
+    else armsim_call(fnRender, arm_line, arm_attr, arm_pixels, pass ? 0xFF : 0x00);
+}
+
+// -------------------------------------------------------------------------------------
+// One line through both renderers - the attribute and pixel rows are 32 byte aligned
+// like the real screen, the output has guard bytes either side
+// -------------------------------------------------------------------------------------
+static void draw(int pass, int n, const u8 *attr, const u8 *pixels)
+{
+    static u8 c_attr[32] __attribute__((aligned(32)));
+    static u8 c_pixels[32] __attribute__((aligned(32)));
+    static u8 c_line[GUARD + 256 + GUARD] __attribute__((aligned(32)));
+
+    memcpy(c_attr, attr, 32);
+    memcpy(c_pixels, pixels, 32);
+    render_c(pass, c_line + GUARD, c_attr, c_pixels);
+    mix_hash(c_line + GUARD, 256);
+    if (!arm) return;
+
+    u8 *a = armsim_ptr(arm_line - GUARD);
+    memset(a, 0x5A, GUARD + 256 + GUARD);
+    memcpy(armsim_ptr(arm_attr), attr, 32);
+    memcpy(armsim_ptr(arm_pixels), pixels, 32);
+    render_arm(pass);
+
+    for (int i = 0; i < GUARD; i++)
+    {
+        if (a[i] != 0x5A || a[GUARD + 256 + i] != 0x5A) { if (failures++ < 5) printf("%s line %d: the asm writes outside the line\n", pass_name[pass], n); return; }
+    }
+    if (memcmp(a + GUARD, c_line + GUARD, 256))
+    {
+        for (int i = 0; i < 256 && failures < 5; i++)
+        {
+            if (a[GUARD + i] != c_line[GUARD + i])
+            {
+                printf("%s line %d: pixel %d is %02X (asm) vs %02X (C) - attr %02X, pixels %02X\n", pass_name[pass], n, i, a[GUARD + i], c_line[GUARD + i], attr[i / 8], pixels[i / 8]);
+                break;
+            }
+        }
+        failures++;
+    }
+}
+
+static uint64_t run_pass(int pass)
+{
+    u8 attr[32], pixels[32];
+    int n = 0;
+
+    hash = 14695981039346656037ULL;
+
+    // Every attribute against every pixel byte
+    for (int cell = 0; cell < 0x10000; n++)
+    {
+        for (int x = 0; x < 32; x++, cell++) { attr[x] = cell >> 8; pixels[x] = cell; }
+        draw(pass, n, attr, pixels);
+    }
+
+    // Random lines, with the all-paper cells the C renderer special cased mixed in
+    rng = 0x9E3779B9u * (pass + 1);
+    for (int i = 0; i < RANDOM_LINES; i++, n++)
+    {
+        for (int x = 0; x < 32; x++) { attr[x] = rnd(); pixels[x] = (rnd() % 4) ? rnd() : 0; }
+        draw(pass, n, attr, pixels);
+    }
+    return hash;
+}
+
+static int bench(void)
+{
+    static u8 attr[32] __attribute__((aligned(32)));
+    static u8 pixels[192][32] __attribute__((aligned(32)));
+    static u8 screen[192][256] __attribute__((aligned(32)));
+    u32 frames = 0;
+
+    rng = 1;
+    for (int x = 0; x < 32; x++) attr[x] = rnd() & 0x7F;
+    for (int y = 0; y < 192; y++) for (int x = 0; x < 32; x++) pixels[y][x] = (rnd() % 3) ? rnd() : 0;
+
+    clock_t start = clock(), now;
+    do
+    {
+        for (int i = 0; i < 50; i++, frames++)
+        {
+            for (int y = 0; y < 192; y++) speccy_render_screen_line((u32 *)screen[y], attr, pixels[y], 0x00);
+        }
+        now = clock();
+    } while ((now - start) < CLOCKS_PER_SEC * 2);
+    double secs = (double)(now - start) / CLOCKS_PER_SEC;
+    printf("C renderer: %.2f Mlines/sec (%.0f frames/sec)\n", frames * 192 / secs / 1e6, frames / secs);
+
+    // armsim has no idea of time but the instruction count per line is a fair guide for the ARM9
+    if (arm)
+    {
+        for (int pass = 0; pass < PASSES; pass++)
+        {
+            memcpy(armsim_ptr(arm_attr), attr, 32);
+            uint64_t steps = armsim_steps;
+            for (int y = 0; y < 192; y++)
+            {
+                memcpy(armsim_ptr(arm_pixels), pixels[y], 32);
+                render_arm(pass);
+            }
+            printf("spectrum_render.s (%s): %.1f ARM instructions/line\n", pass_name[pass], (double)(armsim_steps - steps) / 192);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t golden[PASSES] = {0};
+
+    int bench_only = (argc > 1) && !strcmp(argv[1], "-bench");
+    if (bench_only) { argc--; argv++; }
+
+    make_tables();
+
+    if (argc > 1)
+    {
+        if (armsim_load(argv[1])) return 2;
+        fnRender        = armsim_symbol("speccy_render_line_asm");
+        fnRenderUlaPlus = armsim_symbol("speccy_render_line_ula_plus_asm");
+        if (!fnRender || !fnRenderUlaPlus) { printf("%s: missing the renderer functions\n", argv[1]); return 2; }
+        arm_attr   = armsim_alloc(32);
+        arm_pixels = armsim_alloc(32);
+        arm_line   = armsim_alloc(GUARD + 256 + GUARD) + GUARD;
+        arm = 1;
+    }
+
+    if (bench_only) return bench();
+
+    if (!arm)
+    {
+        FILE *f = fopen("golden/render_replay.txt", "r");
+        char name[16];
+        unsigned long long h;
+        if (!f) { printf("render_replay: no golden/render_replay.txt\n"); return 2; }
+        while (fscanf(f, " %15s %llx", name, &h) == 2)
+        {
+            for (int p = 0; p < PASSES; p++) if (!strcmp(name, pass_name[p])) golden[p] = h;
+        }
+        fclose(f);
+    }
+
+    for (int p = 0; p < PASSES; p++)
+    {
+        uint64_t h = run_pass(p);
+        if (arm) printf("%s %016llx\n", pass_name[p], (unsigned long long)h);
+        else if (h != golden[p]) { printf("%s: hash %016llx, golden %016llx\n", pass_name[p], (unsigned long long)h, (unsigned long long)golden[p]); failures++; }
+    }
+
+    printf("render_replay: %s (%s, %d passes)\n", failures ? "FAILED" : "OK", arm ? "spectrum_render.s vs C" : "C vs golden", PASSES);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+// =====================================================================================
+// screen_dirty - the dirty line tracking in screen_dirty.c, which decides the lines the
+// renderer draws. A line it misses keeps showing what was there before, so every way
+// onto the screen is checked for exactly the lines it should flag and no others:
+//
+//   - every one of the 6912 screen offsets (and the 6144 of the Timex second display
+//     file) written through zx_screen_write() - a bitmap byte flags its one line and
+//     an attribute the 8 lines of its character row
+//   - writing what's already there flags nothing and logs no attribute write
+//   - a FLASH toggle flags just the character rows with a flashing cell
+//   - each VRAM page's bit is taken on its own (zx_line_take) and only once
+//   - the Z80 cores writing the screen with LDIR through RamWrZ80() - including past
+//     the end of the attributes and into a screen in bank 7 and the bank that isn't
+//
+// The cores are built from arm9/source the same way as the z80_* tests.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include "z80_host.h"
+#include "screen_dirty.h"
+
+static int failures = 0;
+static const char *test_name;
+
+#define CHECK(Cond, ...) do { if (!(Cond)) { if (failures++ < 10) { printf("screen_dirty: %s: ", test_name); printf(__VA_ARGS__); } } } while (0)
+
+static u32 rng = 1;
+static u32 rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+// The screen line of a bitmap offset - worked out from the row, character row and third
+static int bitmap_line(u32 offset)
+{
+    u32 third = offset >> 11, pixel_row = (offset >> 8) & 7, char_row = (offset >> 5) & 7;
+    return (third * 64) + (char_row * 8) + pixel_row;
+}
+
+// The lines a write at this offset should flag, as a 192 byte map
+static void expect_lines(u8 *expect, u32 offset)
+{
+    if ((offset & 0x1FFF) < 0x1800) expect[bitmap_line(offset & 0x1FFF)] = ZX_DIRTY_BOTH;
+    else if (offset < 0x1B00) memset(&expect[((offset - 0x1800) / 32) * 8], ZX_DIRTY_BOTH, 8);
+}
+
+// Just the expected lines flagged (and each for both pages)?
+static int check_lines(const u8 *expect, const char *what, u32 offset)
+{
+    for (int line = 0; line < 192; line++)
+    {
+        if (zx_line_dirty[line] != expect[line])
+        {
+            CHECK(0, "%s %04X: line %d is %d, should be %d\n", what, offset, line, zx_line_dirty[line], expect[line]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// -------------------------------------------------------------------------------------
+// Every offset one at a time, then again with the value that's already there
+// -------------------------------------------------------------------------------------
+static void test_offsets(void)
+{
+    u8 expect[192];
+
+    test_name = "offsets";
+    zx_screen_page = HostRAM[5];
+    for (int i = 0; i < 0x4000; i++) zx_screen_page[i] = rnd();
+
+    for (u32 offset = 0; offset < 0x3800; offset++)
+    {
+        if ((offset >= 0x1B00) && (offset < 0x2000)) continue;     // Not the screen in any mode
+
+        u8 old = zx_screen_page[offset];
+        u8 value = old ^ (1 + (rnd() % 255));
+        memset(zx_line_dirty, 0x00, sizeof(zx_line_dirty));
+        memset(expect, 0x00, sizeof(expect));
+        expect_lines(expect, offset);
+        zx_attr_logging = 1;
+        zx_attr_log_count = 0;
+
+        zx_screen_write(zx_screen_page + offset, value, 1234);
+        CHECK(zx_screen_page[offset] == value, "write %04X: the screen isn't written\n", offset);
+        check_lines(expect, "write", offset);
+
+        // The multicolor log sees only attribute writes - with what they replaced
+        if ((offset >= 0x1800) && (offset < 0x1B00))
+        {
+            CHECK((zx_attr_log_count == 1) && (zx_attr_log[0].offset == offset - 0x1800) && (zx_attr_log[0].tstates == 1234) && (zx_attr_log[0].old == old), "write %04X: not logged\n", offset);
+        }
+        else CHECK(zx_attr_log_count == 0, "write %04X: logged as an attribute\n", offset);
+
+        // The same again changes nothing
+        memset(zx_line_dirty, 0x00, sizeof(zx_line_dirty));
+        memset(expect, 0x00, sizeof(expect));
+        zx_attr_log_count = 0;
+        zx_screen_write(zx_screen_page + offset, value, 1234);
+        check_lines(expect, "same value", offset);
+        CHECK(zx_attr_log_count == 0, "same value %04X: logged\n", offset);
+    }
+    zx_attr_logging = 0;
+    zx_attr_log_count = 0;
+}
+
+// -------------------------------------------------------------------------------------
+// FLASH - some rows with no flashing cells, some with one anywhere along them
+// -------------------------------------------------------------------------------------
+static void test_flash(void)
+{
+    u8 expect[192];
+
+    test_name = "flash";
+    zx_screen_page = HostRAM[5];
+    for (int pass = 0; pass < 64; pass++)
+    {
+        memset(expect, 0x00, sizeof(expect));
+        for (int row = 0; row < 24; row++)
+        {
+            u8 *attr = zx_screen_page + 0x1800 + row * 32;
+            for (int x = 0; x < 32; x++) attr[x] = rnd() & 0x7F;
+            if ((rnd() % 3) == 0)
+            {
+                attr[rnd() % 32] |= 0x80;
+                memset(&expect[row * 8], ZX_DIRTY_BOTH, 8);
+            }
+        }
+        memset(zx_line_dirty, 0x00, sizeof(zx_line_dirty));
+        zx_screen_dirty_flash();
+        check_lines(expect, "pass", pass);
+    }
+}
+
+// -------------------------------------------------------------------------------------
+// The page bits - drawing into one VRAM page leaves the line to be drawn into the other
+// -------------------------------------------------------------------------------------
+static void test_pages(void)
+{
+    test_name = "pages";
+    zx_screen_page = HostRAM[5];
+    for (u32 line = 0; line < 192; line++)
+    {
+        u8 first = line & 1;    // Either page can be the back page when the line changes
+
+        memset(zx_line_dirty, 0x00, sizeof(zx_line_dirty));
+        CHECK(!zx_line_take(line, 0) && !zx_line_take(line, 1), "line %d: taken while clean\n", line);
+
+        u32 offset = ((line & 0xC0) << 5) | ((line & 0x07) << 8) | ((line & 0x38) << 2);
+        zx_screen_write(zx_screen_page + offset, zx_screen_page[offset] ^ 0xFF, 0);
+
+        CHECK(zx_line_take(line, first), "line %d: not taken for page %d\n", line, first);
+        CHECK(zx_line_dirty[line] == (1 << (first ^ 1)), "line %d: %d left after page %d\n", line, zx_line_dirty[line], first);
+        CHECK(!zx_line_take(line, first), "line %d: taken twice for page %d\n", line, first);
+        CHECK(zx_line_take(line, first ^ 1), "line %d: not taken for page %d\n", line, first ^ 1);
+        CHECK(zx_line_dirty[line] == 0, "line %d: %d left after both pages\n", line, zx_line_dirty[line]);
+
+        // Written again after one page has it - both need it again
+        zx_screen_write(zx_screen_page + offset, zx_screen_page[offset] ^ 0xFF, 0);
+        CHECK(zx_line_take(line, first) && (zx_line_dirty[line] == (1 << (first ^ 1))), "line %d: page %d only\n", line, first);
+        zx_screen_write(zx_screen_page + 0x1800 + (line / 8) * 32, zx_screen_page[0x1800 + (line / 8) * 32] ^ 0xFF, 0);
+        CHECK(zx_line_dirty[line] == ZX_DIRTY_BOTH, "line %d: %d after an attribute write\n", line, zx_line_dirty[line]);
+    }
+}
+
+// -------------------------------------------------------------------------------------
+// The cores - LDIR a copy of the screen with a few bytes changed over it (and on past
+// the attributes) and see that just those lines were flagged
+// -------------------------------------------------------------------------------------
+#define COPY_LEN    (6912 + 256)
+
+static void put(word A, const u8 *code, int len)
+{
+    for (int i = 0; i < len; i++) MemoryMap[(word)(A + i) >> 14][(word)(A + i)] = code[i];
+}
+
+static void run_ldir(int core, word dest, u8 *target)
+{
+    static const u8 code[] = {0x21, 0x00, 0x80, 0x11, 0x00, 0x00, 0x01, COPY_LEN & 0xFF, COPY_LEN >> 8, 0xED, 0xB0, 0x76};   // LD HL,$8000; LD DE,dest; LD BC,COPY_LEN; LDIR; HALT
+    u8 expect[192];
+    u8 *source = HostRAM[2];
+
+    memset(expect, 0x00, sizeof(expect));
+    for (int i = 0; i < 0x4000; i++) target[i] = rnd();
+    memcpy(source, target, COPY_LEN);
+    for (int n = 0; n < 48; n++)
+    {
+        u32 offset = rnd() % COPY_LEN;
+        source[offset] ^= 1 + (rnd() % 255);
+        if (target == zx_screen_page) expect_lines(expect, offset);
+    }
+
+    put(0xBF00, code, sizeof(code));
+    MemoryMap[2][0xBF04] = dest & 0xFF;
+    MemoryMap[2][0xBF05] = dest >> 8;
+    memset(zx_line_dirty, 0x00, sizeof(zx_line_dirty));
+    CPU.PC.W = 0xBF00;
+    CPU.SP.W = 0xBE00;
+    host_exec(CPU.TStates + 400000);
+
+    CHECK(CPU.PC.W == 0xBF0B, "%s: LDIR to %04X didn't finish (PC %04X)\n", host_core_name[core], dest, CPU.PC.W);
+    CHECK(!memcmp(target, source, COPY_LEN), "%s: LDIR to %04X didn't copy\n", host_core_name[core], dest);
+    check_lines(expect, host_core_name[core], dest);
+}
+
+static void test_cores(void)
+{
+    test_name = "cores";
+    for (int core = 0; core < HOST_CORES; core++)
+    {
+        host_reset(core);
+        zx_screen_page = HostRAM[5];
+        run_ldir(core, 0x4000, HostRAM[5]);
+
+        // The screen in bank 7 paged in at $C000 - writes to bank 5 no longer count
+        MemoryMap[3] = HostRAM[7] - 0xC000;
+        zx_screen_page = HostRAM[7];
+        run_ldir(core, 0x4000, HostRAM[5]);
+        run_ldir(core, 0xC000, HostRAM[7]);
+    }
+    zx_screen_page = HostRAM[5];
+}
+
+int main(int argc, char **argv)
+{
+    host_init();
+    test_offsets();
+    test_flash();
+    test_pages();
+    test_cores();
+    printf("screen_dirty: %s (%d screen offsets, FLASH, both pages, %d cores)\n", failures ? "FAILED" : "OK", 6912 + 6144, HOST_CORES);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+// =====================================================================================
+// z80_bench - how fast each Z80 core runs on this machine, in emulated MHz (T-States
+// per second). Build it once per Z80 build (make bench) to compare the switch and the
+// threaded dispatch. The host is not an ARM946E-S so only the ratios between builds
+// mean much - and even those want checking on the DS before anything is decided.
+//
+// The program is a small game-like loop: an LDIR to the screen, a masked sprite drawn
+// through IX, a shift-and-add multiply behind a CALL and some CB bit twiddling, with
+// the usual IM 1 interrupt counting frames. Frames are run a scanline at a time just
+// like speccy_run() does, so the accurate cores see their contended screen writes.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "z80_host.h"
+
+#if defined(Z80_REG_CACHE)
+#define BUILD_NAME  "cached"
+#elif defined(Z80_THREADED_DISPATCH)
+#define BUILD_NAME  "threaded"
+#else
+#define BUILD_NAME  "switch"
+#endif
+
+static u8 *p, *org;
+#define EMIT(...)   do { const u8 b[] = {__VA_ARGS__}; memcpy(p, b, sizeof(b)); p += sizeof(b); } while (0)
+#define HERE()      ((word)(0x8000 + (p - org)))
+#define JR_TO(Op,L) do { *p++ = (Op); *p = (u8)((L) - (HERE() + 1)); p++; } while (0)
+
+static void load_program(void)
+{
+    // IM 1 handler: count the frames in FRAMES like the ROM does
+    static const u8 isr[] = {0xF5, 0xE5, 0x2A, 0x78, 0x5C, 0x23, 0x22, 0x78, 0x5C, 0xE1, 0xF1, 0xFB, 0xC9};
+    memcpy(&HostROM[0x38], isr, sizeof(isr));
+
+    org = p = &MemoryMap[2][0x8000];
+    const word mul = 0x8100;
+
+    EMIT(0x31, 0x00, 0xFF);                         // LD SP,$FF00
+    EMIT(0xED, 0x56);                               // IM 1
+    EMIT(0xFB);                                     // EI
+    word main_loop = HERE();
+    EMIT(0x21, 0x00, 0x90);                         // LD HL,$9000
+    EMIT(0x11, 0x00, 0x40);                         // LD DE,$4000
+    EMIT(0x01, 0x00, 0x08);                         // LD BC,$0800
+    EMIT(0xED, 0xB0);                               // LDIR
+
+    EMIT(0xDD, 0x21, 0x00, 0xA0);                   // LD IX,$A000
+    EMIT(0x21, 0x00, 0x48);                         // LD HL,$4800
+    EMIT(0x0E, 0x10);                               // LD C,16
+    word row = HERE();
+    EMIT(0x06, 0x04);                               // LD B,4
+    word col = HERE();
+    EMIT(0x7E);                                     // LD A,(HL)
+    EMIT(0xDD, 0xA6, 0x00);                         // AND (IX+0)
+    EMIT(0xDD, 0xB6, 0x01);                         // OR (IX+1)
+    EMIT(0x77);                                     // LD (HL),A
+    EMIT(0xDD, 0x23, 0xDD, 0x23);                   // INC IX; INC IX
+    EMIT(0x2C);                                     // INC L
+    JR_TO(0x10, col);                               // DJNZ col
+    EMIT(0x11, 0x1C, 0x00);                         // LD DE,28
+    EMIT(0x19);                                     // ADD HL,DE
+    EMIT(0x0D);                                     // DEC C
+    JR_TO(0x20, row);                               // JR NZ,row
+
+    EMIT(0x06, 0x40);                               // LD B,64
+    word mul_loop = HERE();
+    EMIT(0x78);                                     // LD A,B
+    EMIT(0x11, 0x34, 0x12);                         // LD DE,$1234
+    EMIT(0xCD, mul & 0xFF, mul >> 8);               // CALL mul
+    EMIT(0x22, 0x00, 0x98);                         // LD ($9800),HL
+    JR_TO(0x10, mul_loop);                          // DJNZ mul_loop
+
+    EMIT(0x21, 0x00, 0x90);                         // LD HL,$9000
+    EMIT(0x06, 0x00);                               // LD B,0
+    word bits = HERE();
+    EMIT(0xCB, 0x06);                               // RLC (HL)
+    EMIT(0xCB, 0x5E);                               // BIT 3,(HL)
+    EMIT(0x28, 0x02);                               // JR Z,+2
+    EMIT(0xCB, 0xFE);                               // SET 7,(HL)
+    EMIT(0x23);                                     // INC HL
+    JR_TO(0x10, bits);                              // DJNZ bits
+    EMIT(0xC3, main_loop & 0xFF, main_loop >> 8);   // JP main_loop
+
+    // mul: HL = A * DE
+    p = org + (mul - 0x8000);
+    EMIT(0xC5);                                     // PUSH BC
+    EMIT(0x21, 0x00, 0x00);                         // LD HL,0
+    EMIT(0x06, 0x08);                               // LD B,8
+    word mul_bit = HERE();
+    EMIT(0x29);                                     // ADD HL,HL
+    EMIT(0x17);                                     // RLA
+    EMIT(0x30, 0x01);                               // JR NC,+1
+    EMIT(0x19);                                     // ADD HL,DE
+    JR_TO(0x10, mul_bit);                           // DJNZ mul_bit
+    EMIT(0xC1);                                     // POP BC
+    EMIT(0xC9);                                     // RET
+}
+
+static double bench(int core)
+{
+    const u32 lines = (core == HOST_CORE_128) ? SCANLINES_PER_FRAME_128 : SCANLINES_PER_FRAME_48;
+    const u32 line_cycles = (core == HOST_CORE_128) ? CYCLES_PER_SCANLINE_128 : CYCLES_PER_SCANLINE_48;
+    u64 tstates = 0;
+
+    memset(HostROM, 0x00, sizeof(HostROM));
+    memset(HostRAM, 0x00, sizeof(HostRAM));
+    host_reset(core);
+    load_program();
+    CPU.PC.W = 0x8000;
+
+    clock_t start = clock(), now;
+    do
+    {
+        for (int frame = 0; frame < 50; frame++)
+        {
+            for (u32 line = 1; line <= lines; line++) host_exec(line * line_cycles);
+            tstates += lines * line_cycles;
+            CPU.TStates -= lines * line_cycles;
+            IntZ80(&CPU, INT_RST38);
+        }
+        now = clock();
+    } while ((now - start) < CLOCKS_PER_SEC * 2);
+
+    return tstates / ((double)(now - start) / CLOCKS_PER_SEC) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    host_init();
+    printf("z80_bench (%s):", BUILD_NAME);
+    for (int core = 0; core < HOST_CORES; core++)
+    {
+        printf(" %s %.1f MHz%s", host_core_name[core], bench(core), (core < HOST_CORES-1) ? "," : "\n");
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+// =====================================================================================
+// z80_block - LDIR/LDDR/CPIR/INIR/OTIR repeat inside one dispatch (BLOCK_AGAIN and
+// BLOCK_AGAIN_WR in Z80_core.h). The same cases run through a core built with
+// Z80_NO_BLOCK_AGAIN, where every repeat goes back round the main loop the way it
+// always used to, and the two logs have to match line for line.
+//
+//   z80_block               print the log (run the Z80_NO_BLOCK_AGAIN build this way)
+//   z80_block <ref.txt>     run and check against the log of the reference build
+//
+// Each case drops one block instruction (followed by a HALT) somewhere in RAM with
+// random registers and memory and then runs the CPU in random slices so the repeat is
+// cut off at every sort of T-State. After each slice the log gets the registers, F,
+// R and T-States plus a hash of every port access and CPU event so far; at the end
+// of the case a hash of all memory and the whole CPU struct. The cases go out of
+// their way to hit the exits: writes heading into the ROM and the Dandanator, blocks that overwrite
+// their own opcode, an OTIR that pages its own bank out and CPU events that pull in
+// the run limit from a port write.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include "z80_host.h"
+#include "Tables.h"
+
+#define CASES           2000            // Per core
+#define MAX_SLICES      40
+
+static const u8 block_ops[] = {LDIR, LDDR, CPIR, INIR, OTIR};
+
+static u32 rng;
+static u32 rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static u64 io_hash;
+static void io_mix(u64 v) { io_hash = (io_hash ^ v) * 0x100000001B3ULL; }
+
+static int core;
+static u32 slices = 0;
+
+// -------------------------------------------------------------------------------------
+// The port handlers and events only depend on the CPU so both builds see the same
+// values as long as they are still in step.
+// -------------------------------------------------------------------------------------
+static u8 test_in(u16 Port)
+{
+    io_mix(0x10000000ULL | Port);
+    io_mix(CPU.TStates);
+    return (u8)(Port * 31 + CPU.TStates * 7);
+}
+
+static void test_out(u16 Port, u8 Value)
+{
+    io_mix(0x20000000ULL | (Value << 16) | Port);
+    io_mix(CPU.TStates);
+
+    // The 128K paging port swaps the top 16K - which may well hold the OTIR itself
+    if ((core == HOST_CORE_128) && !(Port & 0x8002))
+    {
+        MemoryMap[3] = HostRAM[Value & 0x07] - 0xC000;
+        ContendMap[3] = Value & 0x01;
+    }
+
+    // And now and then something else wants the CPU to stop a little later
+    if ((Value & 0x0F) == 0x05) speccy_cpu_event(CPU.TStates + (Value >> 4), CPU_EVT_TAPE);
+}
+
+static void test_event(u8 event)
+{
+    io_mix(0x30000000ULL | event);
+    io_mix(CPU.TStates);
+}
+
+// -------------------------------------------------------------------------------------
+
+static void setup_case(int n)
+{
+    rng = 0x9E3779B9u * (core * CASES + n + 1);
+    io_hash = 0xCBF29CE484222325ULL;
+
+    for (u32 *p = (u32 *)HostROM; p < (u32 *)(HostROM + sizeof(HostROM)); p++) *p = rnd();
+    for (u32 *p = (u32 *)HostRAM; p < (u32 *)((u8 *)HostRAM + sizeof(HostRAM)); p++) *p = rnd();
+
+    host_reset(core);
+    host_in = test_in;
+    host_out = test_out;
+    host_event = test_event;
+    if ((core == HOST_CORE_128) && (rnd() & 1))
+    {
+        u8 page = rnd() & 0x07;
+        MemoryMap[3] = HostRAM[page] - 0xC000;
+        ContendMap[3] = page & 0x01;
+    }
+
+    u8 op = block_ops[rnd() % sizeof(block_ops)];
+    word pc = 0x4000 + rnd() % 0xBFFD;
+    MemoryMap[pc >> 14][pc] = PFX_ED;
+    MemoryMap[(pc + 1) >> 14][pc + 1] = op;
+    MemoryMap[(pc + 2) >> 14][pc + 2] = HALT;
+
+    CPU.PC.W = pc;
+    CPU.AF.W = rnd();
+    CPU.BC.W = (rnd() % 4) ? (rnd() % 300) : rnd();
+    CPU.DE.W = rnd();
+    CPU.HL.W = rnd();
+    CPU.SP.W = rnd();
+    CPU.IX.W = rnd();
+    CPU.IY.W = rnd();
+    CPU.R = rnd() & 0x7F;
+    if ((op == INIR) || (op == OTIR)) CPU.BC.B.h = rnd();
+
+    switch (rnd() % 8)
+    {
+        case 0: // Writes wrapping round into the Dandanator command addresses
+            speccy_mode = (rnd() & 1) ? MODE_ROM : 0;
+            if (op == INIR) CPU.HL.W = 0xFFFF - rnd() % 32;
+            else CPU.DE.W = (op == LDDR) ? rnd() % 4 : 0xFFFF - rnd() % 32;
+            break;
+        case 4: // Writes heading into (or starting in) the ROM
+            CPU.DE.W = (op == LDDR) ? 0x4000 + rnd() % 64 : 0x3FFF - rnd() % 64;
+            CPU.HL.W = (op == LDDR) ? 0x4000 + rnd() % 64 : 0x3FFF - rnd() % 64;
+            break;
+        case 1: // The block runs over its own opcode
+            CPU.DE.W = (op == LDDR) ? pc + 1 + rnd() % 16 : pc - rnd() % 16;
+            CPU.HL.W = (op == LDDR) ? pc + 1 + rnd() % 16 : pc - rnd() % 16;
+            break;
+        case 2: // The classic fill - copy onto the next byte
+            CPU.HL.W = 0x4000 + rnd() % 0xBF00;
+            CPU.DE.W = (op == LDDR) ? CPU.HL.W - 1 : CPU.HL.W + 1;
+            break;
+        case 3: // Across the paged bank boundary
+            CPU.HL.W = 0xC000 - rnd() % 32;
+            CPU.DE.W = 0xC000 - rnd() % 32;
+            break;
+    }
+
+    // Give CPIR something to find now and then
+    if ((op == CPIR) && (rnd() & 1))
+    {
+        word at = CPU.HL.W + rnd() % 64;
+        MemoryMap[at >> 14][at] = CPU.AF.B.h;
+    }
+}
+
+static void log_case(FILE *ref, int n, int *failures)
+{
+    char line[256], want[256];
+    int slice = 0;
+    u32 t = 0;
+
+    while (1)
+    {
+        if (slice < MAX_SLICES)
+        {
+            t += 1 + ((rnd() % 4) ? rnd() % 200 : rnd() % 3000);
+            host_exec(t);
+            snprintf(line, sizeof(line), "%s %d.%d PC=%04X AF=%04X BC=%04X DE=%04X HL=%04X R=%02X T=%u IO=%016llX\n",
+                     host_core_name[core], n, slice, CPU.PC.W, CPU.AF.W, CPU.BC.W, CPU.DE.W, CPU.HL.W,
+                     CPU.R & 0xFF, CPU.TStates, (unsigned long long)io_hash);
+            slices++;
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "%s %d mem=%016llX cpu=%016llX\n", host_core_name[core], n,
+                     (unsigned long long)host_hash_memory(), (unsigned long long)host_hash_cpu());
+        }
+
+        if (!ref) fputs(line, stdout);
+        else if (!fgets(want, sizeof(want), ref))
+        {
+            if ((*failures)++ < 5) printf("z80_block: the reference log ends before %s", line);
+            return;
+        }
+        else if (strcmp(line, want))
+        {
+            if ((*failures)++ < 5) printf("z80_block: got  %sz80_block: want %s", line, want);
+        }
+
+        if (slice++ == MAX_SLICES) break;
+        if (CPU.IFF & IFF_HALT) slice = MAX_SLICES;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FILE *ref = NULL;
+    int failures = 0;
+
+    if (argc > 1)
+    {
+        ref = fopen(argv[1], "r");
+        if (!ref) { printf("z80_block: can't open %s\n", argv[1]); return 2; }
+    }
+
+    host_init();
+    for (core = 0; core < HOST_CORES; core++)
+    {
+        for (int n = 0; n < CASES; n++)
+        {
+            setup_case(n);
+            log_case(ref, n, &failures);
+        }
+    }
+
+    if (!ref) return 0;
+    fclose(ref);
+    printf("z80_block: %s (%d cores x %d cases, %u slices, %d lines differ)\n", failures ? "FAILED" : "OK", HOST_CORES, CASES, slices, failures);
+    return failures ? 1 : 0;
+}
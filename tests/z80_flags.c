@@ -0,0 +1,195 @@
+// =====================================================================================
+// z80_flags - the lazy flags (Z80_FLAGS=lazy) against the cores that build F straight
+// away. The same cases run through a core built without Z80_LAZY_FLAGS, which gives
+// the reference log, and the lazy builds have to match it line for line.
+//
+//   z80_flags               print the log (run the eager build this way)
+//   z80_flags <ref.txt>     run and check against the log of the eager build
+//
+// Every case is an 8-bit ADD/ADC/SUB/SBC/CP (which only records its operands in a
+// lazy core) followed by one more instruction, both in a single ExecZ80() call, so the
+// second instruction is the first thing to see the pending flags. It covers:
+//
+//   - every A, operand and carry in for each of ADD/ADC/SUB/SBC/CP r with PUSH AF
+//     after, so the F that FlagsEvalZ80() builds is checked for all inputs
+//   - the A,A forms and the n, (HL), (IX+d) and (IY+d) operands
+//   - every main, CB, ED, DD, FD, DDCB and FDCB opcode as the second instruction -
+//     whatever it does with F shows up in the registers, memory or where it jumps
+//
+// ZEXDOC itself isn't part of the tree (nor is a CP/M host to run it) so this is the
+// check for the lazy flags: anything ZEXDOC could see the eager core do, the lazy ones
+// have to do as well.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include "z80_host.h"
+
+#define CODE            0x8000          // Uncontended in every core
+#define SCRATCH         0x9000          // Where the registers point - hashed after each case
+#define SAMPLES         128             // Random cases per opcode in the opcode sweep
+
+static u32 rng;
+static u32 rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static u64 hash;
+static void mix(u64 v) { hash = (hash ^ v) * 0x100000001B3ULL; hash ^= hash >> 29; }
+
+static int core;
+static u32 cases = 0;
+
+static u8 test_in(u16 Port) { mix(0x10000 | Port); return (u8)(Port * 13 + 7); }
+static void test_out(u16 Port, u8 Value) { mix(0x20000 | (Value << 16) | Port); }
+
+// The producers and how long each takes - all in uncontended memory
+typedef struct
+{
+    u8 code[3];
+    u8 length;
+    u8 tstates;
+} Producer;
+
+static const Producer alu_B[] = {
+    {{0x80}, 1, 4},         // ADD A,B
+    {{0x88}, 1, 4},         // ADC A,B
+    {{0x90}, 1, 4},         // SUB B
+    {{0x98}, 1, 4},         // SBC A,B
+    {{0xB8}, 1, 4},         // CP B
+};
+
+static const Producer alu_forms[] = {
+    {{0x87}, 1, 4},  {{0x8F}, 1, 4},  {{0x9F}, 1, 4},                                                     // ADD/ADC/SBC A,A
+    {{0xC6}, 2, 7},  {{0xCE}, 2, 7},  {{0xD6}, 2, 7},  {{0xDE}, 2, 7},  {{0xFE}, 2, 7},                 // op A,n
+    {{0x86}, 1, 7},  {{0x8E}, 1, 7},  {{0x96}, 1, 7},  {{0x9E}, 1, 7},  {{0xBE}, 1, 7},                 // op A,(HL)
+    {{0xDD, 0x86}, 3, 19}, {{0xDD, 0x8E}, 3, 19}, {{0xDD, 0x96}, 3, 19}, {{0xDD, 0x9E}, 3, 19}, {{0xDD, 0xBE}, 3, 19},
+    {{0xFD, 0x86}, 3, 19}, {{0xFD, 0x8E}, 3, 19}, {{0xFD, 0x96}, 3, 19}, {{0xFD, 0x9E}, 3, 19}, {{0xFD, 0xBE}, 3, 19},
+};
+
+// -------------------------------------------------------------------------------------
+// Put the producer and what follows it at CODE and run exactly those two instructions
+// -------------------------------------------------------------------------------------
+static void run_case(const Producer *P, const u8 *next, int next_len, u8 A, u8 operand, u8 F)
+{
+    u8 *code = &MemoryMap[CODE >> 14][CODE];
+    memcpy(code, P->code, P->length);
+    if (P->length == 2) code[1] = operand;
+    if (P->length == 3) code[2] = 0x10;     // (IX+16)
+    memcpy(code + P->length, next, next_len);
+
+    u8 *scratch = &MemoryMap[SCRATCH >> 14][SCRATCH];
+    for (int i = 0; i < 0x200; i++) scratch[i - 0x100] = i * 37;
+    scratch[0x10] = operand;                // (HL), (IX+16) and (IY+16)
+    scratch[0x00] = operand;
+
+    CPU.AF.B.h = A; CPU.AF.B.l = F;
+    CPU.BC.W = (operand << 8) | 0x40;
+    CPU.DE.W = SCRATCH + 0x20;
+    CPU.HL.W = SCRATCH;
+    CPU.IX.W = SCRATCH;
+    CPU.IY.W = SCRATCH;
+    CPU.SP.W = SCRATCH + 0xC0;
+    CPU.AF1.W = 0x1234; CPU.BC1.W = 0x5678; CPU.DE1.W = 0x9ABC; CPU.HL1.W = 0xDEF0;
+    CPU.PC.W = CODE;
+    CPU.IFF = 0; CPU.I = 0x3F; CPU.R = 0;
+    CPU.TStates = 1000;
+
+    host_exec(CPU.TStates + P->tstates + 1);
+
+    mix(CPU.AF.W); mix(CPU.BC.W); mix(CPU.DE.W); mix(CPU.HL.W);
+    mix(CPU.IX.W); mix(CPU.IY.W); mix(CPU.SP.W); mix(CPU.PC.W);
+    mix(CPU.AF1.W); mix(CPU.BC1.W); mix(CPU.DE1.W); mix(CPU.HL1.W);
+    mix(CPU.IFF); mix(CPU.I); mix(CPU.R & 0xFF); mix(CPU.TStates);
+    for (int i = 0; i < 0x200; i += 8)
+    {
+        u64 w;
+        memcpy(&w, &scratch[i - 0x100], 8);
+        mix(w);
+    }
+    cases++;
+}
+
+static void log_line(FILE *ref, const char *line, int *failures)
+{
+    char want[128];
+    if (!ref) { fputs(line, stdout); return; }
+    if (!fgets(want, sizeof(want), ref)) strcpy(want, "(end of the reference log)\n");
+    if (strcmp(line, want) && ((*failures)++ < 5)) printf("z80_flags: got  %sz80_flags: want %s", line, want);
+}
+
+int main(int argc, char **argv)
+{
+    static const u8 push_af[] = {0xF5};
+    static const u8 prefixes[][2] = {{0}, {0xCB}, {0xED}, {0xDD}, {0xFD}, {0xDD, 0xCB}, {0xFD, 0xCB}};
+    static const char *prefix_names[] = {"", "CB", "ED", "DD", "FD", "DDCB", "FDCB"};
+    FILE *ref = NULL;
+    int failures = 0;
+    char line[128];
+
+    if (argc > 1)
+    {
+        ref = fopen(argv[1], "r");
+        if (!ref) { printf("z80_flags: can't open %s\n", argv[1]); return 2; }
+    }
+
+    host_init();
+    for (core = 0; core < HOST_CORES; core++)
+    {
+        host_reset(core);
+        host_in = test_in;
+        host_out = test_out;
+
+        // Every input of every 8-bit arithmetic op, F pushed straight after
+        for (int p = 0; p < sizeof(alu_B) / sizeof(alu_B[0]); p++)
+        {
+            for (int A = 0; A < 256; A++)
+            {
+                hash = 0xCBF29CE484222325ULL;
+                for (int operand = 0; operand < 256; operand++)
+                {
+                    run_case(&alu_B[p], push_af, 1, A, operand, 0x00);
+                    run_case(&alu_B[p], push_af, 1, A, operand, 0xFF);
+                }
+                snprintf(line, sizeof(line), "%s %02X A=%02X %016llX\n", host_core_name[core], alu_B[p].code[0], A, (unsigned long long)hash);
+                log_line(ref, line, &failures);
+            }
+        }
+
+        // The other forms with random inputs
+        rng = 0x2545F491;
+        for (int p = 0; p < sizeof(alu_forms) / sizeof(alu_forms[0]); p++)
+        {
+            hash = 0xCBF29CE484222325ULL;
+            for (int n = 0; n < 4096; n++) run_case(&alu_forms[p], push_af, 1, rnd(), rnd(), rnd());
+            snprintf(line, sizeof(line), "%s %02X%02X %016llX\n", host_core_name[core], alu_forms[p].code[0], alu_forms[p].code[1], (unsigned long long)hash);
+            log_line(ref, line, &failures);
+        }
+
+        // Every opcode as the first thing to look at the pending flags
+        for (int g = 0; g < sizeof(prefixes) / sizeof(prefixes[0]); g++)
+        {
+            for (int op = 0; op < 256; op++)
+            {
+                u8 next[6];
+                int len = 0;
+                if (prefixes[g][0]) next[len++] = prefixes[g][0];
+                if (prefixes[g][1]) next[len++] = prefixes[g][1];
+                if (g >= 5) next[len++] = 0x10;         // DDCB/FDCB displacement comes first
+                next[len++] = op;
+                next[len++] = 0x80;                     // Anything that wants n, nn or d
+                next[len++] = 0x90;
+
+                hash = 0xCBF29CE484222325ULL;
+                for (int p = 0; p < sizeof(alu_B) / sizeof(alu_B[0]); p++)
+                {
+                    for (int n = 0; n < SAMPLES; n++) run_case(&alu_B[p], next, len, rnd(), rnd(), rnd());
+                }
+                snprintf(line, sizeof(line), "%s %s%02X %016llX\n", host_core_name[core], prefix_names[g], op, (unsigned long long)hash);
+                log_line(ref, line, &failures);
+            }
+        }
+    }
+
+    if (!ref) return 0;
+    fclose(ref);
+    printf("z80_flags: %s (%d cores, %u cases, %d lines differ)\n", failures ? "FAILED" : "OK", HOST_CORES, cases, failures);
+    return failures ? 1 : 0;
+}
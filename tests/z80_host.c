@@ -0,0 +1,182 @@
+// =====================================================================================
+// z80_host - see z80_host.h
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "z80_host.h"
+
+const char *host_core_name[HOST_CORES] = {"fast", "48K", "128K"};
+
+u8 HostROM[0x4000];
+u8 HostRAM[8][0x4000];
+u32 host_screen_writes = 0;
+u32 host_screen_tstates = 0;
+
+// -------------------------------------------------------------------------------------
+// What the cores link against from the rest of the emulator
+// -------------------------------------------------------------------------------------
+Z80 CPU;
+u8 *MemoryMap[4];
+u8 *zx_screen_page = HostRAM[5];
+u32 zx_screen_window = 0x1B00;
+u8 accurate_emulation = 1;
+u32 debug[0x10];
+u32 DX, DY;
+u8 zx_128k_mode, portFD;
+u8 ROM_Memory[MAX_TAPE_SIZE];
+u8 SpectrumBios[0x4000];
+u8 SpectrumBios128[0x8000];
+struct Config_t myConfig;
+u8 rom_special_bank = 0;
+u8 speccy_mode = 0;
+u32 cpu_event_next = 0xFFFFFFFF;
+
+extern u8 dan_state, dan_settle, dan_counter, dan_latched_cmd, dandy_locked;
+extern void dandanator_settle(void);
+
+static u32 cpu_event_time[CPU_EVT_COUNT];
+u8 cpu_event_pending = 0;
+
+static u8 default_in(u16 Port) { return 0xFF; }
+static void default_out(u16 Port, u8 Value) { }
+static void default_event(u8 event) { }
+
+u8   (*host_in)(u16 Port) = default_in;
+void (*host_out)(u16 Port, u8 Value) = default_out;
+void (*host_event)(u8 event) = default_event;
+
+#ifndef HOST_SCREEN_DIRTY     // Unless the test links the real one from screen_dirty.c
+void zx_screen_write(u8 *Ptr, byte value, u32 tstates)
+{
+    host_screen_writes++;
+    host_screen_tstates = tstates;
+    *Ptr = value;
+}
+#endif
+
+unsigned char cpu_readport_speccy(register unsigned short Port)
+{
+    CPU.TStates += 4;
+    return host_in(Port);
+}
+
+void cpu_writeport_speccy(register unsigned short Port, register unsigned char Value)
+{
+    CPU.TStates += 4;
+    host_out(Port, Value);
+}
+
+// The CPU events work just the same as in spectrum.c
+void speccy_cpu_event(u32 tstates, u8 event)
+{
+    cpu_event_time[event] = tstates;
+    cpu_event_pending |= (1 << event);
+    if (tstates < cpu_event_next) cpu_event_next = tstates;
+    if (tstates < zx_run_limit) zx_run_limit = tstates;
+}
+
+void speccy_cpu_events(void)
+{
+    for (u8 event=0; event<CPU_EVT_COUNT; event++)
+    {
+        if ((cpu_event_pending & (1 << event)) && (cpu_event_time[event] <= CPU.TStates))
+        {
+            cpu_event_pending &= ~(1 << event);
+            host_event(event);
+            switch (event)
+            {
+                case CPU_EVT_DANDANATOR:
+                    dandanator_settle();
+                    break;
+
+                case CPU_EVT_TAPE:
+                    accurate_emulation = 0;
+                    break;
+            }
+        }
+    }
+
+    cpu_event_next = 0xFFFFFFFF;
+    for (u8 event=0; event<CPU_EVT_COUNT; event++)
+    {
+        if ((cpu_event_pending & (1 << event)) && (cpu_event_time[event] < cpu_event_next)) cpu_event_next = cpu_event_time[event];
+    }
+}
+
+void Trap_Bad_Ops(char *prefix, byte I, word W)
+{
+}
+
+// -------------------------------------------------------------------------------------
+
+void host_init(void)
+{
+    if (mmap((void*)PatchLookup, 0x10000 * sizeof(patchFunc), PROT_READ|PROT_WRITE, MAP_FIXED|MAP_PRIVATE|MAP_ANONYMOUS, -1, 0) != (void*)PatchLookup)
+    {
+        printf("z80_host: can't map the tape patch table at %p\n", (void*)PatchLookup);
+        exit(2);
+    }
+}
+
+// Like the emulator, MemoryMap[] holds each page biased back by its start address
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+void host_reset(int core)
+{
+    MemoryMap[0] = HostROM;
+    MemoryMap[1] = HostRAM[5] - 0x4000;
+    MemoryMap[2] = HostRAM[2] - 0x8000;
+    MemoryMap[3] = HostRAM[0] - 0xC000;
+    ContendMap[0] = ContendMap[1] = ContendMap[2] = ContendMap[3] = 0;
+    if (core != HOST_CORE_FAST) ContendMap[1] = 1;
+    myConfig.machine = (core == HOST_CORE_128);
+    accurate_emulation = (core != HOST_CORE_FAST);
+    contend_line_base_48 = contend_line_base_128 = 0;
+    cpu_event_next = 0xFFFFFFFF;
+    cpu_event_pending = 0;
+    speccy_mode = 0;
+    rom_special_bank = 0;
+    dandy_disabled = dandy_locked = 0;
+    dandanator_cmd = dan_latched_cmd = dan_state = dan_settle = dan_counter = 0;
+    memset(PatchLookup, 0x00, 0x10000 * sizeof(patchFunc));
+    host_in = default_in;
+    host_out = default_out;
+    host_event = default_event;
+    host_screen_writes = 0;
+
+    ResetZ80(&CPU);
+    rom_decode_flush();
+}
+#pragma GCC diagnostic pop
+
+void host_exec(u32 RunToCycles)
+{
+    ExecZ80_Speccy(RunToCycles);
+}
+
+// -------------------------------------------------------------------------------------
+
+static u64 hash_words(u64 h, const void *p, size_t n)
+{
+    const u8 *b = p;
+    for (size_t i = 0; i < n; i += 8)
+    {
+        u64 w = 0;
+        memcpy(&w, b + i, (n - i < 8) ? n - i : 8);
+        h = (h ^ w) * 0x100000001B3ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+u64 host_hash_memory(void)
+{
+    u64 h = hash_words(0xCBF29CE484222325ULL, HostROM, sizeof(HostROM));
+    return hash_words(h, HostRAM, sizeof(HostRAM));
+}
+
+u64 host_hash_cpu(void)
+{
+    return hash_words(0xCBF29CE484222325ULL, &CPU, sizeof(CPU));
+}
@@ -0,0 +1,54 @@
+// =====================================================================================
+// z80_host - the bits of the emulator the Z80 cores need around them (memory map, I/O
+// ports, screen writes, CPU events) so the host tests can build the cores exactly as
+// they are for the DS and drive them directly. No ULA, tape, sound or screen here -
+// each test plugs in the port and event handlers it wants to see.
+// =====================================================================================
+#ifndef Z80_HOST_H
+#define Z80_HOST_H
+
+#include <nds.h>
+#include "Z80.h"
+#include "SpeccyUtils.h"
+
+#define HOST_CORE_FAST      0   // ExecZ80_Speccy_Fast - cycle tables, no contention
+#define HOST_CORE_48        1   // ExecZ80_Speccy_48
+#define HOST_CORE_128       2   // ExecZ80_Speccy_128
+#define HOST_CORES          3
+
+extern const char *host_core_name[HOST_CORES];
+
+// The lower 16K is HostROM and the rest is mapped from the eight 128K RAM pages the same
+// way the 128K machine does after a reset: page 5, page 2 and then page 0.
+extern u8 HostROM[0x4000];
+extern u8 HostRAM[8][0x4000];
+
+// Port handlers - the defaults read 0xFF and ignore writes. Both are charged the 4
+// T-States of the I/O cycle like spectrum.c does. The CPU events (speccy_cpu_event)
+// are carried out as in spectrum.c; host_event is told about each one first.
+extern u8   (*host_in)(u16 Port);
+extern void (*host_out)(u16 Port, u8 Value);
+extern void (*host_event)(u8 event);
+
+// How many writes zx_screen_write() saw and the T-State it was given for the last one
+// (the screen is plain RAM here - built with HOST_SCREEN_DIRTY, the real zx_screen_write()
+// from screen_dirty.c is linked instead and these stay at zero)
+extern u32 host_screen_writes;
+extern u32 host_screen_tstates;
+
+// Once per run - maps the tape patch table (PatchLookup lives at a fixed DS address)
+void host_init(void);
+
+// Reset the CPU, the Dandanator and the memory map for the given core (contention on
+// page 5 for the accurate cores, everything else uncontended) and put back the default
+// handlers.
+void host_reset(int core);
+
+// Run until RunToCycles through ExecZ80_Speccy() on the core host_reset() picked
+void host_exec(u32 RunToCycles);
+
+// A quick hash of the whole memory map, the CPU and everything the cores keep aside
+u64 host_hash_memory(void);
+u64 host_hash_cpu(void);
+
+#endif
@@ -0,0 +1,215 @@
+// =====================================================================================
+// z80_idle - idle loop skipping (IDLE_LOOP in Z80_core.h, IdleLoopZ80 in Z80.c). The
+// same wait loops run through a core built with Z80_NO_IDLE_LOOP, where every pass goes
+// round the CPU, and the two logs have to match line for line.
+//
+//   z80_idle               print the log (run the Z80_NO_IDLE_LOOP build this way)
+//   z80_idle <ref.txt>     run and check against the log of the reference build
+//
+// There are two kinds of wait - the frame counter (LD A,(23672) / CP B / JR Z) and a
+// flag in RAM (LD A,(nn) / CP 0 / JR Z) - with the loop and what it polls in pages the
+// ULA contends and pages it doesn't. The CPU runs in random slices and between some of
+// them there is an IM 1 interrupt, as spectrum.c gives at the start of each frame, whose
+// routine bumps FRAMES or sets the flag. After each slice the log gets the registers, R
+// and T-States; at the end of the run a hash of all memory and the whole CPU struct.
+//
+// idle_loop_skips is checked too: the reference build never skips, the fast core has
+// to skip every run and the contended cores exactly when the loop's opcode fetches and
+// memory reads are all outside the contended pages.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include "z80_host.h"
+
+#define RUNS            40              // Per case and core
+#define SLICES          60
+#define FRAMES          23672
+
+typedef struct
+{
+    const char *name;
+    u8   frames;                        // Polls FRAMES (otherwise a flag at poll)
+    word code;                          // Where the loop goes
+    word poll;
+    u8   bank;                          // Paged in at $C000 on the 128K (0 is the reset default)
+} Case_t;
+
+static const Case_t cases[] =
+{
+    {"frames/8000",     1, 0x8000, FRAMES, 0},     // FRAMES is in contended RAM
+    {"frames/6000",     1, 0x6000, FRAMES, 0},
+    {"flag/8000/9000",  0, 0x8000, 0x9000, 0},     // Nothing contended
+    {"flag/6000/9000",  0, 0x6000, 0x9000, 0},     // The loop is
+    {"flag/8000/7000",  0, 0x8000, 0x7000, 0},     // What it reads is
+    {"flag/C000/D000",  0, 0xC000, 0xD000, 0},
+    {"flag/C000/D000/7",0, 0xC000, 0xD000, 7},     // Bank 7 is contended on the 128K
+    {"flag/8000/E000/3",0, 0x8000, 0xE000, 3},     // So is bank 3
+};
+#define CASES   (int)(sizeof(cases) / sizeof(cases[0]))
+
+static u32 rng;
+static u32 rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static int core;
+static int failures = 0;
+static u32 slices = 0;
+
+static void poke(word A, u8 value) { MemoryMap[A >> 14][A] = value; }
+
+static void put(word A, const u8 *code, int len)
+{
+    for (int i = 0; i < len; i++) poke(A + i, code[i]);
+}
+
+// -------------------------------------------------------------------------------------
+
+static void setup_run(const Case_t *c, int n)
+{
+    rng = 0x9E3779B9u * ((core * CASES + (c - cases)) * RUNS + n + 1);
+
+    for (u32 *p = (u32 *)HostROM; p < (u32 *)(HostROM + sizeof(HostROM)); p++) *p = rnd();
+    for (u32 *p = (u32 *)HostRAM; p < (u32 *)((u8 *)HostRAM + sizeof(HostRAM)); p++) *p = rnd();
+
+    host_reset(core);
+    if ((core == HOST_CORE_128) && c->bank)
+    {
+        MemoryMap[3] = HostRAM[c->bank] - 0xC000;
+        ContendMap[3] = c->bank & 0x01;
+    }
+
+    word p = c->code;
+    u8 lo = c->poll & 0xFF, hi = c->poll >> 8;
+    if (c->frames)
+    {
+        const u8 isr[] = {0xE5,                     // PUSH HL
+                          0x2A, lo, hi,             // LD HL,(FRAMES)
+                          0x23,                     // INC HL
+                          0x22, lo, hi,             // LD (FRAMES),HL
+                          0xE1, 0xFB, 0xC9};        // POP HL; EI; RET
+        memcpy(&HostROM[0x0038], isr, sizeof(isr));
+
+        const u8 loop[] = {0x3A, lo, hi,            // LD A,(FRAMES)
+                           0x47,                    // LD B,A
+                           0x3A, lo, hi,            // wait: LD A,(FRAMES)
+                           0xB8,                    // CP B
+                           0x28, 0xFA,              // JR Z,wait
+                           0x13,                    // INC DE
+                           0x18, 0xF3};             // JR to the top
+        put(p, loop, sizeof(loop));
+    }
+    else
+    {
+        const u8 isr[] = {0xF5,                     // PUSH AF
+                          0x3E, 1 + rnd() % 255,    // LD A,n
+                          0x32, lo, hi,             // LD (nn),A
+                          0xF1, 0xFB, 0xC9};        // POP AF; EI; RET
+        memcpy(&HostROM[0x0038], isr, sizeof(isr));
+        const u8 loop[] = {0x3A, lo, hi,            // wait: LD A,(nn)
+                           0xFE, 0x00,              // CP 0
+                           0x28, 0xF9,              // JR Z,wait
+                           0x13,                    // INC DE
+                           0xAF,                    // XOR A
+                           0x32, lo, hi,            // LD (nn),A
+                           0x18, 0xF2};             // JR wait
+        put(p, loop, sizeof(loop));
+        poke(c->poll, 0);
+    }
+
+    CPU.PC.W = p;
+    CPU.AF.W = rnd();
+    CPU.BC.W = rnd();
+    CPU.DE.W = 0;
+    CPU.HL.W = rnd();
+    CPU.SP.W = 0xBF00;
+    CPU.R = rnd() & 0x7F;
+    CPU.IFF = IFF_1 | IFF_IM1;
+}
+
+// Would a contended core see contention anywhere in this loop?
+static int contended(const Case_t *c)
+{
+    return ContendMap[c->code >> 14] || ContendMap[(c->code + 13) >> 14] || ContendMap[c->poll >> 14];
+}
+
+static void log_run(FILE *ref, const Case_t *c, int n)
+{
+    char line[256], want[256];
+    u32 t = 0;
+
+    for (int slice = 0; slice <= SLICES; slice++)
+    {
+        if (slice < SLICES)
+        {
+            t += 1 + ((rnd() % 4) ? rnd() % 3000 : rnd() % 70000);
+            host_exec(t);
+            snprintf(line, sizeof(line), "%s %s %d.%d PC=%04X AF=%04X BC=%04X DE=%04X HL=%04X R=%02X T=%u\n",
+                     host_core_name[core], c->name, n, slice, CPU.PC.W, CPU.AF.W, CPU.BC.W, CPU.DE.W, CPU.HL.W,
+                     CPU.R & 0xFF, CPU.TStates);
+            slices++;
+
+            // The interrupt now and then - its routine gets to run in the next slice
+            if ((rnd() % 3) == 0) IntZ80(&CPU, INT_RST38);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "%s %s %d mem=%016llX cpu=%016llX\n", host_core_name[core], c->name, n,
+                     (unsigned long long)host_hash_memory(), (unsigned long long)host_hash_cpu());
+        }
+
+        if (!ref) fputs(line, stdout);
+        else if (!fgets(want, sizeof(want), ref))
+        {
+            if (failures++ < 5) printf("z80_idle: the reference log ends before %s", line);
+            return;
+        }
+        else if (strcmp(line, want))
+        {
+            if (failures++ < 5) printf("z80_idle: got  %sz80_idle: want %s", line, want);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FILE *ref = NULL;
+    u32 skips = 0;
+
+    if (argc > 1)
+    {
+        ref = fopen(argv[1], "r");
+        if (!ref) { printf("z80_idle: can't open %s\n", argv[1]); return 2; }
+    }
+
+    host_init();
+    for (core = 0; core < HOST_CORES; core++)
+    {
+        for (int i = 0; i < CASES; i++)
+        {
+            const Case_t *c = &cases[i];
+            u32 skipped = 0;
+
+            for (int n = 0; n < RUNS; n++)
+            {
+                setup_run(c, n);
+                int expect = ref && ((core == HOST_CORE_FAST) || !contended(c));
+                log_run(ref, c, n);
+
+                if (expect && !idle_loop_skips)
+                {
+                    if (failures++ < 5) fprintf(ref ? stdout : stderr, "z80_idle: %s %s %d: never skipped\n", host_core_name[core], c->name, n);
+                }
+                else if (!expect && idle_loop_skips)
+                {
+                    if (failures++ < 5) fprintf(ref ? stdout : stderr, "z80_idle: %s %s %d: %u skips, should be none\n", host_core_name[core], c->name, n, idle_loop_skips);
+                }
+                skipped += idle_loop_skips;
+            }
+            skips += skipped;
+        }
+    }
+
+    if (!ref) return failures ? 1 : 0;
+    fclose(ref);
+    printf("z80_idle: %s (%d cores x %d cases x %d runs, %u slices, %u skips, %d checks failed)\n", failures ? "FAILED" : "OK", HOST_CORES, CASES, RUNS, slices, skips, failures);
+    return failures ? 1 : 0;
+}
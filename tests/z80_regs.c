@@ -0,0 +1,124 @@
+// =====================================================================================
+// z80_regs - what the rest of the emulator does to the CPU struct from inside a call
+// out of the core has to stick, and what it reads there has to be current. That is
+// the contract of the register cache (Z80_REGS=cached, CPU_CALLOUT in Z80_core.h) but
+// every build is held to it.
+//
+// A tape patch (PatchLookup on a DEC A) rewrites A, HL, R, the PC and the T-States
+// directly in CPU. The code it sends the CPU to stores what it finds, writes the
+// screen and does an OUT whose handler checks what it sees and then changes it all
+// again. An IN handler checks the result of that. The screen writes in between must
+// be handed the T-States as they are after each call out, not as they were before.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include "z80_host.h"
+
+static int failures = 0;
+static const char *core_name;
+
+#define CHECK(Cond)  do { if (!(Cond)) { printf("z80_regs: %s: %s\n", core_name, #Cond); failures++; } } while (0)
+
+static u32 patch_T, out_T, in_T;
+static u32 screen_T[2];
+static u32 screen_count;
+
+// DEC A at $8002 (looked up by the PC after it) - the way the tape loader patches
+// jump the CPU elsewhere
+static u8 test_patch(void)
+{
+    CHECK(CPU.PC.W == 0x8003);
+    CHECK(CPU.AF.B.h == 0x05);
+    patch_T = CPU.TStates;
+
+    CPU.AF.B.h = 0x42;
+    CPU.HL.W = 0x1234;
+    CPU.R = 0x40;
+    CPU.PC.W = 0x8100;
+    CPU.TStates += 10000;
+    return 0;
+}
+
+static void test_out(u16 Port, u8 Value)
+{
+    screen_T[0] = host_screen_tstates;
+    screen_count = host_screen_writes;
+
+    CHECK(Port == 0x42FE);
+    CHECK(Value == 0x42);
+    CHECK(CPU.PC.W == 0x810B);
+    CHECK(CPU.HL.W == 0x1234);
+    CHECK((CPU.R & 0x7F) == 0x44);
+    CHECK((CPU.TStates - patch_T) >= 10000 && (CPU.TStates - patch_T) < 10100);
+    out_T = CPU.TStates;
+
+    CPU.AF.B.h = 0x99;
+    CPU.HL.W = 0xBEEF;
+    CPU.R = 0x60;
+    CPU.PC.W = 0x8200;
+    CPU.TStates += 20000;
+}
+
+static u8 test_in(u16 Port)
+{
+    screen_T[1] = host_screen_tstates;
+
+    CHECK(Port == 0x99FE);
+    CHECK(CPU.PC.W == 0x820B);
+    CHECK(CPU.HL.W == 0xBEEF);
+    CHECK((CPU.R & 0x7F) == 0x64);
+    CHECK((CPU.TStates - out_T) >= 20000 && (CPU.TStates - out_T) < 20100);
+    in_T = CPU.TStates;
+    return 0x77;
+}
+
+static void put(word A, const u8 *code, int len)
+{
+    for (int i = 0; i < len; i++) MemoryMap[(word)(A + i) >> 14][(word)(A + i)] = code[i];
+}
+
+static void run(int core)
+{
+    static const u8 start[] = {0x3E, 0x05, 0x3D, 0x76};                                     // LD A,5; DEC A; HALT
+    static const u8 after_patch[] = {0x22, 0x00, 0x90, 0x32, 0x02, 0x90, 0x32, 0x00, 0x40, 0xD3, 0xFE, 0x76};   // LD ($9000),HL; LD ($9002),A; LD ($4000),A; OUT ($FE),A; HALT
+    static const u8 after_out[] = {0x22, 0x10, 0x90, 0x32, 0x12, 0x90, 0x32, 0x01, 0x40, 0xDB, 0xFE, 0x32, 0x14, 0x90, 0x76};  // ... LD ($4001),A; IN A,($FE); LD ($9014),A; HALT
+
+    core_name = host_core_name[core];
+    memset(HostROM, 0x00, sizeof(HostROM));
+    memset(HostRAM, 0x00, sizeof(HostRAM));
+    host_reset(core);
+    host_in = test_in;
+    host_out = test_out;
+    PatchLookup[0x8003] = test_patch;
+    put(0x8000, start, sizeof(start));
+    put(0x8100, after_patch, sizeof(after_patch));
+    put(0x8200, after_out, sizeof(after_out));
+    patch_T = out_T = in_T = 0;
+    screen_T[0] = screen_T[1] = 0;
+
+    CPU.PC.W = 0x8000;
+    CPU.SP.W = 0xF000;
+    host_exec(50000);
+
+    u8 *mem = &MemoryMap[2][0x9000];
+    CHECK(in_T != 0);
+    CHECK(mem[0x00] == 0x34 && mem[0x01] == 0x12 && mem[0x02] == 0x42);
+    CHECK(mem[0x10] == 0xEF && mem[0x11] == 0xBE && mem[0x12] == 0x99);
+    CHECK(mem[0x14] == 0x77);
+    CHECK(MemoryMap[1][0x4000] == 0x42 && MemoryMap[1][0x4001] == 0x99);
+    CHECK(screen_count == 1 && host_screen_writes == 2);
+    CHECK((screen_T[0] - patch_T) >= 10000 + 16 + 13 && screen_T[0] < out_T);      // Past LD (nn),HL and LD (nn),A
+    CHECK((screen_T[1] - out_T) >= 20000 + 16 + 13 && screen_T[1] < in_T);
+    CHECK(CPU.PC.W == 0x820E);
+    CHECK(CPU.AF.B.h == 0x77);
+    CHECK(CPU.HL.W == 0xBEEF);
+    CHECK(CPU.TStates >= 50000);
+}
+
+int main(int argc, char **argv)
+{
+    host_init();
+    for (int core = 0; core < HOST_CORES; core++) run(core);
+    printf("z80_regs: %s (%d cores, %d checks failed)\n", failures ? "FAILED" : "OK", HOST_CORES, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,353 @@
+// =====================================================================================
+// zxr_roundtrip - records a made-up game session with recorder.c as it is, reads it
+// back with tools/zxr.c and then turns it into an AVI with zxr2video and reads that
+// back too. Every frame's screen, border, ULA+ palette, Timex mode and audio have to come out of
+// the recording as they went in, and every pixel and sample has to be in the AVI.
+//
+//   zxr_roundtrip <zxr2video>
+//
+// The session has frames where nothing moves, a sprite moving, whole screens of noise
+// (which don't compress at all), FLASH, border and palette changes, ULA+ going on and
+// off, the Timex hi-colour and hi-res modes, frames of no audio, the most audio a frame
+// can have and the mixer being reset.
+// It runs in build/zxr since the recorder writes to the current directory.
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+#include "../tools/zxr.h"
+
+// What recorder.c needs from the rest of the emulator
+extern uint8_t recorder_active;
+extern void recorder_start(uint32_t sample_rate);
+extern void recorder_stop(void);
+extern void recorder_frame(const s16 *mixer_ring, uint16_t mixer_mask, uint16_t mixer_head);
+
+uint8_t *zx_screen_page;
+uint8_t  portFE = 0;
+uint8_t  zx_128k_mode = 1;
+uint8_t  zx_ula_plus_enabled = 0;
+uint8_t  zx_ula_plus_palette[64];
+uint8_t  zx_timex_latched = 0;
+void _putchar(char character) {}
+
+#define FRAMES          150
+#define SAMPLE_RATE     44100
+#define MIXER_MASK      2047
+
+static const u8 spectrum_rgb[16][3] =
+{
+    {0x00,0x00,0x00}, {0x00,0x00,0xD8}, {0xD8,0x00,0x00}, {0xD8,0x00,0xD8},
+    {0x00,0xD8,0x00}, {0x00,0xD8,0xD8}, {0xD8,0xD8,0x00}, {0xD8,0xD8,0xD8},
+    {0x00,0x00,0x00}, {0x00,0x00,0xFF}, {0xFF,0x00,0x00}, {0xFF,0x00,0xFF},
+    {0x00,0xFF,0x00}, {0x00,0xFF,0xFF}, {0xFF,0xFF,0x00}, {0xFF,0xFF,0xFF},
+};
+
+// Everything each frame should come back as
+static struct
+{
+    u8  screen[6912];
+    u8  border;
+    u8  palette[64];
+    u8  ulaplus;
+    u8  timex;
+    u8  screen2[6144];
+    u16 samples;
+    s16 audio[ZXR_MAX_SAMPLES];
+} expect[FRAMES];
+
+static u32 rng = 1;
+static u32 rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static int failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { if (failures++ < 10) printf(__VA_ARGS__); } } while (0)
+
+static u32 read32(const u8 *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24); }
+
+// -------------------------------------------------------------------------------------
+// The session - the screen, border, palette and mixer ring as the emulator would leave
+// them at the end of each frame
+// -------------------------------------------------------------------------------------
+static void record(void)
+{
+    static u8 screen[0x4000];   // Both Timex display files
+    static s16 mixer[MIXER_MASK + 1];
+    u16 head = 0, tail = 0;
+    s16 level = 0;
+
+    for (int i = 0; i < 0x4000; i++) screen[i] = rnd();
+    zx_screen_page = screen;
+
+    recorder_start(SAMPLE_RATE);
+    if (!recorder_active) { printf("zxr_roundtrip: the recorder didn't start\n"); exit(2); }
+
+    for (int f = 0; f < FRAMES; f++)
+    {
+        // The screen - a sprite moving across most frames, now and then no change or all noise
+        if ((f % 37) == 20) for (int i = 0; i < 0x4000; i++) screen[i] = rnd();
+        else if ((f % 5) != 3)
+        {
+            for (int row = 0; row < 16; row++) screen[((f * 3) & 0x7FF) + row * 32] ^= 0xA5 + row;
+            screen[0x1800 + ((f * 7) % 768)] = rnd();
+            screen[0x2000 + ((f * 11) % 6144)] = rnd();     // Seen only in the Timex modes
+        }
+
+        // Timex hi-colour, then hi-res in two different colors and then back to normal
+        if (f == 100) zx_timex_latched = 0x02;
+        if (f == 120) zx_timex_latched = 0x06 | (2 << 3);
+        if (f == 130) zx_timex_latched = 0x06 | (5 << 3);
+        if (f == 140) zx_timex_latched = 0x00;
+
+        if ((f % 7) == 0) portFE = (portFE & ~0x07) | (rnd() & 0x07);
+        if (f == 30) zx_ula_plus_enabled = 1;
+        if ((f >= 30) && (f < 90) && ((f % 9) == 0)) zx_ula_plus_palette[rnd() & 63] = rnd();
+        if (f == 90) zx_ula_plus_enabled = 0;
+        if (f == 110) zx_ula_plus_palette[5] ^= 0xFF;  // Changed while ULA+ is off
+
+        // The audio - about a frame's worth, but none, the most there can be and a reset too
+        u32 n = 870 + (rnd() % 20);
+        if ((f % 25) == 12) n = 0;
+        if (f == 50) n = ZXR_MAX_SAMPLES;
+        for (u32 i = 0; i < n; i++) { level += 97 + (rnd() & 0x3FF); mixer[head] = level; head = (head + 1) & MIXER_MASK; }
+        if (f == 70) head = (head + ZXR_MAX_SAMPLES + 100) & MIXER_MASK;   // The mixer was reset
+
+        // What should come out for this frame - the recorder picks up the ring on the first
+        if (f == 0) tail = head;
+        u32 samples = (head - tail) & MIXER_MASK;
+        if (samples > ZXR_MAX_SAMPLES) { tail = head; samples = 0; }
+        memcpy(expect[f].screen, screen, 6912);
+        expect[f].border = portFE & 0x07;
+        memcpy(expect[f].palette, zx_ula_plus_palette, 64);
+        expect[f].ulaplus = zx_ula_plus_enabled;
+        expect[f].timex = zx_timex_latched;
+        memcpy(expect[f].screen2, screen + 0x2000, 6144);
+        expect[f].samples = samples;
+        for (u32 i = 0; i < samples; i++, tail = (tail + 1) & MIXER_MASK) expect[f].audio[i] = mixer[tail];
+
+        recorder_frame(mixer, MIXER_MASK, head);
+    }
+    recorder_stop();
+}
+
+// The recording the recorder just made (after any old ones were cleared away)
+static int find_recording(char *path, size_t len, int remove_all)
+{
+    DIR *dir = opendir(".");
+    struct dirent *entry;
+    int found = 0;
+
+    while (dir && (entry = readdir(dir)))
+    {
+        size_t n = strlen(entry->d_name);
+        if (strncmp(entry->d_name, "REC-", 4) || (n < 4) || strcmp(entry->d_name + n - 4, ".zxr")) continue;
+        if (remove_all) remove(entry->d_name);
+        else { snprintf(path, len, "%s", entry->d_name); found++; }
+    }
+    if (dir) closedir(dir);
+    return found;
+}
+
+// -------------------------------------------------------------------------------------
+// The recording read back frame by frame
+// -------------------------------------------------------------------------------------
+static void check_zxr(const char *path)
+{
+    static zxr_t zxr;
+    int f, status;
+
+    CHECK(zxr_open(&zxr, path) == 0, "%s: won't open\n", path);
+    CHECK((zxr.machine == 1) && (zxr.fps == 50) && (zxr.sample_rate == SAMPLE_RATE), "header: machine %d, %d fps, %u Hz\n", zxr.machine, zxr.fps, zxr.sample_rate);
+
+    for (f = 0; (status = zxr_next(&zxr)) == 1; f++)
+    {
+        if (f >= FRAMES) break;
+        CHECK(!memcmp(zxr.screen, expect[f].screen, 6912), "frame %d: the screen is different\n", f);
+        CHECK(zxr.border == expect[f].border, "frame %d: border %d, should be %d\n", f, zxr.border, expect[f].border);
+        CHECK(zxr.ulaplus == expect[f].ulaplus, "frame %d: ULA+ %d, should be %d\n", f, zxr.ulaplus, expect[f].ulaplus);
+        CHECK(!expect[f].ulaplus || !memcmp(zxr.palette, expect[f].palette, 64), "frame %d: the ULA+ palette is different\n", f);
+        CHECK(zxr.timex == expect[f].timex, "frame %d: Timex mode %02X, should be %02X\n", f, zxr.timex, expect[f].timex);
+        CHECK(!(expect[f].timex & 0x02) || !memcmp(zxr.screen2, expect[f].screen2, 6144), "frame %d: the second display file is different\n", f);
+        CHECK(zxr.samples == expect[f].samples, "frame %d: %d samples, should be %d\n", f, zxr.samples, expect[f].samples);
+        CHECK(!memcmp(zxr.audio, expect[f].audio, zxr.samples * 2), "frame %d: the audio is different\n", f);
+    }
+    CHECK((f == FRAMES) && (status == 0), "%d frames and then %d - should be %d and then the end\n", f, status, FRAMES);
+    zxr_close(&zxr);
+}
+
+// A recording cut short (the SD card filled up) gives the frames before it and then ends
+static void check_truncated(const char *path)
+{
+    static u8 data[8 << 20];
+    static zxr_t zxr;
+    FILE *f = fopen(path, "rb");
+    size_t len = fread(data, 1, sizeof(data), f);
+    fclose(f);
+
+    for (size_t cut = 16; cut < len; cut += len / 7)
+    {
+        f = fopen("cut.zxr", "wb");
+        fwrite(data, 1, cut, f);
+        fclose(f);
+
+        int frames = 0, status;
+        CHECK(zxr_open(&zxr, "cut.zxr") == 0, "cut at %zu: won't open\n", cut);
+        while ((status = zxr_next(&zxr)) == 1)
+        {
+            CHECK(!memcmp(zxr.screen, expect[frames].screen, 6912), "cut at %zu: frame %d is different\n", cut, frames);
+            if (++frames > FRAMES) break;
+        }
+        CHECK((status == 0) && (frames < FRAMES), "cut at %zu: %d frames and then %d\n", cut, frames, status);
+        zxr_close(&zxr);
+    }
+    remove("cut.zxr");
+}
+
+// -------------------------------------------------------------------------------------
+// The AVI zxr2video made of it - worked out here pixel by pixel rather than the way
+// zxr_render() does it
+// -------------------------------------------------------------------------------------
+static void expected_pixel(int f, int x, int y, u8 *rgb)
+{
+    int sx = x - ZXR_BORDER_X, sy = y - ZXR_BORDER_Y;
+
+    if ((sx < 0) || (sx >= 256) || (sy < 0) || (sy >= 192)) { memcpy(rgb, spectrum_rgb[expect[f].border], 3); return; }
+
+    u32 addr = ((sy >> 6) << 11) | ((sy & 7) << 8) | (((sy >> 3) & 7) << 5) | (sx >> 3);
+    u8 attr = expect[f].screen[0x1800 + (sy / 8) * 32 + (sx / 8)];
+    int on = (expect[f].screen[addr] >> (7 - (sx & 7))) & 1;
+
+    // Hi-res - 512 pixels across (a byte from each display file in turn) shown as 256, so
+    // each pixel here is set if either of the two it covers is. BRIGHT and no FLASH or ULA+.
+    if ((expect[f].timex & 0x06) == 0x06)
+    {
+        int hx = sx * 2, column = hx >> 3;
+        u32 hires = (addr & ~31u) + (column >> 1);
+        u8 byte = (column & 1) ? expect[f].screen2[hires] : expect[f].screen[hires];
+        int paper = (expect[f].timex >> 3) & 7;
+        on = (byte >> (6 - (hx & 7))) & 3;
+        memcpy(rgb, spectrum_rgb[8 + (on ? (paper ^ 7) : paper)], 3);
+        return;
+    }
+    if (expect[f].timex & 0x02) attr = expect[f].screen2[addr];     // Hi-colour - one attribute per 8x1
+
+    if (expect[f].ulaplus)
+    {
+        u8 value = expect[f].palette[(attr >> 6) * 16 + (on ? (attr & 7) : 8 + ((attr >> 3) & 7))];
+        int r = (value >> 2) & 7, g = value >> 5, b = ((value & 3) << 1) | ((value & 3) != 0);
+        rgb[0] = (r * 255 + 3) / 7; rgb[1] = (g * 255 + 3) / 7; rgb[2] = (b * 255 + 3) / 7;
+        return;
+    }
+    if ((attr & 0x80) && ((f / 16) & 1)) on = !on;
+    int bright = (attr & 0x40) ? 8 : 0;
+    memcpy(rgb, spectrum_rgb[bright + (on ? (attr & 7) : ((attr >> 3) & 7))], 3);
+}
+
+static void check_avi(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) { CHECK(0, "%s: not there\n", path); return; }
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    u8 *avi = malloc(len);
+    CHECK(fread(avi, len, 1, file) == 1, "%s: can't read it\n", path);
+    fclose(file);
+
+    u32 total = 0;
+    for (int f = 0; f < FRAMES; f++) total += expect[f].samples;
+    u32 rate = (u32)(((double)total * 50 / FRAMES) + 0.5);
+
+    // The headers - as laid out by avi.c
+    CHECK(!memcmp(avi, "RIFF", 4) && (read32(avi + 4) == (u32)len - 8) && !memcmp(avi + 8, "AVI ", 4), "%s: bad RIFF header\n", path);
+    CHECK(!memcmp(avi + 24, "avih", 4) && (read32(avi + 32) == 20000) && (read32(avi + 48) == FRAMES) && (read32(avi + 56) == 2), "avih: %u us/frame, %u frames, %u streams\n", read32(avi + 32), read32(avi + 48), read32(avi + 56));
+    CHECK((read32(avi + 64) == ZXR_WIDTH) && (read32(avi + 68) == ZXR_HEIGHT), "avih: %ux%u\n", read32(avi + 64), read32(avi + 68));
+    CHECK(!memcmp(avi + 108, "vids", 4) && (read32(avi + 132) == 50) && (read32(avi + 140) == FRAMES), "video stream header\n");
+    CHECK(!memcmp(avi + 232, "auds", 4) && (read32(avi + 256) == rate) && (read32(avi + 264) == total), "audio stream: %u Hz for %u samples, should be %u Hz for %u\n", read32(avi + 256), read32(avi + 264), rate, total);
+    CHECK(!memcmp(avi + 322, "movi", 4), "no movi list\n");
+
+    // The chunks in order against the index
+    u32 movi_end = 322 + read32(avi + 318);
+    u32 pos = 326, chunks = 0, frame = 0, sample = 0, sample_frame = 0;
+    const u8 *idx1 = avi + movi_end;
+    CHECK(!memcmp(idx1, "idx1", 4), "no idx1 after the movi list\n");
+    u32 entries = read32(idx1 + 4) / 16;
+
+    while ((pos + 8 <= movi_end) && (failures < 10))
+    {
+        const u8 *chunk = avi + pos;
+        u32 size = read32(chunk + 4);
+        const u8 *entry = idx1 + 8 + chunks * 16;
+
+        CHECK((chunks < entries) && !memcmp(entry, chunk, 4) && (read32(entry + 8) == pos - 322) && (read32(entry + 12) == size), "index entry %u doesn't match the chunk at %u\n", chunks, pos);
+
+        if (!memcmp(chunk, "00db", 4))
+        {
+            CHECK(size == ZXR_WIDTH * ZXR_HEIGHT * 3, "frame %u: %u bytes\n", frame, size);
+            for (int y = 0; y < ZXR_HEIGHT && frame < FRAMES; y++)
+            {
+                const u8 *row = chunk + 8 + (ZXR_HEIGHT - 1 - y) * ZXR_WIDTH * 3;
+                for (int x = 0; x < ZXR_WIDTH; x++)
+                {
+                    u8 rgb[3];
+                    expected_pixel(frame, x, y, rgb);
+                    if ((row[x*3+2] != rgb[0]) || (row[x*3+1] != rgb[1]) || (row[x*3+0] != rgb[2]))
+                    {
+                        CHECK(0, "frame %u pixel %d,%d: %02X%02X%02X, should be %02X%02X%02X\n", frame, x, y, row[x*3+2], row[x*3+1], row[x*3+0], rgb[0], rgb[1], rgb[2]);
+                        y = ZXR_HEIGHT;
+                        break;
+                    }
+                }
+            }
+            sample_frame = frame++;
+            sample = 0;
+        }
+        else if (!memcmp(chunk, "01wb", 4))
+        {
+            CHECK(size == expect[sample_frame].samples * 2u, "frame %u: %u bytes of audio, should be %u\n", sample_frame, size, expect[sample_frame].samples * 2);
+            for (u32 i = 0; (i < size / 2) && (i < expect[sample_frame].samples); i++, sample++)
+            {
+                if ((s16)(chunk[8 + i*2] | (chunk[9 + i*2] << 8)) != expect[sample_frame].audio[i]) { CHECK(0, "frame %u: sample %u is different\n", sample_frame, i); break; }
+            }
+        }
+        else CHECK(0, "unknown chunk at %u\n", pos);
+
+        pos += 8 + size;
+        chunks++;
+    }
+    CHECK((pos == movi_end) && (frame == FRAMES) && (chunks == entries), "%u frames in %u chunks, %u index entries\n", frame, chunks, entries);
+    free(avi);
+}
+
+int main(int argc, char **argv)
+{
+    char converter[PATH_MAX], path[256], command[PATH_MAX + 512];
+    struct stat st;
+
+    if ((argc != 2) || !realpath(argv[1], converter)) { printf("usage: zxr_roundtrip <zxr2video>\n"); return 2; }
+    mkdir("build", 0777);
+    mkdir("build/zxr", 0777);
+    if (chdir("build/zxr")) { printf("zxr_roundtrip: no build/zxr\n"); return 2; }
+
+    find_recording(path, sizeof(path), 1);
+    record();
+    if (find_recording(path, sizeof(path), 0) != 1) { printf("zxr_roundtrip: the recorder didn't write a recording\n"); return 1; }
+
+    stat(path, &st);
+    printf("%s: %d frames in %ld bytes (%.1f%% of the raw frames)\n", path, FRAMES, (long)st.st_size, 100.0 * st.st_size / (FRAMES * (6912 + 2 + 880 * 2)));
+    check_zxr(path);
+    check_truncated(path);
+
+    snprintf(command, sizeof(command), "%s %s out.avi", converter, path);
+    CHECK(system(command) == 0, "%s failed\n", command);
+    check_avi("out.avi");
+    remove("out.avi");
+
+    printf("zxr_roundtrip: %s (recorder.c -> zxr.c -> zxr2video, %d frames)\n", failures ? "FAILED" : "OK", FRAMES);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+// =====================================================================================
+// A plain AVI writer (AVI 1.0 with an idx1 index). Each frame goes in as a '00db' chunk
+// of bottom-up B,G,R rows followed by its audio as a '01wb' chunk. The headers are
+// written with the counts as zero and filled in again by avi_close().
+// =====================================================================================
+#include <stdlib.h>
+#include <string.h>
+
+#include "avi.h"
+
+#define AVI_HEADER_LEN      326         // RIFF, the hdrl list and the movi list header
+#define AVI_MOVI_FOURCC     322         // Where 'movi' is - the idx1 offsets are from here
+
+static uint8_t *put32(uint8_t *p, uint32_t value)
+{
+    p[0] = value & 0xFF; p[1] = (value >> 8) & 0xFF; p[2] = (value >> 16) & 0xFF; p[3] = (value >> 24) & 0xFF;
+    return p + 4;
+}
+
+static uint8_t *put16(uint8_t *p, uint32_t value)
+{
+    p[0] = value & 0xFF; p[1] = (value >> 8) & 0xFF;
+    return p + 2;
+}
+
+static uint8_t *fourcc(uint8_t *p, const char *id)
+{
+    memcpy(p, id, 4);
+    return p + 4;
+}
+
+static uint32_t frame_bytes(const avi_t *avi)
+{
+    return avi->width * avi->height * 3;
+}
+
+static int write_header(avi_t *avi)
+{
+    uint8_t header[AVI_HEADER_LEN];
+    uint8_t *p = header;
+    uint32_t index_bytes = 8 + avi->index_len * 16;
+
+    memset(header, 0x00, sizeof(header));
+    p = fourcc(p, "RIFF"); p = put32(p, AVI_HEADER_LEN - 8 + avi->movi_len + index_bytes); p = fourcc(p, "AVI ");
+    p = fourcc(p, "LIST"); p = put32(p, 294); p = fourcc(p, "hdrl");
+
+    p = fourcc(p, "avih"); p = put32(p, 56);
+    p = put32(p, 1000000 / avi->fps);                                   // Microseconds per frame
+    p = put32(p, (frame_bytes(avi) + 8) * avi->fps + avi->sample_rate * 2);
+    p = put32(p, 0);                                                    // Padding granularity
+    p = put32(p, 0x110);                                                // Has an index and is interleaved
+    p = put32(p, avi->frames);
+    p = put32(p, 0);                                                    // Initial frames
+    p = put32(p, 2);                                                    // Streams
+    p = put32(p, avi->max_chunk + 8);
+    p = put32(p, avi->width);
+    p = put32(p, avi->height);
+    p += 16;                                                            // Reserved
+
+    // Stream 0 - the video
+    p = fourcc(p, "LIST"); p = put32(p, 116); p = fourcc(p, "strl");
+    p = fourcc(p, "strh"); p = put32(p, 56);
+    p = fourcc(p, "vids"); p = put32(p, 0); p = put32(p, 0); p = put32(p, 0); p = put32(p, 0);
+    p = put32(p, 1); p = put32(p, avi->fps);                            // Scale and rate - frames per second
+    p = put32(p, 0); p = put32(p, avi->frames);                         // Start and length
+    p = put32(p, frame_bytes(avi)); p = put32(p, 0xFFFFFFFF); p = put32(p, 0);
+    p = put16(p, 0); p = put16(p, 0); p = put16(p, avi->width); p = put16(p, avi->height);
+    p = fourcc(p, "strf"); p = put32(p, 40);
+    p = put32(p, 40); p = put32(p, avi->width); p = put32(p, avi->height);
+    p = put16(p, 1); p = put16(p, 24);                                  // Planes and bits per pixel
+    p = put32(p, 0); p = put32(p, frame_bytes(avi));                    // Uncompressed
+    p += 16;
+
+    // Stream 1 - the audio
+    p = fourcc(p, "LIST"); p = put32(p, 94); p = fourcc(p, "strl");
+    p = fourcc(p, "strh"); p = put32(p, 56);
+    p = fourcc(p, "auds"); p = put32(p, 0); p = put32(p, 0); p = put32(p, 0); p = put32(p, 0);
+    p = put32(p, 1); p = put32(p, avi->sample_rate);                    // Scale and rate - samples per second
+    p = put32(p, 0); p = put32(p, avi->samples);
+    p = put32(p, avi->sample_rate * 2); p = put32(p, 0xFFFFFFFF); p = put32(p, 2);
+    p += 8;
+    p = fourcc(p, "strf"); p = put32(p, 18);
+    p = put16(p, 1); p = put16(p, 1);                                   // PCM, mono
+    p = put32(p, avi->sample_rate); p = put32(p, avi->sample_rate * 2);
+    p = put16(p, 2); p = put16(p, 16); p = put16(p, 0);
+
+    p = fourcc(p, "LIST"); p = put32(p, 4 + avi->movi_len); p = fourcc(p, "movi");
+
+    return (fseek(avi->file, 0, SEEK_SET) == 0) && (fwrite(header, sizeof(header), 1, avi->file) == 1) ? 0 : -1;
+}
+
+static int write_chunk(avi_t *avi, const char *id, const void *data, uint32_t len)
+{
+    uint8_t head[8];
+
+    if (avi->index_len == avi->index_max)
+    {
+        uint8_t *index = realloc(avi->index, (avi->index_max + 4096) * 16);
+        if (!index) return -1;
+        avi->index = index;
+        avi->index_max += 4096;
+    }
+    uint8_t *entry = avi->index + avi->index_len++ * 16;
+    entry = fourcc(entry, id); entry = put32(entry, 0x10);              // Every chunk is a key frame
+    entry = put32(entry, AVI_HEADER_LEN - AVI_MOVI_FOURCC + avi->movi_len); put32(entry, len);
+
+    fourcc(head, id); put32(head + 4, len);
+    if ((fwrite(head, 8, 1, avi->file) != 1) || (data && (fwrite(data, len, 1, avi->file) != 1))) return -1;
+    avi->movi_len += 8 + len;
+    if (len > avi->max_chunk) avi->max_chunk = len;
+    return 0;
+}
+
+int avi_open(avi_t *avi, const char *path, uint32_t width, uint32_t height, uint32_t fps, uint32_t sample_rate)
+{
+    memset(avi, 0x00, sizeof(*avi));
+    avi->width = width;
+    avi->height = height;
+    avi->fps = fps;
+    avi->sample_rate = sample_rate;
+
+    avi->row = malloc(width * 3);
+    avi->file = fopen(path, "wb");
+    if (!avi->row || !avi->file || write_header(avi))
+    {
+        if (avi->file) fclose(avi->file);
+        free(avi->row);
+        return -1;
+    }
+    return 0;
+}
+
+// One frame of RGB (top row first, as zxr_render draws it) and the audio that goes with it
+int avi_frame(avi_t *avi, const uint8_t *rgb, const int16_t *audio, uint32_t samples)
+{
+    uint32_t pitch = avi->width * 3;
+
+    if (write_chunk(avi, "00db", NULL, frame_bytes(avi))) return -1;
+    for (uint32_t y = avi->height; y-- > 0; )
+    {
+        const uint8_t *in = rgb + y * pitch;
+        for (uint32_t x = 0; x < pitch; x += 3)
+        {
+            avi->row[x+0] = in[x+2];
+            avi->row[x+1] = in[x+1];
+            avi->row[x+2] = in[x+0];
+        }
+        if (fwrite(avi->row, pitch, 1, avi->file) != 1) return -1;
+    }
+    avi->frames++;
+
+    if (samples)
+    {
+        uint8_t pcm[samples * 2];
+        for (uint32_t i = 0; i < samples; i++) put16(&pcm[i*2], (uint16_t)audio[i]);
+        if (write_chunk(avi, "01wb", pcm, samples * 2)) return -1;
+        avi->samples += samples;
+    }
+    return 0;
+}
+
+uint32_t avi_size_with(const avi_t *avi, uint32_t samples)
+{
+    return AVI_HEADER_LEN + avi->movi_len + 8 + frame_bytes(avi) + 8 + samples * 2 + 8 + (avi->index_len + 2) * 16;
+}
+
+// Write the index and fill in the headers - the file is closed either way
+int avi_close(avi_t *avi)
+{
+    uint8_t head[8];
+    int ok;
+
+    fourcc(head, "idx1"); put32(head + 4, avi->index_len * 16);
+    ok = (fwrite(head, 8, 1, avi->file) == 1) && (!avi->index_len || (fwrite(avi->index, avi->index_len * 16, 1, avi->file) == 1));
+    ok = ok && (write_header(avi) == 0);
+    ok = (fclose(avi->file) == 0) && ok;
+
+    free(avi->index);
+    free(avi->row);
+    avi->file = NULL;
+    avi->index = NULL;
+    avi->row = NULL;
+    return ok ? 0 : -1;
+}
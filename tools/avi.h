@@ -0,0 +1,36 @@
+// =====================================================================================
+// A plain AVI writer - uncompressed 24-bit video and 16-bit mono PCM audio, which any
+// player or editor opens (and ffmpeg turns into anything else).
+// =====================================================================================
+#ifndef AVI_H
+#define AVI_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Keep each file under 1GB - the limit for an AVI without the OpenDML extensions
+#define AVI_SIZE_MAX        (1u << 30)
+
+typedef struct
+{
+    FILE     *file;
+    uint32_t width, height, fps, sample_rate;
+    uint32_t frames;
+    uint32_t samples;
+    uint32_t movi_start;                // File offset of the 'movi' list type
+    uint32_t movi_len;
+    uint32_t max_chunk;
+    uint8_t  *index;                    // The idx1 entries, 16 bytes each
+    uint32_t index_len;
+    uint32_t index_max;
+    uint8_t  *row;                      // One bottom-up row of B,G,R
+} avi_t;
+
+extern int avi_open(avi_t *avi, const char *path, uint32_t width, uint32_t height, uint32_t fps, uint32_t sample_rate);
+extern int avi_frame(avi_t *avi, const uint8_t *rgb, const int16_t *audio, uint32_t samples);
+extern int avi_close(avi_t *avi);
+
+// How big the file would be with one more frame of this many samples
+extern uint32_t avi_size_with(const avi_t *avi, uint32_t samples);
+
+#endif
@@ -0,0 +1,195 @@
+// =====================================================================================
+// Reading back the gameplay recordings (.zxr) - each chunk of frames is unpacked with
+// the same lzav.h the recorder packed it with and the screens are XOR'd back onto the
+// previous frame. zxr_render() draws a frame the way screenshot.c would.
+// =====================================================================================
+#include <stdlib.h>
+#include <string.h>
+
+#include "zxr.h"
+#include "lzav.h"
+
+// The 16 colors of the normal ULA - ZX_Spectrum_palette[] in SpeccyUtils.c
+static const u8 zxr_palette[16*3] =
+{
+    0x00,0x00,0x00,  0x00,0x00,0xD8,  0xD8,0x00,0x00,  0xD8,0x00,0xD8,
+    0x00,0xD8,0x00,  0x00,0xD8,0xD8,  0xD8,0xD8,0x00,  0xD8,0xD8,0xD8,
+    0x00,0x00,0x00,  0x00,0x00,0xFF,  0xFF,0x00,0x00,  0xFF,0x00,0xFF,
+    0x00,0xFF,0x00,  0x00,0xFF,0xFF,  0xFF,0xFF,0x00,  0xFF,0xFF,0xFF,
+};
+
+static u32 read32(const u8 *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24);
+}
+
+// Returns 0 if the file is there and is a recording we know
+int zxr_open(zxr_t *zxr, const char *path)
+{
+    u8 header[16];
+
+    memset(zxr, 0x00, sizeof(*zxr));
+    zxr->file = fopen(path, "rb");
+    if (!zxr->file) return -1;
+
+    zxr->comp = malloc(lzav_compress_bound(ZXR_CHUNK_MAX));
+    if (!zxr->comp || (fread(header, sizeof(header), 1, zxr->file) != 1) || memcmp(header, "ZXRC", 4) || (header[4] < 1) || (header[4] > ZXR_VERSION))
+    {
+        zxr_close(zxr);
+        return -1;
+    }
+
+    zxr->machine = header[5];
+    zxr->fps = header[6] | (header[7] << 8);
+    zxr->sample_rate = read32(&header[8]);
+    return 0;
+}
+
+void zxr_close(zxr_t *zxr)
+{
+    if (zxr->file) fclose(zxr->file);
+    free(zxr->comp);
+    zxr->file = NULL;
+    zxr->comp = NULL;
+}
+
+// -------------------------------------------------------------------------------------
+// The next frame into zxr - returns 1 for a frame, 0 at the end of the recording and
+// -1 if the file is damaged (what was read before that is still good). A recording cut
+// short in the middle of a chunk (the SD card filled up) just ends at the last chunk.
+// -------------------------------------------------------------------------------------
+int zxr_next(zxr_t *zxr)
+{
+    if (zxr->chunk_pos == zxr->chunk_len)
+    {
+        u8 lens[8];
+        if (fread(lens, sizeof(lens), 1, zxr->file) != 1) return 0;
+
+        u32 raw_len = read32(&lens[0]);
+        u32 comp_len = read32(&lens[4]);
+        if ((raw_len == 0) || (raw_len > ZXR_CHUNK_MAX) || (comp_len > (u32)lzav_compress_bound(ZXR_CHUNK_MAX))) return -1;
+        if (fread(zxr->comp, comp_len, 1, zxr->file) != 1) return 0;
+        if (lzav_decompress(zxr->comp, zxr->chunk, comp_len, raw_len) != (int)raw_len) return -1;
+
+        zxr->chunk_len = raw_len;
+        zxr->chunk_pos = 0;
+    }
+
+    const u8 *in = zxr->chunk + zxr->chunk_pos;
+    const u8 *end = zxr->chunk + zxr->chunk_len;
+    u8 flags = *in++;
+
+    if (flags & ZXR_FLAG_BORDER)
+    {
+        if (in + 1 > end) return -1;
+        zxr->border = *in++ & 0x07;
+    }
+    if (flags & ZXR_FLAG_PALETTE)
+    {
+        if (in + 64 > end) return -1;
+        memcpy(zxr->palette, in, 64); in += 64;
+    }
+    zxr->ulaplus = (flags & ZXR_FLAG_ULAPLUS) ? 1:0;
+    if (flags & ZXR_FLAG_TIMEX)
+    {
+        if (in + 1 > end) return -1;
+        zxr->timex = *in++;
+    }
+
+    if (in + 2 > end) return -1;
+    u32 samples = in[0] | (in[1] << 8); in += 2;
+    u32 screen2 = (zxr->timex & 0x02) ? 6144 : 0;
+    if ((samples > ZXR_MAX_SAMPLES) || (in + 6912 + screen2 + (samples * 2) > end)) return -1;
+
+    for (int i=0; i<6912; i++) zxr->screen[i] ^= *in++;
+    for (u32 i=0; i<screen2; i++) zxr->screen2[i] ^= *in++;
+    for (u32 i=0; i<samples; i++, in += 2) zxr->audio[i] = (s16)(in[0] | (in[1] << 8));
+    zxr->samples = samples;
+
+    zxr->chunk_pos = in - zxr->chunk;
+    zxr->frame++;
+    return 1;
+}
+
+// The R,G,B of a ULA+ palette register (G3 R3 B2) - as apply_ula_plus_palette() in spectrum.c
+static void ula_plus_rgb(u8 value, u8 *rgb)
+{
+    u8 r = (value >> 2) & 7;
+    u8 g = (value >> 5) & 7;
+    u8 b = (value & 3) << 1 | ((value & 3) ? 1:0);
+    rgb[0] = (r << 5) | (r << 2) | (r >> 1);
+    rgb[1] = (g << 5) | (g << 2) | (g >> 1);
+    rgb[2] = (b << 5) | (b << 2) | (b >> 1);
+}
+
+// 8 hi-res pixels down to 4 - zx_hires_pack[] in spectrum.c
+static u8 zxr_hires_pack(u8 pixels)
+{
+    return ((pixels & 0xC0) ? 0x08:0) | ((pixels & 0x30) ? 0x04:0) | ((pixels & 0x0C) ? 0x02:0) | ((pixels & 0x03) ? 0x01:0);
+}
+
+// -------------------------------------------------------------------------------------
+// The last frame read as ZXR_WIDTH x ZXR_HEIGHT RGB. FLASH isn't recorded, so it goes by
+// the frame count - the ULA swaps ink and paper every 16 frames. For ULA+ the FLASH and
+// BRIGHT bits pick one of the 4 palette groups instead (16 colors - 8 ink then 8 paper).
+//
+// Timex hi-colour takes the attribute for each 8x1 pixels from the second display file.
+// Hi-res is squeezed down to 256 pixels across the way the emulator shows it (a pair of
+// pixels is set if either is) in BRIGHT paper from bits 3-5 of the mode and its
+// complement as the ink - the normal colors whatever ULA+ is doing.
+// -------------------------------------------------------------------------------------
+void zxr_render(const zxr_t *zxr, u8 *rgb)
+{
+    u8 colors[64*3];
+    u8 flash = (((zxr->frame - 1) >> 4) & 1) ? 0x80 : 0x00;
+
+    if (zxr->ulaplus) for (int i=0; i<64; i++) ula_plus_rgb(zxr->palette[i], &colors[i*3]);
+    else memcpy(colors, zxr_palette, sizeof(zxr_palette));
+
+    // The border is always one of the 8 normal colors (as zx_border_colors[] in spectrum.c)
+    const u8 *border = &zxr_palette[zxr->border * 3];
+    for (int i=0; i<ZXR_WIDTH*ZXR_HEIGHT; i++) memcpy(&rgb[i*3], border, 3);
+
+    u8 hires = ((zxr->timex & 0x06) == 0x06);
+    u8 hicolor = (!hires && (zxr->timex & 0x02));
+    if (hires) memcpy(colors, zxr_palette, sizeof(zxr_palette));
+
+    for (int y=0; y<192; y++)
+    {
+        u32 line = ((y&0x07) << 8) | ((y&0x38) << 2) | ((y&0xC0) << 5);
+        const u8 *pixelPtr = zxr->screen + line;
+        const u8 *attrPtr = hicolor ? (zxr->screen2 + line) : (zxr->screen + 0x1800 + ((y >> 3) * 32));
+        u8 *out = rgb + ((((y + ZXR_BORDER_Y) * ZXR_WIDTH) + ZXR_BORDER_X) * 3);
+
+        for (int x=0; x<32; x++)
+        {
+            u8 attr = *attrPtr++;
+            u8 pixel = *pixelPtr++;
+            u8 ink, paper;
+
+            if (hires)
+            {
+                u8 odd = zxr->screen2[line + x];
+                pixel = (zxr_hires_pack(pixel) << 4) | zxr_hires_pack(odd);
+                paper = 0x08 | ((zxr->timex >> 3) & 0x07);
+                ink   = paper ^ 0x07;
+            }
+            else if (zxr->ulaplus)
+            {
+                ink   = ((attr >> 2) & 0x30) | (attr & 0x07);
+                paper = ((attr >> 2) & 0x30) | 0x08 | ((attr >> 3) & 0x07);
+            }
+            else
+            {
+                ink   = (attr & 0x07) | ((attr >> 3) & 0x08);
+                paper = (attr >> 3) & 0x0F;
+                if (attr & flash) pixel ^= 0xFF;
+            }
+
+            for (int bit=0; bit<8; bit++, out += 3)
+            {
+                memcpy(out, &colors[((pixel & (0x80 >> bit)) ? ink : paper) * 3], 3);
+            }
+        }
+    }
+}
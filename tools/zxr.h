@@ -0,0 +1,62 @@
+// =====================================================================================
+// Reading back the gameplay recordings (.zxr) that arm9/source/recorder.c writes - see
+// the file layout at the top of that file.
+// =====================================================================================
+#ifndef ZXR_H
+#define ZXR_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int16_t  s16;
+
+#define ZXR_VERSION         2           // Version 1 (no Timex modes) reads too
+#define ZXR_MAX_SAMPLES     1536        // REC_MAX_SAMPLES in recorder.c
+#define ZXR_FRAME_MAX       (1 + 1 + 64 + 1 + 2 + 6912 + 6144 + (ZXR_MAX_SAMPLES * 2))
+#define ZXR_CHUNK_MAX       (4 * ZXR_FRAME_MAX)
+
+#define ZXR_FLAG_BORDER     0x01
+#define ZXR_FLAG_PALETTE    0x02
+#define ZXR_FLAG_ULAPLUS    0x04
+#define ZXR_FLAG_TIMEX      0x08
+
+// The rendered picture - the 256x192 screen with 32 pixels of border either side and
+// 24 above and below, 3 bytes (R,G,B) a pixel, top row first
+#define ZXR_WIDTH           320
+#define ZXR_HEIGHT          240
+#define ZXR_BORDER_X        32
+#define ZXR_BORDER_Y        24
+
+typedef struct
+{
+    FILE *file;
+    u8   machine;                       // 0=48K, 1=128K
+    u16  fps;
+    u32  sample_rate;                   // As noted when the recording started
+
+    u8   chunk[ZXR_CHUNK_MAX];          // The chunk being read and where we are in it
+    u8  *comp;
+    u32  chunk_len;
+    u32  chunk_pos;
+
+    // Everything as of the last frame read
+    u32  frame;                         // Frames read so far
+    u8   screen[6912];
+    u8   border;
+    u8   palette[64];
+    u8   ulaplus;
+    u8   timex;                         // Timex screen mode - screen2 is only kept up while bit 1 is set
+    u8   screen2[6144];                 // The second display file (hi-colour attributes or odd hi-res columns)
+    u16  samples;
+    s16  audio[ZXR_MAX_SAMPLES];
+} zxr_t;
+
+extern int  zxr_open(zxr_t *zxr, const char *path);
+extern int  zxr_next(zxr_t *zxr);
+extern void zxr_close(zxr_t *zxr);
+extern void zxr_render(const zxr_t *zxr, u8 *rgb);
+
+#endif
@@ -0,0 +1,90 @@
+// =====================================================================================
+// zxr2video - turns a SpeccySE gameplay recording (REC-*.zxr, see recorder.c) into an
+// AVI with uncompressed video and PCM audio.
+//
+//   zxr2video REC-01-02-2026-10-20-30.zxr [out.avi]
+//
+// The video is the 256x192 screen with a 32 pixel border at 50 frames/sec. Past 1GB
+// the video goes on in out-2.avi, out-3.avi and so on. For something smaller:
+//
+//   ffmpeg -i out.avi -c:v libx264 -crf 18 -c:a aac out.mp4
+//
+// The audio is every sample the emulation made for each frame. Its rate is worked out
+// from how many there are over the whole recording rather than taken from the header,
+// so the sound stays in step with the picture however far the emulation drifted from
+// the nominal rate (the sound output is what follows the DS clock, not the mixer).
+// =====================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zxr.h"
+#include "avi.h"
+
+static char *part_name(const char *out, int part)
+{
+    static char name[1024];
+    const char *dot = strrchr(out, '.');
+    int base = dot ? (int)(dot - out) : (int)strlen(out);
+
+    if (part == 1) snprintf(name, sizeof(name), "%s", out);
+    else snprintf(name, sizeof(name), "%.*s-%d%s", base, out, part, dot ? dot : "");
+    return name;
+}
+
+int main(int argc, char **argv)
+{
+    static zxr_t zxr;
+    static u8 rgb[ZXR_WIDTH * ZXR_HEIGHT * 3];
+    char out[1024];
+    avi_t avi;
+    int status;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        printf("usage: zxr2video recording.zxr [out.avi]\n");
+        return 2;
+    }
+    if (argc == 3) snprintf(out, sizeof(out), "%s", argv[2]);
+    else
+    {
+        const char *dot = strrchr(argv[1], '.');
+        snprintf(out, sizeof(out), "%.*s.avi", dot ? (int)(dot - argv[1]) : (int)strlen(argv[1]), argv[1]);
+    }
+
+    // First the length of the recording and how much audio there is
+    if (zxr_open(&zxr, argv[1])) { printf("%s: not a SpeccySE recording\n", argv[1]); return 1; }
+    u32 frames = 0;
+    double samples = 0;
+    while ((status = zxr_next(&zxr)) == 1) { frames++; samples += zxr.samples; }
+    zxr_close(&zxr);
+    if (status < 0) printf("%s: damaged after frame %u - converting what came before\n", argv[1], frames);
+    if (frames == 0) { printf("%s: no frames\n", argv[1]); return 1; }
+
+    u32 fps = zxr.fps ? zxr.fps : 50;
+    u32 sample_rate = (u32)((samples * fps / frames) + 0.5);
+    if (sample_rate == 0) sample_rate = zxr.sample_rate;
+
+    zxr_open(&zxr, argv[1]);
+    int part = 1;
+    if (avi_open(&avi, part_name(out, part), ZXR_WIDTH, ZXR_HEIGHT, fps, sample_rate)) { printf("%s: can't write it\n", part_name(out, part)); return 1; }
+
+    for (u32 frame = 0; frame < frames; frame++)
+    {
+        zxr_next(&zxr);
+        zxr_render(&zxr, rgb);
+
+        if (avi_size_with(&avi, zxr.samples) > AVI_SIZE_MAX)
+        {
+            if (avi_close(&avi)) { printf("%s: write failed\n", part_name(out, part)); return 1; }
+            if (avi_open(&avi, part_name(out, ++part), ZXR_WIDTH, ZXR_HEIGHT, fps, sample_rate)) { printf("%s: can't write it\n", part_name(out, part)); return 1; }
+        }
+        if (avi_frame(&avi, rgb, zxr.audio, zxr.samples)) { printf("%s: write failed\n", part_name(out, part)); return 1; }
+    }
+    zxr_close(&zxr);
+    if (avi_close(&avi)) { printf("%s: write failed\n", part_name(out, part)); return 1; }
+
+    printf("%s: %u frames (%u:%02u), %s, audio %u Hz (%u Hz in the header)%s\n", out, frames, frames / fps / 60, (frames / fps) % 60,
+           zxr.machine ? "128K" : "48K", sample_rate, zxr.sample_rate, (part > 1) ? " - in parts" : "");
+    return 0;
+}